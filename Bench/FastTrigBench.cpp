@@ -0,0 +1,129 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Times the sine and cosine and the arc tangent of the library against
+// the polynomials of each accuracy, one value at a time and for arrays.
+// The accuracy is checked by Tests/FastTrigTest.
+#include "FastTrig.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock CLOCK;
+
+// values in each array and the times the arrays are timed
+static const int SAMPLES = 1000000;
+static const int REPEATS = 20;
+
+/////////////////////////////////////////////////////////////////////////////
+// nanoseconds a value between two times
+static double GetNanoseconds( CLOCK::time_point t0, CLOCK::time_point t1 )
+{
+	const double dTotal = chrono::duration<double, nano>( t1 - t0 ).count();
+	return dTotal / REPEATS / SAMPLES;
+
+} // GetNanoseconds
+
+/////////////////////////////////////////////////////////////////////////////
+// time one accuracy where the name is printed with its timings
+template <class TAccuracy> static void TimeAccuracy
+(
+	const char* pName, const vector<double>& x, const vector<double>& y
+)
+{
+	typedef CFastTrig<TAccuracy> TRIG;
+	vector<double> sines( SAMPLES );
+	vector<double> cosines( SAMPLES );
+	vector<double> angles( SAMPLES );
+	double dSum = 0;
+
+	const CLOCK::time_point t0 = CLOCK::now();
+	for ( int nRepeat = 0; nRepeat < REPEATS; nRepeat++ )
+	{
+		for ( int n = 0; n < SAMPLES; n++ )
+		{
+			sines[ n ] = sin( x[ n ] );
+			cosines[ n ] = cos( x[ n ] );
+		}
+		dSum += sines[ nRepeat ] + cosines[ nRepeat ];
+	}
+	const CLOCK::time_point t1 = CLOCK::now();
+	for ( int nRepeat = 0; nRepeat < REPEATS; nRepeat++ )
+	{
+		for ( int n = 0; n < SAMPLES; n++ )
+		{
+			TRIG::SinCos( x[ n ], sines[ n ], cosines[ n ] );
+		}
+		dSum += sines[ nRepeat ] + cosines[ nRepeat ];
+	}
+	const CLOCK::time_point t2 = CLOCK::now();
+	for ( int nRepeat = 0; nRepeat < REPEATS; nRepeat++ )
+	{
+		TRIG::SinCos( x.data(), sines.data(), cosines.data(), SAMPLES );
+		dSum += sines[ nRepeat ] + cosines[ nRepeat ];
+	}
+	const CLOCK::time_point t3 = CLOCK::now();
+	for ( int nRepeat = 0; nRepeat < REPEATS; nRepeat++ )
+	{
+		for ( int n = 0; n < SAMPLES; n++ )
+		{
+			angles[ n ] = atan2( y[ n ], x[ n ] );
+		}
+		dSum += angles[ nRepeat ];
+	}
+	const CLOCK::time_point t4 = CLOCK::now();
+	for ( int nRepeat = 0; nRepeat < REPEATS; nRepeat++ )
+	{
+		for ( int n = 0; n < SAMPLES; n++ )
+		{
+			angles[ n ] = TRIG::Atan2( y[ n ], x[ n ] );
+		}
+		dSum += angles[ nRepeat ];
+	}
+	const CLOCK::time_point t5 = CLOCK::now();
+	for ( int nRepeat = 0; nRepeat < REPEATS; nRepeat++ )
+	{
+		TRIG::Atan2( y.data(), x.data(), angles.data(), SAMPLES );
+		dSum += angles[ nRepeat ];
+	}
+	const CLOCK::time_point t6 = CLOCK::now();
+
+	printf
+	(
+		"%s: sin and cos library %.1f ns, one %.1f ns, array %.1f ns\n",
+		pName, GetNanoseconds( t0, t1 ), GetNanoseconds( t1, t2 ),
+		GetNanoseconds( t2, t3 )
+	);
+	printf
+	(
+		"%s: atan2 library %.1f ns, one %.1f ns, array %.1f ns (sum %g)\n",
+		pName, GetNanoseconds( t3, t4 ), GetNanoseconds( t4, t5 ),
+		GetNanoseconds( t5, t6 ), dSum
+	);
+
+} // TimeAccuracy
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	// angles within a thousand radians and points of every quadrant
+	vector<double> x( SAMPLES );
+	vector<double> y( SAMPLES );
+	unsigned int nState = 12345;
+	for ( int n = 0; n < SAMPLES; n++ )
+	{
+		nState = nState * 1664525 + 1013904223;
+		x[ n ] = 1000 * ( nState / 2147483648.0 - 1 );
+		nState = nState * 1664525 + 1013904223;
+		y[ n ] = 5 * ( nState / 2147483648.0 - 1 );
+	}
+
+	TimeAccuracy<CTrigScreen>( "screen", x, y );
+	TimeAccuracy<CTrigPhysics>( "physics", x, y );
+	return 0;
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
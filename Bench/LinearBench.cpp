@@ -0,0 +1,296 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Times a frame's worth of CLinear geometry with the cached length, angle
+// and direction against the arithmetic CLinear used before the cache, and
+// reports how far the two results are apart. CLinear uses MFC types and
+// MSVC properties, so this benchmark is only built with Visual Studio.
+#include "stdafx.h"
+#include "Linear.h"
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+typedef chrono::steady_clock CLOCK;
+
+// frames timed
+static const int FRAMES = 2000000;
+
+/////////////////////////////////////////////////////////////////////////////
+// the arithmetic of CLinear before the length, angle and direction were
+// cached, where every read of the angle takes an arc tangent and a length
+// change rotates the segment to horizontal and back
+class CLegacyLinear
+{
+	// protected data
+protected:
+	double m_dX1;
+	double m_dY1;
+	double m_dX2;
+	double m_dY2;
+	int m_nUpIncrement;
+
+	// public methods
+public:
+	// PI
+	static double GetPI()
+	{
+		return 3.1415926535897932384626433832795;
+	}
+
+	double GetX2() const
+	{
+		return m_dX2;
+	}
+
+	double GetY2() const
+	{
+		return m_dY2;
+	}
+
+	// set both points
+	void SetPoints( double dX1, double dY1, double dX2, double dY2 )
+	{
+		m_dX1 = dX1;
+		m_dY1 = dY1;
+		m_dX2 = dX2;
+		m_dY2 = dY2;
+	}
+
+	// absolute length of this line segment
+	double GetLength() const
+	{
+		const double dRun = m_dX2 - m_dX1;
+		const double dRise = m_dY2 - m_dY1;
+		if ( dRun == 0 )
+		{
+			return fabs( dRise );
+		}
+		else if ( dRise == 0 )
+		{
+			return fabs( dRun );
+		}
+		return sqrt( dRun * dRun + dRise * dRise );
+	}
+
+	// return the angle in radians from horizontal
+	double GetAngleInRadians() const
+	{
+		if ( GetLength() == 0 )
+		{
+			return 0;
+		}
+
+		const double dOpp = m_nUpIncrement * ( m_dY2 - m_dY1 );
+		const double dAdj = m_dX2 - m_dX1;
+		double dAngle;
+		if ( dAdj == 0 )
+		{
+			dAngle = dOpp > 0 ? GetPI() / 2 : -GetPI() / 2;
+		}
+		else if ( dOpp == 0 )
+		{
+			dAngle = dAdj > 0 ? 0 : GetPI();
+		}
+		else
+		{
+			dAngle = atan( dOpp / dAdj );
+			if ( dAdj < 0 )
+			{
+				dAngle += dOpp < 0 ? -GetPI() : GetPI();
+			}
+		}
+		return dAngle;
+	}
+
+	// return the angle in degrees from horizontal
+	double GetAngleInDegrees() const
+	{
+		return 180 * GetAngleInRadians() / GetPI();
+	}
+
+	// rotate the second point around the first point, including the
+	// unused read of the angle in degrees the old code made
+	void RotateAroundFirstPoint( double dRotation )
+	{
+		const double dHyp = GetLength();
+		if ( dHyp == 0 )
+		{
+			return;
+		}
+
+		volatile double dLineAngle = GetAngleInDegrees();
+		(void)dLineAngle;
+		const double dRadians =
+			GetAngleInRadians() + dRotation * GetPI() / 180;
+		m_dX2 = m_dX1 + dHyp * cos( dRadians );
+		m_dY2 = m_dY1 + m_nUpIncrement * dHyp * sin( dRadians );
+	}
+
+	// set the length by rotating the segment to horizontal and back
+	void SetLength( double dLength )
+	{
+		const double dAngle = GetAngleInDegrees();
+		RotateAroundFirstPoint( -dAngle );
+		m_dX2 = m_dX1 + dLength;
+		RotateAroundFirstPoint( dAngle );
+	}
+
+	// public construction
+public:
+	CLegacyLinear()
+	{
+		m_dX1 = m_dY1 = m_dX2 = m_dY2 = 0;
+		m_nUpIncrement = -1;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// set the points of a CLinear the same way as CLegacyLinear
+static void SetPoints
+(
+	CLinear& line, double dX1, double dY1, double dX2, double dY2
+)
+{
+	line.SetX1( dX1 );
+	line.SetY1( dY1 );
+	line.SetX2( dX2 );
+	line.SetY2( dY2 );
+
+} // SetPoints
+
+/////////////////////////////////////////////////////////////////////////////
+// set the points of a CLegacyLinear
+static void SetPoints
+(
+	CLegacyLinear& line, double dX1, double dY1, double dX2, double dY2
+)
+{
+	line.SetPoints( dX1, dY1, dX2, dY2 );
+
+} // SetPoints
+
+/////////////////////////////////////////////////////////////////////////////
+// The geometry of a number of frames: the distance, gravity and velocity
+// vectors are moved as UpdateMoonVectors moves them, and then nine vectors
+// are drawn with the two sides of their arrowheads, the angle of their
+// labels and the arcs and angle text of the three main vectors. Returns a
+// sum of the results so the work is not optimized away.
+template <class TLine> static double RunFrames( int nFrames )
+{
+	double dSum = 0;
+	for ( int nFrame = 0; nFrame < nFrames; nFrame++ )
+	{
+		const double dOrbit = nFrame * 0.001;
+		const double dMoonX = 1000 + 4000 * cos( dOrbit );
+		const double dMoonY = 1000 - 4000 * sin( dOrbit );
+
+		TLine vectors[ 9 ];
+		SetPoints( vectors[ 0 ], dMoonX, dMoonY, 1000, 1000 );
+		SetPoints( vectors[ 1 ], dMoonX, dMoonY, 1000, 1000 );
+		vectors[ 1 ].SetLength( 2000 );
+		vectors[ 2 ] = vectors[ 1 ];
+		vectors[ 2 ].SetLength( 1000 );
+		vectors[ 2 ].RotateAroundFirstPoint( -90 );
+		for ( int nVector = 3; nVector < 9; nVector++ )
+		{
+			vectors[ nVector ] = vectors[ nVector % 3 ];
+		}
+
+		for ( int nVector = 0; nVector < 9; nVector++ )
+		{
+			TLine& line = vectors[ nVector ];
+			for ( int nSide = 0; nSide < 2; nSide++ )
+			{
+				const double dAngle =
+					line.GetAngleInDegrees() + ( nSide == 0 ? 15 : -15 );
+				TLine side;
+				SetPoints
+				(
+					side, line.GetX2(), line.GetY2(), line.GetX2() - 100,
+					line.GetY2()
+				);
+				side.RotateAroundFirstPoint( dAngle );
+				dSum += side.GetX2();
+			}
+
+			if ( nVector < 3 )
+			{
+				dSum += line.GetAngleInDegrees() + line.GetLength();
+			}
+			dSum += line.GetAngleInDegrees();
+		}
+	}
+
+	return dSum;
+
+} // RunFrames
+
+/////////////////////////////////////////////////////////////////////////////
+// the largest difference in logical units between the two implementations
+// over many segments that have their length set and are then rotated
+static double GetLargestDifference()
+{
+	double dLargest = 0;
+	for ( int nSegment = 0; nSegment < 100000; nSegment++ )
+	{
+		const double dAngle = nSegment * 0.0137;
+		const double dX2 = 10 + 500 * cos( dAngle );
+		const double dY2 = 20 + 300 * sin( 3 * dAngle );
+		CLinear line;
+		CLegacyLinear legacy;
+		SetPoints( line, 10, 20, dX2, dY2 );
+		SetPoints( legacy, 10, 20, dX2, dY2 );
+
+		line.SetLength( 777 );
+		legacy.SetLength( 777 );
+		dLargest = max
+		(
+			dLargest,
+			fabs( line.GetX2() - legacy.GetX2() ) +
+			fabs( line.GetY2() - legacy.GetY2() )
+		);
+
+		line.RotateAroundFirstPoint( nSegment * 7.3 );
+		legacy.RotateAroundFirstPoint( nSegment * 7.3 );
+		dLargest = max
+		(
+			dLargest,
+			fabs( line.GetX2() - legacy.GetX2() ) +
+			fabs( line.GetY2() - legacy.GetY2() )
+		);
+	}
+	return dLargest;
+
+} // GetLargestDifference
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	for ( int nRun = 0; nRun < 2; nRun++ )
+	{
+		const CLOCK::time_point t0 = CLOCK::now();
+		const double dLegacy = RunFrames<CLegacyLinear>( FRAMES );
+		const CLOCK::time_point t1 = CLOCK::now();
+		const double dCached = RunFrames<CLinear>( FRAMES );
+		const CLOCK::time_point t2 = CLOCK::now();
+
+		printf
+		(
+			"before %.1f ns a frame, after %.1f ns a frame (sums %g %g)\n",
+			chrono::duration<double, nano>( t1 - t0 ).count() / FRAMES,
+			chrono::duration<double, nano>( t2 - t1 ).count() / FRAMES,
+			dLegacy, dCached
+		);
+	}
+
+	printf
+	(
+		"largest difference %g logical units\n", GetLargestDifference()
+	);
+	return 0;
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
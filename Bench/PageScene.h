@@ -0,0 +1,104 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "DisplayList.h"
+#include <cmath>
+#include <cwchar>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////
+// The logical size of the page the lunar orbit view draws, which is 11 by
+// 8.5 inches at the Map of the document of 1000 units per inch.
+static const int PAGE_WIDTH = 11000;
+static const int PAGE_HEIGHT = 8500;
+
+/////////////////////////////////////////////////////////////////////////////
+// Record a page shaped like the lunar orbit view for the benchmarks of the
+// software renderer: the grid with its labels, a block of equations on an
+// opaque background, the earth, a trail of the given number of points
+// around it and the moon with nine vectors, each with its arrowhead,
+// dotted arc and turned label.
+inline void RecordPage
+(
+	CDisplayList& list, CDisplayStyles& styles, int nTrailPoints
+)
+{
+	const int nGrid =
+		styles.AddPen( DISPLAY_PEN_SOLID, 0, DisplayColor( 192, 192, 192 ) );
+	const int nBlack = styles.AddPen( DISPLAY_PEN_SOLID, 10, 0 );
+	const int nBlue = styles.AddBrush( DisplayColor( 0, 0, 255 ) );
+	const int nGray = styles.AddBrush( DisplayColor( 128, 128, 128 ) );
+	const int nFont = styles.AddFont( L"Arial", 125 );
+	const int nSmallFont = styles.AddFont( L"Arial", 100 );
+
+	// the grid and its labels every half inch
+	for ( int nX = 500; nX <= 10500; nX += 500 )
+	{
+		list.Line( nGrid, nX, 500, nX, 8000 );
+		wchar_t szLabel[ 16 ];
+		swprintf( szLabel, 16, L"%d", nX / 10 );
+		list.Text
+		(
+			nSmallFont, -900, DISPLAY_ALIGN_LEFT | DISPLAY_ALIGN_BASELINE, 0,
+			nX, 480, szLabel
+		);
+	}
+	for ( int nY = 500; nY <= 8000; nY += 500 )
+	{
+		list.Line( nGrid, 500, nY, 10500, nY );
+	}
+
+	// the equations
+	for ( int nLine = 0; nLine < 12; nLine++ )
+	{
+		list.Text
+		(
+			nFont, 0, DISPLAY_ALIGN_OPAQUE, 0, 600, 600 + nLine * 150,
+			L"    s = ut + \x00bd" L"at\x00b2  angle=12.34\x00ba"
+		);
+	}
+
+	// the earth and the trail of the moon around it
+	list.Ellipse( nBlack, nBlue, 5000, 3750, 5500, 4250 );
+	vector<DISPLAY_POINT> trail( nTrailPoints );
+	for ( int nPoint = 0; nPoint < nTrailPoints; nPoint++ )
+	{
+		const double dAngle = 6.283185307179586 * nPoint / nTrailPoints;
+		trail[ nPoint ].x = long( 5250 + 3000 * cos( dAngle ) );
+		trail[ nPoint ].y = long( 4000 - 2800 * sin( dAngle ) );
+	}
+	list.Polyline( nBlack, trail.data(), nTrailPoints );
+
+	// the moon and its vectors
+	list.Ellipse( nBlack, nGray, 8150, 3900, 8350, 4100 );
+	for ( int nVector = 0; nVector < 9; nVector++ )
+	{
+		const double dAngle = nVector * 0.7;
+		const double dDegrees = dAngle * 180 / 3.141592653589793;
+		const long nX2 = long( 8250 + 1500 * cos( dAngle ) );
+		const long nY2 = long( 4000 - 1500 * sin( dAngle ) );
+		const DISPLAY_COLOR color =
+			DisplayColor( nVector % 2 == 0 ? 0 : 255, 0, 255 );
+		const int nPen = styles.AddPen( DISPLAY_PEN_SOLID, 20, color );
+		const int nDot = styles.AddPen( DISPLAY_PEN_DOT, 20, color );
+		list.Line( nPen, 8250, 4000, nX2, nY2 );
+		const DISPLAY_POINT arrow[ 4 ] =
+		{
+			{ nX2, nY2 }, { nX2 - 100, nY2 + 50 }, { nX2 - 50, nY2 - 100 },
+			{ nX2, nY2 }
+		};
+		list.Polygon( nPen, nBlue, arrow, 4 );
+		list.Arc( nDot, 8250, 4000, 375, 0.0f, float( dDegrees ) );
+		list.Text
+		(
+			nSmallFont, int( dDegrees * 10 ),
+			DISPLAY_ALIGN_CENTER | DISPLAY_ALIGN_BOTTOM,
+			DisplayColor( 255, 0, 0 ), ( 8250 + nX2 ) / 2, ( 4000 + nY2 ) / 2,
+			L"Vg 1.02 km/s"
+		);
+	}
+
+} // RecordPage
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,257 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Times the step loop of CPropagator in nanoseconds a time slice against
+// the loop it replaced, for each combination of stop conditions, and then
+// each of the integrators that can be selected at runtime.
+#include "Propagator.h"
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+typedef chrono::steady_clock CLOCK;
+
+// radius of the orbit in meters
+static const double ORBIT_RADIUS = 382500000.0;
+
+// time slices in a batch and batches timed
+static const int BATCH_STEPS = 3600;
+static const int BATCHES = 1000;
+
+/////////////////////////////////////////////////////////////////////////////
+// The properties the step loop read from the view and the document before
+// CPropagator, which are kept out of line so every read is a call as it
+// was through the MFC property getters.
+class CLegacyView
+{
+public:
+	bool m_bThirtyDegreeSteps;
+	bool m_bSingleOrbit;
+	double m_dAngleError;
+	double m_dMoonX;
+	double m_dMoonY;
+	double m_dMoonScaling;
+	int m_nMap;
+
+	// public methods
+public:
+#if defined( _MSC_VER )
+	__declspec( noinline ) bool GetThirtyDegreeSteps();
+	__declspec( noinline ) bool GetSingleOrbit();
+	__declspec( noinline ) double GetAngleError();
+	__declspec( noinline ) double GetDegrees();
+#else
+	__attribute__(( noinline )) bool GetThirtyDegreeSteps();
+	__attribute__(( noinline )) bool GetSingleOrbit();
+	__attribute__(( noinline )) double GetAngleError();
+	__attribute__(( noinline )) double GetDegrees();
+#endif
+};
+
+/////////////////////////////////////////////////////////////////////////////
+bool CLegacyView::GetThirtyDegreeSteps()
+{
+	return m_bThirtyDegreeSteps;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool CLegacyView::GetSingleOrbit()
+{
+	return m_bSingleOrbit;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double CLegacyView::GetAngleError()
+{
+	return m_dAngleError;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// the angle of the distance vector from the moon center in logical units
+// the way CLinear measured it
+double CLegacyView::GetDegrees()
+{
+	const int nX = int( m_dMoonX / m_dMoonScaling * m_nMap );
+	const int nY = int( m_dMoonY / m_dMoonScaling * m_nMap );
+	const double dOpposite = -nY;
+	const double dAdjacent = nX;
+	if ( dAdjacent == 0 && dOpposite == 0 )
+	{
+		return 0;
+	}
+
+	double dRadians = atan( dOpposite / dAdjacent );
+	if ( dAdjacent < 0 )
+	{
+		dRadians += dOpposite < 0 ? -3.14159265358979 : 3.14159265358979;
+	}
+	return 180 * dRadians / 3.14159265358979;
+
+} // GetDegrees
+
+/////////////////////////////////////////////////////////////////////////////
+// the step loop of UpdateMoonPosition before CPropagator, which read the
+// stop conditions every time slice and measured the angle every step
+static bool LegacyPropagate
+(
+	CLegacyView& view, LUNAR_STATE& state, const LUNAR_PARAMETERS& params,
+	int nSteps
+)
+{
+	bool bDone = false;
+	for ( int nStep = 0; nStep < nSteps; nStep++ )
+	{
+		LUNAR_STATE next = state;
+		CEulerIntegrator::Step( next, params );
+
+		if
+		(
+			view.GetThirtyDegreeSteps() &&
+			state.dTime > params.dThirtyDegreeDelay
+		)
+		{
+			view.m_dMoonX = next.dX;
+			view.m_dMoonY = next.dY;
+			const double dMod = fmod( view.GetDegrees(), 30.0 );
+			if ( fabs( dMod ) < view.GetAngleError() )
+			{
+				bDone = true;
+			}
+		}
+
+		if ( view.GetSingleOrbit() && state.dTime > params.dSingleOrbitDelay )
+		{
+			if ( next.dX - state.dX > 0 )
+			{
+				return true;
+			}
+		}
+
+		state = next;
+	}
+
+	return bDone;
+
+} // LegacyPropagate
+
+/////////////////////////////////////////////////////////////////////////////
+// nanoseconds a time slice between two times
+static double GetNanoseconds
+(
+	CLOCK::time_point start,
+	CLOCK::time_point stop
+)
+{
+	const double dNanoseconds =
+		chrono::duration<double, nano>( stop - start ).count();
+	return dNanoseconds / ( double( BATCH_STEPS ) * BATCHES );
+
+} // GetNanoseconds
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	const double dGravity =
+		6.657e-11 * 5.983e24 / ( ORBIT_RADIUS * ORBIT_RADIUS );
+
+	LUNAR_PARAMETERS params = {};
+	params.dGravityRatio = dGravity / ORBIT_RADIUS;
+	params.dSampleTime = 1;
+	params.dMoonScaling = ORBIT_RADIUS / 4;
+	params.nMap = 1000;
+	params.dAngleError = 0.01;
+	params.dThirtyDegreeDelay = 3600;
+	params.dSingleOrbitDelay = 27 * 86400;
+
+	const LUNAR_STATE start = { -ORBIT_RADIUS, 0, 0, 1022, dGravity, 0, 0 };
+
+	printf( "stop conditions      before    after  (ns a time slice)\n" );
+	for ( int nMode = 0; nMode < 4; nMode++ )
+	{
+		const bool bThirty = ( nMode & 1 ) != 0;
+		const bool bSingle = ( nMode & 2 ) != 0;
+
+		CLegacyView view;
+		view.m_bThirtyDegreeSteps = bThirty;
+		view.m_bSingleOrbit = bSingle;
+		view.m_dAngleError = params.dAngleError;
+		view.m_dMoonX = 0;
+		view.m_dMoonY = 0;
+		view.m_dMoonScaling = params.dMoonScaling;
+		view.m_nMap = params.nMap;
+
+		LUNAR_STATE before = start;
+		LUNAR_STATE after = start;
+		int nBeforeStops = 0;
+		int nAfterStops = 0;
+		CNullRecorder recorder;
+
+		const CLOCK::time_point t0 = CLOCK::now();
+		for ( int nBatch = 0; nBatch < BATCHES; nBatch++ )
+		{
+			nBeforeStops +=
+				LegacyPropagate( view, before, params, BATCH_STEPS );
+		}
+		const CLOCK::time_point t1 = CLOCK::now();
+		for ( int nBatch = 0; nBatch < BATCHES; nBatch++ )
+		{
+			nAfterStops += CPropagator::Propagate<CEulerIntegrator>
+			(
+				after, params, BATCH_STEPS, bThirty, bSingle, recorder
+			);
+		}
+		const CLOCK::time_point t2 = CLOCK::now();
+
+		printf
+		(
+			"30 degree %d orbit %d  %8.2f %8.2f  stops %d / %d%s\n",
+			bThirty, bSingle, GetNanoseconds( t0, t1 ),
+			GetNanoseconds( t1, t2 ), nBeforeStops, nAfterStops,
+			before.dX == after.dX && before.dTime == after.dTime ?
+				"" : "  states differ"
+		);
+	}
+
+	const struct
+	{
+		INTEGRATOR eIntegrator;
+		const char* pName;
+	} integrators[] =
+	{
+		{ INTEGRATOR_EULER, "Euler" },
+		{ INTEGRATOR_RALSTON, "Ralston" },
+		{ INTEGRATOR_SSPRK3, "SSPRK3" },
+		{ INTEGRATOR_RK4, "RK4" },
+		{ INTEGRATOR_TSITOURAS5, "Tsitouras5" },
+	};
+
+	printf( "\nintegrator   ns a time slice\n" );
+	for ( const auto& integrator : integrators )
+	{
+		LUNAR_STATE state = start;
+		const CLOCK::time_point t0 = CLOCK::now();
+		for ( int nBatch = 0; nBatch < BATCHES; nBatch++ )
+		{
+			CPropagator::Propagate
+			(
+				integrator.eIntegrator, state, params, BATCH_STEPS, false, false
+			);
+		}
+		const CLOCK::time_point t1 = CLOCK::now();
+
+		// the distance is printed so the loop is not optimized away
+		const double dDistance =
+			sqrt( state.dX * state.dX + state.dY * state.dY );
+		printf
+		(
+			"%-12s %8.2f  distance %.6e m\n", integrator.pName,
+			GetNanoseconds( t0, t1 ), dDistance
+		);
+	}
+
+	return 0;
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
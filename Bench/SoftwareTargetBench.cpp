@@ -0,0 +1,72 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Prints the frames per second CSoftwareTarget draws a page of the lunar
+// orbit view at for windows of a few sizes and a page at 300 dots per
+// inch. Each frame clears the layer and replays the whole display list.
+#include "PageScene.h"
+#include "SoftwareTarget.h"
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+typedef chrono::steady_clock CLOCK;
+
+// points of the trail of the moon
+static const int TRAIL_POINTS = 4000;
+
+// seconds each size is timed for
+static const double SECONDS = 2.0;
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	CDisplayStyles styles;
+	CDisplayList list;
+	RecordPage( list, styles, TRAIL_POINTS );
+
+	const struct
+	{
+		int nWidth;
+		const char* pName;
+	} sizes[] =
+	{
+		{ 1280, "1280 pixel window" },
+		{ 1920, "1920 pixel window" },
+		{ 3300, "page at 300 dpi" },
+	};
+
+	CSoftwareTarget target( styles );
+	CPixelLayer layer;
+	const LAYER_PIXEL white =
+		CSoftwareTarget::GetLayerPixel( DisplayColor( 255, 255, 255 ) );
+	for ( const auto& size : sizes )
+	{
+		const int nHeight = size.nWidth * PAGE_HEIGHT / PAGE_WIDTH;
+		layer.Resize( size.nWidth, nHeight );
+		target.SetMapping( 0, 0, PAGE_WIDTH, size.nWidth );
+
+		int nFrames = 0;
+		double dSeconds = 0;
+		const CLOCK::time_point start = CLOCK::now();
+		while ( dSeconds < SECONDS )
+		{
+			layer.Fill( white );
+			target.Draw( layer, list );
+			nFrames++;
+			dSeconds = chrono::duration<double>( CLOCK::now() - start ).count();
+		}
+
+		printf
+		(
+			"%-18s %4d x %4d: %6.1f fps (%.2f ms a frame, %d commands)\n",
+			size.pName, size.nWidth, nHeight, nFrames / dSeconds,
+			1000 * dSeconds / nFrames, list.GetCommandCount()
+		);
+	}
+	return 0;
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
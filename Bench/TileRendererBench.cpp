@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Times an export of the 11 by 8.5 inch page of the lunar orbit view at
+// the Map of 1000 logical units per inch into a layer at print resolution,
+// drawn by CSoftwareTarget in one piece and by CTileRenderer with more and
+// more threads, and checks the tiled pages are the same as the serial one.
+// The resolution in dots per inch can be given on the command line.
+#include "PageScene.h"
+#include "TileRenderer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+
+typedef chrono::steady_clock CLOCK;
+
+// points of the trail of the moon
+static const int TRAIL_POINTS = 4000;
+
+// seconds each way of drawing is timed for
+static const double SECONDS = 2.0;
+
+/////////////////////////////////////////////////////////////////////////////
+// milliseconds a page takes to draw, drawing it for a few seconds
+template <class TDraw> static double TimePage( TDraw draw )
+{
+	int nPages = 0;
+	double dSeconds = 0;
+	const CLOCK::time_point start = CLOCK::now();
+	while ( dSeconds < SECONDS )
+	{
+		draw();
+		nPages++;
+		dSeconds = chrono::duration<double>( CLOCK::now() - start ).count();
+	}
+	return 1000 * dSeconds / nPages;
+
+} // TimePage
+
+/////////////////////////////////////////////////////////////////////////////
+int main( int argc, char* argv[] )
+{
+	const int nDotsPerInch = argc > 1 ? atoi( argv[ 1 ] ) : 300;
+	const int nWidth = nDotsPerInch * PAGE_WIDTH / 1000;
+	const int nHeight = nDotsPerInch * PAGE_HEIGHT / 1000;
+	const size_t nBytes = size_t( nWidth ) * nHeight * sizeof( LAYER_PIXEL );
+
+	CDisplayStyles styles;
+	CDisplayList list;
+	RecordPage( list, styles, TRAIL_POINTS );
+	const LAYER_PIXEL white =
+		CSoftwareTarget::GetLayerPixel( DisplayColor( 255, 255, 255 ) );
+
+	CPixelLayer serial;
+	serial.Resize( nWidth, nHeight );
+	CSoftwareTarget target( styles );
+	target.SetMapping( 0, 0, PAGE_WIDTH, nWidth );
+	const double dSerial = TimePage
+	(
+		[ & ]()
+		{
+			serial.Fill( white );
+			target.Draw( serial, list );
+		}
+	);
+	printf
+	(
+		"%d x %d pixels at %d dpi, %u hardware threads\n", nWidth, nHeight,
+		nDotsPerInch, thread::hardware_concurrency()
+	);
+	printf( "serial             %8.2f ms a page\n", dSerial );
+
+	const int threads[] = { 1, 2, 4, 8, 0 };
+	CPixelLayer tiled;
+	tiled.Resize( nWidth, nHeight );
+	for ( const int nThreads : threads )
+	{
+		CTileRenderer renderer( styles );
+		renderer.SetMapping( 0, 0, PAGE_WIDTH, nWidth );
+		renderer.SetThreads( nThreads );
+		tiled.Fill( 0 );
+		const double dTiled = TimePage
+		(
+			[ & ]()
+			{
+				renderer.Draw( tiled, list );
+			}
+		);
+		const bool bSame =
+			memcmp( serial.GetPixels(), tiled.GetPixels(), nBytes ) == 0;
+		printf
+		(
+			"tiled, %d threads %s %8.2f ms a page, %.2f times, %s\n",
+			nThreads, nThreads == 0 ? "(all)" : "     ", dTiled,
+			dSerial / dTiled, bSame ? "same pixels" : "DIFFERENT PIXELS"
+		);
+	}
+	return 0;
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
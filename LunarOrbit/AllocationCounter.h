@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+
+/////////////////////////////////////////////////////////////////////////////
+// Counts the heap allocations made through the debug CRT while an instance
+// is in scope, so code that must not allocate can be checked with an
+// ASSERT in debug builds. The counter installs a CRT allocation hook and
+// passes every call on to the hook it replaced. Counters are not nested.
+// The hook is process wide, but the count is kept for each thread, so a
+// counter only counts the allocations of the thread that constructed it
+// and the simulation or recorder threads allocating at the same time are
+// neither counted nor racing on the count.
+class CAllocationCounter
+{
+	// protected data
+protected:
+	// value of the count of this thread when the counter was constructed
+	long m_nStart;
+
+	// protected methods
+protected:
+	// number of allocations the calling thread has made since the first
+	// counter was constructed
+	static long& GetCount()
+	{
+		static thread_local long nCount = 0;
+		return nCount;
+	}
+
+	// the hook that was installed before the counter
+	static _CRT_ALLOC_HOOK& GetPreviousHook()
+	{
+		static _CRT_ALLOC_HOOK pHook = nullptr;
+		return pHook;
+	}
+
+	// count allocations and reallocations of the calling thread and call
+	// the previous hook
+	static int __cdecl AllocHook
+	(
+		int nAllocType, void* pvData, size_t nSize, int nBlockUse,
+		long lRequest, const unsigned char* szFileName, int nLine
+	)
+	{
+		if ( nAllocType == _HOOK_ALLOC || nAllocType == _HOOK_REALLOC )
+		{
+			GetCount()++;
+		}
+
+		const _CRT_ALLOC_HOOK pHook = GetPreviousHook();
+		if ( pHook == nullptr )
+		{
+			return TRUE;
+		}
+
+		return pHook
+		(
+			nAllocType, pvData, nSize, nBlockUse, lRequest, szFileName, nLine
+		);
+	}
+
+	// public properties
+public:
+	// number of allocations made by the thread that constructed this
+	// counter while it was in scope
+	long GetAllocations()
+	{
+		return GetCount() - m_nStart;
+	}
+	// number of allocations made while this counter was in scope
+	__declspec( property( get = GetAllocations ) )
+		long Allocations;
+
+	// public constructor / destructor
+public:
+	// install the counting hook
+	CAllocationCounter()
+	{
+		m_nStart = GetCount();
+		GetPreviousHook() = _CrtSetAllocHook( AllocHook );
+	}
+
+	// restore the previous hook
+	~CAllocationCounter()
+	{
+		_CrtSetAllocHook( GetPreviousHook() );
+	}
+};
+
+#endif // _DEBUG
+
+/////////////////////////////////////////////////////////////////////////////
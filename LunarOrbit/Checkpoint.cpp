@@ -0,0 +1,95 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "Checkpoint.h"
+#include <cstring>
+
+// the reflected polynomial of CRC-32
+static const unsigned CRC_POLYNOMIAL = 0xEDB88320;
+
+/////////////////////////////////////////////////////////////////////////////
+// the CRC-32 of each byte value, built the first time it is used
+static const unsigned* GetCRCTable()
+{
+	struct CRC_TABLE
+	{
+		unsigned nValues[ 256 ];
+
+		CRC_TABLE()
+		{
+			for ( unsigned nByte = 0; nByte < 256; nByte++ )
+			{
+				unsigned nCRC = nByte;
+				for ( int nBit = 0; nBit < 8; nBit++ )
+				{
+					const unsigned nMask = 0 - ( nCRC & 1 );
+					nCRC = ( nCRC >> 1 ) ^ ( CRC_POLYNOMIAL & nMask );
+				}
+				nValues[ nByte ] = nCRC;
+			}
+		}
+	};
+	static const CRC_TABLE table;
+	return table.nValues;
+
+} // GetCRCTable
+
+/////////////////////////////////////////////////////////////////////////////
+CCheckpoint::CCheckpoint()
+{
+	m_nPosition = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CRC-32 of the given bytes as used by zip and PNG
+unsigned CCheckpoint::GetCRC( const void* pData, size_t nSize )
+{
+	const unsigned* pTable = GetCRCTable();
+	const unsigned char* pBytes = (const unsigned char*)pData;
+	unsigned nCRC = 0xFFFFFFFF;
+	for ( size_t nByte = 0; nByte < nSize; nByte++ )
+	{
+		nCRC = pTable[ ( nCRC ^ pBytes[ nByte ] ) & 0xFF ] ^ ( nCRC >> 8 );
+	}
+	return ~nCRC;
+
+} // GetCRC
+
+/////////////////////////////////////////////////////////////////////////////
+// remove the bytes
+void CCheckpoint::Clear()
+{
+	m_Bytes.clear();
+	m_nPosition = 0;
+
+} // Clear
+
+/////////////////////////////////////////////////////////////////////////////
+// append the given bytes
+void CCheckpoint::Write( const void* pData, size_t nSize )
+{
+	const unsigned char* pBytes = (const unsigned char*)pData;
+	m_Bytes.insert( m_Bytes.end(), pBytes, pBytes + nSize );
+
+} // Write
+
+/////////////////////////////////////////////////////////////////////////////
+// copy the next bytes and return false if there are not enough, in which
+// case nothing is read
+bool CCheckpoint::Read( void* pData, size_t nSize )
+{
+	if ( nSize > m_Bytes.size() - m_nPosition )
+	{
+		return false;
+	}
+
+	if ( nSize > 0 )
+	{
+		memcpy( pData, &m_Bytes[ m_nPosition ], nSize );
+		m_nPosition += nSize;
+	}
+	return true;
+
+} // Read
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,104 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// The bytes of a checkpoint of the simulation. The state is written into
+// memory with Put and PutArray, which copy the bytes of plain values as
+// they are, so the whole checkpoint can be written to a file at once with
+// its checksum and read back at once before any of it is used. Reading
+// past the end of the bytes fails instead of reading garbage, so a short
+// file is found however the values are read. The byte order is that of
+// the machine, which is little endian on every target of the application.
+// The checkpoint does not depend on MFC.
+class CCheckpoint
+{
+	// protected data
+protected:
+	// the bytes written or to be read
+	vector<unsigned char> m_Bytes;
+
+	// offset of the next byte to be read
+	size_t m_nPosition;
+
+	// public methods
+public:
+	// the bytes written or to be read
+	unsigned char* GetData()
+	{
+		return m_Bytes.empty() ? nullptr : &m_Bytes[ 0 ];
+	}
+
+	// number of bytes written or to be read
+	size_t GetSize() const
+	{
+		return m_Bytes.size();
+	}
+	// number of bytes to be read where the bytes are filled in through
+	// GetData and reading starts again from the first one
+	void SetSize( size_t value )
+	{
+		m_Bytes.resize( value );
+		m_nPosition = 0;
+	}
+
+	// true once every byte has been read
+	bool IsEnd() const
+	{
+		return m_nPosition == m_Bytes.size();
+	}
+
+	// CRC-32 of the bytes as used by zip and PNG
+	unsigned GetCRC() const
+	{
+		return GetCRC( m_Bytes.data(), m_Bytes.size() );
+	}
+
+	// CRC-32 of the given bytes as used by zip and PNG
+	static unsigned GetCRC( const void* pData, size_t nSize );
+
+	// remove the bytes
+	void Clear();
+
+	// append the given bytes
+	void Write( const void* pData, size_t nSize );
+
+	// copy the next bytes and return false if there are not enough
+	bool Read( void* pData, size_t nSize );
+
+	// append a plain value
+	template <class T> void Put( const T& value )
+	{
+		Write( &value, sizeof( T ) );
+	}
+
+	// copy the next plain value and return false if there is not enough
+	template <class T> bool Get( T& value )
+	{
+		return Read( &value, sizeof( T ) );
+	}
+
+	// append an array of plain values
+	template <class T> void PutArray( const T* pValues, size_t nCount )
+	{
+		Write( pValues, nCount * sizeof( T ) );
+	}
+
+	// copy the next array of plain values and return false if there are
+	// not enough
+	template <class T> bool GetArray( T* pValues, size_t nCount )
+	{
+		return Read( pValues, nCount * sizeof( T ) );
+	}
+
+	// public construction
+public:
+	CCheckpoint();
+};
+
+/////////////////////////////////////////////////////////////////////////////
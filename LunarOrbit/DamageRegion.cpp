@@ -0,0 +1,197 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "DamageRegion.h"
+#include <algorithm>
+
+/////////////////////////////////////////////////////////////////////////////
+CDamageRegion::CDamageRegion( int nMaxRects )
+{
+	m_nMaxRects = max( nMaxRects, 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// most rectangles kept before they are merged
+void CDamageRegion::SetMaxRects( int value )
+{
+	m_nMaxRects = max( value, 1 );
+
+} // SetMaxRects
+
+/////////////////////////////////////////////////////////////////////////////
+// number of units in the rectangle
+long long CDamageRegion::GetArea( const DISPLAY_RECT& rect )
+{
+	return
+		(long long)( rect.right - rect.left ) * ( rect.bottom - rect.top );
+
+} // GetArea
+
+/////////////////////////////////////////////////////////////////////////////
+// the rectangle containing both rectangles
+DISPLAY_RECT CDamageRegion::GetUnion
+(
+	const DISPLAY_RECT& rect1, const DISPLAY_RECT& rect2
+)
+{
+	DISPLAY_RECT value;
+	value.left = min( rect1.left, rect2.left );
+	value.top = min( rect1.top, rect2.top );
+	value.right = max( rect1.right, rect2.right );
+	value.bottom = max( rect1.bottom, rect2.bottom );
+	return value;
+
+} // GetUnion
+
+/////////////////////////////////////////////////////////////////////////////
+// true if the rectangles share any area
+bool CDamageRegion::Overlaps
+(
+	const DISPLAY_RECT& rect1, const DISPLAY_RECT& rect2
+)
+{
+	return
+		rect1.left < rect2.right && rect2.left < rect1.right &&
+		rect1.top < rect2.bottom && rect2.top < rect1.bottom;
+
+} // Overlaps
+
+/////////////////////////////////////////////////////////////////////////////
+// add a rectangle to the region where empty rectangles are ignored
+void CDamageRegion::Add( const DISPLAY_RECT& rect )
+{
+	if ( rect.right <= rect.left || rect.bottom <= rect.top )
+	{
+		return;
+	}
+
+	m_Rects.push_back( rect );
+	Merge( GetCount() - 1 );
+
+	// merge the pair that wastes the least area until the list fits
+	while ( GetCount() > m_nMaxRects )
+	{
+		const int nRects = GetCount();
+		long long nBest = -1;
+		int nBest1 = 0;
+		int nBest2 = 1;
+		for ( int n1 = 0; n1 < nRects; n1++ )
+		{
+			for ( int n2 = n1 + 1; n2 < nRects; n2++ )
+			{
+				const long long nWaste =
+					GetArea( GetUnion( m_Rects[ n1 ], m_Rects[ n2 ] ) ) -
+					GetArea( m_Rects[ n1 ] ) - GetArea( m_Rects[ n2 ] );
+				if ( nBest < 0 || nWaste < nBest )
+				{
+					nBest = nWaste;
+					nBest1 = n1;
+					nBest2 = n2;
+				}
+			}
+		}
+
+		m_Rects[ nBest1 ] = GetUnion( m_Rects[ nBest1 ], m_Rects[ nBest2 ] );
+		m_Rects.erase( m_Rects.begin() + nBest2 );
+		Merge( nBest1 );
+	}
+
+} // Add
+
+/////////////////////////////////////////////////////////////////////////////
+// add the rectangles of another region
+void CDamageRegion::Add( const CDamageRegion& region )
+{
+	for ( const DISPLAY_RECT& rect : region.m_Rects )
+	{
+		Add( rect );
+	}
+
+} // Add
+
+/////////////////////////////////////////////////////////////////////////////
+// Merge rectangles until none overlap and no merge is free, starting with
+// the rectangle at the given index. A merged rectangle is larger and may
+// reach others, so it is tested again until nothing changes.
+void CDamageRegion::Merge( int nRect )
+{
+	bool bMerged = true;
+	while ( bMerged )
+	{
+		bMerged = false;
+		const int nRects = GetCount();
+		for ( int nOther = 0; nOther < nRects; nOther++ )
+		{
+			if ( nOther == nRect )
+			{
+				continue;
+			}
+
+			const DISPLAY_RECT& rect = m_Rects[ nRect ];
+			const DISPLAY_RECT& other = m_Rects[ nOther ];
+			const DISPLAY_RECT merged = GetUnion( rect, other );
+			if
+			(
+				Overlaps( rect, other ) ||
+				GetArea( merged ) <= GetArea( rect ) + GetArea( other )
+			)
+			{
+				m_Rects[ nRect ] = merged;
+				m_Rects.erase( m_Rects.begin() + nOther );
+				if ( nOther < nRect )
+				{
+					nRect--;
+				}
+				bMerged = true;
+				break;
+			}
+		}
+	}
+
+} // Merge
+
+/////////////////////////////////////////////////////////////////////////////
+// number of units (pixels) in the region
+long long CDamageRegion::GetArea() const
+{
+	long long value = 0;
+	for ( const DISPLAY_RECT& rect : m_Rects )
+	{
+		value += GetArea( rect );
+	}
+	return value;
+
+} // GetArea
+
+/////////////////////////////////////////////////////////////////////////////
+// the rectangle containing the whole region
+DISPLAY_RECT CDamageRegion::GetBounds() const
+{
+	DISPLAY_RECT value = { 0, 0, 0, 0 };
+	const int nRects = GetCount();
+	for ( int nRect = 0; nRect < nRects; nRect++ )
+	{
+		value =
+			nRect == 0 ? m_Rects[ 0 ] : GetUnion( value, m_Rects[ nRect ] );
+	}
+	return value;
+
+} // GetBounds
+
+/////////////////////////////////////////////////////////////////////////////
+// true if the rectangle is inside the bounding rectangle of the region
+bool CDamageRegion::IsInsideBounds( const DISPLAY_RECT& rect ) const
+{
+	if ( IsEmpty() )
+	{
+		return false;
+	}
+
+	const DISPLAY_RECT bounds = GetBounds();
+	return
+		rect.left >= bounds.left && rect.top >= bounds.top &&
+		rect.right <= bounds.right && rect.bottom <= bounds.bottom;
+
+} // IsInsideBounds
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "DisplayList.h"
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// The parts of a window that have to be drawn again, kept as a short list
+// of rectangles that do not overlap. A rectangle that overlaps one already
+// in the list is merged with it, as are two rectangles whose bounding
+// rectangle is no larger than the two of them, so the area of the region
+// is the sum of the areas of its rectangles. When the list grows past its
+// limit the two rectangles that waste the least area are merged, which
+// trades a little drawing for fewer calls to draw.
+//
+// The region does not depend on MFC and works in any units, typically the
+// pixels of the client area.
+class CDamageRegion
+{
+	// protected data
+protected:
+	// rectangles that do not overlap
+	vector<DISPLAY_RECT> m_Rects;
+
+	// most rectangles kept before they are merged
+	int m_nMaxRects;
+
+	// public methods
+public:
+	// number of rectangles
+	int GetCount() const
+	{
+		return (int)m_Rects.size();
+	}
+
+	// true if nothing has to be drawn
+	bool IsEmpty() const
+	{
+		return m_Rects.empty();
+	}
+
+	// the rectangle at the given index
+	const DISPLAY_RECT& GetRect( int nRect ) const
+	{
+		return m_Rects[ nRect ];
+	}
+
+	// most rectangles kept before they are merged
+	int GetMaxRects() const
+	{
+		return m_nMaxRects;
+	}
+	// most rectangles kept before they are merged
+	void SetMaxRects( int value );
+
+	// remove all of the rectangles
+	void Clear()
+	{
+		m_Rects.clear();
+	}
+
+	// add a rectangle to the region where empty rectangles are ignored
+	void Add( const DISPLAY_RECT& rect );
+
+	// add the rectangles of another region
+	void Add( const CDamageRegion& region );
+
+	// number of units (pixels) in the region
+	long long GetArea() const;
+
+	// the rectangle containing the whole region
+	DISPLAY_RECT GetBounds() const;
+
+	// true if the rectangle is inside the bounding rectangle of the region
+	bool IsInsideBounds( const DISPLAY_RECT& rect ) const;
+
+	// number of units in the rectangle
+	static long long GetArea( const DISPLAY_RECT& rect );
+
+	// the rectangle containing both rectangles
+	static DISPLAY_RECT GetUnion
+	(
+		const DISPLAY_RECT& rect1, const DISPLAY_RECT& rect2
+	);
+
+	// true if the rectangles share any area
+	static bool Overlaps
+	(
+		const DISPLAY_RECT& rect1, const DISPLAY_RECT& rect2
+	);
+
+	// protected methods
+protected:
+	// merge rectangles until none overlap and no merge is free,
+	// starting with the rectangle at the given index
+	void Merge( int nRect );
+
+	// public construction
+public:
+	CDamageRegion( int nMaxRects = 8 );
+};
+
+/////////////////////////////////////////////////////////////////////////////
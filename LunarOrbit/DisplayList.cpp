@@ -0,0 +1,517 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "DisplayList.h"
+#include <algorithm>
+#include <cmath>
+#include <cwchar>
+
+/////////////////////////////////////////////////////////////////////////////
+// handle of a pen
+int CDisplayStyles::AddPen
+(
+	DISPLAY_PEN_STYLE eStyle, int nWidth, DISPLAY_COLOR color
+)
+{
+	const int nPens = GetPenCount();
+	for ( int nPen = 0; nPen < nPens; nPen++ )
+	{
+		const DISPLAY_PEN& pen = m_Pens[ nPen ];
+		if ( pen.eStyle == eStyle && pen.nWidth == nWidth && pen.color == color )
+		{
+			return nPen;
+		}
+	}
+
+	DISPLAY_PEN pen;
+	pen.eStyle = eStyle;
+	pen.nWidth = nWidth;
+	pen.color = color;
+	m_Pens.push_back( pen );
+	return nPens;
+
+} // AddPen
+
+/////////////////////////////////////////////////////////////////////////////
+// handle of a solid brush
+int CDisplayStyles::AddBrush( DISPLAY_COLOR color )
+{
+	const int nBrushes = GetBrushCount();
+	for ( int nBrush = 0; nBrush < nBrushes; nBrush++ )
+	{
+		if ( m_Brushes[ nBrush ].color == color )
+		{
+			return nBrush;
+		}
+	}
+
+	DISPLAY_BRUSH brush;
+	brush.color = color;
+	m_Brushes.push_back( brush );
+	return nBrushes;
+
+} // AddBrush
+
+/////////////////////////////////////////////////////////////////////////////
+// handle of a font
+int CDisplayStyles::AddFont
+(
+	const wchar_t* pFace, int nHeight, bool bBold, bool bItalic
+)
+{
+	const int nFonts = GetFontCount();
+	for ( int nFont = 0; nFont < nFonts; nFont++ )
+	{
+		const DISPLAY_FONT& font = m_Fonts[ nFont ];
+		if
+		(
+			font.nHeight == nHeight && font.bBold == bBold &&
+			font.bItalic == bItalic && font.csFace == pFace
+		)
+		{
+			return nFont;
+		}
+	}
+
+	DISPLAY_FONT font;
+	font.csFace = pFace;
+	font.nHeight = nHeight;
+	font.bBold = bBold;
+	font.bItalic = bItalic;
+	m_Fonts.push_back( font );
+	return nFonts;
+
+} // AddFont
+
+/////////////////////////////////////////////////////////////////////////////
+// number of commands of the given type
+int CDisplayList::GetCommandCount( DISPLAY_COMMAND_TYPE eType ) const
+{
+	int value = 0;
+	for ( const DISPLAY_COMMAND& command : m_Commands )
+	{
+		if ( command.eType == eType )
+		{
+			value++;
+		}
+	}
+	return value;
+
+} // GetCommandCount
+
+/////////////////////////////////////////////////////////////////////////////
+// remove the commands while keeping the storage
+void CDisplayList::Clear()
+{
+	m_Commands.clear();
+	m_Points.clear();
+	m_Text.clear();
+
+} // Clear
+
+/////////////////////////////////////////////////////////////////////////////
+// add a command with its points and return it for the caller to fill in
+// the rest of the fields
+DISPLAY_COMMAND& CDisplayList::AddCommand
+(
+	DISPLAY_COMMAND_TYPE eType, const DISPLAY_POINT* pPoints, int nPoints
+)
+{
+	DISPLAY_COMMAND command = {};
+	command.eType = eType;
+	command.nPen = -1;
+	command.nBrush = -1;
+	command.nFont = -1;
+	command.nFirstPoint = (int)m_Points.size();
+	command.nPoints = nPoints;
+	command.nFirstCharacter = -1;
+	m_Points.insert( m_Points.end(), pPoints, pPoints + nPoints );
+	m_Commands.push_back( command );
+	return m_Commands.back();
+
+} // AddCommand
+
+/////////////////////////////////////////////////////////////////////////////
+// a line between two points
+void CDisplayList::Line( int nPen, long nX1, long nY1, long nX2, long nY2 )
+{
+	const DISPLAY_POINT points[ 2 ] = { { nX1, nY1 }, { nX2, nY2 } };
+	DISPLAY_COMMAND& command = AddCommand( DISPLAY_LINE, points, 2 );
+	command.nPen = nPen;
+
+} // Line
+
+/////////////////////////////////////////////////////////////////////////////
+// connected lines through the points
+void CDisplayList::Polyline
+(
+	int nPen, const DISPLAY_POINT* pPoints, int nPoints
+)
+{
+	DISPLAY_COMMAND& command = AddCommand( DISPLAY_POLYLINE, pPoints, nPoints );
+	command.nPen = nPen;
+
+} // Polyline
+
+/////////////////////////////////////////////////////////////////////////////
+// a closed shape through the points filled with the brush
+void CDisplayList::Polygon
+(
+	int nPen, int nBrush, const DISPLAY_POINT* pPoints, int nPoints
+)
+{
+	DISPLAY_COMMAND& command = AddCommand( DISPLAY_POLYGON, pPoints, nPoints );
+	command.nPen = nPen;
+	command.nBrush = nBrush;
+
+} // Polygon
+
+/////////////////////////////////////////////////////////////////////////////
+// an ellipse inside the rectangle filled with the brush
+void CDisplayList::Ellipse
+(
+	int nPen, int nBrush, long nLeft, long nTop, long nRight, long nBottom
+)
+{
+	const DISPLAY_POINT points[ 2 ] = { { nLeft, nTop }, { nRight, nBottom } };
+	DISPLAY_COMMAND& command = AddCommand( DISPLAY_ELLIPSE, points, 2 );
+	command.nPen = nPen;
+	command.nBrush = nBrush;
+
+} // Ellipse
+
+/////////////////////////////////////////////////////////////////////////////
+// an arc of a circle from the start angle through the sweep angle
+void CDisplayList::Arc
+(
+	int nPen, long nX, long nY, int nRadius,
+	float fStartAngle, float fSweepAngle
+)
+{
+	const DISPLAY_POINT point = { nX, nY };
+	DISPLAY_COMMAND& command = AddCommand( DISPLAY_ARC, &point, 1 );
+	command.nPen = nPen;
+	command.nRadius = nRadius;
+	command.fStartAngle = fStartAngle;
+	command.fSweepAngle = fSweepAngle;
+
+} // Arc
+
+/////////////////////////////////////////////////////////////////////////////
+// a line of text at the point
+void CDisplayList::Text
+(
+	int nFont, int nEscapement, int nAlign, DISPLAY_COLOR color,
+	long nX, long nY, const wchar_t* pText
+)
+{
+	const DISPLAY_POINT point = { nX, nY };
+	DISPLAY_COMMAND& command = AddCommand( DISPLAY_TEXT, &point, 1 );
+	command.nFont = nFont;
+	command.nEscapement = nEscapement;
+	command.nAlign = nAlign;
+	command.color = color;
+	command.nFirstCharacter = (int)m_Text.size();
+
+	// the terminator is kept so the text can be handed to a target as a
+	// string without copying it
+	m_Text.insert( m_Text.end(), pText, pText + wcslen( pText ) + 1 );
+
+} // Text
+
+/////////////////////////////////////////////////////////////////////////////
+// replay the commands in order onto the target
+void CDisplayList::Replay( CDisplayTarget& target ) const
+{
+	const int nCommands = GetCommandCount();
+	for ( int nCommand = 0; nCommand < nCommands; nCommand++ )
+	{
+		Replay( target, nCommand );
+	}
+
+} // Replay
+
+/////////////////////////////////////////////////////////////////////////////
+// replay one command onto the target
+void CDisplayList::Replay( CDisplayTarget& target, int nCommand ) const
+{
+	const DISPLAY_COMMAND& command = m_Commands[ nCommand ];
+	const DISPLAY_POINT* pPoints = m_Points.data() + command.nFirstPoint;
+	switch ( command.eType )
+	{
+		case DISPLAY_LINE:
+		{
+			target.Line( command.nPen, pPoints[ 0 ], pPoints[ 1 ] );
+			break;
+		}
+		case DISPLAY_POLYLINE:
+		{
+			target.Polyline( command.nPen, pPoints, command.nPoints );
+			break;
+		}
+		case DISPLAY_POLYGON:
+		{
+			target.Polygon
+			(
+				command.nPen, command.nBrush, pPoints, command.nPoints
+			);
+			break;
+		}
+		case DISPLAY_ELLIPSE:
+		{
+			target.Ellipse
+			(
+				command.nPen, command.nBrush, pPoints[ 0 ], pPoints[ 1 ]
+			);
+			break;
+		}
+		case DISPLAY_ARC:
+		{
+			target.Arc
+			(
+				command.nPen, pPoints[ 0 ], command.nRadius,
+				command.fStartAngle, command.fSweepAngle
+			);
+			break;
+		}
+		case DISPLAY_TEXT:
+		{
+			const wchar_t* pText = m_Text.data() + command.nFirstCharacter;
+			target.Text
+			(
+				command.nFont, command.nEscapement, command.nAlign,
+				command.color, pPoints[ 0 ], pText, (int)wcslen( pText )
+			);
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+} // Replay
+
+/////////////////////////////////////////////////////////////////////////////
+// A rectangle containing everything the command draws including the width
+// of its pen. The extent of text is estimated generously from the height
+// of the font and the number of characters and turned by the angle of the
+// text.
+DISPLAY_RECT CDisplayList::GetBounds
+(
+	int nCommand, const CDisplayStyles& styles
+) const
+{
+	const DISPLAY_COMMAND& command = m_Commands[ nCommand ];
+	const DISPLAY_POINT* pPoints = m_Points.data() + command.nFirstPoint;
+	DISPLAY_RECT value =
+	{
+		pPoints[ 0 ].x, pPoints[ 0 ].y, pPoints[ 0 ].x, pPoints[ 0 ].y
+	};
+
+	if ( command.eType == DISPLAY_TEXT )
+	{
+		const DISPLAY_FONT& font = styles.GetFont( command.nFont );
+		const double dHeight = font.nHeight;
+
+		// the average character is 2/5 of the height (see BuildFont) and
+		// the widest are about twice that
+		const int nLength =
+			(int)wcslen( m_Text.data() + command.nFirstCharacter );
+		const double dWidth = nLength * dHeight * 0.75;
+
+		// the extent of the text relative to the point before turning it,
+		// where y increases downward
+		double dLeft = 0;
+		switch ( command.nAlign & DISPLAY_ALIGN_HORIZONTAL )
+		{
+			case DISPLAY_ALIGN_CENTER:
+			{
+				dLeft = -dWidth / 2;
+				break;
+			}
+			case DISPLAY_ALIGN_RIGHT:
+			{
+				dLeft = -dWidth;
+				break;
+			}
+		}
+		double dTop = 0;
+		double dBottom = dHeight;
+		switch ( command.nAlign & DISPLAY_ALIGN_VERTICAL )
+		{
+			case DISPLAY_ALIGN_BASELINE:
+			{
+				dTop = -dHeight;
+				dBottom = dHeight / 2;
+				break;
+			}
+			case DISPLAY_ALIGN_BOTTOM:
+			{
+				dTop = -dHeight;
+				dBottom = 0;
+				break;
+			}
+		}
+		const double dRight = dLeft + dWidth;
+
+		// turn the corners counter clockwise by the escapement
+		const double dRadians =
+			command.nEscapement * 3.14159265358979323846 / 1800;
+		const double dCos = cos( dRadians );
+		const double dSin = sin( dRadians );
+		const double dCornersX[ 4 ] = { dLeft, dRight, dRight, dLeft };
+		const double dCornersY[ 4 ] = { dTop, dTop, dBottom, dBottom };
+		double dMinX = 0, dMaxX = 0, dMinY = 0, dMaxY = 0;
+		for ( int nCorner = 0; nCorner < 4; nCorner++ )
+		{
+			const double dX =
+				dCornersX[ nCorner ] * dCos + dCornersY[ nCorner ] * dSin;
+			const double dY =
+				dCornersY[ nCorner ] * dCos - dCornersX[ nCorner ] * dSin;
+			dMinX = nCorner == 0 ? dX : min( dMinX, dX );
+			dMaxX = nCorner == 0 ? dX : max( dMaxX, dX );
+			dMinY = nCorner == 0 ? dY : min( dMinY, dY );
+			dMaxY = nCorner == 0 ? dY : max( dMaxY, dY );
+		}
+
+		value.left += (long)floor( dMinX );
+		value.top += (long)floor( dMinY );
+		value.right += (long)ceil( dMaxX ) + 1;
+		value.bottom += (long)ceil( dMaxY ) + 1;
+		return value;
+	}
+
+	if ( command.eType == DISPLAY_ARC )
+	{
+		// the whole circle is a small price for not working out the arc
+		value.left -= command.nRadius;
+		value.top -= command.nRadius;
+		value.right += command.nRadius;
+		value.bottom += command.nRadius;
+	}
+	else
+	{
+		for ( int nPoint = 1; nPoint < command.nPoints; nPoint++ )
+		{
+			value.left = min( value.left, pPoints[ nPoint ].x );
+			value.top = min( value.top, pPoints[ nPoint ].y );
+			value.right = max( value.right, pPoints[ nPoint ].x );
+			value.bottom = max( value.bottom, pPoints[ nPoint ].y );
+		}
+	}
+
+	// half of the pen lies outside of the points and the right and
+	// bottom edges are outside of the rectangle
+	const long nPen =
+		command.nPen < 0 ? 0 : styles.GetPen( command.nPen ).nWidth / 2 + 1;
+	value.left -= nPen;
+	value.top -= nPen;
+	value.right += nPen + 1;
+	value.bottom += nPen + 1;
+	return value;
+
+} // GetBounds
+
+/////////////////////////////////////////////////////////////////////////////
+CDisplayCounter::CDisplayCounter()
+{
+	Reset();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// set the counts to zero
+void CDisplayCounter::Reset()
+{
+	for ( int n = 0; n < DISPLAY_COMMAND_TYPES; n++ )
+	{
+		m_nCounts[ n ] = 0;
+	}
+	m_nPoints = 0;
+
+} // Reset
+
+/////////////////////////////////////////////////////////////////////////////
+// number of commands of every type
+int CDisplayCounter::GetTotal() const
+{
+	int value = 0;
+	for ( int n = 0; n < DISPLAY_COMMAND_TYPES; n++ )
+	{
+		value += m_nCounts[ n ];
+	}
+	return value;
+
+} // GetTotal
+
+/////////////////////////////////////////////////////////////////////////////
+void CDisplayCounter::Line
+(
+	int /*nPen*/, const DISPLAY_POINT& /*pt1*/, const DISPLAY_POINT& /*pt2*/
+)
+{
+	m_nCounts[ DISPLAY_LINE ]++;
+	m_nPoints += 2;
+
+} // Line
+
+/////////////////////////////////////////////////////////////////////////////
+void CDisplayCounter::Polyline
+(
+	int /*nPen*/, const DISPLAY_POINT* /*pPoints*/, int nPoints
+)
+{
+	m_nCounts[ DISPLAY_POLYLINE ]++;
+	m_nPoints += nPoints;
+
+} // Polyline
+
+/////////////////////////////////////////////////////////////////////////////
+void CDisplayCounter::Polygon
+(
+	int /*nPen*/, int /*nBrush*/, const DISPLAY_POINT* /*pPoints*/, int nPoints
+)
+{
+	m_nCounts[ DISPLAY_POLYGON ]++;
+	m_nPoints += nPoints;
+
+} // Polygon
+
+/////////////////////////////////////////////////////////////////////////////
+void CDisplayCounter::Ellipse
+(
+	int /*nPen*/, int /*nBrush*/,
+	const DISPLAY_POINT& /*ptTopLeft*/, const DISPLAY_POINT& /*ptBottomRight*/
+)
+{
+	m_nCounts[ DISPLAY_ELLIPSE ]++;
+	m_nPoints += 2;
+
+} // Ellipse
+
+/////////////////////////////////////////////////////////////////////////////
+void CDisplayCounter::Arc
+(
+	int /*nPen*/, const DISPLAY_POINT& /*ptCenter*/, int /*nRadius*/,
+	float /*fStartAngle*/, float /*fSweepAngle*/
+)
+{
+	m_nCounts[ DISPLAY_ARC ]++;
+	m_nPoints += 1;
+
+} // Arc
+
+/////////////////////////////////////////////////////////////////////////////
+void CDisplayCounter::Text
+(
+	int /*nFont*/, int /*nEscapement*/, int /*nAlign*/,
+	DISPLAY_COLOR /*color*/, const DISPLAY_POINT& /*pt*/,
+	const wchar_t* /*pText*/, int /*nLength*/
+)
+{
+	m_nCounts[ DISPLAY_TEXT ]++;
+	m_nPoints += 1;
+
+} // Text
+
+/////////////////////////////////////////////////////////////////////////////
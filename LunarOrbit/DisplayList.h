@@ -0,0 +1,426 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// A retained list of drawing commands. The view records what it draws
+// into display lists instead of drawing on a device context, and a list
+// is replayed onto a target: CGdiDisplayTarget draws on a device context
+// and CDisplayCounter counts the commands without any window. Pens,
+// brushes and fonts are described once in a CDisplayStyles table and the
+// commands refer to them by handle, so a target can create its drawing
+// objects once and reuse them every time a list is replayed.
+//
+// Co-ordinates are logical units and text is wide characters, matching
+// the Unicode build of the application. This header does not depend on
+// MFC.
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// a color laid out as red, green and blue bytes like a COLORREF
+typedef unsigned long DISPLAY_COLOR;
+
+/////////////////////////////////////////////////////////////////////////////
+// build a color from its red, green and blue components
+inline DISPLAY_COLOR DisplayColor( int nRed, int nGreen, int nBlue )
+{
+	return
+		DISPLAY_COLOR( nRed & 0xff ) |
+		( DISPLAY_COLOR( nGreen & 0xff ) << 8 ) |
+		( DISPLAY_COLOR( nBlue & 0xff ) << 16 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// a point in logical co-ordinates laid out like a POINT
+struct DISPLAY_POINT
+{
+	long x;
+	long y;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a rectangle laid out like a RECT where the right and bottom edges are
+// outside of the rectangle
+struct DISPLAY_RECT
+{
+	long left;
+	long top;
+	long right;
+	long bottom;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// how lines are drawn
+enum DISPLAY_PEN_STYLE
+{
+	DISPLAY_PEN_SOLID, // a solid line
+	DISPLAY_PEN_DOT // a dotted line
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a pen used to draw lines and outlines
+struct DISPLAY_PEN
+{
+	DISPLAY_PEN_STYLE eStyle; // solid or dotted
+	int nWidth; // width in logical units
+	DISPLAY_COLOR color; // color of the line
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a solid brush used to fill shapes
+struct DISPLAY_BRUSH
+{
+	DISPLAY_COLOR color; // color of the interior
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a font used to draw text, where the rotation of the text is given by
+// each text command
+struct DISPLAY_FONT
+{
+	wstring csFace; // name of the font face
+	int nHeight; // height in logical units
+	bool bBold; // bold font if true
+	bool bItalic; // italic font if true
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// text alignment flags combining one horizontal and one vertical value
+enum DISPLAY_ALIGN
+{
+	DISPLAY_ALIGN_LEFT = 0x0,
+	DISPLAY_ALIGN_CENTER = 0x1,
+	DISPLAY_ALIGN_RIGHT = 0x2,
+	DISPLAY_ALIGN_TOP = 0x0,
+	DISPLAY_ALIGN_BASELINE = 0x4,
+	DISPLAY_ALIGN_BOTTOM = 0x8,
+	DISPLAY_ALIGN_HORIZONTAL = 0x3, // mask of the horizontal values
+	DISPLAY_ALIGN_VERTICAL = 0xc, // mask of the vertical values
+	DISPLAY_ALIGN_OPAQUE = 0x10 // the text erases its background
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the kinds of drawing commands
+enum DISPLAY_COMMAND_TYPE
+{
+	DISPLAY_LINE, // a line between two points
+	DISPLAY_POLYLINE, // connected lines through the points
+	DISPLAY_POLYGON, // a closed and filled shape through the points
+	DISPLAY_ELLIPSE, // a filled ellipse inside a bounding rectangle
+	DISPLAY_ARC, // an arc of a circle around a center point
+	DISPLAY_TEXT, // a line of text at a point
+	DISPLAY_COMMAND_TYPES // number of kinds of commands
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// one recorded drawing command where the points and text are kept in the
+// arrays of the list so commands are a fixed size
+struct DISPLAY_COMMAND
+{
+	DISPLAY_COMMAND_TYPE eType; // kind of command
+	int nPen; // pen handle for lines and outlines
+	int nBrush; // brush handle for filled shapes
+	int nFont; // font handle for text
+	int nAlign; // DISPLAY_ALIGN flags for text
+	int nEscapement; // text angle in tenths of a degree (counter clockwise)
+	DISPLAY_COLOR color; // color of text
+	int nFirstPoint; // index of the first point
+	int nPoints; // number of points
+	int nFirstCharacter; // index of the first character of the text
+	int nRadius; // radius of an arc
+	float fStartAngle; // start angle of an arc in degrees
+	float fSweepAngle; // sweep of an arc in degrees
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// pens, brushes and fonts shared by display lists, where adding a style
+// equal to one already in the table returns the existing handle, so
+// recording the same style every frame does not grow the table
+class CDisplayStyles
+{
+	// protected data
+protected:
+	vector<DISPLAY_PEN> m_Pens; // pens by handle
+	vector<DISPLAY_BRUSH> m_Brushes; // brushes by handle
+	vector<DISPLAY_FONT> m_Fonts; // fonts by handle
+
+	// public methods
+public:
+	// number of pens
+	int GetPenCount() const
+	{
+		return (int)m_Pens.size();
+	}
+
+	// number of brushes
+	int GetBrushCount() const
+	{
+		return (int)m_Brushes.size();
+	}
+
+	// number of fonts
+	int GetFontCount() const
+	{
+		return (int)m_Fonts.size();
+	}
+
+	// the pen with the given handle
+	const DISPLAY_PEN& GetPen( int nPen ) const
+	{
+		return m_Pens[ nPen ];
+	}
+
+	// the brush with the given handle
+	const DISPLAY_BRUSH& GetBrush( int nBrush ) const
+	{
+		return m_Brushes[ nBrush ];
+	}
+
+	// the font with the given handle
+	const DISPLAY_FONT& GetFont( int nFont ) const
+	{
+		return m_Fonts[ nFont ];
+	}
+
+	// handle of a pen
+	int AddPen( DISPLAY_PEN_STYLE eStyle, int nWidth, DISPLAY_COLOR color );
+
+	// handle of a solid brush
+	int AddBrush( DISPLAY_COLOR color );
+
+	// handle of a font
+	int AddFont
+	(
+		const wchar_t* pFace, int nHeight, bool bBold = false,
+		bool bItalic = false
+	);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a destination for the commands of a display list
+class CDisplayTarget
+{
+	// public methods
+public:
+	// a line between two points
+	virtual void Line
+	(
+		int nPen, const DISPLAY_POINT& pt1, const DISPLAY_POINT& pt2
+	) = 0;
+
+	// connected lines through the points
+	virtual void Polyline
+	(
+		int nPen, const DISPLAY_POINT* pPoints, int nPoints
+	) = 0;
+
+	// a closed shape through the points filled with the brush
+	virtual void Polygon
+	(
+		int nPen, int nBrush, const DISPLAY_POINT* pPoints, int nPoints
+	) = 0;
+
+	// an ellipse inside the rectangle filled with the brush
+	virtual void Ellipse
+	(
+		int nPen, int nBrush,
+		const DISPLAY_POINT& ptTopLeft, const DISPLAY_POINT& ptBottomRight
+	) = 0;
+
+	// an arc of a circle from the start angle through the sweep angle
+	// where the angles are in degrees counter clockwise from the X axis
+	virtual void Arc
+	(
+		int nPen, const DISPLAY_POINT& ptCenter, int nRadius,
+		float fStartAngle, float fSweepAngle
+	) = 0;
+
+	// a line of text at the point
+	virtual void Text
+	(
+		int nFont, int nEscapement, int nAlign, DISPLAY_COLOR color,
+		const DISPLAY_POINT& pt, const wchar_t* pText, int nLength
+	) = 0;
+
+	// public construction
+public:
+	virtual ~CDisplayTarget()
+	{
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// A list of drawing commands. Clearing the list keeps the storage of its
+// arrays, so a list that is recorded again every frame stops allocating
+// once it has grown to the size of a frame.
+class CDisplayList
+{
+	// protected data
+protected:
+	vector<DISPLAY_COMMAND> m_Commands; // the commands in drawing order
+	vector<DISPLAY_POINT> m_Points; // points of all of the commands
+	vector<wchar_t> m_Text; // null terminated text of all of the commands
+
+	// public methods
+public:
+	// number of commands
+	int GetCommandCount() const
+	{
+		return (int)m_Commands.size();
+	}
+
+	// true if there are no commands
+	bool IsEmpty() const
+	{
+		return m_Commands.empty();
+	}
+
+	// the command at the given index
+	const DISPLAY_COMMAND& GetCommand( int nCommand ) const
+	{
+		return m_Commands[ nCommand ];
+	}
+
+	// the points of the command at the given index
+	const DISPLAY_POINT* GetPoints( int nCommand ) const
+	{
+		return m_Points.data() + m_Commands[ nCommand ].nFirstPoint;
+	}
+
+	// number of commands of the given type
+	int GetCommandCount( DISPLAY_COMMAND_TYPE eType ) const;
+
+	// remove the commands while keeping the storage
+	void Clear();
+
+	// a line between two points
+	void Line( int nPen, long nX1, long nY1, long nX2, long nY2 );
+
+	// connected lines through the points
+	void Polyline( int nPen, const DISPLAY_POINT* pPoints, int nPoints );
+
+	// a closed shape through the points filled with the brush
+	void Polygon
+	(
+		int nPen, int nBrush, const DISPLAY_POINT* pPoints, int nPoints
+	);
+
+	// an ellipse inside the rectangle filled with the brush
+	void Ellipse
+	(
+		int nPen, int nBrush, long nLeft, long nTop, long nRight, long nBottom
+	);
+
+	// an arc of a circle from the start angle through the sweep angle
+	void Arc
+	(
+		int nPen, long nX, long nY, int nRadius,
+		float fStartAngle, float fSweepAngle
+	);
+
+	// a line of text at the point
+	void Text
+	(
+		int nFont, int nEscapement, int nAlign, DISPLAY_COLOR color,
+		long nX, long nY, const wchar_t* pText
+	);
+
+	// replay the commands in order onto the target
+	void Replay( CDisplayTarget& target ) const;
+
+	// replay one command onto the target
+	void Replay( CDisplayTarget& target, int nCommand ) const;
+
+	// A rectangle containing everything the command draws including the
+	// width of its pen. The extent of text is not known without a device
+	// context, so it is estimated generously from the height of the font
+	// and the number of characters and turned by the angle of the text.
+	DISPLAY_RECT GetBounds
+	(
+		int nCommand, const CDisplayStyles& styles
+	) const;
+
+	// protected methods
+protected:
+	// add a command with its points and return it for the caller to
+	// fill in the rest of the fields
+	DISPLAY_COMMAND& AddCommand
+	(
+		DISPLAY_COMMAND_TYPE eType, const DISPLAY_POINT* pPoints, int nPoints
+	);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// A target that draws nothing and counts the commands replayed onto it,
+// so what a frame draws can be checked without a window.
+class CDisplayCounter : public CDisplayTarget
+{
+	// protected data
+protected:
+	// number of commands of each type
+	int m_nCounts[ DISPLAY_COMMAND_TYPES ];
+
+	// number of points in all of the commands
+	int m_nPoints;
+
+	// public methods
+public:
+	// number of commands of the given type
+	int GetCount( DISPLAY_COMMAND_TYPE eType ) const
+	{
+		return m_nCounts[ eType ];
+	}
+
+	// number of commands of every type
+	int GetTotal() const;
+
+	// number of points in all of the commands
+	int GetPoints() const
+	{
+		return m_nPoints;
+	}
+
+	// set the counts to zero
+	void Reset();
+
+	// public overrides
+public:
+	void Line
+	(
+		int nPen, const DISPLAY_POINT& pt1, const DISPLAY_POINT& pt2
+	) override;
+	void Polyline
+	(
+		int nPen, const DISPLAY_POINT* pPoints, int nPoints
+	) override;
+	void Polygon
+	(
+		int nPen, int nBrush, const DISPLAY_POINT* pPoints, int nPoints
+	) override;
+	void Ellipse
+	(
+		int nPen, int nBrush,
+		const DISPLAY_POINT& ptTopLeft, const DISPLAY_POINT& ptBottomRight
+	) override;
+	void Arc
+	(
+		int nPen, const DISPLAY_POINT& ptCenter, int nRadius,
+		float fStartAngle, float fSweepAngle
+	) override;
+	void Text
+	(
+		int nFont, int nEscapement, int nAlign, DISPLAY_COLOR color,
+		const DISPLAY_POINT& pt, const wchar_t* pText, int nLength
+	) override;
+
+	// public construction
+public:
+	CDisplayCounter();
+};
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,452 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cmath>
+#include "RungeKutta.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// Number types for forward mode automatic differentiation. Code that is
+// templated on its scalar type computes exact derivatives alongside its
+// values when it is instantiated with these types instead of double.
+//
+// CDual carries the first derivatives with respect to N independent
+// variables where the derivatives are stored as a contiguous array of lanes
+// and each operation is unrolled across the lanes at compile time, so the
+// lanes are straight-line arithmetic the compiler can vectorize.
+//
+// CHyperDual carries the first derivatives with respect to two variables
+// and the mixed second derivative, so seeding both with the same variable
+// gives the exact second derivative.
+//
+// This header does not depend on MFC.
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// calls an operation for each of N lanes, unrolled so the result does not
+// depend on the optimizer's loop peeling heuristics
+template <int N> class CDualLanes
+{
+public:
+	template <class TOperation>
+	static RUNGE_KUTTA_INLINE void Apply( const TOperation& operation )
+	{
+		CDualLanes<N - 1>::Apply( operation );
+		operation( N - 1 );
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end of the recursion over the lanes
+template <> class CDualLanes<0>
+{
+public:
+	template <class TOperation>
+	static RUNGE_KUTTA_INLINE void Apply( const TOperation& )
+	{
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a value and its derivatives with respect to N variables
+template <int N> class CDual
+{
+	// public data
+public:
+	// the value
+	double m_dValue;
+
+	// the derivative with respect to each variable
+	double m_dDerivative[ N ];
+
+	// public methods
+public:
+	// a variable whose derivative with respect to itself is one
+	static inline CDual Variable( double dValue, int nLane )
+	{
+		CDual value( dValue );
+		value.m_dDerivative[ nLane ] = 1;
+		return value;
+	}
+
+	// the value
+	inline double GetValue() const
+	{
+		return m_dValue;
+	}
+
+	// the derivative with respect to the variable of the given lane
+	inline double GetDerivative( int nLane ) const
+	{
+		return m_dDerivative[ nLane ];
+	}
+
+	// add a value and its derivatives
+	RUNGE_KUTTA_INLINE CDual& operator+=( const CDual& rhs )
+	{
+		m_dValue += rhs.m_dValue;
+		CDualLanes<N>::Apply( [ & ]( int n )
+		{
+			m_dDerivative[ n ] += rhs.m_dDerivative[ n ];
+		} );
+		return *this;
+	}
+
+	// subtract a value and its derivatives
+	RUNGE_KUTTA_INLINE CDual& operator-=( const CDual& rhs )
+	{
+		m_dValue -= rhs.m_dValue;
+		CDualLanes<N>::Apply( [ & ]( int n )
+		{
+			m_dDerivative[ n ] -= rhs.m_dDerivative[ n ];
+		} );
+		return *this;
+	}
+
+	// multiply by a value using the product rule
+	RUNGE_KUTTA_INLINE CDual& operator*=( const CDual& rhs )
+	{
+		CDualLanes<N>::Apply( [ & ]( int n )
+		{
+			m_dDerivative[ n ] =
+				m_dDerivative[ n ] * rhs.m_dValue +
+				m_dValue * rhs.m_dDerivative[ n ];
+		} );
+		m_dValue *= rhs.m_dValue;
+		return *this;
+	}
+
+	// multiply by a constant
+	RUNGE_KUTTA_INLINE CDual& operator*=( double rhs )
+	{
+		m_dValue *= rhs;
+		CDualLanes<N>::Apply( [ & ]( int n )
+		{
+			m_dDerivative[ n ] *= rhs;
+		} );
+		return *this;
+	}
+
+	// divide by a value using the quotient rule
+	RUNGE_KUTTA_INLINE CDual& operator/=( const CDual& rhs )
+	{
+		const double dInverse = 1 / rhs.m_dValue;
+		m_dValue *= dInverse;
+		CDualLanes<N>::Apply( [ & ]( int n )
+		{
+			m_dDerivative[ n ] =
+				( m_dDerivative[ n ] - m_dValue * rhs.m_dDerivative[ n ] ) *
+				dInverse;
+		} );
+		return *this;
+	}
+
+	// public constructors
+public:
+	// uninitialized so arrays of duals cost nothing to declare
+	CDual()
+	{
+	}
+
+	// a constant whose derivatives are zero
+	CDual( double dValue )
+	{
+		m_dValue = dValue;
+		CDualLanes<N>::Apply( [ & ]( int n )
+		{
+			m_dDerivative[ n ] = 0;
+		} );
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+template <int N> RUNGE_KUTTA_INLINE CDual<N> operator-
+(
+	const CDual<N>& rhs
+)
+{
+	CDual<N> value = rhs;
+	value *= -1.0;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template <int N> RUNGE_KUTTA_INLINE CDual<N> operator+
+(
+	const CDual<N>& lhs, const CDual<N>& rhs
+)
+{
+	CDual<N> value = lhs;
+	value += rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template <int N> RUNGE_KUTTA_INLINE CDual<N> operator-
+(
+	const CDual<N>& lhs, const CDual<N>& rhs
+)
+{
+	CDual<N> value = lhs;
+	value -= rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template <int N> RUNGE_KUTTA_INLINE CDual<N> operator*
+(
+	const CDual<N>& lhs, const CDual<N>& rhs
+)
+{
+	CDual<N> value = lhs;
+	value *= rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template <int N> RUNGE_KUTTA_INLINE CDual<N> operator*
+(
+	double lhs, const CDual<N>& rhs
+)
+{
+	CDual<N> value = rhs;
+	value *= lhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template <int N> RUNGE_KUTTA_INLINE CDual<N> operator*
+(
+	const CDual<N>& lhs, double rhs
+)
+{
+	CDual<N> value = lhs;
+	value *= rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template <int N> RUNGE_KUTTA_INLINE CDual<N> operator/
+(
+	const CDual<N>& lhs, const CDual<N>& rhs
+)
+{
+	CDual<N> value = lhs;
+	value /= rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template <int N> inline CDual<N> sqrt( const CDual<N>& rhs )
+{
+	const double dRoot = std::sqrt( rhs.m_dValue );
+	const double dSlope = dRoot == 0 ? 0 : 0.5 / dRoot;
+
+	CDual<N> value;
+	value.m_dValue = dRoot;
+	CDualLanes<N>::Apply( [ & ]( int n )
+	{
+		value.m_dDerivative[ n ] = rhs.m_dDerivative[ n ] * dSlope;
+	} );
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// a value with first derivatives along two directions and the mixed
+// second derivative: a + b e1 + c e2 + d e1e2 where e1^2 = e2^2 = 0
+class CHyperDual
+{
+	// public data
+public:
+	double m_dValue; // the value
+	double m_dE1; // the derivative along the first direction
+	double m_dE2; // the derivative along the second direction
+	double m_dE1E2; // the mixed second derivative
+
+	// public methods
+public:
+	// a variable seeded along both directions so the mixed second
+	// derivative is the second derivative with respect to the variable
+	static inline CHyperDual Variable( double dValue )
+	{
+		return CHyperDual( dValue, 1, 1, 0 );
+	}
+
+	// the value
+	inline double GetValue() const
+	{
+		return m_dValue;
+	}
+
+	// the first derivative along the first direction
+	inline double GetFirstDerivative() const
+	{
+		return m_dE1;
+	}
+
+	// the mixed second derivative
+	inline double GetSecondDerivative() const
+	{
+		return m_dE1E2;
+	}
+
+	// add a value and its derivatives
+	inline CHyperDual& operator+=( const CHyperDual& rhs )
+	{
+		m_dValue += rhs.m_dValue;
+		m_dE1 += rhs.m_dE1;
+		m_dE2 += rhs.m_dE2;
+		m_dE1E2 += rhs.m_dE1E2;
+		return *this;
+	}
+
+	// subtract a value and its derivatives
+	inline CHyperDual& operator-=( const CHyperDual& rhs )
+	{
+		m_dValue -= rhs.m_dValue;
+		m_dE1 -= rhs.m_dE1;
+		m_dE2 -= rhs.m_dE2;
+		m_dE1E2 -= rhs.m_dE1E2;
+		return *this;
+	}
+
+	// multiply by a value where the e1e2 term collects both cross terms
+	inline CHyperDual& operator*=( const CHyperDual& rhs )
+	{
+		const double dE1E2 =
+			m_dValue * rhs.m_dE1E2 + m_dE1 * rhs.m_dE2 +
+			m_dE2 * rhs.m_dE1 + m_dE1E2 * rhs.m_dValue;
+		const double dE1 = m_dValue * rhs.m_dE1 + m_dE1 * rhs.m_dValue;
+		const double dE2 = m_dValue * rhs.m_dE2 + m_dE2 * rhs.m_dValue;
+
+		m_dValue *= rhs.m_dValue;
+		m_dE1 = dE1;
+		m_dE2 = dE2;
+		m_dE1E2 = dE1E2;
+		return *this;
+	}
+
+	// multiply by a constant
+	inline CHyperDual& operator*=( double rhs )
+	{
+		m_dValue *= rhs;
+		m_dE1 *= rhs;
+		m_dE2 *= rhs;
+		m_dE1E2 *= rhs;
+		return *this;
+	}
+
+	// divide by a value by multiplying with its reciprocal where
+	// f( x ) = 1 / x, f' = -1 / x^2 and f'' = 2 / x^3
+	inline CHyperDual& operator/=( const CHyperDual& rhs )
+	{
+		const double dInverse = 1 / rhs.m_dValue;
+		const double dSlope = -dInverse * dInverse;
+		const double dCurve = -2 * dSlope * dInverse;
+
+		const CHyperDual reciprocal
+		(
+			dInverse, dSlope * rhs.m_dE1, dSlope * rhs.m_dE2,
+			dSlope * rhs.m_dE1E2 + dCurve * rhs.m_dE1 * rhs.m_dE2
+		);
+		return *this *= reciprocal;
+	}
+
+	// public constructors
+public:
+	// uninitialized so arrays of hyper-duals cost nothing to declare
+	CHyperDual()
+	{
+	}
+
+	// a constant whose derivatives are zero
+	CHyperDual( double dValue )
+	{
+		m_dValue = dValue;
+		m_dE1 = 0;
+		m_dE2 = 0;
+		m_dE1E2 = 0;
+	}
+
+	// all four parts
+	CHyperDual( double dValue, double dE1, double dE2, double dE1E2 )
+	{
+		m_dValue = dValue;
+		m_dE1 = dE1;
+		m_dE2 = dE2;
+		m_dE1E2 = dE1E2;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+inline CHyperDual operator-( const CHyperDual& rhs )
+{
+	CHyperDual value = rhs;
+	value *= -1.0;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+inline CHyperDual operator+( const CHyperDual& lhs, const CHyperDual& rhs )
+{
+	CHyperDual value = lhs;
+	value += rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+inline CHyperDual operator-( const CHyperDual& lhs, const CHyperDual& rhs )
+{
+	CHyperDual value = lhs;
+	value -= rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+inline CHyperDual operator*( const CHyperDual& lhs, const CHyperDual& rhs )
+{
+	CHyperDual value = lhs;
+	value *= rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+inline CHyperDual operator*( double lhs, const CHyperDual& rhs )
+{
+	CHyperDual value = rhs;
+	value *= lhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+inline CHyperDual operator*( const CHyperDual& lhs, double rhs )
+{
+	CHyperDual value = lhs;
+	value *= rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+inline CHyperDual operator/( const CHyperDual& lhs, const CHyperDual& rhs )
+{
+	CHyperDual value = lhs;
+	value /= rhs;
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// f( x ) = sqrt( x ), f' = 1 / ( 2 sqrt( x ) ), f'' = -f' / ( 2 x )
+inline CHyperDual sqrt( const CHyperDual& rhs )
+{
+	const double dRoot = std::sqrt( rhs.m_dValue );
+	const double dSlope = dRoot == 0 ? 0 : 0.5 / dRoot;
+	const double dCurve = rhs.m_dValue == 0 ? 0 : -0.5 * dSlope / rhs.m_dValue;
+
+	return CHyperDual
+	(
+		dRoot, dSlope * rhs.m_dE1, dSlope * rhs.m_dE2,
+		dSlope * rhs.m_dE1E2 + dCurve * rhs.m_dE1 * rhs.m_dE2
+	);
+}
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,533 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cmath>
+
+/////////////////////////////////////////////////////////////////////////////
+// Polynomial sine, cosine and arc tangent at a choice of accuracy. An
+// accuracy is a class that evaluates the polynomials on the reduced
+// ranges, the same way the Runge-Kutta tableaus are classes:
+//	CTrigScreen - about 4e-7 radians, far below a logical pixel
+//	CTrigPhysics - within a few units in the last place of the library
+//
+// CFastTrig<TAccuracy> reduces the argument and applies the polynomials
+// to one value or to arrays, where pairs of values are evaluated together
+// with SSE2 when the compiler targets it. The sine and cosine share the
+// reduction, and the degree versions reduce by multiples of 90 degrees
+// before the only conversion to radians, so angles kept in degrees are
+// never converted back and forth. The arguments of the sine and cosine
+// are expected to be within a million radians.
+//
+// This header does not depend on MFC.
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// SSE2 is part of every x64 target and is optional for 32 bit targets
+#if defined( _M_X64 ) || defined( __SSE2__ ) || \
+	( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define FAST_TRIG_SSE2
+#include <emmintrin.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// constants shared by the accuracies
+class CTrigConstants
+{
+	// public methods
+public:
+	// PI
+	static constexpr double PI()
+	{
+		return 3.1415926535897932384626433832795;
+	}
+
+	// two divided by PI
+	static constexpr double TwoOverPI()
+	{
+		return 0.63661977236758134307553505349006;
+	}
+
+	// PI / 2 split into three parts so the multiples of the first two
+	// parts are exact and the reduced argument keeps its precision
+	static constexpr double HalfPI1()
+	{
+		return 1.57079632673412561417e+00;
+	}
+	static constexpr double HalfPI2()
+	{
+		return 6.07710050630396597660e-11;
+	}
+	static constexpr double HalfPI3()
+	{
+		return 2.02226624871116645580e-21;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// accuracy for drawing where the error is about 4e-7 radians (Taylor
+// series of low degree)
+class CTrigScreen
+{
+	// public methods
+public:
+	// largest absolute error of the sine, cosine and arc tangent
+	static constexpr double MaximumError()
+	{
+		return 4e-7;
+	}
+
+	// sine of a reduced angle from -PI/4 to PI/4 given its square
+	template <class T> static T Sine( const T& r, const T& r2 )
+	{
+		return r + r * r2 *
+		(
+			T( -1.0 / 6 ) + r2 * ( T( 1.0 / 120 ) + r2 * T( -1.0 / 5040 ) )
+		);
+	}
+
+	// cosine of a reduced angle from -PI/4 to PI/4 given its square
+	template <class T> static T Cosine( const T& r2 )
+	{
+		return T( 1.0 ) + r2 *
+		(
+			T( -0.5 ) + r2 *
+			(
+				T( 1.0 / 24 ) + r2 * ( T( -1.0 / 720 ) + r2 * T( 1.0 / 40320 ) )
+			)
+		);
+	}
+
+	// ratios above this are reduced by PI/4 before the arc tangent
+	static constexpr double ArcTangentLimit()
+	{
+		return 0.41421356237309503; // tangent of PI/8
+	}
+
+	// arc tangent of a ratio within the limit given its square
+	template <class T> static T ArcTangent( const T& t, const T& t2 )
+	{
+		return t + t * t2 *
+		(
+			T( -1.0 / 3 ) + t2 *
+			(
+				T( 1.0 / 5 ) + t2 *
+				(
+					T( -1.0 / 7 ) + t2 *
+					(
+						T( 1.0 / 9 ) + t2 *
+						(
+							T( -1.0 / 11 ) + t2 * T( 1.0 / 13 )
+						)
+					)
+				)
+			)
+		);
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// accuracy for the physics where the error is within a few units in the
+// last place (the minimax kernels of fdlibm and the rational arc tangent
+// of Cephes)
+class CTrigPhysics
+{
+	// public methods
+public:
+	// largest absolute error of the sine, cosine and arc tangent
+	static constexpr double MaximumError()
+	{
+		return 1e-15;
+	}
+
+	// sine of a reduced angle from -PI/4 to PI/4 given its square
+	template <class T> static T Sine( const T& r, const T& r2 )
+	{
+		return r + r * r2 *
+		(
+			T( -1.66666666666666324348e-01 ) + r2 *
+			(
+				T( 8.33333333332248946124e-03 ) + r2 *
+				(
+					T( -1.98412698298579493134e-04 ) + r2 *
+					(
+						T( 2.75573137070700676789e-06 ) + r2 *
+						(
+							T( -2.50507602534068634195e-08 ) + r2 *
+							T( 1.58969099521155010221e-10 )
+						)
+					)
+				)
+			)
+		);
+	}
+
+	// cosine of a reduced angle from -PI/4 to PI/4 given its square
+	template <class T> static T Cosine( const T& r2 )
+	{
+		return T( 1.0 ) - T( 0.5 ) * r2 + r2 * r2 *
+		(
+			T( 4.16666666666666019037e-02 ) + r2 *
+			(
+				T( -1.38888888888741095749e-03 ) + r2 *
+				(
+					T( 2.48015872894767294178e-05 ) + r2 *
+					(
+						T( -2.75573143513906633035e-07 ) + r2 *
+						(
+							T( 2.08757232129817482790e-09 ) + r2 *
+							T( -1.13596475577881948265e-11 )
+						)
+					)
+				)
+			)
+		);
+	}
+
+	// ratios above this are reduced by PI/4 before the arc tangent
+	static constexpr double ArcTangentLimit()
+	{
+		return 0.66;
+	}
+
+	// arc tangent of a ratio within the limit given its square
+	template <class T> static T ArcTangent( const T& t, const T& t2 )
+	{
+		const T p =
+		(
+			(
+				(
+					T( -8.750608600031904122785e-01 ) * t2 +
+					T( -1.615753718733365076637e+01 )
+				) * t2 + T( -7.500855792314704667340e+01 )
+			) * t2 + T( -1.228866684490136173410e+02 )
+		) * t2 + T( -6.485021904942025371773e+01 );
+		const T q =
+		(
+			(
+				(
+					(
+						t2 + T( 2.485846490142306297962e+01 )
+					) * t2 + T( 1.650270098316988542046e+02 )
+				) * t2 + T( 4.328810604912902668951e+02 )
+			) * t2 + T( 4.853903996359136964868e+02 )
+		) * t2 + T( 1.945506571482613964425e+02 );
+		return t + t * t2 * p / q;
+	}
+};
+
+#ifdef FAST_TRIG_SSE2
+/////////////////////////////////////////////////////////////////////////////
+// two doubles in an SSE2 register with the arithmetic operators, so the
+// polynomials of an accuracy are written once for one or two values
+class CPackedDouble
+{
+	// public data
+public:
+	__m128d m_Value;
+
+	// public construction
+public:
+	// both lanes from the register
+	CPackedDouble( __m128d value ) : m_Value( value )
+	{
+	}
+
+	// both lanes set to the same value
+	CPackedDouble( double value ) : m_Value( _mm_set1_pd( value ) )
+	{
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+inline CPackedDouble operator+( const CPackedDouble& a, const CPackedDouble& b )
+{
+	return _mm_add_pd( a.m_Value, b.m_Value );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+inline CPackedDouble operator-( const CPackedDouble& a, const CPackedDouble& b )
+{
+	return _mm_sub_pd( a.m_Value, b.m_Value );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+inline CPackedDouble operator*( const CPackedDouble& a, const CPackedDouble& b )
+{
+	return _mm_mul_pd( a.m_Value, b.m_Value );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+inline CPackedDouble operator/( const CPackedDouble& a, const CPackedDouble& b )
+{
+	return _mm_div_pd( a.m_Value, b.m_Value );
+}
+#endif // FAST_TRIG_SSE2
+
+/////////////////////////////////////////////////////////////////////////////
+// sine, cosine and arc tangent at the given accuracy (CTrigScreen or
+// CTrigPhysics)
+template <class TAccuracy> class CFastTrig
+{
+	// protected methods
+protected:
+	// The sine and cosine of the angle reduced by the given number of
+	// quarter turns, where each quarter turn exchanges the sine and
+	// cosine and every other one changes their signs.
+	static void Quadrant
+	(
+		double r, int nQuadrant, double& dSine, double& dCosine
+	)
+	{
+		const double r2 = r * r;
+		const double dS = TAccuracy::Sine( r, r2 );
+		const double dC = TAccuracy::Cosine( r2 );
+		switch ( nQuadrant & 3 )
+		{
+			case 0:
+			{
+				dSine = dS;
+				dCosine = dC;
+				break;
+			}
+			case 1:
+			{
+				dSine = dC;
+				dCosine = -dS;
+				break;
+			}
+			case 2:
+			{
+				dSine = -dS;
+				dCosine = -dC;
+				break;
+			}
+			default:
+			{
+				dSine = -dC;
+				dCosine = dS;
+				break;
+			}
+		}
+	}
+
+	// public methods
+public:
+	// sine and cosine of an angle in radians
+	static void SinCos( double dRadians, double& dSine, double& dCosine )
+	{
+		const double q = floor( dRadians * CTrigConstants::TwoOverPI() + 0.5 );
+		const double r =
+			dRadians - q * CTrigConstants::HalfPI1() -
+			q * CTrigConstants::HalfPI2() - q * CTrigConstants::HalfPI3();
+		Quadrant( r, int( q ), dSine, dCosine );
+	}
+
+	// Sine and cosine of an angle in degrees where the quarter turns are
+	// removed in degrees, so multiples of 90 degrees are exact.
+	static void SinCosDegrees( double dDegrees, double& dSine, double& dCosine )
+	{
+		const double q = floor( dDegrees / 90 + 0.5 );
+		const double r = ( dDegrees - 90 * q ) * ( CTrigConstants::PI() / 180 );
+		Quadrant( r, int( q ), dSine, dCosine );
+	}
+
+	// sine of an angle in radians
+	static double Sin( double dRadians )
+	{
+		double dSine, dCosine;
+		SinCos( dRadians, dSine, dCosine );
+		return dSine;
+	}
+
+	// cosine of an angle in radians
+	static double Cos( double dRadians )
+	{
+		double dSine, dCosine;
+		SinCos( dRadians, dSine, dCosine );
+		return dCosine;
+	}
+
+	// Angle in radians from -PI to PI of the point ( dX, dY ) following
+	// atan2, except a negative zero X is treated as a positive zero.
+	static double Atan2( double dY, double dX )
+	{
+		const double dAbsX = fabs( dX );
+		const double dAbsY = fabs( dY );
+		const bool bSteep = dAbsY > dAbsX;
+		const double dNumerator = bSteep ? dAbsX : dAbsY;
+		const double dDenominator = bSteep ? dAbsY : dAbsX;
+
+		// ratio from zero to one of the shorter side to the longer one
+		double t = dDenominator == 0 ? 0 : dNumerator / dDenominator;
+		double dOffset = 0;
+		if ( t > TAccuracy::ArcTangentLimit() )
+		{
+			t = ( t - 1 ) / ( t + 1 );
+			dOffset = CTrigConstants::PI() / 4;
+		}
+
+		double value = dOffset + TAccuracy::ArcTangent( t, t * t );
+		if ( bSteep )
+		{
+			value = CTrigConstants::PI() / 2 - value;
+		}
+		if ( dX < 0 )
+		{
+			value = CTrigConstants::PI() - value;
+		}
+		return copysign( value, dY );
+	}
+
+	// angle in degrees from -180 to 180 of the point ( dX, dY )
+	static double Atan2Degrees( double dY, double dX )
+	{
+		return Atan2( dY, dX ) * ( 180 / CTrigConstants::PI() );
+	}
+
+	// sine and cosine of an array of angles in radians
+	static void SinCos
+	(
+		const double* pRadians, double* pSine, double* pCosine, int nCount
+	)
+	{
+		int n = 0;
+
+#ifdef FAST_TRIG_SSE2
+		typedef CPackedDouble T;
+		const __m128d sign = _mm_set1_pd( -0.0 );
+		const __m128i one = _mm_set1_epi32( 1 );
+		const __m128i two = _mm_set1_epi32( 2 );
+		for ( ; n + 2 <= nCount; n += 2 )
+		{
+			const T x = _mm_loadu_pd( pRadians + n );
+
+			// the conversion rounds to the nearest quarter turn and each
+			// quarter turn is copied into both halves of its lane so the
+			// integer comparisons below are masks for the doubles
+			const __m128i quadrant = _mm_shuffle_epi32
+			(
+				_mm_cvtpd_epi32( ( x * T( CTrigConstants::TwoOverPI() ) ).m_Value ),
+				_MM_SHUFFLE( 1, 1, 0, 0 )
+			);
+			const T q = _mm_cvtepi32_pd
+			(
+				_mm_shuffle_epi32( quadrant, _MM_SHUFFLE( 3, 3, 2, 0 ) )
+			);
+			const T r =
+				x - q * T( CTrigConstants::HalfPI1() ) -
+				q * T( CTrigConstants::HalfPI2() ) -
+				q * T( CTrigConstants::HalfPI3() );
+			const T r2 = r * r;
+			const __m128d s = TAccuracy::Sine( r, r2 ).m_Value;
+			const __m128d c = TAccuracy::Cosine( r2 ).m_Value;
+
+			const __m128d odd = _mm_castsi128_pd
+			(
+				_mm_cmpeq_epi32( _mm_and_si128( quadrant, one ), one )
+			);
+			const __m128d negateSine = _mm_castsi128_pd
+			(
+				_mm_cmpeq_epi32( _mm_and_si128( quadrant, two ), two )
+			);
+			const __m128d negateCosine = _mm_castsi128_pd
+			(
+				_mm_cmpeq_epi32
+				(
+					_mm_and_si128( _mm_add_epi32( quadrant, one ), two ), two
+				)
+			);
+
+			__m128d sine = _mm_or_pd
+			(
+				_mm_and_pd( odd, c ), _mm_andnot_pd( odd, s )
+			);
+			__m128d cosine = _mm_or_pd
+			(
+				_mm_and_pd( odd, s ), _mm_andnot_pd( odd, c )
+			);
+			sine = _mm_xor_pd( sine, _mm_and_pd( negateSine, sign ) );
+			cosine = _mm_xor_pd( cosine, _mm_and_pd( negateCosine, sign ) );
+			_mm_storeu_pd( pSine + n, sine );
+			_mm_storeu_pd( pCosine + n, cosine );
+		}
+#endif
+
+		for ( ; n < nCount; n++ )
+		{
+			SinCos( pRadians[ n ], pSine[ n ], pCosine[ n ] );
+		}
+	}
+
+	// angles in radians of an array of points (see Atan2)
+	static void Atan2
+	(
+		const double* pY, const double* pX, double* pRadians, int nCount
+	)
+	{
+		int n = 0;
+
+#ifdef FAST_TRIG_SSE2
+		typedef CPackedDouble T;
+		const __m128d sign = _mm_set1_pd( -0.0 );
+		const __m128d zero = _mm_setzero_pd();
+		const __m128d limit = _mm_set1_pd( TAccuracy::ArcTangentLimit() );
+		const __m128d quarterPI = _mm_set1_pd( CTrigConstants::PI() / 4 );
+		for ( ; n + 2 <= nCount; n += 2 )
+		{
+			const __m128d y = _mm_loadu_pd( pY + n );
+			const __m128d x = _mm_loadu_pd( pX + n );
+			const __m128d absX = _mm_andnot_pd( sign, x );
+			const __m128d absY = _mm_andnot_pd( sign, y );
+			const __m128d steep = _mm_cmpgt_pd( absY, absX );
+			const __m128d numerator = _mm_min_pd( absX, absY );
+			const __m128d denominator = _mm_max_pd( absX, absY );
+
+			// the quotient at the origin is discarded
+			__m128d ratio = _mm_andnot_pd
+			(
+				_mm_cmpeq_pd( denominator, zero ),
+				_mm_div_pd( numerator, denominator )
+			);
+			const __m128d reduce = _mm_cmpgt_pd( ratio, limit );
+			const T one( 1.0 );
+			const T reduced = ( T( ratio ) - one ) / ( T( ratio ) + one );
+			ratio = _mm_or_pd
+			(
+				_mm_and_pd( reduce, reduced.m_Value ),
+				_mm_andnot_pd( reduce, ratio )
+			);
+
+			const T t = ratio;
+			__m128d value = _mm_add_pd
+			(
+				_mm_and_pd( reduce, quarterPI ),
+				TAccuracy::ArcTangent( t, t * t ).m_Value
+			);
+			const __m128d complement =
+				( T( CTrigConstants::PI() / 2 ) - T( value ) ).m_Value;
+			value = _mm_or_pd
+			(
+				_mm_and_pd( steep, complement ), _mm_andnot_pd( steep, value )
+			);
+			const __m128d negativeX = _mm_cmplt_pd( x, zero );
+			const __m128d supplement =
+				( T( CTrigConstants::PI() ) - T( value ) ).m_Value;
+			value = _mm_or_pd
+			(
+				_mm_and_pd( negativeX, supplement ),
+				_mm_andnot_pd( negativeX, value )
+			);
+			value = _mm_or_pd( value, _mm_and_pd( sign, y ) );
+			_mm_storeu_pd( pRadians + n, value );
+		}
+#endif
+
+		for ( ; n < nCount; n++ )
+		{
+			pRadians[ n ] = Atan2( pY[ n ], pX[ n ] );
+		}
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
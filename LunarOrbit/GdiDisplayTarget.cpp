@@ -0,0 +1,331 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "stdafx.h"
+#include "GdiDisplayTarget.h"
+#include "CHelper.h"
+#include <cmath>
+
+// the points of a list are handed to GDI without copying them
+static_assert
+(
+	sizeof( DISPLAY_POINT ) == sizeof( POINT ),
+	"DISPLAY_POINT must be laid out like POINT"
+);
+
+// most fonts kept before the font cache is emptied
+static const int MAX_FONTS = 64;
+
+/////////////////////////////////////////////////////////////////////////////
+CGdiDisplayTarget::CGdiDisplayTarget( const CDisplayStyles& styles ) :
+	m_Styles( styles )
+{
+	m_pDC = nullptr;
+	m_nPen = -1;
+	m_nBrush = -1;
+	m_nFont = -1;
+	m_nEscapement = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+CGdiDisplayTarget::~CGdiDisplayTarget()
+{
+	for ( HPEN hPen : m_Pens )
+	{
+		if ( hPen != NULL )
+		{
+			::DeleteObject( hPen );
+		}
+	}
+	for ( HBRUSH hBrush : m_Brushes )
+	{
+		if ( hBrush != NULL )
+		{
+			::DeleteObject( hBrush );
+		}
+	}
+	DeleteFonts();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// delete the created fonts
+void CGdiDisplayTarget::DeleteFonts()
+{
+	for ( const GDI_FONT& font : m_Fonts )
+	{
+		::DeleteObject( font.hFont );
+	}
+	m_Fonts.clear();
+
+} // DeleteFonts
+
+/////////////////////////////////////////////////////////////////////////////
+// select the pen with the given handle
+void CGdiDisplayTarget::SelectPen( int nPen )
+{
+	if ( nPen == m_nPen )
+	{
+		return;
+	}
+
+	if ( nPen >= (int)m_Pens.size() )
+	{
+		m_Pens.resize( nPen + 1, NULL );
+	}
+
+	HPEN& hPen = m_Pens[ nPen ];
+	if ( hPen == NULL )
+	{
+		const DISPLAY_PEN& pen = m_Styles.GetPen( nPen );
+		if ( pen.eStyle == DISPLAY_PEN_DOT )
+		{
+			// wide dotted lines need a geometric pen
+			LOGBRUSH lb;
+			lb.lbStyle = BS_SOLID;
+			lb.lbColor = pen.color;
+			lb.lbHatch = HS_BDIAGONAL;
+			hPen = ::ExtCreatePen
+			(
+				PS_GEOMETRIC | PS_DOT, pen.nWidth, &lb, 0, nullptr
+			);
+		}
+		else
+		{
+			hPen = ::CreatePen( PS_SOLID, pen.nWidth, pen.color );
+		}
+	}
+
+	::SelectObject( m_pDC->GetSafeHdc(), hPen );
+	m_nPen = nPen;
+
+} // SelectPen
+
+/////////////////////////////////////////////////////////////////////////////
+// select the brush with the given handle
+void CGdiDisplayTarget::SelectBrush( int nBrush )
+{
+	if ( nBrush == m_nBrush )
+	{
+		return;
+	}
+
+	if ( nBrush >= (int)m_Brushes.size() )
+	{
+		m_Brushes.resize( nBrush + 1, NULL );
+	}
+
+	HBRUSH& hBrush = m_Brushes[ nBrush ];
+	if ( hBrush == NULL )
+	{
+		hBrush = ::CreateSolidBrush( m_Styles.GetBrush( nBrush ).color );
+	}
+
+	::SelectObject( m_pDC->GetSafeHdc(), hBrush );
+	m_nBrush = nBrush;
+
+} // SelectBrush
+
+/////////////////////////////////////////////////////////////////////////////
+// select the font with the given handle and text angle
+void CGdiDisplayTarget::SelectFont( int nFont, int nEscapement )
+{
+	if ( nFont == m_nFont && nEscapement == m_nEscapement )
+	{
+		return;
+	}
+
+	HFONT hFont = NULL;
+	for ( const GDI_FONT& font : m_Fonts )
+	{
+		if ( font.nFont == nFont && font.nEscapement == nEscapement )
+		{
+			hFont = font.hFont;
+			break;
+		}
+	}
+
+	if ( hFont == NULL )
+	{
+		// the same logical font CBaseView::BuildFont creates
+		const DISPLAY_FONT& style = m_Styles.GetFont( nFont );
+		LOGFONT lf;
+		::GetObject( GetStockObject( SYSTEM_FONT ), sizeof( LOGFONT ), &lf );
+		lf.lfHeight = style.nHeight;
+		lf.lfWidth = style.nHeight * 2 / 5;
+		lf.lfEscapement = nEscapement;
+		lf.lfOrientation = nEscapement;
+		lf.lfWeight = style.bBold ? FW_BOLD : FW_NORMAL;
+		lf.lfItalic = style.bItalic;
+		lf.lfCharSet = ANSI_CHARSET;
+		_tcsncpy_s( lf.lfFaceName, style.csFace.c_str(), _TRUNCATE );
+
+		GDI_FONT font;
+		font.nFont = nFont;
+		font.nEscapement = nEscapement;
+		font.hFont = ::CreateFontIndirect( &lf );
+		m_Fonts.push_back( font );
+		hFont = font.hFont;
+	}
+
+	::SelectObject( m_pDC->GetSafeHdc(), hFont );
+	m_nFont = nFont;
+	m_nEscapement = nEscapement;
+
+} // SelectFont
+
+/////////////////////////////////////////////////////////////////////////////
+// replay the list onto the device context where the state of the device
+// context is restored afterwards
+void CGdiDisplayTarget::Draw( CDC* pDC, const CDisplayList& list )
+{
+	m_pDC = pDC;
+	const int nSaved = pDC->SaveDC();
+
+	// nothing of ours is selected into a device context between lists
+	m_nPen = -1;
+	m_nBrush = -1;
+	m_nFont = -1;
+
+	// a selected font cannot be deleted, so the font cache is only
+	// emptied before drawing starts
+	if ( (int)m_Fonts.size() >= MAX_FONTS )
+	{
+		DeleteFonts();
+	}
+
+	list.Replay( *this );
+
+	// restoring the device context releases the pens, brushes and fonts
+	pDC->RestoreDC( nSaved );
+	m_nPen = -1;
+	m_nBrush = -1;
+	m_nFont = -1;
+	m_pDC = nullptr;
+
+} // Draw
+
+/////////////////////////////////////////////////////////////////////////////
+void CGdiDisplayTarget::Line
+(
+	int nPen, const DISPLAY_POINT& pt1, const DISPLAY_POINT& pt2
+)
+{
+	SelectPen( nPen );
+	m_pDC->MoveTo( pt1.x, pt1.y );
+	m_pDC->LineTo( pt2.x, pt2.y );
+
+} // Line
+
+/////////////////////////////////////////////////////////////////////////////
+void CGdiDisplayTarget::Polyline
+(
+	int nPen, const DISPLAY_POINT* pPoints, int nPoints
+)
+{
+	SelectPen( nPen );
+	m_pDC->Polyline( (const POINT*)pPoints, nPoints );
+
+} // Polyline
+
+/////////////////////////////////////////////////////////////////////////////
+void CGdiDisplayTarget::Polygon
+(
+	int nPen, int nBrush, const DISPLAY_POINT* pPoints, int nPoints
+)
+{
+	SelectPen( nPen );
+	SelectBrush( nBrush );
+	m_pDC->Polygon( (const POINT*)pPoints, nPoints );
+
+} // Polygon
+
+/////////////////////////////////////////////////////////////////////////////
+void CGdiDisplayTarget::Ellipse
+(
+	int nPen, int nBrush,
+	const DISPLAY_POINT& ptTopLeft, const DISPLAY_POINT& ptBottomRight
+)
+{
+	SelectPen( nPen );
+	SelectBrush( nBrush );
+	m_pDC->Ellipse( ptTopLeft.x, ptTopLeft.y, ptBottomRight.x, ptBottomRight.y );
+
+} // Ellipse
+
+/////////////////////////////////////////////////////////////////////////////
+void CGdiDisplayTarget::Arc
+(
+	int nPen, const DISPLAY_POINT& ptCenter, int nRadius,
+	float fStartAngle, float fSweepAngle
+)
+{
+	SelectPen( nPen );
+
+	// AngleArc draws a line from the current position to the start of
+	// the arc, so the current position is moved to the start first
+	const double dStart = CHelper::GetRadians( fStartAngle );
+	m_pDC->MoveTo
+	(
+		ptCenter.x + int( nRadius * cos( dStart ) ),
+		ptCenter.y + int( nRadius * sin( dStart ) )
+	);
+	m_pDC->AngleArc
+	(
+		ptCenter.x, ptCenter.y, nRadius, fStartAngle, fSweepAngle
+	);
+
+} // Arc
+
+/////////////////////////////////////////////////////////////////////////////
+void CGdiDisplayTarget::Text
+(
+	int nFont, int nEscapement, int nAlign, DISPLAY_COLOR color,
+	const DISPLAY_POINT& pt, const wchar_t* pText, int nLength
+)
+{
+	SelectFont( nFont, nEscapement );
+
+	UINT nTA = TA_LEFT;
+	switch ( nAlign & DISPLAY_ALIGN_HORIZONTAL )
+	{
+		case DISPLAY_ALIGN_CENTER:
+		{
+			nTA = TA_CENTER;
+			break;
+		}
+		case DISPLAY_ALIGN_RIGHT:
+		{
+			nTA = TA_RIGHT;
+			break;
+		}
+	}
+	switch ( nAlign & DISPLAY_ALIGN_VERTICAL )
+	{
+		case DISPLAY_ALIGN_BASELINE:
+		{
+			nTA |= TA_BASELINE;
+			break;
+		}
+		case DISPLAY_ALIGN_BOTTOM:
+		{
+			nTA |= TA_BOTTOM;
+			break;
+		}
+		default:
+		{
+			nTA |= TA_TOP;
+			break;
+		}
+	}
+
+	m_pDC->SetTextAlign( nTA );
+	m_pDC->SetTextColor( color );
+	m_pDC->SetBkMode
+	(
+		( nAlign & DISPLAY_ALIGN_OPAQUE ) != 0 ? OPAQUE : TRANSPARENT
+	);
+	m_pDC->TextOut( pt.x, pt.y, pText, nLength );
+
+} // Text
+
+/////////////////////////////////////////////////////////////////////////////
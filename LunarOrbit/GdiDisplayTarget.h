@@ -0,0 +1,107 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "DisplayList.h"
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// a font created for a font handle at a given text angle
+struct GDI_FONT
+{
+	int nFont; // handle of the font in the style table
+	int nEscapement; // text angle in tenths of a degree
+	HFONT hFont; // the created font
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// A display target that draws on a device context. The pens, brushes and
+// fonts are created the first time a handle is used and are kept for the
+// life of the target, so replaying a list every frame creates no GDI
+// objects once every style has been seen. Fonts are created for each text
+// angle, and since the labels of the vectors turn with the moon the font
+// cache is emptied when it grows past a few dozen fonts.
+class CGdiDisplayTarget : public CDisplayTarget
+{
+	// protected data
+protected:
+	// the styles the handles refer to
+	const CDisplayStyles& m_Styles;
+
+	// the device context being drawn on
+	CDC* m_pDC;
+
+	// created pens by handle or NULL
+	vector<HPEN> m_Pens;
+
+	// created brushes by handle or NULL
+	vector<HBRUSH> m_Brushes;
+
+	// created fonts by handle and angle
+	vector<GDI_FONT> m_Fonts;
+
+	// handles currently selected into the device context or -1
+	int m_nPen;
+	int m_nBrush;
+	int m_nFont;
+	int m_nEscapement;
+
+	// protected methods
+protected:
+	// select the pen with the given handle
+	void SelectPen( int nPen );
+
+	// select the brush with the given handle
+	void SelectBrush( int nBrush );
+
+	// select the font with the given handle and text angle
+	void SelectFont( int nFont, int nEscapement );
+
+	// delete the created fonts
+	void DeleteFonts();
+
+	// public methods
+public:
+	// replay the list onto the device context where the state of the
+	// device context is restored afterwards
+	void Draw( CDC* pDC, const CDisplayList& list );
+
+	// public overrides
+public:
+	void Line
+	(
+		int nPen, const DISPLAY_POINT& pt1, const DISPLAY_POINT& pt2
+	) override;
+	void Polyline
+	(
+		int nPen, const DISPLAY_POINT* pPoints, int nPoints
+	) override;
+	void Polygon
+	(
+		int nPen, int nBrush, const DISPLAY_POINT* pPoints, int nPoints
+	) override;
+	void Ellipse
+	(
+		int nPen, int nBrush,
+		const DISPLAY_POINT& ptTopLeft, const DISPLAY_POINT& ptBottomRight
+	) override;
+	void Arc
+	(
+		int nPen, const DISPLAY_POINT& ptCenter, int nRadius,
+		float fStartAngle, float fSweepAngle
+	) override;
+	void Text
+	(
+		int nFont, int nEscapement, int nAlign, DISPLAY_COLOR color,
+		const DISPLAY_POINT& pt, const wchar_t* pText, int nLength
+	) override;
+
+	// public construction
+public:
+	CGdiDisplayTarget( const CDisplayStyles& styles );
+	virtual ~CGdiDisplayTarget();
+};
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,48 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// A built in bitmap font for drawing text without an operating system font,
+// such as on a platform without GDI. Each glyph is 5 columns by 7 rows
+// stored as one byte per row from the top where the leftmost column is the
+// highest of the five bits. The printable ASCII characters are included
+// along with the few Latin-1 characters the view draws (the degree signs,
+// the superscript two and one half), and every other character is drawn
+// as a box.
+//
+// A glyph sits in a character cell of 6 columns by 9 rows, leaving a
+// column between characters, a row of leading above the glyph and a row of
+// descent below it. The baseline is the bottom of the eighth row.
+class CGlyphAtlas
+{
+	// public definitions
+public:
+	enum
+	{
+		GLYPH_COLUMNS = 5, // columns of a glyph
+		GLYPH_ROWS = 7, // rows of a glyph
+		CELL_COLUMNS = 6, // columns of a character cell
+		CELL_ROWS = 9, // rows of a character cell
+		CELL_ASCENT = 8, // rows of a cell above the baseline
+		GLYPH_TOP = 1 // row of the cell holding the first row of a glyph
+	};
+
+	// public methods
+public:
+	// the rows of the glyph of a character
+	static const unsigned char* GetGlyph( wchar_t ch );
+
+	// true if the glyph has a dot at the given column and row where
+	// positions outside of the glyph are empty
+	static bool IsSet( const unsigned char* pGlyph, int nColumn, int nRow )
+	{
+		return
+			nColumn >= 0 && nColumn < GLYPH_COLUMNS &&
+			nRow >= 0 && nRow < GLYPH_ROWS &&
+			( pGlyph[ nRow ] & ( 0x10 >> nColumn ) ) != 0;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,82 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "LayerCache.h"
+#include <algorithm>
+#include <cstring>
+
+/////////////////////////////////////////////////////////////////////////////
+CLayerCache::CLayerCache()
+{
+	m_Key.dScale = 0;
+	m_Key.dLeftOfView = 0;
+	m_Key.dTopOfView = 0;
+	m_Key.nWidth = 0;
+	m_Key.nHeight = 0;
+	m_bValid = false;
+	m_nHits = 0;
+	m_nMisses = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Return true if the layer must be drawn again for the given key. The
+// layer is considered valid for the key afterwards, so the caller draws
+// it before the next call.
+bool CLayerCache::Prepare( const LAYER_KEY& key )
+{
+	if ( IsValid( key ) )
+	{
+		m_nHits++;
+		return false;
+	}
+
+	m_Key = key;
+	m_bValid = true;
+	m_nMisses++;
+	return true;
+
+} // Prepare
+
+/////////////////////////////////////////////////////////////////////////////
+CPixelLayer::CPixelLayer()
+{
+	m_nWidth = 0;
+	m_nHeight = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// change the size where the pixels are undefined unless the size is
+// unchanged
+void CPixelLayer::Resize( int nWidth, int nHeight )
+{
+	m_nWidth = max( nWidth, 0 );
+	m_nHeight = max( nHeight, 0 );
+	m_Pixels.resize( size_t( m_nWidth ) * m_nHeight );
+
+} // Resize
+
+/////////////////////////////////////////////////////////////////////////////
+// set every pixel to the given color
+void CPixelLayer::Fill( LAYER_PIXEL color )
+{
+	fill( m_Pixels.begin(), m_Pixels.end(), color );
+
+} // Fill
+
+/////////////////////////////////////////////////////////////////////////////
+// copy the size and pixels of another layer
+void CPixelLayer::CopyFrom( const CPixelLayer& layer )
+{
+	Resize( layer.m_nWidth, layer.m_nHeight );
+	if ( !m_Pixels.empty() )
+	{
+		memcpy
+		(
+			m_Pixels.data(), layer.m_Pixels.data(),
+			m_Pixels.size() * sizeof( LAYER_PIXEL )
+		);
+	}
+
+} // CopyFrom
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,185 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// a pixel laid out as red, green and blue bytes like a COLORREF, where
+// the high byte is alpha, so the pixels of a layer are RGBA in memory
+typedef uint32_t LAYER_PIXEL;
+
+/////////////////////////////////////////////////////////////////////////////
+// everything that moves or scales the background of the view, so a cached
+// background is only good for the key it was drawn with
+struct LAYER_KEY
+{
+	double dScale; // zooming scale factor
+	double dLeftOfView; // horizontal scroll position in inches
+	double dTopOfView; // vertical scroll position in inches
+	int nWidth; // width of the client area in pixels
+	int nHeight; // height of the client area in pixels
+
+	// true if every member is the same
+	bool operator==( const LAYER_KEY& rhs ) const
+	{
+		return
+			dScale == rhs.dScale && dLeftOfView == rhs.dLeftOfView &&
+			dTopOfView == rhs.dTopOfView && nWidth == rhs.nWidth &&
+			nHeight == rhs.nHeight;
+	}
+
+	// true if any member is different
+	bool operator!=( const LAYER_KEY& rhs ) const
+	{
+		return !( *this == rhs );
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Decides when a cached background layer has to be drawn again. The view
+// keeps the parts of the drawing that never move (the grid, scale, labels
+// and equations) in a layer that is drawn once for a key and copied under
+// the moving parts every frame, so the cost of a frame does not depend on
+// how much is in the background. The layer itself is a bitmap on Windows
+// or a CPixelLayer anywhere else.
+class CLayerCache
+{
+	// protected data
+protected:
+	// the key the layer was last drawn with
+	LAYER_KEY m_Key;
+
+	// true if the layer holds a drawing for the key
+	bool m_bValid;
+
+	// number of frames that reused the layer
+	int m_nHits;
+
+	// number of frames that drew the layer again
+	int m_nMisses;
+
+	// public methods
+public:
+	// true if the layer holds a drawing for the given key
+	bool IsValid( const LAYER_KEY& key ) const
+	{
+		return m_bValid && m_Key == key;
+	}
+
+	// number of frames that reused the layer
+	int GetHits() const
+	{
+		return m_nHits;
+	}
+
+	// number of frames that drew the layer again
+	int GetMisses() const
+	{
+		return m_nMisses;
+	}
+
+	// Return true if the layer must be drawn again for the given key. The
+	// layer is considered valid for the key afterwards, so the caller
+	// draws it before the next call.
+	bool Prepare( const LAYER_KEY& key );
+
+	// the layer must be drawn again on the next frame, such as when the
+	// content of the background changes
+	void Invalidate()
+	{
+		m_bValid = false;
+	}
+
+	// public construction
+public:
+	CLayerCache();
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// A layer of pixels in memory for drawing without a device context, such
+// as drawing off screen or on a platform without GDI. Resizing to the same
+// size keeps the pixels and resizing to a smaller size keeps the storage.
+class CPixelLayer
+{
+	// protected data
+protected:
+	// width in pixels
+	int m_nWidth;
+
+	// height in pixels
+	int m_nHeight;
+
+	// pixels by row from the top left corner
+	vector<LAYER_PIXEL> m_Pixels;
+
+	// public methods
+public:
+	// width in pixels
+	int GetWidth() const
+	{
+		return m_nWidth;
+	}
+
+	// height in pixels
+	int GetHeight() const
+	{
+		return m_nHeight;
+	}
+
+	// the pixels by row from the top left corner
+	LAYER_PIXEL* GetPixels()
+	{
+		return m_Pixels.data();
+	}
+
+	// the pixels by row from the top left corner
+	const LAYER_PIXEL* GetPixels() const
+	{
+		return m_Pixels.data();
+	}
+
+	// the pixels of the given row
+	LAYER_PIXEL* GetRow( int nRow )
+	{
+		return m_Pixels.data() + size_t( nRow ) * m_nWidth;
+	}
+
+	// the pixels of the given row
+	const LAYER_PIXEL* GetRow( int nRow ) const
+	{
+		return m_Pixels.data() + size_t( nRow ) * m_nWidth;
+	}
+
+	// the pixel at the given column and row
+	LAYER_PIXEL GetPixel( int nColumn, int nRow ) const
+	{
+		return GetRow( nRow )[ nColumn ];
+	}
+
+	// set the pixel at the given column and row
+	void SetPixel( int nColumn, int nRow, LAYER_PIXEL value )
+	{
+		GetRow( nRow )[ nColumn ] = value;
+	}
+
+	// change the size where the pixels are undefined unless the size is
+	// unchanged
+	void Resize( int nWidth, int nHeight );
+
+	// set every pixel to the given color
+	void Fill( LAYER_PIXEL color );
+
+	// copy the size and pixels of another layer, as when the cached
+	// background is copied under the moving parts of a frame
+	void CopyFrom( const CPixelLayer& layer );
+
+	// public construction
+public:
+	CPixelLayer();
+};
+
+/////////////////////////////////////////////////////////////////////////////
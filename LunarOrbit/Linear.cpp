@@ -3,6 +3,7 @@
 /////////////////////////////////////////////////////////////////////////////
 #include "stdafx.h"
 #include "Linear.h"
+#include "FastTrig.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // given x and y co-ordinates, return a line perpendicular to this line
@@ -123,76 +124,96 @@ bool CLinear::GetLineIntercept( CLinear& refLine, double& dX, double& dY )
 } // GetLineIntercept
 
 /////////////////////////////////////////////////////////////////////////////
-// return the angle in radians from horizontal
-double CLinear::GetAngleInRadians()
+// calculate the length, angle and unit direction from the points where
+// the angle is from -PI to PI with PI returned for a horizontal segment
+// pointing left and zero returned for a zero length segment
+void CLinear::UpdateCache() const
 {
-	const double dHyp = Length;
-	if ( dHyp == 0 )
-		return 0;
-	const double dOpp = UpIncrement * Rise;
-	const double dAdj = Run;
+	const double dRun = m_dX2 - m_dX1;
+	const double dRise = m_dY2 - m_dY1;
 
-	double dAngle;
-	if ( dAdj == 0 )
+	if ( dRun == 0 )
 	{
-		if ( dOpp > 0 )
-		{
-			dAngle = PI / 2;
-		}
-		else
-		{
-			dAngle = -PI / 2;
-		}
+		m_dLength = fabs( dRise );
 	}
-	else if ( dOpp == 0 )
+	else if ( dRise == 0 )
 	{
-		if ( dAdj > 0 )
-		{
-			dAngle = 0;
-		}
-		else
-		{
-			dAngle = PI;
-		}
+		m_dLength = fabs( dRun );
+	}
+	else // Pythagorean theorem (square root of the sum of the squares)
+	{
+		m_dLength = sqrt( dRun * dRun + dRise * dRise );
+	}
+
+	const double dHyp = m_dLength;
+	if ( dHyp == 0 )
+	{
+		m_dRadians = 0;
+		m_dCosine = 1;
+		m_dSine = 0;
 	}
 	else
 	{
-		const double dTan = dOpp / dAdj;
-		dAngle = atan( dTan );
+		const double dOpp = m_nUpIncrement * dRise;
+		const double dAdj = dRun;
 
-		if ( dAdj < 0 )
+		// the sign of a zero opposite side depends on the up increment
+		// so horizontal segments are tested before the arc tangent
+		if ( dOpp == 0 )
 		{
-			if ( dOpp < 0 )
-			{
-				dAngle -= PI;
-			}
-			else
-			{
-				dAngle += PI;
-			}
+			m_dRadians = dAdj > 0 ? 0 : GetPI();
 		}
+		else
+		{
+			m_dRadians = CFastTrig<CTrigPhysics>::Atan2( dOpp, dAdj );
+		}
+		m_dCosine = dAdj / dHyp;
+		m_dSine = dOpp / dHyp;
 	}
-	return dAngle;
-} // GetAngleInRadians
+
+	m_bCached = true;
+
+} // UpdateCache
 
 /////////////////////////////////////////////////////////////////////////////
 // Second point will be relocated by rotating it by dRotation degrees
-// with the first point being the center of the rotation
+// with the first point being the center of the rotation where the new
+// direction comes from the cached one by the angle sum identities
 void CLinear::RotateAroundFirstPoint( double dRotation )
 {
 	const double dHyp = Length;
 	if ( dHyp == 0 ) // nothing to do
 		return;
 	const double dRotationRadians = ConvertDegreesToRadians( dRotation );
-	const double dLineAngle = Degrees;
-	const double dRadians = Radians + dRotationRadians;
-	const double dSine = sin( dRadians );
-	const double dCosine = cos( dRadians );
+	double dSineOfRotation, dCosineOfRotation;
+	CFastTrig<CTrigPhysics>::SinCosDegrees
+	(
+		dRotation, dSineOfRotation, dCosineOfRotation
+	);
+	const double dSine =
+		m_dSine * dCosineOfRotation + m_dCosine * dSineOfRotation;
+	const double dCosine =
+		m_dCosine * dCosineOfRotation - m_dSine * dSineOfRotation;
+
+	// keep the angle from -PI to PI like the arc tangent
+	double dRadians = remainder( m_dRadians + dRotationRadians, 2 * PI );
+	if ( dRadians <= -PI )
+	{
+		dRadians += 2 * PI;
+	}
+
 	const double dOpp = dHyp * dSine; // new rise
 	const double dAdj = dHyp * dCosine; // new run
 	X2 = X1 + dAdj;
 	Y2 = Y1 + UpIncrement * dOpp;
 
+	// the rotation does not change the length
+	m_dLength = dHyp;
+	m_dRadians = dRadians;
+	m_dCosine = dCosine;
+	m_dSine = dSine;
+	m_bCached = true;
+
 } // RotateAroundFirstPoint
 
 /////////////////////////////////////////////////////////////////////////////
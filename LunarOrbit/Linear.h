@@ -21,6 +21,30 @@ private:
 	// logical pixels per inch
 	int m_nMap;
 
+	// The length, angle and unit direction are derived from the points
+	// when first asked for and kept until a point or the up increment
+	// changes, so a segment that is read many times while it is drawn
+	// only pays for one square root and one arc tangent.
+	mutable bool m_bCached; // true if the derived values are current
+	mutable double m_dLength; // length of the segment
+	mutable double m_dRadians; // angle from horizontal in radians
+	mutable double m_dCosine; // cosine of the angle (run / length)
+	mutable double m_dSine; // sine of the angle (up * rise / length)
+
+	// private methods
+private:
+	// calculate the length, angle and unit direction from the points
+	void UpdateCache() const;
+
+	// calculate the derived values if a point has changed
+	inline void Validate() const
+	{
+		if ( !m_bCached )
+		{
+			UpdateCache();
+		}
+	}
+
 	// public properties
 public:
 	// PI
@@ -33,7 +57,7 @@ public:
 		double PI;
 
 	// logical pixels per inch
-	int GetMap()
+	int GetMap() const
 	{
 		return m_nMap;
 	}
@@ -53,6 +77,7 @@ public:
 	void SetUpIncrement( int nValue = -1 )
 	{
 		m_nUpIncrement = nValue;
+		m_bCached = false;
 	}
 	// since device contexts can be set such that increasing 
 	// Y values will go up or down, this attribute sets the 
@@ -76,6 +101,7 @@ public:
 	inline void SetX1( double dX1 )
 	{
 		m_dX1 = dX1;
+		m_bCached = false;
 	}
 	// first x co-ordinate property
 	__declspec( property( get = GetX1, put = SetX1 ) ) double X1;
@@ -89,6 +115,7 @@ public:
 	inline void SetX2( double dX2 )
 	{
 		m_dX2 = dX2;
+		m_bCached = false;
 	}
 	// second x co-ordinate property
 	__declspec( property( get = GetX2, put = SetX2 ) ) double X2;
@@ -102,6 +129,7 @@ public:
 	inline void SetY1( double dY1 )
 	{
 		m_dY1 = dY1;
+		m_bCached = false;
 	}
 	// first y co-ordinate property
 	__declspec( property( get = GetY1, put = SetY1 ) ) double Y1;
@@ -115,6 +143,7 @@ public:
 	inline void SetY2( double dY2 )
 	{
 		m_dY2 = dY2;
+		m_bCached = false;
 	}
 	// second y co-ordinate property
 	__declspec( property( get = GetY2, put = SetY2 ) ) double Y2;
@@ -158,6 +187,7 @@ public:
 	inline void SetRun( double dRun )
 	{
 		m_dX2 = m_dX1 + dRun;
+		m_bCached = false;
 	}
 	// run property
 	__declspec( property( get = GetRun, put = SetRun ) ) double Run;
@@ -171,12 +201,17 @@ public:
 	inline void SetRise( double dRise )
 	{
 		m_dY2 = m_dY1 + dRise;
+		m_bCached = false;
 	}
 	// rise property
 	__declspec( property( get = GetRise, put = SetRise ) ) double Rise;
 
 	// return the angle in radians from horizontal
-	double GetAngleInRadians();
+	double GetAngleInRadians() const
+	{
+		Validate();
+		return m_dRadians;
+	}
 	// set angle in radians
 	void SetAngleInRadians( double dRotation )
 	{
@@ -237,31 +272,53 @@ public:
 	__declspec( property( get = GetDirectionY ) )
 		int DirectionY;
 
-	// absolute length of this line segment
-	double GetLength()
+	// cosine of the angle from horizontal (the X component of the
+	// unit vector in the direction of the segment)
+	double GetCosine() const
 	{
-		double dRun = Run;
-		double dRise = Rise;
-		if ( dRun == 0 )
-		{
-			return fabs( dRise );
-		}
-		else if ( dRise == 0 )
-		{
-			return fabs( dRun );
-		}
-		else // Pythagorean theorem (square root of the sum of the squares)
-		{
-			return sqrt( dRun * dRun + dRise * dRise );
-		}
+		Validate();
+		return m_dCosine;
 	}
+	// cosine of the angle from horizontal
+	__declspec( property( get = GetCosine ) )
+		double Cosine;
+
+	// sine of the angle from horizontal where positive is up (the Y 
+	// component of the unit vector is the sine times the up increment)
+	double GetSine() const
+	{
+		Validate();
+		return m_dSine;
+	}
+	// sine of the angle from horizontal where positive is up
+	__declspec( property( get = GetSine ) )
+		double Sine;
+
 	// absolute length of this line segment
+	double GetLength() const
+	{
+		Validate();
+		return m_dLength;
+	}
+	// absolute length of this line segment where the second point is
+	// moved along the current direction (a zero length segment is 
+	// extended horizontally to the right)
 	void SetLength( double dLength )
 	{
-		double dAngle = GetAngleInDegrees();
-		RotateAroundFirstPoint( -dAngle ); // horizontal
-		X2 = X1 + dLength;
-		RotateAroundFirstPoint( dAngle );
+		Validate();
+		const double dCosine = m_dCosine;
+		const double dSine = m_dSine;
+		const double dRadians = m_dRadians;
+		X2 = X1 + dLength * dCosine;
+		Y2 = Y1 + UpIncrement * dLength * dSine;
+
+		// the direction is unchanged so only the length is new unless
+		// a negative length reversed the segment
+		m_dLength = dLength;
+		m_dRadians = dRadians;
+		m_dCosine = dCosine;
+		m_dSine = dSine;
+		m_bCached = dLength > 0;
 	}
 	// absolute length of this line segment
 	__declspec( property( get = GetLength, put = SetLength ) )
@@ -366,18 +423,24 @@ public:
 		SecondPoint = pt2;
 	}
 
-	// copies a line to another line
-	CLinear operator=( const CLinear& ln )
+	// copies a line to another line along with its derived values
+	CLinear& operator=( const CLinear& ln )
 	{
 		X1 = ln.X1;
 		X2 = ln.X2;
 		Y1 = ln.Y1;
 		Y2 = ln.Y2;
 		UpIncrement = ln.UpIncrement;
+
+		m_bCached = ln.m_bCached;
+		m_dLength = ln.m_dLength;
+		m_dRadians = ln.m_dRadians;
+		m_dCosine = ln.m_dCosine;
+		m_dSine = ln.m_dSine;
 		return *this;
 	}
 
-	// move the line by given delta
+	// move the line by given delta (the length and angle do not change)
 	inline void Translate( double dX, double dY )
 	{
 		m_dX1 += dX;
@@ -639,6 +702,7 @@ public:
 	CLinear()
 	{
 		m_dX1 = m_dY1 = m_dX2 = m_dY2 = 0; 
+		m_bCached = false;
 
 		// default to Y coordinate where Y gets smaller going up
 		UpIncrement = -1;
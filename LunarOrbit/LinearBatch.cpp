@@ -0,0 +1,676 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "LinearBatch.h"
+#include "FastTrig.h"
+#include <cmath>
+
+/////////////////////////////////////////////////////////////////////////////
+// SSE2 is part of every x64 target and is optional for 32 bit targets
+#if defined( _M_X64 ) || defined( __SSE2__ ) || \
+	( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define LINEAR_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef LINEAR_BATCH_SSE2
+/////////////////////////////////////////////////////////////////////////////
+// choose the first value where the mask is set and the second elsewhere
+static inline __m128d Select( __m128d mask, __m128d first, __m128d second )
+{
+	return _mm_or_pd( _mm_and_pd( mask, first ), _mm_andnot_pd( mask, second ) );
+
+} // Select
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// Rotate a run and rise by the given cosine and sine where the sine has
+// already been multiplied by the up increment. In device co-ordinates the
+// up component is the rise times the up increment, and since the up
+// increment squared is one the rotation of the up component reduces to
+// this rotation of the run and rise.
+static inline void Rotate
+(
+	double& dRun, double& dRise, double dCosine, double dUpSine
+)
+{
+	const double dNewRun = dRun * dCosine - dRise * dUpSine;
+	const double dNewRise = dRise * dCosine + dRun * dUpSine;
+	dRun = dNewRun;
+	dRise = dNewRise;
+
+} // Rotate
+
+/////////////////////////////////////////////////////////////////////////////
+// scale a run and rise to the given length where a zero length direction
+// is taken to be horizontal to the right
+static inline void Normalize( double& dRun, double& dRise, double dLength )
+{
+	const double dHyp = sqrt( dRun * dRun + dRise * dRise );
+	if ( dHyp == 0 )
+	{
+		dRun = dLength;
+		dRise = 0;
+	}
+	else
+	{
+		const double dScale = dLength / dHyp;
+		dRun *= dScale;
+		dRise *= dScale;
+	}
+
+} // Normalize
+
+/////////////////////////////////////////////////////////////////////////////
+// one length for every segment, which is broadcast once instead of being
+// copied into an array for each segment
+class CUniformLength
+{
+	// protected data
+protected:
+	double m_dLength;
+#ifdef LINEAR_BATCH_SSE2
+	__m128d m_length;
+#endif
+
+	// public methods
+public:
+	// the length of the given segment
+	double Get( int /*nSegment*/ ) const
+	{
+		return m_dLength;
+	}
+
+#ifdef LINEAR_BATCH_SSE2
+	// the lengths of the given segment and the one after it
+	__m128d Load( int /*nSegment*/ ) const
+	{
+		return m_length;
+	}
+#endif
+
+	// public construction
+public:
+	CUniformLength( double dLength )
+	{
+		m_dLength = dLength;
+#ifdef LINEAR_BATCH_SSE2
+		m_length = _mm_set1_pd( dLength );
+#endif
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// an array with one length for each segment
+class CLengthArray
+{
+	// protected data
+protected:
+	const double* m_pLengths;
+
+	// public methods
+public:
+	// the length of the given segment
+	double Get( int nSegment ) const
+	{
+		return m_pLengths[ nSegment ];
+	}
+
+#ifdef LINEAR_BATCH_SSE2
+	// the lengths of the given segment and the one after it
+	__m128d Load( int nSegment ) const
+	{
+		return _mm_loadu_pd( m_pLengths + nSegment );
+	}
+#endif
+
+	// public construction
+public:
+	CLengthArray( const double* pLengths )
+	{
+		m_pLengths = pLengths;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// one rotation for every segment, which is broadcast once with its sine
+// multiplied by the up increment
+class CUniformRotation
+{
+	// protected data
+protected:
+	double m_dCosine;
+	double m_dUpSine;
+#ifdef LINEAR_BATCH_SSE2
+	__m128d m_cosine;
+	__m128d m_upSine;
+#endif
+
+	// public methods
+public:
+	// the cosine and the sine times the up increment of the rotation of
+	// the given segment
+	void Get( int /*nSegment*/, double& dCosine, double& dUpSine ) const
+	{
+		dCosine = m_dCosine;
+		dUpSine = m_dUpSine;
+	}
+
+#ifdef LINEAR_BATCH_SSE2
+	// the cosines and the sines times the up increment of the rotations
+	// of the given segment and the one after it
+	void Load( int /*nSegment*/, __m128d& cosine, __m128d& upSine ) const
+	{
+		cosine = m_cosine;
+		upSine = m_upSine;
+	}
+#endif
+
+	// public construction
+public:
+	CUniformRotation( const LINEAR_ROTATION& rotation, double dUp )
+	{
+		m_dCosine = rotation.dCosine;
+		m_dUpSine = dUp * rotation.dSine;
+#ifdef LINEAR_BATCH_SSE2
+		m_cosine = _mm_set1_pd( m_dCosine );
+		m_upSine = _mm_set1_pd( m_dUpSine );
+#endif
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// an array with one rotation for each segment
+class CRotationArray
+{
+	// protected data
+protected:
+	const LINEAR_ROTATION* m_pRotations;
+	double m_dUp;
+#ifdef LINEAR_BATCH_SSE2
+	__m128d m_up;
+#endif
+
+	// public methods
+public:
+	// the cosine and the sine times the up increment of the rotation of
+	// the given segment
+	void Get( int nSegment, double& dCosine, double& dUpSine ) const
+	{
+		dCosine = m_pRotations[ nSegment ].dCosine;
+		dUpSine = m_dUp * m_pRotations[ nSegment ].dSine;
+	}
+
+#ifdef LINEAR_BATCH_SSE2
+	// the cosines and the sines times the up increment of the rotations
+	// of the given segment and the one after it, where the rotations are
+	// pairs of cosine and sine that are transposed into a vector of each
+	void Load( int nSegment, __m128d& cosine, __m128d& upSine ) const
+	{
+		const __m128d first = _mm_loadu_pd( &m_pRotations[ nSegment ].dCosine );
+		const __m128d second =
+			_mm_loadu_pd( &m_pRotations[ nSegment + 1 ].dCosine );
+		cosine = _mm_unpacklo_pd( first, second );
+		upSine = _mm_mul_pd( _mm_unpackhi_pd( first, second ), m_up );
+	}
+#endif
+
+	// public construction
+public:
+	CRotationArray( const LINEAR_ROTATION* pRotations, double dUp )
+	{
+		m_pRotations = pRotations;
+		m_dUp = dUp;
+#ifdef LINEAR_BATCH_SSE2
+		m_up = _mm_set1_pd( dUp );
+#endif
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Set the length of each segment by moving its second point along its
+// direction, where the lengths are one for all of the segments or one for
+// each (zero length segments extend to the right).
+template <class TLengths> static void SetLengths
+(
+	int nCount, const double* pX1, const double* pY1, double* pX2,
+	double* pY2, const TLengths& lengths
+)
+{
+	int n = 0;
+
+#ifdef LINEAR_BATCH_SSE2
+	const __m128d zero = _mm_setzero_pd();
+	for ( ; n + 2 <= nCount; n += 2 )
+	{
+		const __m128d x1 = _mm_loadu_pd( pX1 + n );
+		const __m128d y1 = _mm_loadu_pd( pY1 + n );
+		const __m128d length = lengths.Load( n );
+		const __m128d run = _mm_sub_pd( _mm_loadu_pd( pX2 + n ), x1 );
+		const __m128d rise = _mm_sub_pd( _mm_loadu_pd( pY2 + n ), y1 );
+		const __m128d hyp = _mm_sqrt_pd
+		(
+			_mm_add_pd( _mm_mul_pd( run, run ), _mm_mul_pd( rise, rise ) )
+		);
+
+		// the quotient of a zero length is discarded by the selection
+		const __m128d empty = _mm_cmpeq_pd( hyp, zero );
+		const __m128d scale = _mm_div_pd( length, hyp );
+		const __m128d newRun = Select( empty, length, _mm_mul_pd( run, scale ) );
+		const __m128d newRise = Select( empty, zero, _mm_mul_pd( rise, scale ) );
+		_mm_storeu_pd( pX2 + n, _mm_add_pd( x1, newRun ) );
+		_mm_storeu_pd( pY2 + n, _mm_add_pd( y1, newRise ) );
+	}
+#endif
+
+	for ( ; n < nCount; n++ )
+	{
+		double dRun = pX2[ n ] - pX1[ n ];
+		double dRise = pY2[ n ] - pY1[ n ];
+		Normalize( dRun, dRise, lengths.Get( n ) );
+		pX2[ n ] = pX1[ n ] + dRun;
+		pY2[ n ] = pY1[ n ] + dRise;
+	}
+
+} // SetLengths
+
+/////////////////////////////////////////////////////////////////////////////
+// Rotate the second point of each segment around its first point, where
+// the rotations are one for all of the segments or one for each.
+template <class TRotations> static void RotateSecondPoints
+(
+	int nCount, const double* pX1, const double* pY1, double* pX2,
+	double* pY2, const TRotations& rotations
+)
+{
+	int n = 0;
+
+#ifdef LINEAR_BATCH_SSE2
+	for ( ; n + 2 <= nCount; n += 2 )
+	{
+		__m128d cosine;
+		__m128d upSine;
+		rotations.Load( n, cosine, upSine );
+
+		const __m128d x1 = _mm_loadu_pd( pX1 + n );
+		const __m128d y1 = _mm_loadu_pd( pY1 + n );
+		const __m128d run = _mm_sub_pd( _mm_loadu_pd( pX2 + n ), x1 );
+		const __m128d rise = _mm_sub_pd( _mm_loadu_pd( pY2 + n ), y1 );
+		const __m128d newRun = _mm_sub_pd
+		(
+			_mm_mul_pd( run, cosine ), _mm_mul_pd( rise, upSine )
+		);
+		const __m128d newRise = _mm_add_pd
+		(
+			_mm_mul_pd( rise, cosine ), _mm_mul_pd( run, upSine )
+		);
+		_mm_storeu_pd( pX2 + n, _mm_add_pd( x1, newRun ) );
+		_mm_storeu_pd( pY2 + n, _mm_add_pd( y1, newRise ) );
+	}
+#endif
+
+	for ( ; n < nCount; n++ )
+	{
+		double dCosine;
+		double dUpSine;
+		rotations.Get( n, dCosine, dUpSine );
+
+		double dRun = pX2[ n ] - pX1[ n ];
+		double dRise = pY2[ n ] - pY1[ n ];
+		Rotate( dRun, dRise, dCosine, dUpSine );
+		pX2[ n ] = pX1[ n ] + dRun;
+		pY2[ n ] = pY1[ n ] + dRise;
+	}
+
+} // RotateSecondPoints
+
+/////////////////////////////////////////////////////////////////////////////
+CLinearBatch::CLinearBatch()
+{
+	// default to Y coordinate where Y gets smaller going up
+	m_nUpIncrement = -1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// the rotation for the given angle in degrees
+LINEAR_ROTATION CLinearBatch::GetRotation( double dDegrees )
+{
+	LINEAR_ROTATION value;
+	CFastTrig<CTrigPhysics>::SinCosDegrees
+	(
+		dDegrees, value.dSine, value.dCosine
+	);
+	return value;
+
+} // GetRotation
+
+/////////////////////////////////////////////////////////////////////////////
+// remove all of the segments
+void CLinearBatch::Clear()
+{
+	m_X1.clear();
+	m_Y1.clear();
+	m_X2.clear();
+	m_Y2.clear();
+
+} // Clear
+
+/////////////////////////////////////////////////////////////////////////////
+// reserve storage for the given number of segments
+void CLinearBatch::Reserve( int nSegments )
+{
+	m_X1.reserve( nSegments );
+	m_Y1.reserve( nSegments );
+	m_X2.reserve( nSegments );
+	m_Y2.reserve( nSegments );
+
+} // Reserve
+
+/////////////////////////////////////////////////////////////////////////////
+// add a segment and return its index
+int CLinearBatch::Add( double dX1, double dY1, double dX2, double dY2 )
+{
+	m_X1.push_back( dX1 );
+	m_Y1.push_back( dY1 );
+	m_X2.push_back( dX2 );
+	m_Y2.push_back( dY2 );
+	return GetCount() - 1;
+
+} // Add
+
+/////////////////////////////////////////////////////////////////////////////
+// replace the points of the given segment
+void CLinearBatch::SetPoints
+(
+	int nSegment, double dX1, double dY1, double dX2, double dY2
+)
+{
+	m_X1[ nSegment ] = dX1;
+	m_Y1[ nSegment ] = dY1;
+	m_X2[ nSegment ] = dX2;
+	m_Y2[ nSegment ] = dY2;
+
+} // SetPoints
+
+/////////////////////////////////////////////////////////////////////////////
+// move every segment by the given delta
+void CLinearBatch::Translate( double dX, double dY )
+{
+	const int nCount = GetCount();
+	double* pX1 = m_X1.data();
+	double* pY1 = m_Y1.data();
+	double* pX2 = m_X2.data();
+	double* pY2 = m_Y2.data();
+	int n = 0;
+
+#ifdef LINEAR_BATCH_SSE2
+	const __m128d dx = _mm_set1_pd( dX );
+	const __m128d dy = _mm_set1_pd( dY );
+	for ( ; n + 2 <= nCount; n += 2 )
+	{
+		_mm_storeu_pd( pX1 + n, _mm_add_pd( _mm_loadu_pd( pX1 + n ), dx ) );
+		_mm_storeu_pd( pY1 + n, _mm_add_pd( _mm_loadu_pd( pY1 + n ), dy ) );
+		_mm_storeu_pd( pX2 + n, _mm_add_pd( _mm_loadu_pd( pX2 + n ), dx ) );
+		_mm_storeu_pd( pY2 + n, _mm_add_pd( _mm_loadu_pd( pY2 + n ), dy ) );
+	}
+#endif
+
+	for ( ; n < nCount; n++ )
+	{
+		pX1[ n ] += dX;
+		pY1[ n ] += dY;
+		pX2[ n ] += dX;
+		pY2[ n ] += dY;
+	}
+
+} // Translate
+
+/////////////////////////////////////////////////////////////////////////////
+// scale every segment around its first point
+void CLinearBatch::Scale( double dFactor )
+{
+	const int nCount = GetCount();
+	const double* pX1 = m_X1.data();
+	const double* pY1 = m_Y1.data();
+	double* pX2 = m_X2.data();
+	double* pY2 = m_Y2.data();
+	int n = 0;
+
+#ifdef LINEAR_BATCH_SSE2
+	const __m128d factor = _mm_set1_pd( dFactor );
+	for ( ; n + 2 <= nCount; n += 2 )
+	{
+		const __m128d x1 = _mm_loadu_pd( pX1 + n );
+		const __m128d y1 = _mm_loadu_pd( pY1 + n );
+		const __m128d run = _mm_sub_pd( _mm_loadu_pd( pX2 + n ), x1 );
+		const __m128d rise = _mm_sub_pd( _mm_loadu_pd( pY2 + n ), y1 );
+		_mm_storeu_pd( pX2 + n, _mm_add_pd( x1, _mm_mul_pd( run, factor ) ) );
+		_mm_storeu_pd( pY2 + n, _mm_add_pd( y1, _mm_mul_pd( rise, factor ) ) );
+	}
+#endif
+
+	for ( ; n < nCount; n++ )
+	{
+		pX2[ n ] = pX1[ n ] + ( pX2[ n ] - pX1[ n ] ) * dFactor;
+		pY2[ n ] = pY1[ n ] + ( pY2[ n ] - pY1[ n ] ) * dFactor;
+	}
+
+} // Scale
+
+/////////////////////////////////////////////////////////////////////////////
+// set the length of every segment by moving its second point along
+// its direction (zero length segments extend to the right)
+void CLinearBatch::SetLength( double dLength )
+{
+	SetLengths
+	(
+		GetCount(), m_X1.data(), m_Y1.data(), m_X2.data(), m_Y2.data(),
+		CUniformLength( dLength )
+	);
+
+} // SetLength
+
+/////////////////////////////////////////////////////////////////////////////
+// set the length of each segment from an array with one length per
+// segment
+void CLinearBatch::SetLength( const double* pLengths )
+{
+	SetLengths
+	(
+		GetCount(), m_X1.data(), m_Y1.data(), m_X2.data(), m_Y2.data(),
+		CLengthArray( pLengths )
+	);
+
+} // SetLength
+
+/////////////////////////////////////////////////////////////////////////////
+// rotate the second point of every segment around its first point
+void CLinearBatch::RotateAroundFirstPoint( double dDegrees )
+{
+	RotateAroundFirstPoint( GetRotation( dDegrees ) );
+
+} // RotateAroundFirstPoint
+
+/////////////////////////////////////////////////////////////////////////////
+// rotate the second point of every segment around its first point
+void CLinearBatch::RotateAroundFirstPoint( const LINEAR_ROTATION& rotation )
+{
+	RotateSecondPoints
+	(
+		GetCount(), m_X1.data(), m_Y1.data(), m_X2.data(), m_Y2.data(),
+		CUniformRotation( rotation, m_nUpIncrement )
+	);
+
+} // RotateAroundFirstPoint
+
+/////////////////////////////////////////////////////////////////////////////
+// rotate the second point of each segment around its first point
+// from an array with one rotation per segment
+void CLinearBatch::RotateAroundFirstPoint( const LINEAR_ROTATION* pRotations )
+{
+	RotateSecondPoints
+	(
+		GetCount(), m_X1.data(), m_Y1.data(), m_X2.data(), m_Y2.data(),
+		CRotationArray( pRotations, m_nUpIncrement )
+	);
+
+} // RotateAroundFirstPoint
+
+/////////////////////////////////////////////////////////////////////////////
+// rotate both points of every segment around a common center
+void CLinearBatch::RotateAroundPoint( double dX, double dY, double dDegrees )
+{
+	const LINEAR_ROTATION rotation = GetRotation( dDegrees );
+	const double dCosine = rotation.dCosine;
+	const double dUpSine = m_nUpIncrement * rotation.dSine;
+	const int nCount = GetCount();
+
+	// both points are offsets from the center, so the same rotation is
+	// applied to the array of first points and then the second points
+	double* pX[ 2 ] = { m_X1.data(), m_X2.data() };
+	double* pY[ 2 ] = { m_Y1.data(), m_Y2.data() };
+	for ( int nPoint = 0; nPoint < 2; nPoint++ )
+	{
+		double* pXn = pX[ nPoint ];
+		double* pYn = pY[ nPoint ];
+		int n = 0;
+
+#ifdef LINEAR_BATCH_SSE2
+		const __m128d cx = _mm_set1_pd( dX );
+		const __m128d cy = _mm_set1_pd( dY );
+		const __m128d cosine = _mm_set1_pd( dCosine );
+		const __m128d upSine = _mm_set1_pd( dUpSine );
+		for ( ; n + 2 <= nCount; n += 2 )
+		{
+			const __m128d run = _mm_sub_pd( _mm_loadu_pd( pXn + n ), cx );
+			const __m128d rise = _mm_sub_pd( _mm_loadu_pd( pYn + n ), cy );
+			const __m128d newRun = _mm_sub_pd
+			(
+				_mm_mul_pd( run, cosine ), _mm_mul_pd( rise, upSine )
+			);
+			const __m128d newRise = _mm_add_pd
+			(
+				_mm_mul_pd( rise, cosine ), _mm_mul_pd( run, upSine )
+			);
+			_mm_storeu_pd( pXn + n, _mm_add_pd( cx, newRun ) );
+			_mm_storeu_pd( pYn + n, _mm_add_pd( cy, newRise ) );
+		}
+#endif
+
+		for ( ; n < nCount; n++ )
+		{
+			double dRun = pXn[ n ] - dX;
+			double dRise = pYn[ n ] - dY;
+			Rotate( dRun, dRise, dCosine, dUpSine );
+			pXn[ n ] = dX + dRun;
+			pYn[ n ] = dY + dRise;
+		}
+	}
+
+} // RotateAroundPoint
+
+/////////////////////////////////////////////////////////////////////////////
+// Build the two sides of the arrowhead of every segment where each side
+// starts at the second point and is turned the given angle either way
+// from the reverse of the segment. The sides replace the contents of the
+// positive and negative batches.
+void CLinearBatch::CreateArrowheads
+(
+	double dLength, double dDegrees,
+	CLinearBatch& positive, CLinearBatch& negative
+) const
+{
+	const int nCount = GetCount();
+	const LINEAR_ROTATION rotation = GetRotation( dDegrees );
+	const double dCosine = rotation.dCosine;
+	const double dUpSine = m_nUpIncrement * rotation.dSine;
+
+	// both sides start at the second points
+	positive.m_X1 = m_X2;
+	positive.m_Y1 = m_Y2;
+	positive.m_X2.resize( nCount );
+	positive.m_Y2.resize( nCount );
+	positive.m_nUpIncrement = m_nUpIncrement;
+	negative.m_X1 = m_X2;
+	negative.m_Y1 = m_Y2;
+	negative.m_X2.resize( nCount );
+	negative.m_Y2.resize( nCount );
+	negative.m_nUpIncrement = m_nUpIncrement;
+
+	const double* pX1 = m_X1.data();
+	const double* pY1 = m_Y1.data();
+	const double* pX2 = m_X2.data();
+	const double* pY2 = m_Y2.data();
+	double* pPositiveX = positive.m_X2.data();
+	double* pPositiveY = positive.m_Y2.data();
+	double* pNegativeX = negative.m_X2.data();
+	double* pNegativeY = negative.m_Y2.data();
+	int n = 0;
+
+#ifdef LINEAR_BATCH_SSE2
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d length = _mm_set1_pd( -dLength );
+	const __m128d cosine = _mm_set1_pd( dCosine );
+	const __m128d upSine = _mm_set1_pd( dUpSine );
+	for ( ; n + 2 <= nCount; n += 2 )
+	{
+		const __m128d x2 = _mm_loadu_pd( pX2 + n );
+		const __m128d y2 = _mm_loadu_pd( pY2 + n );
+		const __m128d run = _mm_sub_pd( x2, _mm_loadu_pd( pX1 + n ) );
+		const __m128d rise = _mm_sub_pd( y2, _mm_loadu_pd( pY1 + n ) );
+		const __m128d hyp = _mm_sqrt_pd
+		(
+			_mm_add_pd( _mm_mul_pd( run, run ), _mm_mul_pd( rise, rise ) )
+		);
+
+		// reverse of the segment with the length of the arrowhead
+		const __m128d empty = _mm_cmpeq_pd( hyp, zero );
+		const __m128d scale = _mm_div_pd( length, hyp );
+		const __m128d backRun = Select( empty, length, _mm_mul_pd( run, scale ) );
+		const __m128d backRise = Select( empty, zero, _mm_mul_pd( rise, scale ) );
+
+		const __m128d runCosine = _mm_mul_pd( backRun, cosine );
+		const __m128d riseCosine = _mm_mul_pd( backRise, cosine );
+		const __m128d runSine = _mm_mul_pd( backRun, upSine );
+		const __m128d riseSine = _mm_mul_pd( backRise, upSine );
+		_mm_storeu_pd
+		(
+			pPositiveX + n, _mm_add_pd( x2, _mm_sub_pd( runCosine, riseSine ) )
+		);
+		_mm_storeu_pd
+		(
+			pPositiveY + n, _mm_add_pd( y2, _mm_add_pd( riseCosine, runSine ) )
+		);
+		_mm_storeu_pd
+		(
+			pNegativeX + n, _mm_add_pd( x2, _mm_add_pd( runCosine, riseSine ) )
+		);
+		_mm_storeu_pd
+		(
+			pNegativeY + n, _mm_add_pd( y2, _mm_sub_pd( riseCosine, runSine ) )
+		);
+	}
+#endif
+
+	for ( ; n < nCount; n++ )
+	{
+		double dRun = pX2[ n ] - pX1[ n ];
+		double dRise = pY2[ n ] - pY1[ n ];
+		Normalize( dRun, dRise, -dLength );
+
+		double dRun1 = dRun;
+		double dRise1 = dRise;
+		Rotate( dRun1, dRise1, dCosine, dUpSine );
+		pPositiveX[ n ] = pX2[ n ] + dRun1;
+		pPositiveY[ n ] = pY2[ n ] + dRise1;
+
+		double dRun2 = dRun;
+		double dRise2 = dRise;
+		Rotate( dRun2, dRise2, dCosine, -dUpSine );
+		pNegativeX[ n ] = pX2[ n ] + dRun2;
+		pNegativeY[ n ] = pY2[ n ] + dRise2;
+	}
+
+} // CreateArrowheads
+
+/////////////////////////////////////////////////////////////////////////////
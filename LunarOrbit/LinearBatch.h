@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// a rotation by a fixed angle kept as its cosine and sine so the same
+// rotation can be applied to many segments with a single call to the
+// trigonometry library
+struct LINEAR_ROTATION
+{
+	double dCosine; // cosine of the angle of rotation
+	double dSine; // sine of the angle of rotation
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Many line segments stored as a structure of arrays so rotations, length
+// changes and translations are applied to all of them in one pass. The
+// operations follow CLinear: angles are in degrees, positive angles turn
+// counter clockwise when the up increment matches the device context and
+// rotations are around the first point unless a center is given. Pairs
+// of segments are processed together with SSE2 when the compiler targets
+// it, otherwise one at a time.
+//
+// Segments are exchanged with any class that has the CLinear accessors
+// (GetX1, SetX1 and so on), so this header does not depend on MFC.
+class CLinearBatch
+{
+	// protected data
+protected:
+	vector<double> m_X1; // x co-ordinates of the first points
+	vector<double> m_Y1; // y co-ordinates of the first points
+	vector<double> m_X2; // x co-ordinates of the second points
+	vector<double> m_Y2; // y co-ordinates of the second points
+
+	// increment amount to move up the DC one pixel (1 or -1)
+	int m_nUpIncrement;
+
+	// public properties
+public:
+	// number of segments in the batch
+	int GetCount() const
+	{
+		return (int)m_X1.size();
+	}
+
+	// increment amount to move up the DC one pixel (1 or -1)
+	int GetUpIncrement() const
+	{
+		return m_nUpIncrement;
+	}
+	// increment amount to move up the DC one pixel (1 or -1)
+	void SetUpIncrement( int value = -1 )
+	{
+		m_nUpIncrement = value;
+	}
+
+	// x co-ordinate of the first point of the given segment
+	double GetX1( int nSegment ) const
+	{
+		return m_X1[ nSegment ];
+	}
+	// y co-ordinate of the first point of the given segment
+	double GetY1( int nSegment ) const
+	{
+		return m_Y1[ nSegment ];
+	}
+	// x co-ordinate of the second point of the given segment
+	double GetX2( int nSegment ) const
+	{
+		return m_X2[ nSegment ];
+	}
+	// y co-ordinate of the second point of the given segment
+	double GetY2( int nSegment ) const
+	{
+		return m_Y2[ nSegment ];
+	}
+
+	// public methods
+public:
+	// the rotation for the given angle in degrees
+	static LINEAR_ROTATION GetRotation( double dDegrees );
+
+	// remove all of the segments
+	void Clear();
+
+	// reserve storage for the given number of segments
+	void Reserve( int nSegments );
+
+	// add a segment and return its index
+	int Add( double dX1, double dY1, double dX2, double dY2 );
+
+	// add a copy of a line and return its index
+	template <class TLine> int Add( const TLine& line )
+	{
+		return Add( line.GetX1(), line.GetY1(), line.GetX2(), line.GetY2() );
+	}
+
+	// replace the points of the given segment
+	void SetPoints
+	(
+		int nSegment, double dX1, double dY1, double dX2, double dY2
+	);
+
+	// copy the points of the given segment into a line
+	template <class TLine> void GetLine( int nSegment, TLine& line ) const
+	{
+		line.SetX1( m_X1[ nSegment ] );
+		line.SetY1( m_Y1[ nSegment ] );
+		line.SetX2( m_X2[ nSegment ] );
+		line.SetY2( m_Y2[ nSegment ] );
+	}
+
+	// move every segment by the given delta
+	void Translate( double dX, double dY );
+
+	// scale every segment around its first point
+	void Scale( double dFactor );
+
+	// set the length of every segment by moving its second point along
+	// its direction (zero length segments extend to the right)
+	void SetLength( double dLength );
+
+	// set the length of each segment from an array with one length per
+	// segment
+	void SetLength( const double* pLengths );
+
+	// rotate the second point of every segment around its first point
+	void RotateAroundFirstPoint( double dDegrees );
+
+	// rotate the second point of every segment around its first point
+	void RotateAroundFirstPoint( const LINEAR_ROTATION& rotation );
+
+	// rotate the second point of each segment around its first point
+	// from an array with one rotation per segment
+	void RotateAroundFirstPoint( const LINEAR_ROTATION* pRotations );
+
+	// rotate both points of every segment around a common center
+	void RotateAroundPoint( double dX, double dY, double dDegrees );
+
+	// Build the two sides of the arrowhead of every segment (see
+	// CMagnitudeVector::CreateArrowhead) where each side starts at the
+	// second point and is turned the given angle either way from the
+	// reverse of the segment. The sides replace the contents of the
+	// positive and negative batches.
+	void CreateArrowheads
+	(
+		double dLength, double dDegrees,
+		CLinearBatch& positive, CLinearBatch& negative
+	) const;
+
+	// public construction
+public:
+	CLinearBatch();
+};
+
+/////////////////////////////////////////////////////////////////////////////
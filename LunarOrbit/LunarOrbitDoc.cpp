@@ -12,6 +12,12 @@
 #define new DEBUG_NEW
 #endif
 
+// first four bytes of a document, which spell LOCP in the file
+static const DWORD CHECKPOINT_MAGIC = 0x50434F4C;
+
+// version of the checkpoint written in a document
+static const DWORD CHECKPOINT_VERSION = 2;
+
 /////////////////////////////////////////////////////////////////////////////
 IMPLEMENT_DYNCREATE(CLunarOrbitDoc, CBaseDoc)
 
@@ -59,6 +65,15 @@ CLunarOrbitDoc::CLunarOrbitDoc()
 	SampleTime = 1; // seconds
 	const double dSamplesPerDay = SamplesPerDay;
 	RunningTime = 0; // seconds
+
+	// the original lagged Euler scheme, where any of the Runge-Kutta
+	// methods can be selected to trade speed for accuracy
+	Integrator = INTEGRATOR_EULER;
+
+	// the model runs until it is paused
+	SingleOrbit = false;
+	ThirtyDegreeSteps = false;
+
 	const double dLunarPeriod = LunarPeriod;
 
 	// the distance vector starts at the moon's center and ends at
@@ -157,6 +172,85 @@ CLunarOrbitDoc::~CLunarOrbitDoc()
 {
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// sensitivity of the moon's state after the given number of seconds to the
+// initial conditions (the state transition matrix and the derivatives with
+// respect to LunarVelocity and MoonDistance) integrated alongside the state
+// instead of differencing pairs of complete simulations
+void CLunarOrbitDoc::GetSensitivity( double dSeconds, LUNAR_SENSITIVITY& value )
+{
+	LUNAR_STATE state = InitialLunarState;
+
+	// only the gravity ratio and the time slice are used by the
+	// variational propagation
+	LUNAR_PARAMETERS params = {};
+	params.dGravityRatio = AccelerationOfGravity / MoonDistance;
+	params.dSampleTime = SampleTime;
+
+	const int nSteps = (int)( dSeconds / SampleTime );
+
+	CVariationalPropagator::Propagate
+	(
+		Integrator, state, params, nSteps, value
+	);
+
+} // GetSensitivity
+
+/////////////////////////////////////////////////////////////////////////////
+// exact derivatives of the moon's state after the given number of seconds
+// with respect to MoonDistance, LunarVelocity and MassOfTheEarth where
+// each parameter is one lane of a dual number propagated with the state
+void CLunarOrbitDoc::GetDerivatives( double dSeconds, LUNAR_DERIVATIVES& value )
+{
+	typedef CDual<3> DUAL;
+	const DUAL distance = DUAL::Variable( MoonDistance, 0 );
+	const DUAL velocity = DUAL::Variable( LunarVelocity, 1 );
+	const DUAL mass = DUAL::Variable( MassOfTheEarth, 2 );
+
+	// the gravity ratio is the acceleration of gravity divided by the
+	// distance to the moon (GM/R^3)
+	const DUAL k =
+		GravitationalConstant * mass / ( distance * distance * distance );
+
+	// the initial conditions of the model (see InitialLunarState)
+	CStateVector<DUAL, 4> y;
+	y[ 0 ] = -distance;
+	y[ 1 ] = 0;
+	y[ 2 ] = 0;
+	y[ 3 ] = velocity;
+
+	const int nSteps = (int)( dSeconds / SampleTime );
+	CPropagator::Integrate( Integrator, y, k, SampleTime, nSteps );
+
+	for ( int n = 0; n < 4; n++ )
+	{
+		value.dState[ n ] = y[ n ].GetValue();
+		value.dMoonDistance[ n ] = y[ n ].GetDerivative( 0 );
+		value.dLunarVelocity[ n ] = y[ n ].GetDerivative( 1 );
+		value.dMassOfTheEarth[ n ] = y[ n ].GetDerivative( 2 );
+	}
+
+} // GetDerivatives
+
+/////////////////////////////////////////////////////////////////////////////
+// correct the initial conditions and the period so the orbit closes
+// exactly, where the single orbit mode only stops when the X distance
+// starts increasing again
+bool CLunarOrbitDoc::FindPeriodicOrbit( PERIODIC_ORBIT& value )
+{
+	CPeriodicOrbitFinder finder
+	(
+		AccelerationOfGravity / MoonDistance, SampleTime
+	);
+	finder.SetIntegrator( Integrator );
+
+	const bool bConverged =
+		finder.Find( InitialLunarState, LunarPeriod, value );
+
+	return bConverged;
+
+} // FindPeriodicOrbit
+
 /////////////////////////////////////////////////////////////////////////////
 BOOL CLunarOrbitDoc::OnNewDocument()
 {
@@ -170,15 +264,164 @@ BOOL CLunarOrbitDoc::OnNewDocument()
 }
 
 /////////////////////////////////////////////////////////////////////////////
+// Tell the views the contents are about to be replaced, before a document
+// is read or a new one is started, so a model still running stops before
+// it can write the old run over the new contents.
+void CLunarOrbitDoc::DeleteContents()
+{
+	UpdateAllViews( nullptr, HINT_DELETE_CONTENTS );
+	CBaseDoc::DeleteContents();
+
+} // DeleteContents
+
+/////////////////////////////////////////////////////////////////////////////
+// Write the state of the simulation to a checkpoint, which is everything
+// the model needs to go on from where it is: the state of the moon with
+// the running time, the constants of the model, the integrator, the stop
+// conditions and the trail.
+void CLunarOrbitDoc::SaveCheckpoint( CCheckpoint& checkpoint )
+{
+	checkpoint.Put( LunarState );
+	checkpoint.Put( SampleTime );
+	checkpoint.Put( MoonDistance );
+	checkpoint.Put( MoonInches );
+	checkpoint.Put( LunarVelocity );
+	checkpoint.Put( MassOfTheEarth );
+	checkpoint.Put( int( Integrator ) );
+	checkpoint.Put( (unsigned char)SingleOrbit );
+	checkpoint.Put( (unsigned char)ThirtyDegreeSteps );
+	TrailHistory.Save( checkpoint );
+
+} // SaveCheckpoint
+
+/////////////////////////////////////////////////////////////////////////////
+// Read the state of the simulation from a checkpoint and return false if it
+// does not hold one, in which case the document is unchanged. Everything
+// is read and checked before any of it is given to the document.
+bool CLunarOrbitDoc::LoadCheckpoint( CCheckpoint& checkpoint )
+{
+	LUNAR_STATE state;
+	double dSampleTime = 0;
+	double dMoonDistance = 0;
+	double dMoonInches = 0;
+	double dLunarVelocity = 0;
+	double dMassOfTheEarth = 0;
+	int nIntegrator = 0;
+	unsigned char nSingleOrbit = 0;
+	unsigned char nThirtyDegreeSteps = 0;
+	if
+	(
+		!checkpoint.Get( state ) || !checkpoint.Get( dSampleTime ) ||
+		!checkpoint.Get( dMoonDistance ) || !checkpoint.Get( dMoonInches ) ||
+		!checkpoint.Get( dLunarVelocity ) ||
+		!checkpoint.Get( dMassOfTheEarth ) ||
+		!checkpoint.Get( nIntegrator ) || !checkpoint.Get( nSingleOrbit ) ||
+		!checkpoint.Get( nThirtyDegreeSteps )
+	)
+	{
+		return false;
+	}
+
+	// the constants the model divides by must be positive
+	if
+	(
+		!( dSampleTime > 0 ) || !( dMoonDistance > 0 ) ||
+		!( dMoonInches > 0 ) || !( dMassOfTheEarth > 0 )
+	)
+	{
+		return false;
+	}
+	if ( nIntegrator < INTEGRATOR_EULER || nIntegrator > INTEGRATOR_TSITOURAS5 )
+	{
+		return false;
+	}
+
+	CTrailHistory history;
+	if ( !history.Load( checkpoint ) || !checkpoint.IsEnd() )
+	{
+		return false;
+	}
+
+	SampleTime = dSampleTime;
+	MoonDistance = dMoonDistance;
+	MoonInches = dMoonInches;
+	LunarVelocity = dLunarVelocity;
+	MassOfTheEarth = dMassOfTheEarth;
+	Integrator = INTEGRATOR( nIntegrator );
+	SingleOrbit = nSingleOrbit != 0;
+	ThirtyDegreeSteps = nThirtyDegreeSteps != 0;
+	LunarState = state;
+	swap( m_TrailHistory, history );
+	return true;
+
+} // LoadCheckpoint
+
+/////////////////////////////////////////////////////////////////////////////
+// A document is a checkpoint of the simulation after a header of the magic
+// number, the version, the size of the checkpoint in bytes and its CRC-32.
+// The checkpoint is put together in memory and written in one call, and
+// read back in one call and checked against the CRC before the document
+// is changed, so a damaged file is never half loaded.
 void CLunarOrbitDoc::Serialize(CArchive& ar)
 {
 	if (ar.IsStoring())
 	{
-		// TODO: add storing code here
+		CCheckpoint checkpoint;
+		SaveCheckpoint( checkpoint );
+
+		const DWORD dwSize = (DWORD)checkpoint.GetSize();
+		const DWORD dwCRC = checkpoint.GetCRC();
+		ar << CHECKPOINT_MAGIC << CHECKPOINT_VERSION << dwSize << dwCRC;
+		ar.Write( checkpoint.GetData(), dwSize );
 	}
 	else
 	{
-		// TODO: add loading code here
+		DWORD dwMagic = 0;
+		DWORD dwVersion = 0;
+		DWORD dwSize = 0;
+		DWORD dwCRC = 0;
+		ar >> dwMagic >> dwVersion >> dwSize >> dwCRC;
+		if ( dwMagic != CHECKPOINT_MAGIC )
+		{
+			AfxThrowArchiveException
+			(
+				CArchiveException::badClass, ar.m_strFileName
+			);
+		}
+		if ( dwVersion != CHECKPOINT_VERSION )
+		{
+			AfxThrowArchiveException
+			(
+				CArchiveException::badSchema, ar.m_strFileName
+			);
+		}
+
+		// the size is checked against the file before it is allocated
+		CFile* pFile = ar.GetFile();
+		if ( pFile != nullptr && dwSize > pFile->GetLength() )
+		{
+			AfxThrowArchiveException
+			(
+				CArchiveException::endOfFile, ar.m_strFileName
+			);
+		}
+
+		CCheckpoint checkpoint;
+		checkpoint.SetSize( dwSize );
+		if ( ar.Read( checkpoint.GetData(), dwSize ) != dwSize )
+		{
+			AfxThrowArchiveException
+			(
+				CArchiveException::endOfFile, ar.m_strFileName
+			);
+		}
+		if ( checkpoint.GetCRC() != dwCRC || !LoadCheckpoint( checkpoint ) )
+		{
+			AfxThrowArchiveException
+			(
+				CArchiveException::genericException, ar.m_strFileName
+			);
+		}
 	}
 }
 
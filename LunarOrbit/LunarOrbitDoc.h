@@ -6,6 +6,11 @@
 #pragma once
 #include "BaseDoc.h"
 #include "MagnitudeVector.h"
+#include "PeriodicOrbit.h"
+#include "TrailHistory.h"
+
+// the hint the document gives its views before its contents are replaced
+static const LPARAM HINT_DELETE_CONTENTS = 1;
 
 /////////////////////////////////////////////////////////////////////////////
 class CLunarOrbitDoc : public CBaseDoc
@@ -30,6 +35,12 @@ protected: // create from serialization only
 	double m_dAccelerationOfGravity; // meters per second squared
 	double m_dLunarGravityX; // X Vector of the acceleration of gravity
 	double m_dLunarGravityY; // Y Vector of the acceleration of gravity
+	INTEGRATOR m_eIntegrator; // method used to advance the moon's state
+	bool m_bSingleOrbit; // stop the model after a single orbit
+	bool m_bThirtyDegreeSteps; // stop the model every 30 degrees
+
+	// the trail in meters from the earth over the last few orbits
+	CTrailHistory m_TrailHistory;
 
 	// these are the vectors describing acceleration of the moon
 	CMagnitudeVector m_GravityVector;
@@ -314,6 +325,15 @@ public:
 	__declspec( property( get = GetLunarPeriod ) )
 		double LunarPeriod;
 
+	// universal gravitational constant in Nm2kg-2
+	double GetGravitationalConstant()
+	{
+		return 6.657e-11;
+	}
+	// universal gravitational constant in Nm2kg-2
+	__declspec( property( get = GetGravitationalConstant ) )
+		double GravitationalConstant;
+
 	// absolute value of acceleration of gravity on the moon from the earth
 	double GetAccelerationOfGravity()
 	{
@@ -324,7 +344,7 @@ public:
 		// R is radius (distance to the moon) in meters
 
 		// universal gravitational constant
-		const double dG = 6.657e-11;
+		const double dG = GravitationalConstant;
 		const double dM = MassOfTheEarth;
 		const double dR = MoonDistance;
 
@@ -460,6 +480,107 @@ public:
 	__declspec( property( get = GetRunningTime, put = SetRunningTime ) )
 		double RunningTime;
 
+	// the position, velocity, acceleration and running time of the moon
+	// as a single state for the propagator
+	LUNAR_STATE GetLunarState()
+	{
+		LUNAR_STATE value;
+		value.dX = MoonX;
+		value.dY = MoonY;
+		value.dVx = LunarVelocityX;
+		value.dVy = LunarVelocityY;
+		value.dAx = LunarGravityX;
+		value.dAy = LunarGravityY;
+		value.dTime = RunningTime;
+		return value;
+	}
+	// the position, velocity, acceleration and running time of the moon
+	// as a single state for the propagator
+	void SetLunarState( const LUNAR_STATE& value )
+	{
+		MoonX = value.dX;
+		MoonY = value.dY;
+		LunarVelocityX = value.dVx;
+		LunarVelocityY = value.dVy;
+		LunarGravityX = value.dAx;
+		LunarGravityY = value.dAy;
+		RunningTime = value.dTime;
+	}
+	// the position, velocity, acceleration and running time of the moon
+	// as a single state for the propagator
+	__declspec( property( get = GetLunarState, put = SetLunarState ) )
+		LUNAR_STATE LunarState;
+
+	// the initial conditions of the model as a state for the propagator
+	// where the moon starts left of the earth moving down at LunarVelocity
+	// (the same conditions set by the constructor)
+	LUNAR_STATE GetInitialLunarState()
+	{
+		LUNAR_STATE value;
+		value.dX = -MoonDistance;
+		value.dY = 0;
+		value.dVx = 0;
+		value.dVy = LunarVelocity;
+		value.dAx = -AccelerationOfGravity;
+		value.dAy = 0;
+		value.dTime = 0;
+		return value;
+	}
+	// the initial conditions of the model as a state for the propagator
+	__declspec( property( get = GetInitialLunarState ) )
+		LUNAR_STATE InitialLunarState;
+
+	// method used to advance the moon's state each time slice
+	INTEGRATOR GetIntegrator()
+	{
+		return m_eIntegrator;
+	}
+	// method used to advance the moon's state each time slice
+	void SetIntegrator( INTEGRATOR value )
+	{
+		m_eIntegrator = value;
+	}
+	// method used to advance the moon's state each time slice
+	__declspec( property( get = GetIntegrator, put = SetIntegrator ) )
+		INTEGRATOR Integrator;
+
+	// stop the model after a single orbit
+	bool GetSingleOrbit()
+	{
+		return m_bSingleOrbit;
+	}
+	// stop the model after a single orbit
+	void SetSingleOrbit( bool value )
+	{
+		m_bSingleOrbit = value;
+	}
+	// stop the model after a single orbit
+	__declspec( property( get = GetSingleOrbit, put = SetSingleOrbit ) )
+		bool SingleOrbit;
+
+	// stop the model every 30 degrees
+	bool GetThirtyDegreeSteps()
+	{
+		return m_bThirtyDegreeSteps;
+	}
+	// stop the model every 30 degrees
+	void SetThirtyDegreeSteps( bool value )
+	{
+		m_bThirtyDegreeSteps = value;
+	}
+	// stop the model every 30 degrees
+	__declspec( property( get = GetThirtyDegreeSteps, put = SetThirtyDegreeSteps ) )
+		bool ThirtyDegreeSteps;
+
+	// the trail in meters from the earth over the last few orbits
+	inline CTrailHistory& GetTrailHistory()
+	{
+		return m_TrailHistory;
+	}
+	// the trail in meters from the earth over the last few orbits
+	__declspec( property( get = GetTrailHistory ) )
+		CTrailHistory& TrailHistory;
+
 	// get a pointer to the view
 	CView* GetView()
 	{
@@ -604,11 +725,31 @@ public:
 
 	// Operations
 public:
+	// sensitivity of the moon's state after the given number of seconds
+	// to the initial conditions in one augmented propagation
+	void GetSensitivity( double dSeconds, LUNAR_SENSITIVITY& value );
+
+	// exact derivatives of the moon's state after the given number of
+	// seconds with respect to MoonDistance, LunarVelocity and MassOfTheEarth
+	// by propagating dual numbers in one pass
+	void GetDerivatives( double dSeconds, LUNAR_DERIVATIVES& value );
+
+	// correct the initial conditions and the period so the orbit closes
+	// exactly starting from the model's initial conditions and period
+	bool FindPeriodicOrbit( PERIODIC_ORBIT& value );
+
+	// write the state of the simulation to a checkpoint
+	void SaveCheckpoint( CCheckpoint& checkpoint );
+
+	// read the state of the simulation from a checkpoint and return false
+	// if it does not hold one, in which case the document is unchanged
+	bool LoadCheckpoint( CCheckpoint& checkpoint );
 
 // Overrides
 public:
 	virtual BOOL OnNewDocument();
 	virtual void Serialize(CArchive& ar);
+	virtual void DeleteContents();
 
 // Implementation
 public:
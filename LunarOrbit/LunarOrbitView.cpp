@@ -7,6 +7,8 @@
 #include "LunarOrbit.h"
 #include "LunarOrbitDoc.h"
 #include "LunarOrbitView.h"
+#include "AllocationCounter.h"
+#include <chrono>
 
 #ifdef _DEBUG
 #define new DEBUG_NEW
@@ -14,6 +16,24 @@
 
 #define _DOUBLE_BUFFER
 
+// text angle in tenths of a degree BuildFont gives vertical text, where
+// moving up is a negative value
+static const int VERTICAL_ESCAPEMENT = -900;
+
+// milliseconds between the frames drawn while the model is running
+static const UINT DISPLAY_INTERVAL = 16;
+
+// simulated seconds in a second of wall time unless the time warp is set,
+// which is an hour every 10 milliseconds as when the timer ran the model
+static const double DEFAULT_TIME_WARP = 360000;
+
+// seconds the model can run in a frame unless the frame budget is set,
+// which leaves the rest of the frame interval for the user interface
+static const double DEFAULT_FRAME_BUDGET = 0.008;
+
+// orbits a fast forward runs before giving up on reaching a stop condition
+static const int FAST_FORWARD_ORBITS = 100;
+
 /////////////////////////////////////////////////////////////////////////////
 IMPLEMENT_DYNCREATE(CLunarOrbitView, CBaseView)
 
@@ -36,21 +56,39 @@ BEGIN_MESSAGE_MAP(CLunarOrbitView, CBaseView)
 	ON_UPDATE_COMMAND_UI( ID_EDIT_SINGLEORBIT, &CLunarOrbitView::OnUpdateEditSingleorbit )
 	ON_COMMAND( ID_EDIT_30DEGSTEPS, &CLunarOrbitView::OnEdit30DegSteps )
 	ON_UPDATE_COMMAND_UI( ID_EDIT_30DEGSTEPS, &CLunarOrbitView::OnUpdateEdit30DegSteps )
+	ON_COMMAND( ID_EDIT_FASTFORWARD, &CLunarOrbitView::OnEditFastForward )
+	ON_UPDATE_COMMAND_UI( ID_EDIT_FASTFORWARD, &CLunarOrbitView::OnUpdateEditFastForward )
+	ON_COMMAND( ID_EDIT_RECORD, &CLunarOrbitView::OnEditRecord )
+	ON_UPDATE_COMMAND_UI( ID_EDIT_RECORD, &CLunarOrbitView::OnUpdateEditRecord )
 END_MESSAGE_MAP()
 
 /////////////////////////////////////////////////////////////////////////////
-CLunarOrbitView::CLunarOrbitView()
+CLunarOrbitView::CLunarOrbitView() :
+	m_GdiTarget( m_Styles )
 {
 	Running = false;
-	SingleOrbit = false;
-	ThirtyDegreeSteps = false;
 	TopOfView = 0;
 	AngleError = 0.01; // tenth of a degree
+	TrailOrbits = 8;
+	TimeWarp = DEFAULT_TIME_WARP;
+	FrameBudget = DEFAULT_FRAME_BUDGET;
+	m_Simulation.SetFrameInterval( DISPLAY_INTERVAL / 1000.0 );
+	m_nOrbitFirstSample = 0;
+	m_nTrailStale = 0;
+	m_nLastBatch = 0;
+	m_bTrailDamage = false;
+	m_TrailProjection.nEarthX = 0;
+	m_TrailProjection.nEarthY = 0;
+	m_TrailProjection.dMoonScaling = 0;
+	m_TrailProjection.nMap = 0;
 }
 
 /////////////////////////////////////////////////////////////////////////////
 CLunarOrbitView::~CLunarOrbitView()
 {
+	// the thread stops before the recording it writes to is closed
+	m_Simulation.Stop();
+	m_Recorder.Close();
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -71,54 +109,171 @@ void CLunarOrbitView::render
 {
 	CBaseView::render( pDC, dLeftOfView, dTopOfView );
 
+	// the static parts are drawn under the moving parts
+	RenderBackground( pDC );
+	RenderForeground( pDC );
+
+} // render
+
+/////////////////////////////////////////////////////////////////////////////
+// render the parts of the view that do not move
+void CLunarOrbitView::RenderBackground( CDC* pDC )
+{
+	// the equations, grid, scale and earth do not move, so they are
+	// recorded the first time the view is drawn
+	if ( m_StaticList.IsEmpty() )
+	{
+		// render Newton's equations of motion
+		RenderEquations( m_StaticList );
+
+		// render the grid labels
+		RenderGridLabels( m_StaticList );
+
+		// draw the document grid
+		RenderGrid( m_StaticList );
+
+		// draw the X and Y scale labels
+		RenderScale( m_StaticList );
+
+		// draw the earth's shape
+		RenderEarth( m_StaticList );
+	}
+
+	m_GdiTarget.Draw( pDC, m_StaticList );
+
+} // RenderBackground
+
+/////////////////////////////////////////////////////////////////////////////
+// render the parts of the view that move with the moon
+void CLunarOrbitView::RenderForeground( CDC* pDC )
+{
+	// everything else changes as the moon moves and is recorded again
+	// every frame into the same storage
+	m_DynamicList.Clear();
+
+	// only the runs of the orbital path that touch the area being drawn
+	// are recorded
+	CRect rectClip;
+	pDC->GetClipBox( &rectClip );
+
+	// logical units in a pixel pick the level of detail of the trail
+	CSize sizePixels( 1000, 1000 );
+	pDC->DPtoLP( &sizePixels );
+	const double dUnitsPerPixel = abs( sizePixels.cx ) / 1000.0;
+
 	// draw the lunar orbit up to this point in time
-	RenderLunarOrbit( pDC );
+	RenderLunarOrbit( m_DynamicList, rectClip, dUnitsPerPixel );
 
-	// render Newton's equations of motion
-	RenderEquations( pDC );
+	// the moon, its vectors and the text that changes with them
+	RenderMovingParts( m_DynamicList );
 
+	m_GdiTarget.Draw( pDC, m_DynamicList );
+
+} // RenderForeground
+
+/////////////////////////////////////////////////////////////////////////////
+// render the moon, its vectors and the text that changes with them
+void CLunarOrbitView::RenderMovingParts( CDisplayList& list )
+{
 	// render the initial condition text
-	RenderInitialConditions( pDC );
+	RenderInitialConditions( list );
 
 	// render the distance text information
-	RenderDistanceText( pDC );
+	RenderDistanceText( list );
 
 	// render the gravity text information
-	RenderGravityText( pDC );
+	RenderGravityText( list );
 
 	// render the velocity text information
-	RenderVelocityText( pDC );
+	RenderVelocityText( list );
 
-	// render the grid labels
-	RenderGridLabels( pDC );
+	// draw the moon's shape
+	RenderMoon( list );
 
-	//// draw the textual information 
-	//RenderText( pDC );
+	// render the distance vector
+	RenderDistance( list );
 
-	// draw the document grid
-	RenderGrid( pDC );
+	// render the acceleration vector
+	RenderAcceleration( list );
 
-	// draw the X and Y scale labels
-	RenderScale( pDC );
+	// render the velocity vector
+	RenderVelocity( list );
 
-	// draw the moon's shape
-	RenderMoon( pDC );
+} // RenderMovingParts
 
-	// draw the earth's shape
-	RenderEarth( pDC );
+/////////////////////////////////////////////////////////////////////////////
+// Invalidate the parts of the client area where the moving parts were
+// drawn on the last frame and where they will be drawn on the next one,
+// instead of the whole view. The rectangles are worked out from the
+// display list of the moving parts in client pixels, and the newest
+// segment of the trail is added to them.
+void CLunarOrbitView::InvalidateMovingParts()
+{
+	// a device context with the mapping used to draw a frame
+	CClientDC dc( this );
+	SetDrawDC( &dc );
+	CBaseView::render( &dc, LeftOfView, TopOfView );
 
-	// render the distance vector
-	RenderDistance( pDC );
+	// the segments of the trail added since the last frame are projected
+	// from the history
+	SyncTrail();
 
-	// render the acceleration vector
-	RenderAcceleration( pDC );
+	m_MovingList.Clear();
+	RenderMovingParts( m_MovingList );
 
-	// render the velocity vector
-	RenderVelocity( pDC );
+	CDamageRegion damage;
+	const int nCommands = m_MovingList.GetCommandCount();
+	for ( int nCommand = 0; nCommand < nCommands; nCommand++ )
+	{
+		const DISPLAY_RECT bounds = m_MovingList.GetBounds( nCommand, m_Styles );
+		CRect rect( bounds.left, bounds.top, bounds.right, bounds.bottom );
+		dc.LPtoDP( &rect );
+		rect.NormalizeRect();
+
+		// a pixel either way covers rounding in the mapping
+		rect.InflateRect( 1, 1 );
+		DISPLAY_RECT pixels = { rect.left, rect.top, rect.right, rect.bottom };
+		damage.Add( pixels );
+	}
 
-} // render
+	// the parts of the trail added or replaced since the last frame,
+	// which can be many hours when the simulation runs ahead of the view
+	if ( m_bTrailDamage )
+	{
+		const int nWidth = InchesToLogical( 0.01 );
+		CRect rect = m_rectTrailDamage;
+		rect.InflateRect( nWidth, nWidth );
+		dc.LPtoDP( &rect );
+		rect.NormalizeRect();
+		rect.InflateRect( 1, 1 );
+		DISPLAY_RECT pixels = { rect.left, rect.top, rect.right, rect.bottom };
+		damage.Add( pixels );
+		m_bTrailDamage = false;
+	}
+
+	// the old positions are erased and the new ones drawn
+	m_Damage.Add( m_PreviousDamage );
+	m_Damage.Add( damage );
+	m_PreviousDamage = damage;
+
+	const int nRects = m_Damage.GetCount();
+	for ( int nRect = 0; nRect < nRects; nRect++ )
+	{
+		const DISPLAY_RECT& rect = m_Damage.GetRect( nRect );
+		CRect rectInvalid( rect.left, rect.top, rect.right, rect.bottom );
+		InvalidateRect( &rectInvalid, FALSE );
+	}
+
+} // InvalidateMovingParts
 
 /////////////////////////////////////////////////////////////////////////////
+// The background is drawn into a bitmap that is kept until the view is
+// zoomed, scrolled or resized. The frame is kept in a second bitmap from
+// one paint to the next, so when the timer has only invalidated the parts
+// that moved, only those parts of the frame are copied from the background
+// and drawn again, and only the area being painted is copied to the
+// screen. Printing does not come through here and draws both layers with
+// render.
 void CLunarOrbitView::OnDraw( CDC* pDC )
 {
 	CLunarOrbitDoc* pDoc = Document;
@@ -126,17 +281,192 @@ void CLunarOrbitView::OnDraw( CDC* pDC )
 	if ( !pDoc )
 		return;
 
-	CBaseView::OnDraw( pDC );
+	CRect rectClient;
+	GetClientRect( &rectClient );
+	const int nRectWidth = rectClient.Width();
+	const int nRectHeight = rectClient.Height();
+	const double dTopOfView = TopOfView;
+	const double dLeftOfView = LeftOfView;
+
+	// everything that moves or scales the background
+	LAYER_KEY key;
+	key.dScale = Scale;
+	key.dLeftOfView = dLeftOfView;
+	key.dTopOfView = dTopOfView;
+	key.nWidth = nRectWidth;
+	key.nHeight = nRectHeight;
+
+	CDC dcBackground;
+	dcBackground.CreateCompatibleDC( pDC );
+
+	// the whole frame is drawn again unless only the moving parts changed
+	bool bWholeFrame = false;
+
+	if ( m_BackgroundCache.Prepare( key ) )
+	{
+		CreateBitmap( pDC, m_bmBackground, nRectWidth, nRectHeight );
+
+		CBitmap* pBmOld = dcBackground.SelectObject( &m_bmBackground );
+		dcBackground.PatBlt( 0, 0, nRectWidth, nRectHeight, WHITENESS );
+		const int nDcOrg = dcBackground.SaveDC();
+
+		SetDrawDC( &dcBackground );
+		CBaseView::render( &dcBackground, dLeftOfView, dTopOfView );
+		RenderBackground( &dcBackground );
+
+		dcBackground.RestoreDC( nDcOrg );
+		dcBackground.SelectObject( pBmOld );
+		bWholeFrame = true;
+	}
+
+	// the back buffer persists between paints and is only created again
+	// when the size of the window changes
+	if ( CreateBitmap( pDC, m_bmFrame, nRectWidth, nRectHeight ) )
+	{
+		bWholeFrame = true;
+	}
+
+	// the area being painted in client pixels
+	CRect rectPaint;
+	pDC->GetClipBox( &rectPaint );
+	rectPaint.IntersectRect( &rectPaint, &rectClient );
+	const DISPLAY_RECT paint =
+	{
+		rectPaint.left, rectPaint.top, rectPaint.right, rectPaint.bottom
+	};
+
+	// anything painted outside of the damage came from somewhere other
+	// than the timer, such as another window uncovering this one or an
+	// Invalidate of the whole view
+	if ( !m_Damage.IsInsideBounds( paint ) )
+	{
+		bWholeFrame = true;
+	}
+
+	CDC dcMem;
+	dcMem.CreateCompatibleDC( pDC );
+	CBitmap* pBmOld = dcMem.SelectObject( &m_bmFrame );
+	CBitmap* pBmBackgroundOld = dcBackground.SelectObject( &m_bmBackground );
+
+	// start from the background where the frame is drawn again, and clip
+	// the drawing to it
+	CRgn rgnDamage;
+	if ( bWholeFrame )
+	{
+		dcMem.BitBlt
+		(
+			0, 0, nRectWidth, nRectHeight, &dcBackground, 0, 0, SRCCOPY
+		);
+	}
+	else
+	{
+		rgnDamage.CreateRectRgn( 0, 0, 0, 0 );
+		const int nRects = m_Damage.GetCount();
+		for ( int nRect = 0; nRect < nRects; nRect++ )
+		{
+			const DISPLAY_RECT& rect = m_Damage.GetRect( nRect );
+			dcMem.BitBlt
+			(
+				rect.left, rect.top, rect.right - rect.left,
+				rect.bottom - rect.top, &dcBackground, rect.left, rect.top,
+				SRCCOPY
+			);
+
+			CRgn rgnRect;
+			rgnRect.CreateRectRgn( rect.left, rect.top, rect.right, rect.bottom );
+			rgnDamage.CombineRgn( &rgnDamage, &rgnRect, RGN_OR );
+		}
+		dcMem.SelectClipRgn( &rgnDamage );
+	}
+	dcBackground.SelectObject( pBmBackgroundOld );
+	m_Damage.Clear();
+
+	const int nDcOrg = dcMem.SaveDC();
+	SetDrawDC( &dcMem );
+	CBaseView::render( &dcMem, dLeftOfView, dTopOfView );
+	RenderForeground( &dcMem );
+	dcMem.RestoreDC( nDcOrg );
+	dcMem.SelectClipRgn( nullptr );
+
+	// output the area being painted to the screen in a single bitblit
+	pDC->BitBlt
+	(
+		rectPaint.left, rectPaint.top, rectPaint.Width(), rectPaint.Height(),
+		&dcMem, rectPaint.left, rectPaint.top, SRCCOPY
+	);
+
+	dcMem.SelectObject( pBmOld );
 
 } // OnDraw
 
+/////////////////////////////////////////////////////////////////////////////
+// create the bitmap compatible with the device context unless it already
+// has the given size and return true if it was created
+bool CLunarOrbitView::CreateBitmap
+(
+	CDC* pDC, CBitmap& bitmap, int nWidth, int nHeight
+)
+{
+	BITMAP bmInfo = { 0 };
+	if ( bitmap.GetSafeHandle() != NULL )
+	{
+		bitmap.GetBitmap( &bmInfo );
+	}
+	if ( bmInfo.bmWidth == nWidth && bmInfo.bmHeight == nHeight )
+	{
+		return false;
+	}
+
+	bitmap.DeleteObject();
+	bitmap.CreateCompatibleBitmap( pDC, nWidth, nHeight );
+	return true;
+
+} // CreateBitmap
+
 /////////////////////////////////////////////////////////////////////////////
 void CLunarOrbitView::OnInitialUpdate()
 {
 	CBaseView::OnInitialUpdate();
 
+	// the static parts are recorded and drawn again for the new document
+	m_StaticList.Clear();
+	m_BackgroundCache.Invalidate();
+
+	// The orbit points were projected from the trail of the old document,
+	// whose sample numbers can overlap those of the new one, so the empty
+	// projection makes the next frame project the new trail in full.
+	m_OrbitPoints.clear();
+	m_TrailDetail.Clear();
+	m_TrailIndex.Clear();
+	m_nOrbitFirstSample = 0;
+	m_nTrailStale = 0;
+	m_TrailProjection.nEarthX = 0;
+	m_TrailProjection.nEarthY = 0;
+	m_TrailProjection.dMoonScaling = 0;
+	m_TrailProjection.nMap = 0;
+
+	// the vectors are moved to where a document read from a checkpoint
+	// left the moon
+	UpdateMoonVectors();
+
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// The document hints that its contents are about to be replaced, so the
+// model is stopped before the old run can be written over the document
+// read or the trail that comes with it. Other updates repaint the view.
+void CLunarOrbitView::OnUpdate( CView* pSender, LPARAM lHint, CObject* pHint )
+{
+	if ( lHint == HINT_DELETE_CONTENTS )
+	{
+		StopSimulation();
+		return;
+	}
+
+	CBaseView::OnUpdate( pSender, lHint, pHint );
+
+} // OnUpdate
+
 /////////////////////////////////////////////////////////////////////////////
 void CLunarOrbitView::OnFilePrintPreview()
 {
@@ -225,8 +555,12 @@ void CLunarOrbitView::OnSize( UINT nType, int cx, int cy )
 } // OnSize
 
 /////////////////////////////////////////////////////////////////////////////
-// render the lunar orbit 
-void CLunarOrbitView::RenderLunarOrbit( CDC * pDC )
+// render the lunar orbit inside the given area at the level of detail of
+// the given number of logical units in a pixel
+void CLunarOrbitView::RenderLunarOrbit
+(
+	CDisplayList& list, const CRect& rectClip, double dUnitsPerPixel
+)
 {
 	// 1 hundredths of an inch
 	const int nGrayWidth = InchesToLogical( 0.01 );
@@ -234,26 +568,97 @@ void CLunarOrbitView::RenderLunarOrbit( CDC * pDC )
 	// gray color
 	const COLORREF rgbGray = RGB( 128, 128, 128 );
 
-	// create a solid gray pen 0.05 inches wide
-	CPen penGray;
-	penGray.CreatePen( PS_SOLID, nGrayWidth, rgbGray );
+	// a solid gray pen
+	const int nPen = m_Styles.AddPen( DISPLAY_PEN_SOLID, nGrayWidth, rgbGray );
+
+	// the samples added since the last frame are projected
+	SyncTrail();
+
+	// only the runs of the orbital path that touch the area being drawn
+	// are recorded, where the area is widened by the pen so the edges of
+	// segments just outside it are still drawn
+	CRect rectArea = rectClip;
+	rectArea.InflateRect( nGrayWidth, nGrayWidth );
+
+	// when a level of detail is within a pixel of the trail only its
+	// points are recorded, which are a few for each pixel the trail
+	// crosses however many points the trail has (the levels are only
+	// built again once an eighth of the trail has been replaced, so they
+	// can hold that much of the oldest orbit after it left the history)
+	const int nLevel = m_TrailDetail.FindLevel( dUnitsPerPixel );
+	if ( nLevel >= 0 )
+	{
+		const DISPLAY_RECT rect =
+		{
+			rectArea.left, rectArea.top, rectArea.right, rectArea.bottom
+		};
+		m_TrailDetail.FindRuns( nLevel, rect, m_TrailRuns );
 
-	CPen* pOld = pDC->SelectObject( &penGray );
+		const TRAIL_LEVEL& level = m_TrailDetail.GetLevel( nLevel );
+		for ( const TRAIL_RUN& run : m_TrailRuns )
+		{
+			list.Polyline
+			(
+				nPen, &level.points[ run.nFirstPoint ], run.nPoints
+			);
+		}
+		return;
+	}
+
+	// closer in every point is drawn
+	m_TrailIndex.FindSegments
+	(
+		rectArea.left, rectArea.top, rectArea.right, rectArea.bottom,
+		m_VisibleSegments
+	);
+
+	// the segments before the oldest sample held have been replaced and
+	// are left out, where segment n starts at orbit point n
+	const int nReplaced =
+		int( TrailHistory.GetFirstSample() - m_nOrbitFirstSample );
+	m_VisibleSegments.erase
+	(
+		m_VisibleSegments.begin(),
+		lower_bound
+		(
+			m_VisibleSegments.begin(), m_VisibleSegments.end(), nReplaced
+		)
+	);
 
 	// draw historical moon images and orbital path
-	const size_t nPoints = m_OrbitPoints.size();
-	if ( nPoints != 0 )
+	const int nSegments = (int)m_VisibleSegments.size();
+	int nStart = 0;
+	while ( nStart < nSegments )
 	{
-		pDC->Polyline( &m_OrbitPoints[ 0 ], (int)nPoints );
-	}
+		// extend the run while the segments are consecutive
+		int nEnd = nStart;
+		while
+		(
+			nEnd + 1 < nSegments &&
+			m_VisibleSegments[ nEnd + 1 ] == m_VisibleSegments[ nEnd ] + 1
+		)
+		{
+			nEnd++;
+		}
 
-	pDC->SelectObject( pOld );
+		// segment n joins point n to point n + 1 where a CPoint is laid
+		// out like a DISPLAY_POINT
+		const int nFirstPoint = m_VisibleSegments[ nStart ];
+		const int nLastPoint = m_VisibleSegments[ nEnd ] + 1;
+		list.Polyline
+		(
+			nPen, (const DISPLAY_POINT*)&m_OrbitPoints[ nFirstPoint ],
+			nLastPoint - nFirstPoint + 1
+		);
+
+		nStart = nEnd + 1;
+	}
 
 } // RenderLunarOrbit
 
 /////////////////////////////////////////////////////////////////////////////
 // render the equations of motion
-void CLunarOrbitView::RenderEquations( CDC * pDC )
+void CLunarOrbitView::RenderEquations( CDisplayList& list )
 {
 	// pointer to the document information
 	CLunarOrbitDoc* pDoc = Document;
@@ -267,12 +672,8 @@ void CLunarOrbitView::RenderEquations( CDC * pDC )
 	// 0.12 inch size
 	const int nTextHeight = InchesToLogical( 0.25 );
 
-	// create a font for text output
-	CFont font;
-	BuildFont
-	(
-		_T( "Arial" ), false, false, nTextHeight, false, font
-	);
+	// font for text output
+	const int nFont = m_Styles.AddFont( _T( "Arial" ), nTextHeight );
 
 	// labels for information to be displayed on the output device
 	CString csText
@@ -294,10 +695,9 @@ void CLunarOrbitView::RenderEquations( CDC * pDC )
 		_T( "    t is time." )
 	);
 	
-	// prepare the device context
-	CFont* pOldFont = pDC->SelectObject( &font );
-	const int nTA = pDC->SetTextAlign( TA_LEFT | TA_BASELINE );
-	COLORREF rgbOld = pDC->SetTextColor( rgbBlue );
+	// left justified on the base line over an opaque background
+	const int nAlign =
+		DISPLAY_ALIGN_LEFT | DISPLAY_ALIGN_BASELINE | DISPLAY_ALIGN_OPAQUE;
 
 	// document dimensions
 	const int nDocWidth = InchesToLogical( DocumentWidth );
@@ -321,23 +721,18 @@ void CLunarOrbitView::RenderEquations( CDC * pDC )
 		}
 
 		// draw the equation text one line at a time
-		pDC->TextOut( nX, nY, csToken );
+		list.Text( nFont, 0, nAlign, rgbBlue, nX, nY, csToken );
 
 		// move to next line
 		nY += nTextHeight;
 
 	} while ( true );
 
-	// restore the device context
-	pDC->SetTextColor( rgbOld );
-	pDC->SetTextAlign( nTA );
-	pDC->SelectObject( pOldFont );
-
 } // RenderEquations
 
 /////////////////////////////////////////////////////////////////////////////
 // render the initial condition text in dark green on the top right
-void CLunarOrbitView::RenderInitialConditions( CDC * pDC )
+void CLunarOrbitView::RenderInitialConditions( CDisplayList& list )
 {
 	// pointer to the document information
 	CLunarOrbitDoc* pDoc = Document;
@@ -351,16 +746,13 @@ void CLunarOrbitView::RenderInitialConditions( CDC * pDC )
 	// text color is dark green
 	COLORREF rgbText( RGB( 0, 128, 0 ) );
 
-	// create a font for text output
-	CFont font;
-	BuildFont
-	(
-		_T( "Arial" ), false, false, nTextHeight, false, font
-	);
+	// font for text output
+	const int nFont = m_Styles.AddFont( _T( "Arial" ), nTextHeight );
 
 	// labels for information to be displayed on the output device
 	CString
-		csMassOfEarth, csSample, csSamplesPerDay, csRunningTime;
+		csMassOfEarth, csSample, csSamplesPerDay, csRunningTime,
+		csStepsPerSecond, csRecording;
 
 	csMassOfEarth.Format
 	(
@@ -382,44 +774,67 @@ void CLunarOrbitView::RenderInitialConditions( CDC * pDC )
 		_T( "Period=%0.2f days" ), pDoc->RunningTime / 86400
 	);
 
-	// prepare the device context
-	CFont* pOldFont = pDC->SelectObject( &font );
-	const int nTA = pDC->SetTextAlign( TA_RIGHT | TA_BASELINE );
-	COLORREF rgbOld = pDC->SetTextColor( rgbText );
+	// the rate the model runs at on this machine
+	csStepsPerSecond.Format
+	(
+		_T( "%0.0f steps/s" ), StepsPerSecond
+	);
+
+	// the time slices recorded and the bytes each one took in the file
+	if ( m_Recorder.IsOpen() )
+	{
+		const long long nSteps = m_Recorder.GetSteps();
+		csRecording.Format
+		(
+			_T( "Recorded=%lld steps at %0.2f bytes/step" ), nSteps,
+			nSteps > 0 ? double( m_Recorder.GetBytes() ) / nSteps : 0.0
+		);
+	}
+
+	// right justified on the base line over an opaque background
+	const int nAlign =
+		DISPLAY_ALIGN_RIGHT | DISPLAY_ALIGN_BASELINE | DISPLAY_ALIGN_OPAQUE;
 
 	// right justified to the right margin
 	int nX = LogicalDocumentWidth - 2 * nMargin;
 	int nY = 2 * nMargin;
 
 	// draw the textual information one line at a time
-	pDC->TextOut( nX, nY, csMassOfEarth );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csMassOfEarth );
+	nY += nTextHeight;
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csSample );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csSample );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csSamplesPerDay );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csSamplesPerDay );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csRunningTime );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csRunningTime );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csStepsPerSecond );
 
-	// restore the device context
-	pDC->SetTextColor( rgbOld );
-	pDC->SetTextAlign( nTA );
-	pDC->SelectObject( pOldFont );
+	// the last fast forward is reported until the model is run again
+	if ( !m_csFastForward.IsEmpty() )
+	{
+		nY += nTextHeight;
+		list.Text( nFont, 0, nAlign, rgbText, nX, nY, m_csFastForward );
+	}
+
+	// the recording is reported while it is being written
+	if ( !csRecording.IsEmpty() )
+	{
+		nY += nTextHeight;
+		list.Text( nFont, 0, nAlign, rgbText, nX, nY, csRecording );
+	}
 
 } // RenderInitialConditions
 
 /////////////////////////////////////////////////////////////////////////////
 // render the distance text information
-void CLunarOrbitView::RenderDistanceText( CDC* pDC )
+void CLunarOrbitView::RenderDistanceText( CDisplayList& list )
 {
 	// 0.12 inch size
 	const int nTextHeight = InchesToLogical( 0.25 );
 
-	// create a font for text output
-	CFont font;
-	BuildFont
-	(
-		_T( "Arial" ), false, false, nTextHeight, false, font
-	);
+	// font for text output
+	const int nFont = m_Styles.AddFont( _T( "Arial" ), nTextHeight );
 
 	const CString csDistance = DistanceVector.Label;
 	const CString csDistanceX = DistanceX.Label;
@@ -427,10 +842,11 @@ void CLunarOrbitView::RenderDistanceText( CDC* pDC )
 	CString csAngle;
 	csAngle.Format( _T( "S angle=%0.02f " ), DistanceVector.Degrees );
 
-	// prepare the device context
-	CFont* pOldFont = pDC->SelectObject( &font );
-	const int nTA = pDC->SetTextAlign( TA_RIGHT | TA_BASELINE );
-	COLORREF rgbOld = pDC->SetTextColor( DistanceVector.Color );
+	// right justified on the base line over an opaque background in
+	// the color of the vector
+	const int nAlign =
+		DISPLAY_ALIGN_RIGHT | DISPLAY_ALIGN_BASELINE | DISPLAY_ALIGN_OPAQUE;
+	const COLORREF rgbText = DistanceVector.Color;
 
 	// document dimensions
 	const int nDocWidth = InchesToLogical( DocumentWidth );
@@ -443,34 +859,25 @@ void CLunarOrbitView::RenderDistanceText( CDC* pDC )
 	int nX = 10 * nMargin;
 	int nY = nDocHeight - 6 * nMargin;
 
-	pDC->TextOut( nX, nY, csDistance );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csDistance );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csDistanceX );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csDistanceX );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csDistanceY );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csDistanceY );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csAngle );
-
-	// restore the device context
-	pDC->SetTextColor( rgbOld );
-	pDC->SetTextAlign( nTA );
-	pDC->SelectObject( pOldFont );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csAngle );
 
 } // RenderDistanceText
 
 /////////////////////////////////////////////////////////////////////////////
 // render the gravity text information
-void CLunarOrbitView::RenderGravityText( CDC* pDC )
+void CLunarOrbitView::RenderGravityText( CDisplayList& list )
 {
 	// 0.12 inch size
 	const int nTextHeight = InchesToLogical( 0.25 );
 
-	// create a font for text output
-	CFont font;
-	BuildFont
-	(
-		_T( "Arial" ), false, false, nTextHeight, false, font
-	);
+	// font for text output
+	const int nFont = m_Styles.AddFont( _T( "Arial" ), nTextHeight );
 
 	const CString csGravity = GravityVector.Label;
 	const CString csGravityX = GravityX.Label;
@@ -479,10 +886,11 @@ void CLunarOrbitView::RenderGravityText( CDC* pDC )
 	csAngle.Format( _T( "Ag angle=%0.02f " ), GravityVector.Degrees );
 
 
-	// prepare the device context
-	CFont* pOldFont = pDC->SelectObject( &font );
-	const int nTA = pDC->SetTextAlign( TA_RIGHT | TA_BASELINE );
-	COLORREF rgbOld = pDC->SetTextColor( GravityVector.Color );
+	// right justified on the base line over an opaque background in
+	// the color of the vector
+	const int nAlign =
+		DISPLAY_ALIGN_RIGHT | DISPLAY_ALIGN_BASELINE | DISPLAY_ALIGN_OPAQUE;
+	const COLORREF rgbText = GravityVector.Color;
 
 	// document dimensions
 	const int nDocWidth = InchesToLogical( DocumentWidth );
@@ -495,34 +903,24 @@ void CLunarOrbitView::RenderGravityText( CDC* pDC )
 	int nX = 26 * nMargin;
 	int nY = nDocHeight - 6 * nMargin;
 
-	pDC->SetTextColor( GravityVector.Color );
-	pDC->TextOut( nX, nY, csGravity );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csGravity );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csGravityX );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csGravityX );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csGravityY );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csGravityY );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csAngle );
-
-	// restore the device context
-	pDC->SetTextColor( rgbOld );
-	pDC->SetTextAlign( nTA );
-	pDC->SelectObject( pOldFont );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csAngle );
 } // RenderGravityText
 
 /////////////////////////////////////////////////////////////////////////////
 // render the velocity text information
-void CLunarOrbitView::RenderVelocityText( CDC* pDC )
+void CLunarOrbitView::RenderVelocityText( CDisplayList& list )
 {
 	// 0.12 inch size
 	const int nTextHeight = InchesToLogical( 0.25 );
 
-	// create a font for text output
-	CFont font;
-	BuildFont
-	(
-		_T( "Arial" ), false, false, nTextHeight, false, font
-	);
+	// font for text output
+	const int nFont = m_Styles.AddFont( _T( "Arial" ), nTextHeight );
 
 	const CString csVelocity = VelocityVector.Label;
 	const CString csVelocityX = VelocityX.Label;
@@ -530,10 +928,11 @@ void CLunarOrbitView::RenderVelocityText( CDC* pDC )
 	CString csAngle;
 	csAngle.Format( _T( "Vg angle=%0.02f " ), VelocityVector.Degrees );
 
-	// prepare the device context
-	CFont* pOldFont = pDC->SelectObject( &font );
-	const int nTA = pDC->SetTextAlign( TA_RIGHT | TA_BASELINE );
-	COLORREF rgbOld = pDC->SetTextColor( VelocityVector.Color );
+	// right justified on the base line over an opaque background in
+	// the color of the vector
+	const int nAlign =
+		DISPLAY_ALIGN_RIGHT | DISPLAY_ALIGN_BASELINE | DISPLAY_ALIGN_OPAQUE;
+	const COLORREF rgbText = VelocityVector.Color;
 
 	// document dimensions
 	const int nDocWidth = InchesToLogical( DocumentWidth );
@@ -546,23 +945,18 @@ void CLunarOrbitView::RenderVelocityText( CDC* pDC )
 	int nX = LogicalDocumentWidth - 2 * nMargin;
 	int nY = nDocHeight - 6 * nMargin;
 
-	pDC->TextOut( nX, nY, csVelocity );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csVelocity );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csVelocityX );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csVelocityX );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csVelocityY );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csVelocityY );
 	nY += nTextHeight;
-	pDC->TextOut( nX, nY, csAngle );
-
-	// restore the device context
-	pDC->SetTextColor( rgbOld );
-	pDC->SetTextAlign( nTA );
-	pDC->SelectObject( pOldFont );
+	list.Text( nFont, 0, nAlign, rgbText, nX, nY, csAngle );
 } // RenderVelocityText
 
 /////////////////////////////////////////////////////////////////////////////
 // render the grid labels
-void CLunarOrbitView::RenderGridLabels( CDC* pDC )
+void CLunarOrbitView::RenderGridLabels( CDisplayList& list )
 {
 	// pointer to the document information
 	CLunarOrbitDoc* pDoc = Document;
@@ -573,19 +967,12 @@ void CLunarOrbitView::RenderGridLabels( CDC* pDC )
 	// 0.12 inch size
 	const int nTextHeight = InchesToLogical( 0.25 );
 
-	// create a font for text output
-	CFont font;
-	BuildFont
-	(
-		_T( "Arial" ), false, false, nTextHeight, false, font
-	);
+	// font for text output
+	const int nFont = m_Styles.AddFont( _T( "Arial" ), nTextHeight );
 
 	// center of the earth on the document
 	CPoint ptEarth = EarthCenter;
 
-	// prepare the device context
-	CFont* pOldFont = pDC->SelectObject( &font );
-
 	// document dimensions
 	const int nDocWidth = InchesToLogical( DocumentWidth );
 	const int nDocHeight = InchesToLogical( DocumentHeight );
@@ -599,32 +986,31 @@ void CLunarOrbitView::RenderGridLabels( CDC* pDC )
 	const CString csLabelX( _T( "X (Inches)" ) );
 	const CString csLabelY( _T( "Y (Inches)" ) );
 
-	COLORREF rgbOld = pDC->SetTextColor( rgbScale );
-	int nTA = pDC->SetTextAlign( TA_CENTER | TA_BOTTOM );
-	pDC->TextOut( ptEarth.x, nMargin, csLabelX );
-	pDC->TextOut( ptEarth.x, nDocHeight - nMargin, csLabelX );
-
-	// create a font for vertical text output
-	CFont fontY;
-	BuildFont
+	// centered above the point over an opaque background
+	const int nAlign =
+		DISPLAY_ALIGN_CENTER | DISPLAY_ALIGN_BOTTOM | DISPLAY_ALIGN_OPAQUE;
+	list.Text( nFont, 0, nAlign, rgbScale, ptEarth.x, nMargin, csLabelX );
+	list.Text
 	(
-		_T( "Arial" ), false, false, nTextHeight, true, fontY
+		nFont, 0, nAlign, rgbScale, ptEarth.x, nDocHeight - nMargin, csLabelX
 	);
-	pDC->SelectObject( &fontY );
-	pDC->SetTextAlign( TA_CENTER | TA_BOTTOM );
-
-	pDC->TextOut( nMargin - nTextHeight, ptEarth.y, csLabelY );
-	pDC->TextOut( nDocWidth - nMargin, ptEarth.y, csLabelY );
 
-	// restore the device context
-	pDC->SetTextColor( rgbOld );
-	pDC->SetTextAlign( nTA );
-	pDC->SelectObject( pOldFont );
+	// vertical text is turned 90 degrees the way BuildFont turns it
+	list.Text
+	(
+		nFont, VERTICAL_ESCAPEMENT, nAlign, rgbScale,
+		nMargin - nTextHeight, ptEarth.y, csLabelY
+	);
+	list.Text
+	(
+		nFont, VERTICAL_ESCAPEMENT, nAlign, rgbScale,
+		nDocWidth - nMargin, ptEarth.y, csLabelY
+	);
 } // RenderGridLabels
 
 /////////////////////////////////////////////////////////////////////////////
 // render the grid
-void CLunarOrbitView::RenderGrid( CDC * pDC )
+void CLunarOrbitView::RenderGrid( CDisplayList& list )
 {
 	// gray color
 	const COLORREF rgbGray = RGB( 128, 128, 128 );
@@ -632,14 +1018,8 @@ void CLunarOrbitView::RenderGrid( CDC * pDC )
 	// 1 hundredths of an inch
 	const int nGrayWidth = InchesToLogical( 0.01 );
 
-	// gray pen
-	CPen penGray;
-
-	// create a solid gray pen 0.05 inches wide
-	penGray.CreatePen( PS_SOLID, nGrayWidth, rgbGray );
-
-	// setup the device context
-	CPen* pOld = pDC->SelectObject( &penGray );
+	// a solid gray pen
+	const int nPen = m_Styles.AddPen( DISPLAY_PEN_SOLID, nGrayWidth, rgbGray );
 
 	// document dimensions in logical pixels (device independent)
 	const int nDocWidth = InchesToLogical( DocumentWidth );
@@ -661,25 +1041,20 @@ void CLunarOrbitView::RenderGrid( CDC * pDC )
 	// draw vertical grid lines every 4 margins (every inch)
 	for ( int nX = nX1; nX <= nX2; nX += 4 * nMargin )
 	{
-		pDC->MoveTo( nX, nY1 );
-		pDC->LineTo( nX, nY2 );
+		list.Line( nPen, nX, nY1, nX, nY2 );
 	}
 
 	// draw horizontal grid lines every 4 margins (every inch)
 	for ( int nY = nY1; nY <= nY2; nY += 4 * nMargin )
 	{
-		pDC->MoveTo( nX1, nY );
-		pDC->LineTo( nX2, nY );
+		list.Line( nPen, nX1, nY, nX2, nY );
 	}
 
-	// restore the device context
-	pDC->SelectObject( pOld );
-
 } // RenderGrid
 
 /////////////////////////////////////////////////////////////////////////////
 // render the scale labels in inches
-void CLunarOrbitView::RenderScale( CDC * pDC )
+void CLunarOrbitView::RenderScale( CDisplayList& list )
 {
 	// pointer to the document information
 	CLunarOrbitDoc* pDoc = Document;
@@ -693,12 +1068,8 @@ void CLunarOrbitView::RenderScale( CDC * pDC )
 	// 0.12 inch size
 	const int nTextHeight = InchesToLogical( 0.18 );
 
-	// create a font for text output
-	CFont font;
-	BuildFont
-	(
-		_T( "Arial" ), false, false, nTextHeight, false, font
-	);
+	// font for text output
+	const int nFont = m_Styles.AddFont( _T( "Arial" ), nTextHeight );
 
 	// center of the earth on the document
 	CPoint ptEarth = EarthCenter;
@@ -709,46 +1080,36 @@ void CLunarOrbitView::RenderScale( CDC * pDC )
 	int nY1 = ptEarth.y - nMargin * 16; // 16 margins above center
 	int nY2 = ptEarth.y + nMargin * 16; // 16 margins below center
 
-	// draw X scale labels every 4 margins (every inch)
-	// prepare the device context
-	CFont* pOldFont = pDC->SelectObject( &font );
-	const int nTA = pDC->SetTextAlign( TA_CENTER | TA_TOP );
-	COLORREF rgbOld = pDC->SetTextColor( rgbText );
+	// centered below the point over an opaque background
+	const int nAlign =
+		DISPLAY_ALIGN_CENTER | DISPLAY_ALIGN_TOP | DISPLAY_ALIGN_OPAQUE;
 
+	// draw X scale labels every 4 margins (every inch)
 	CString csValue;
 	for ( int nX = nX1; nX <= nX2; nX += 4 * nMargin )
 	{
 		const double dValue = LogicalToInches( nX - 2 * nMargin );
 		csValue.Format( _T( "%0.0f" ), dValue );
-		pDC->TextOut( nX, nY2, csValue );
+		list.Text( nFont, 0, nAlign, rgbText, nX, nY2, csValue );
 	}
 
 	// draw Y scale labels every 4 margins (every inch)
-	// create a font for vertical text output
-	CFont fontY;
-	BuildFont
-	(
-		_T( "Arial" ), false, false, nTextHeight, true, fontY
-	);
-	pDC->SelectObject( &fontY );
-	pDC->SetTextAlign( TA_CENTER | TA_TOP );
+	// vertical text is turned 90 degrees the way BuildFont turns it
 	for ( int nY = nY1; nY <= nY2; nY += 4 * nMargin )
 	{
 		const double dValue = LogicalToInches( nY - nMargin );
 		csValue.Format( _T( "%0.0f" ), dValue );
-		pDC->TextOut( nX1, nY, csValue );
+		list.Text
+		(
+			nFont, VERTICAL_ESCAPEMENT, nAlign, rgbText, nX1, nY, csValue
+		);
 	}
 
-	// restore the device context
-	pDC->SetTextColor( rgbOld );
-	pDC->SetTextAlign( nTA );
-	pDC->SelectObject( pOldFont );
-
 } // RenderScale
 
 /////////////////////////////////////////////////////////////////////////////
 // render the moon
-void CLunarOrbitView::RenderMoon( CDC * pDC )
+void CLunarOrbitView::RenderMoon( CDisplayList& list )
 {
 	// gray color
 	const COLORREF rgbGray = RGB( 128, 128, 128 );
@@ -757,28 +1118,20 @@ void CLunarOrbitView::RenderMoon( CDC * pDC )
 	const int nGrayWidth = InchesToLogical( 0.01 );
 
 	// gray pen to draw the moon's circumference
-	CPen penGray;
-
-	// create a solid gray pen 0.05 inches wide
-	penGray.CreatePen( PS_SOLID, nGrayWidth, rgbGray );
-
-	// setup the device context
-	CPen* pPenOld = pDC->SelectObject( &penGray );
+	const int nPen = m_Styles.AddPen( DISPLAY_PEN_SOLID, nGrayWidth, rgbGray );
 
 	// a gray brush to fill the moon's interior
-	CBrush brGray;
-
-	// create a gray brush
-	brGray.CreateSolidBrush( rgbGray );
-
-	// color the moon gray
-	CBrush* pBrOld = pDC->SelectObject( &brGray );
+	const int nBrush = m_Styles.AddBrush( rgbGray );
 
 	// create a rectangle representing the moon 
 	CRect rectMoon = MoonRectangle;
 
 	// draw the moon as an ellipse that fits into the rectangle
-	pDC->Ellipse( &rectMoon );
+	list.Ellipse
+	(
+		nPen, nBrush, rectMoon.left, rectMoon.top, rectMoon.right,
+		rectMoon.bottom
+	);
 
 	// the coordinates represent the distance to earth from the moon
 	// in logical coordinates
@@ -790,34 +1143,23 @@ void CLunarOrbitView::RenderMoon( CDC * pDC )
 	// 0.18 inch size
 	const int nTextHeight = InchesToLogical( 0.18 );
 
-	// create a font for text output
-	CFont font;
-	BuildFont
-	(
-		_T( "Arial" ), false, false, nTextHeight, false, font
-	);
+	// font for text output
+	const int nFont = m_Styles.AddFont( _T( "Arial" ), nTextHeight );
 
 	// dark cyan color
 	const COLORREF rgbCyan = RGB( 0, 128, 128 );
 
-	const COLORREF rgbOld = pDC->SetTextColor( rgbCyan );
-	const int nBM = pDC->SetBkMode( TRANSPARENT );
-	const int nTA = pDC->SetTextAlign( DT_TOP | DT_LEFT );
-	CFont* pOldFont = pDC->SelectObject( &font );
-
-	pDC->TextOut( rectMoon.right, ptCenter.y, csCoor );
-
-	// restore the device context
-	pDC->SelectObject( pOldFont );
-	pDC->SetTextColor( rgbOld );
-	pDC->SetBkMode( nBM );
-	pDC->SelectObject( pPenOld );
-	pDC->SelectObject( pBrOld );
+	// top left justified over a transparent background
+	list.Text
+	(
+		nFont, 0, DISPLAY_ALIGN_LEFT | DISPLAY_ALIGN_TOP, rgbCyan,
+		rectMoon.right, ptCenter.y, csCoor
+	);
 
 } // RenderMoon
 
 /////////////////////////////////////////////////////////////////////////////
-void CLunarOrbitView::RenderEarth( CDC * pDC )
+void CLunarOrbitView::RenderEarth( CDisplayList& list )
 {
 	// 5 hundredth of an inch
 	const int nBlueWidth = InchesToLogical( 0.05 );
@@ -828,125 +1170,273 @@ void CLunarOrbitView::RenderEarth( CDC * pDC )
 	// blue color
 	const COLORREF rgbBlue = RGB( 0, 0, 255 );
 
-	// create a pen to draw the earth's circumference 
-	CPen penBlue;
+	// a solid blue pen to draw the earth's circumference 
+	const int nPen = m_Styles.AddPen( DISPLAY_PEN_SOLID, nBlueWidth, rgbBlue );
 
-	// create a solid blue pen 0.05 inches wide
-	penBlue.CreatePen( PS_SOLID, nBlueWidth, rgbBlue );
-
-	// create a green brush to fill the earth's shape
-	CBrush brGreen;
-
-	// create a green brush
-	brGreen.CreateSolidBrush( rgbGreen );
-
-	// colors of the earth
-	CPen* pPenOld = pDC->SelectObject( &penBlue );
-	CBrush* pBrOld = pDC->SelectObject( &brGreen );
+	// a green brush to fill the earth's shape
+	const int nBrush = m_Styles.AddBrush( rgbGreen );
 
 	// create a rectangle representing the earth 
 	CRect rectEarth = EarthRectangle;
 
 	// draw the earth as an ellipse that fits into the rectangle
-	pDC->Ellipse( &rectEarth );
-
-	// restore the device context
-	pDC->SelectObject( pPenOld );
-	pDC->SelectObject( pBrOld );
+	list.Ellipse
+	(
+		nPen, nBrush, rectEarth.left, rectEarth.top, rectEarth.right,
+		rectEarth.bottom
+	);
 
 } // RenderEarth
 
 /////////////////////////////////////////////////////////////////////////////
 // draw the distance vector centered on the moon
-void CLunarOrbitView::RenderDistance( CDC * pDC )
+void CLunarOrbitView::RenderDistance( CDisplayList& list )
 {
 	// draw all three vectors
-	DistanceVector.Draw( pDC );
-	DistanceX.Draw( pDC );
-	DistanceY.Draw( pDC );
+	RecordMoonVector( list, DistanceVector, CMoonVectors::MOON_DISTANCE );
+	RecordMoonVector( list, DistanceX, CMoonVectors::MOON_DISTANCE_X );
+	RecordMoonVector( list, DistanceY, CMoonVectors::MOON_DISTANCE_Y );
 
 } // RenderDistance
 
 /////////////////////////////////////////////////////////////////////////////
 // draw the acceleration vector centered on the moon
-void CLunarOrbitView::RenderAcceleration( CDC * pDC )
+void CLunarOrbitView::RenderAcceleration( CDisplayList& list )
 {
 	// draw all three vectors
-	GravityVector.Draw( pDC );
-	GravityX.Draw( pDC );
-	GravityY.Draw( pDC );
+	RecordMoonVector( list, GravityVector, CMoonVectors::MOON_GRAVITY );
+	RecordMoonVector( list, GravityX, CMoonVectors::MOON_GRAVITY_X );
+	RecordMoonVector( list, GravityY, CMoonVectors::MOON_GRAVITY_Y );
 
 } // RenderAcceleration
 
 /////////////////////////////////////////////////////////////////////////////
 // render velocity vector
-void CLunarOrbitView::RenderVelocity( CDC * pDC )
+void CLunarOrbitView::RenderVelocity( CDisplayList& list )
 {
 	// draw all three vectors
-	VelocityVector.Draw( pDC );
-	VelocityX.Draw( pDC );
-	VelocityY.Draw( pDC );
+	RecordMoonVector( list, VelocityVector, CMoonVectors::MOON_VELOCITY );
+	RecordMoonVector( list, VelocityX, CMoonVectors::MOON_VELOCITY_X );
+	RecordMoonVector( list, VelocityY, CMoonVectors::MOON_VELOCITY_Y );
 
 } // RenderVelocity
 
 /////////////////////////////////////////////////////////////////////////////
-// add the current moon position to the historical points of the lunar orbit
-void CLunarOrbitView::AddOrbitalPoint()
+// Record one of the moon's vectors with the sides of the arrowhead built
+// for it by the last UpdateMoonVectors, which is what moved it.
+void CLunarOrbitView::RecordMoonVector
+(
+	CDisplayList& list, CMagnitudeVector& vector,
+	CMoonVectors::MOON_VECTOR eVector
+)
 {
-	CLunarOrbitDoc* pDoc = Document;
+	const CLinearBatch& positive = m_MoonVectors.GetPositiveArrowheads();
+	const CLinearBatch& negative = m_MoonVectors.GetNegativeArrowheads();
+	const CPoint ptPositive
+	(
+		CLinear::round( positive.GetX2( eVector ) ),
+		CLinear::round( positive.GetY2( eVector ) )
+	);
+	const CPoint ptNegative
+	(
+		CLinear::round( negative.GetX2( eVector ) ),
+		CLinear::round( negative.GetY2( eVector ) )
+	);
+	vector.Record( list, m_Styles, ptPositive, ptNegative );
 
-	// number of points in the current orbit
-	const int nPoints = (int)m_OrbitPoints.size();
+} // RecordMoonVector
+
+/////////////////////////////////////////////////////////////////////////////
+// Add a moon position in meters to the historical points of the lunar
+// orbit. The position is kept in meters in a ring holding the last few
+// orbits, so the model can run for as long as it likes in the same memory
+// and the points are projected into logical units when they are drawn.
+void CLunarOrbitView::AddOrbitalPoint( double dX, double dY )
+{
+	CLunarOrbitDoc* pDoc = Document;
 
 	// number of hours in the known lunar period is the number of seconds
 	// divided by the number of seconds in an hour
 	const int nHours = int( pDoc->LunarPeriod / 3600 );
 
-	// since we are adding one point per hour, we can stop after one orbit's
-	// worth of hours
-	if ( nPoints < nHours )
+	// since we are adding one point per hour, the ring holds the hours of
+	// the orbits kept, where the orbit points can hold an eighth more
+	// than the ring before they are projected again (see SyncTrail)
+	const int nCapacity = nHours * TrailOrbits;
+	if ( TrailHistory.GetCapacity() != nCapacity )
 	{
-		CPoint pt = MoonCenter;
-
-		m_OrbitPoints.push_back( pt );
+		TrailHistory.SetCapacity( nCapacity );
+		m_OrbitPoints.reserve
+		(
+			TrailHistory.GetMaxCount() + nCapacity / 8 + 1
+		);
 	}
 
+	TrailHistory.Add( dX, dY );
+
 } // AddOrbitalPoint
 
 /////////////////////////////////////////////////////////////////////////////
-// this routine will update the moon's position using time slices
-// equal to SampleTime.
-void CLunarOrbitView::UpdateMoonPosition()
+// Bring the orbit points up to date with the trail history. The samples
+// added since the last call are projected onto the end of the orbit
+// points and added to the index and the levels of detail. Everything is
+// projected again in one pass when the scale of the orbit or the center
+// of the earth has moved, or when an eighth of the trail has been replaced
+// since the orbit points were last projected in full, which keeps the
+// orbit points inside the storage reserved for them.
+void CLunarOrbitView::SyncTrail()
+{
+	CLunarOrbitDoc* pDoc = Document;
+
+	const CPoint ptEarth = EarthCenter;
+	TRAIL_PROJECTION projection;
+	projection.nEarthX = ptEarth.x;
+	projection.nEarthY = ptEarth.y;
+	projection.dMoonScaling = pDoc->MoonScaling;
+	projection.nMap = pDoc->Map;
+
+	// numbers of the samples held and of the next sample to be projected
+	const long long nFirstSample = TrailHistory.GetFirstSample();
+	const long long nTotal = TrailHistory.GetTotal();
+	const long long nNextSample =
+		m_nOrbitFirstSample + (long long)m_OrbitPoints.size();
+	const int nCapacity = TrailHistory.GetCapacity();
+
+	const bool bProject =
+		projection != m_TrailProjection ||
+		nNextSample < nFirstSample || nNextSample > nTotal ||
+		nFirstSample - m_nOrbitFirstSample > nCapacity / 8;
+
+	// the segments replaced since the last call are left out of the
+	// drawing from now on, so they are damaged to be erased
+	const long long nReplaced = nFirstSample - m_nOrbitFirstSample;
+	if ( nReplaced > m_nTrailStale )
+	{
+		const int nStale =
+			int( min( nReplaced, (long long)m_OrbitPoints.size() ) );
+		DamageTrail( m_nTrailStale, nStale );
+		m_nTrailStale = nStale;
+	}
+
+	// the first sample to project counting from the oldest held
+	int nFirst = int( nNextSample - nFirstSample );
+
+	// the first orbit point that was not projected before
+	int nNewPoint = (int)m_OrbitPoints.size();
+	if ( bProject )
+	{
+		// the trail is all new when it has moved on the page
+		nNewPoint = projection != m_TrailProjection ?
+			0 : int( max( 0LL, min( nNextSample, nTotal ) - nFirstSample ) );
+
+		m_OrbitPoints.clear();
+		m_TrailDetail.Clear();
+
+		// the trail is indexed in quarter inch cells which hold a few
+		// of the hourly points each
+		m_TrailIndex.Clear();
+		m_TrailIndex.SetCellSize( InchesToLogical( 0.25 ) );
+
+		m_nOrbitFirstSample = nFirstSample;
+		m_TrailProjection = projection;
+		m_nTrailStale = 0;
+		nFirst = 0;
+	}
+
+	const int nCount = TrailHistory.GetCount() - nFirst;
+	if ( nCount <= 0 )
+	{
+		return;
+	}
+
+	// a CPoint is laid out like a DISPLAY_POINT
+	const int nPoints = (int)m_OrbitPoints.size();
+	m_OrbitPoints.resize( nPoints + nCount );
+	TrailHistory.Project
+	(
+		projection, nFirst, nCount, (DISPLAY_POINT*)&m_OrbitPoints[ nPoints ]
+	);
+
+	for ( int nPoint = nPoints; nPoint < nPoints + nCount; nPoint++ )
+	{
+		const CPoint& pt = m_OrbitPoints[ nPoint ];
+		m_TrailIndex.AddPoint( pt.x, pt.y );
+		m_TrailDetail.AddPoint( pt.x, pt.y );
+	}
+
+	// the new segments start at the point before the first new point
+	DamageTrail( nNewPoint - 1, nPoints + nCount - 1 );
+
+} // SyncTrail
+
+/////////////////////////////////////////////////////////////////////////////
+// add the given orbit points to the parts of the trail that changed since
+// the last frame where points outside of the orbit points are ignored
+void CLunarOrbitView::DamageTrail( int nFirstPoint, int nLastPoint )
+{
+	nFirstPoint = max( nFirstPoint, 0 );
+	nLastPoint = min( nLastPoint, (int)m_OrbitPoints.size() - 1 );
+	for ( int nPoint = nFirstPoint; nPoint <= nLastPoint; nPoint++ )
+	{
+		const CPoint& pt = m_OrbitPoints[ nPoint ];
+		if ( !m_bTrailDamage )
+		{
+			m_rectTrailDamage.SetRect( pt.x, pt.y, pt.x, pt.y );
+			m_bTrailDamage = true;
+			continue;
+		}
+		m_rectTrailDamage.left = min( m_rectTrailDamage.left, pt.x );
+		m_rectTrailDamage.top = min( m_rectTrailDamage.top, pt.y );
+		m_rectTrailDamage.right = max( m_rectTrailDamage.right, pt.x );
+		m_rectTrailDamage.bottom = max( m_rectTrailDamage.bottom, pt.y );
+	}
+
+} // DamageTrail
+
+/////////////////////////////////////////////////////////////////////////////
+// the constants of the propagation read from the document
+LUNAR_PARAMETERS CLunarOrbitView::GetPropagationParameters()
 {
 	CLunarOrbitDoc* pDoc = Document;
 
-	// 27 days in seconds
-	const double dSeconds = 27 * 86400;
+	// the constants of the batch are read once so the step loop does not
+	// go through the property getters on every time slice
+	LUNAR_PARAMETERS params;
+
+	// acceleration of earth's gravity on the moon is calculated using 
+	// Newton's equation and is divided by the distance to the moon in
+	// meters to apply the right triangle proportion to each direction
+	params.dGravityRatio = pDoc->AccelerationOfGravity / MoonDistance;
 
-	// starting positions
-	double dX = pDoc->MoonX;
-	double dY = pDoc->MoonY;
+	// the length of a time slice in seconds
+	params.dSampleTime = pDoc->SampleTime;
 
-	// starting velocity
-	double dVx = pDoc->LunarVelocityX;
-	double dVy = pDoc->LunarVelocityY;
+	// screen scaling used to measure the angle of the distance vector
+	params.dMoonScaling = pDoc->MoonScaling;
+	params.nMap = pDoc->Map;
+	params.dAngleError = AngleError;
 
-	// acceleration of earth's gravity on the moon is
-	// calculated using Newton's equation
-	const double dA = pDoc->AccelerationOfGravity;
+	// do not begin testing for 30 degree steps for an hour so we are not 
+	// stopped on the initial reading
+	params.dThirtyDegreeDelay = 3600;
 
-	// starting acceleration of gravity
-	double dAx = pDoc->LunarGravityX;
-	double dAy = pDoc->LunarGravityY;
+	// if we are doing a single orbit, start testing for the end of the 
+	// orbit after 27 days (so the testing only is done when we are close
+	// to the expected result)
+	params.dSingleOrbitDelay = 27 * 86400;
 
-	// the time the model has been run in seconds
-	double dTime = pDoc->RunningTime;
+	return params;
 
-	// mass of the earth in kilograms
-	const double dM = pDoc->MassOfTheEarth;
+} // GetPropagationParameters
 
-	// the distance to the moon in meters
-	const double dR = MoonDistance;
+/////////////////////////////////////////////////////////////////////////////
+// Start the simulation thread from the state of the document. The thread
+// runs the time slices of an hour at a time, so the trail gets a point an
+// hour as it did when the timer ran the model, and keeps the state at the
+// end of each hour until the view takes it.
+void CLunarOrbitView::StartSimulation()
+{
+	CLunarOrbitDoc* pDoc = Document;
 
 	// the number of time slices the day is divided into
 	const int nSamplesPerDay = (int)pDoc->SamplesPerDay;
@@ -954,167 +1444,276 @@ void CLunarOrbitView::UpdateMoonPosition()
 	// samples per hour
 	const int nSamplesPerHour = nSamplesPerDay / 24;
 
-	// the length of a time slice in seconds
-	const double dSt = pDoc->SampleTime;
+	// the view keeps up to the hours the trail holds between two frames,
+	// where older hours would be replaced in the trail anyway
+	const int nHours = int( pDoc->LunarPeriod / 3600 );
+	const int nBatches = max( nHours * TrailOrbits, 1 );
+	m_Simulation.SetPositionCapacity( nBatches );
+	m_Positions.reserve( nBatches );
+
+	// the report of the last fast forward no longer applies
+	m_csFastForward.Empty();
+
+	// the thread counts its batches from zero
+	m_nLastBatch = 0;
+
+	// the stop conditions can be changed while the thread runs
+	m_Simulation.SetThirtyDegreeSteps( ThirtyDegreeSteps );
+	m_Simulation.SetSingleOrbit( SingleOrbit );
+
+	// every time slice the thread runs is recorded while recording
+	m_Simulation.SetRecorder( m_Recorder.IsOpen() ? &m_Recorder : nullptr );
+
+	// the thread advances the state with the document's integrator
+	m_Simulation.Start
+	(
+		pDoc->LunarState, GetPropagationParameters(), pDoc->Integrator,
+		nSamplesPerHour
+	);
+
+} // StartSimulation
+
+/////////////////////////////////////////////////////////////////////////////
+// Stop the simulation thread and the timer that draws its frames, and
+// close any recording, without taking the state the thread reached. This
+// is for when the document is being replaced, where pausing would write
+// the old run over it.
+void CLunarOrbitView::StopSimulation()
+{
+	const bool bRunning = Running;
+	if ( bRunning )
+	{
+		KillTimer( 1 );
+		m_Simulation.Stop();
+		Running = false;
+	}
+
+	if ( m_Recorder.IsOpen() )
+	{
+		StopRecording();
+	}
 
-	double dOldAngle = DistanceVector.Degrees;
+} // StopSimulation
+
+/////////////////////////////////////////////////////////////////////////////
+// Update the moon's position from the simulation thread. Every hour the
+// thread ran since the last frame is added to the trail and the document
+// is given the latest state, so the model runs at its own pace however
+// often the view draws a frame.
+void CLunarOrbitView::UpdateMoonPosition()
+{
+	CLunarOrbitDoc* pDoc = Document;
+
+	// the newest snapshot of the simulation, which is never torn by the
+	// thread writing the next one, and the positions of the hours up to
+	// it that the view has not seen yet
+	const SIMULATION_SNAPSHOT snapshot =
+		m_Simulation.TakeSnapshot( m_Positions );
+
+	// the position, velocity and acceleration of the moon at the end of
+	// the last hour and the time the model has been run in seconds
+	const LUNAR_STATE& state = snapshot.state;
+
+	// the thread stops itself when a stop condition is reached
+	const bool bDone = snapshot.bDone;
+
+	// keep track of orbital points
+	for ( const SIMULATION_POSITION& position : m_Positions )
+	{
+		AddOrbitalPoint( position.dX, position.dY );
+	}
 
 	// are we done with a complete cycle
-	bool bDone = false;
+	if ( bDone && Running )
+	{
+		KillTimer( 1 );
+		m_Simulation.Stop();
+		Running = false;
+	}
 
-	// loop through the time slices and update positions and velocities
-	// using Newton's equations of motion
-	for ( int nSample = 0; nSample < nSamplesPerHour; nSample++ )
+	// record the final vector results into the document, which asks to
+	// be saved when it is closed, once the model has moved on
+	if ( snapshot.nBatch != m_nLastBatch )
+	{
+		m_nLastBatch = snapshot.nBatch;
+		pDoc->LunarState = state;
+		pDoc->SetModifiedFlag();
+	}
+
+	// move the vectors to the new position
+	UpdateMoonVectors();
+
+	// if we are done, repaint the view
+	if ( bDone )
 	{
-		// the acceleration of gravity in the X direction using 
-		// right triangle proportion
-		const double dNewAx = -dA * dX / dR;
+		Invalidate();
+	}
 
-		// the acceleration of gravity in the Y direction using 
-		// right triangle proportion
-		const double dNewAy = -dA * dY / dR;
+} // UpdateMoonPosition
 
-		// the new X velocity in the X direction is the original X velocity
-		// plus X acceleration multiplied by the time increment
-		const double dNewVx = dVx + dAx * dSt;
+/////////////////////////////////////////////////////////////////////////////
+// Update the vectors from the position of the moon in the document. The
+// geometry of all nine vectors and their arrowheads is worked out by
+// m_MoonVectors in one pass, and the main vectors are copied from it
+// before their components are taken, so the components are given their
+// share of the magnitude of the main vectors as before.
+void CLunarOrbitView::UpdateMoonVectors()
+{
+#ifdef _DEBUG
+	// the vector updates only change geometry, so they must not allocate
+	// on this thread whatever the simulation and recorder threads do
+	CAllocationCounter counter;
+#endif
 
-		// the new Y velocity in the Y direction is the original Y velocity
-		// plus Y acceleration multiplied by the time increment
-		const double dNewVy = dVy + dAy * dSt;
+	const CPoint ptMoon = MoonCenter;
+	const CPoint ptEarth = EarthCenter;
 
-		// the new X position is the original X position plus the X velocity
-		// multiplied by the time increment
-		const double dNewX = dX + dVx * dSt;
+	// the gravity vector is two inches long and the velocity vector is
+	// one inch, and every vector has the arrowhead of the distance
+	// vector because the document gives them all the same one
+	const double dGravityLength = InchesToLogical( 2.0 );
+	const double dVelocityLength = InchesToLogical( 1.0 );
+	const double dArrowheadLength =
+		DistanceVector.InchesToLogical( DistanceVector.ArrowheadLength );
+	const double dArrowheadAngle = DistanceVector.ArrowheadAngle;
 
-		// the new Y position is the original Y position plus the Y velocity
-		// multiplied by the time increment
-		const double dNewY = dY + dVy * dSt;
+	m_MoonVectors.SetUpIncrement( DistanceVector.UpIncrement );
+	m_MoonVectors.Update
+	(
+		ptMoon.x, ptMoon.y, ptEarth.x, ptEarth.y, dGravityLength,
+		dVelocityLength, dArrowheadLength, dArrowheadAngle
+	);
 
-		// test the current angle of the gravity vector if doing
-		// 30 degree steps
-		const bool bThirtyDegreeSteps = ThirtyDegreeSteps;
+	// the distance vector with the moon's new position and its X and Y
+	// components, where the components keep the styles and labels they
+	// were given by the document
+	const CLinearBatch& vectors = m_MoonVectors.GetVectors();
+	vectors.GetLine( CMoonVectors::MOON_DISTANCE, DistanceVector );
+	DistanceX.Geometry = DistanceVector.GeometryX;
+	DistanceY.Geometry = DistanceVector.GeometryY;
 
-		// do not begin testing for an hour so we are not stopped on the
-		// initial reading
-		if ( bThirtyDegreeSteps && dTime > 3600 )
-		{
-			pDoc->MoonX = dNewX;
-			pDoc->MoonY = dNewY;
-
-			DistanceVector.FirstPoint = MoonCenter;
-			const double dAngle = DistanceVector.Degrees;
-
-			const double dDelta = dOldAngle - dAngle;
-			dOldAngle = dAngle;
-			const double dMod = fmod( dAngle, 30.0 );
-
-			const double dAngleError = AngleError;
-			const bool bThirty = 
-				CHelper::NearlyEqual( dMod, 0.0, dAngleError );
-			if ( bThirty )
-			{
-				KillTimer( 1 );
-				Running = false;
-				bDone = true;
-			}
-		}
+	// the gravity vector and its X and Y components
+	vectors.GetLine( CMoonVectors::MOON_GRAVITY, GravityVector );
+	GravityX.Geometry = GravityVector.GeometryX;
+	GravityY.Geometry = GravityVector.GeometryY;
+
+	// the velocity vector and its X and Y components
+	vectors.GetLine( CMoonVectors::MOON_VELOCITY, VelocityVector );
+	VelocityX.Geometry = VelocityVector.GeometryX;
+	VelocityY.Geometry = VelocityVector.GeometryY;
+
+#ifdef _DEBUG
+	ASSERT( counter.Allocations == 0 );
+#endif
+
+} // UpdateMoonVectors
+
+/////////////////////////////////////////////////////////////////////////////
+// Run the model from the state of the document to the next stop condition
+// as fast as the CPU allows. The hours are added to the trail as they are
+// run, as on the simulation thread, but nothing is drawn until the stop
+// condition is reached and the view is painted once. The delays before
+// the stop conditions are tested count from where the model is, so the
+// next event is found when the model is already stopped on one, and the
+// model gives up after FAST_FORWARD_ORBITS orbits without reaching one.
+void CLunarOrbitView::FastForward()
+{
+	CLunarOrbitDoc* pDoc = Document;
+
+	// samples per hour
+	const int nSamplesPerHour = max( (int)pDoc->SamplesPerDay / 24, 1 );
+
+	// the state the model starts from
+	LUNAR_STATE state = pDoc->LunarState;
+	const double dStartTime = state.dTime;
+
+	// the stop conditions are tested as if the model started here
+	LUNAR_PARAMETERS params = GetPropagationParameters();
+	params.dThirtyDegreeDelay += dStartTime;
+	params.dSingleOrbitDelay += dStartTime;
 
-		// are we doing a single orbit?
-		const bool bSingleOrbit = SingleOrbit;
+	// the settings are read once instead of every hour
+	const INTEGRATOR eIntegrator = pDoc->Integrator;
+	const bool bThirtyDegreeSteps = ThirtyDegreeSteps;
+	const bool bSingleOrbit = SingleOrbit;
+	const double dLimit = FAST_FORWARD_ORBITS * pDoc->LunarPeriod;
 
-		// if we are doing a single orbit and we have
-		// exceeded 27 days, start testing for the end
-		// of the orbit (so the testing only is done when
-		// we are close to the expected result)
-		if ( bSingleOrbit && dTime > dSeconds )
+	const chrono::steady_clock::time_point start =
+		chrono::steady_clock::now();
+
+	bool bDone = false;
+	while ( !bDone && state.dTime - dStartTime < dLimit )
+	{
+		if ( m_Recorder.IsOpen() )
 		{
-			// difference between the previous X and the new one
-			const double dDelta = dNewX - dX;
-
-			// if the delta is positive, we have reached the beginning
-			// of the orbit
-			if ( dDelta > 0 )
-			{
-				KillTimer( 1 );
-				Running = false;
-				bDone = true;
-				break;
-			}
+			bDone = CPropagator::Propagate
+			(
+				eIntegrator, state, params, nSamplesPerHour,
+				bThirtyDegreeSteps, bSingleOrbit, m_Recorder
+			);
+		}
+		else
+		{
+			bDone = CPropagator::Propagate
+			(
+				eIntegrator, state, params, nSamplesPerHour,
+				bThirtyDegreeSteps, bSingleOrbit
+			);
 		}
 
-		// update the current acceleration, velocity and 
-		// position for the next time slice
-		dAx = dNewAx;
-		dAy = dNewAy;
-		dVx = dNewVx;
-		dVy = dNewVy;
-		dX = dNewX;
-		dY = dNewY;
-
-		// update the running time
-		dTime += dSt;
+		// keep track of orbital points
+		AddOrbitalPoint( state.dX, state.dY );
 	}
 
-	// record the final vector results into the document
-	pDoc->MoonX = dX; // X distance
-	pDoc->MoonY = dY; // Y distance
-	pDoc->LunarVelocityX = dVx; // X velocity
-	pDoc->LunarVelocityY = dVy; // Y velocity
-	pDoc->LunarGravityX = dAx; // X gravity
-	pDoc->LunarGravityY = dAy; // Y gravity
-	pDoc->RunningTime = dTime;
-
-	// update the distance vector with the moon's new position
-	DistanceVector.FirstPoint = MoonCenter;
-	
-	// X and y components of the moon's distance to the earth
-	DistanceX = DistanceVector.VectorX;
-	DistanceX.Description = _T( "Sx" );
-	DistanceY = DistanceVector.VectorY;
-	DistanceY.Description = _T( "Sy" );
-
-	// update the gravity vector with the moon's new position
-	GravityVector.FirstPoint = MoonCenter;
-	GravityVector.SecondPoint = EarthCenter;
+	const chrono::duration<double> wall =
+		chrono::steady_clock::now() - start;
 
-	// set the vector's length to two inches while keeping the angle the same
-	const double dGravityLength = InchesToLogical( 2.0 );
-	GravityVector.Length = dGravityLength;
+	// the simulated time is reported in days and the wall time in
+	// milliseconds
+	m_csFastForward.Format
+	(
+		_T( "Fast forward=%0.2f days in %0.1f ms%s" ),
+		( state.dTime - dStartTime ) / 86400, wall.count() * 1000,
+		bDone ? _T( "" ) : _T( " (no stop)" )
+	);
 
-	// X and y components of gravity
-	GravityX = GravityVector.VectorX;
-	GravityX.Description = _T( "Ax" );
-	GravityY = GravityVector.VectorY;
-	GravityY.Description = _T( "Ay" );
+	// record the final vector results into the document
+	pDoc->LunarState = state;
+	pDoc->SetModifiedFlag();
 
-	// copy the velocity vector location from the acceleration vector
-	VelocityVector.FirstPoint = GravityVector.FirstPoint;
-	VelocityVector.SecondPoint = GravityVector.SecondPoint;
+	// move the vectors to the new position and paint the view once
+	UpdateMoonVectors();
+	Invalidate();
 
-	// set the vector's length to one inch while keeping the angle the
-	// same as the acceleration vector
-	const double dVelocityLength = InchesToLogical( 1.0 );
-	VelocityVector.Length = dVelocityLength;
+} // FastForward
 
-	// the velocity is 90 degrees out of phase with the acceleration
-	// (rotation around the earth is counter-clockwise when looking down 
-	// toward the north pole of the earth)
-	VelocityVector.RotateAroundFirstPoint( -90 );
-	VelocityX = VelocityVector.VectorX;
-	VelocityX.Description = _T( "Vx" );
-	VelocityY = VelocityVector.VectorY;
-	VelocityY.Description = _T( "Vy" );
+/////////////////////////////////////////////////////////////////////////////
+// Start recording every time slice to the given file, which is replaced if
+// it exists. The recorder is only in use while the model runs, so the
+// simulation thread is stopped whenever recording starts or stops.
+void CLunarOrbitView::StartRecording( const CString& csPath )
+{
+	m_RecordFile.open( (LPCTSTR)csPath, ios::binary | ios::trunc );
+	if ( !m_RecordFile.is_open() || !m_Recorder.Open( m_RecordFile ) )
+	{
+		m_RecordFile.close();
+		AfxMessageBox( _T( "The trajectory file could not be written." ) );
+	}
 
-	// keep track of orbital points
-	AddOrbitalPoint();
+} // StartRecording
 
-	// if we are done, repaint the view
-	if ( bDone )
+/////////////////////////////////////////////////////////////////////////////
+// write the rest of the recording and close the file
+void CLunarOrbitView::StopRecording()
+{
+	const bool bRecorded = m_Recorder.Close();
+	m_RecordFile.close();
+	if ( !bRecorded || m_RecordFile.fail() )
 	{
-		Invalidate();
+		AfxMessageBox( _T( "The trajectory file could not be written." ) );
 	}
 
-} // UpdateMoonPosition
+} // StopRecording
 
 /////////////////////////////////////////////////////////////////////////////
 BOOL CLunarOrbitView::OnEraseBkgnd( CDC* pDC )
@@ -1136,11 +1735,11 @@ void CLunarOrbitView::OnVScroll( UINT nSBCode, UINT nPos, CScrollBar* pScrollBar
 /////////////////////////////////////////////////////////////////////////////
 void CLunarOrbitView::OnTimer( UINT_PTR nIDEvent )
 {
-	// update the moon's position and velocity
+	// show the moon's latest position and velocity from the simulation
 	UpdateMoonPosition();
 
-	// redraw the view
-	Invalidate();
+	// redraw where the moving parts were and where they are now
+	InvalidateMovingParts();
 
 	CBaseView::OnTimer( nIDEvent );
 } // OnTimer
@@ -1172,7 +1771,7 @@ void CLunarOrbitView::OnUpdateEditPause( CCmdUI *pCmdUI )
 
 /////////////////////////////////////////////////////////////////////////////
 // the run tool bar button handler changes the running flag and starts
-// the timer
+// or stops the simulation thread and the timer that draws its frames
 void CLunarOrbitView::OnEditRun()
 {
 	const bool bRunning = Running;
@@ -1180,10 +1779,16 @@ void CLunarOrbitView::OnEditRun()
 	{
 		Running = false;
 		KillTimer( 1 );
+		m_Simulation.Stop();
+
+		// the hours run since the last frame are shown where it stopped
+		UpdateMoonPosition();
+		InvalidateMovingParts();
 	}
 	else // paused
 	{
-		SetTimer( 1, 10, nullptr );
+		StartSimulation();
+		SetTimer( 1, DISPLAY_INTERVAL, nullptr );
 		Running = true;
 	}
 
@@ -1250,3 +1855,78 @@ void CLunarOrbitView::OnUpdateEdit30DegSteps( CCmdUI *pCmdUI )
 }
 
 /////////////////////////////////////////////////////////////////////////////
+// the fast forward menu handler stops the model if it is running and runs
+// it to the next stop condition without drawing
+void CLunarOrbitView::OnEditFastForward()
+{
+	const bool bRunning = Running;
+	if ( bRunning )
+	{
+		OnEditRun();
+	}
+
+	CWaitCursor wait;
+	FastForward();
+
+} // OnEditFastForward
+
+/////////////////////////////////////////////////////////////////////////////
+// the fast forward UI handler grays out the menu item unless there is a
+// stop condition to run to
+void CLunarOrbitView::OnUpdateEditFastForward( CCmdUI *pCmdUI )
+{
+	const bool bEnable = SingleOrbit || ThirtyDegreeSteps;
+	pCmdUI->Enable( bEnable );
+
+} // OnUpdateEditFastForward
+
+/////////////////////////////////////////////////////////////////////////////
+// the record menu handler stops recording or asks for a file to record to,
+// where the model is paused while the recording starts or stops
+void CLunarOrbitView::OnEditRecord()
+{
+	const bool bRunning = Running;
+	if ( bRunning )
+	{
+		OnEditRun();
+	}
+
+	if ( m_Recorder.IsOpen() )
+	{
+		CWaitCursor wait;
+		StopRecording();
+	}
+	else // not recording
+	{
+		CFileDialog dlg
+		(
+			FALSE, _T( "lot" ), nullptr,
+			OFN_HIDEREADONLY | OFN_OVERWRITEPROMPT,
+			_T( "Trajectory Files (*.lot)|*.lot|All Files (*.*)|*.*||" ),
+			this
+		);
+		if ( dlg.DoModal() == IDOK )
+		{
+			StartRecording( dlg.GetPathName() );
+		}
+	}
+
+	if ( bRunning )
+	{
+		OnEditRun();
+	}
+
+	// the recording line of the text comes or goes
+	Invalidate();
+
+} // OnEditRecord
+
+/////////////////////////////////////////////////////////////////////////////
+// the record UI handler checks the menu item while recording
+void CLunarOrbitView::OnUpdateEditRecord( CCmdUI *pCmdUI )
+{
+	pCmdUI->SetCheck( m_Recorder.IsOpen() );
+
+} // OnUpdateEditRecord
+
+/////////////////////////////////////////////////////////////////////////////
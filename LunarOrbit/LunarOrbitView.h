@@ -5,6 +5,18 @@
 
 #pragma once
 #include "BaseView.h"
+#include "FastTrig.h"
+#include "DisplayList.h"
+#include "GdiDisplayTarget.h"
+#include "LayerCache.h"
+#include "DamageRegion.h"
+#include "TrailIndex.h"
+#include "TrailDetail.h"
+#include "TrailHistory.h"
+#include "MoonVectors.h"
+#include "Simulation.h"
+#include "TrajectoryRecorder.h"
+#include <fstream>
 #include <vector>
 #include <algorithm>
 
@@ -18,11 +30,97 @@ protected: // create from serialization only
 	DECLARE_DYNCREATE(CLunarOrbitView)
 
 	bool m_bRunning;
-	bool m_bSingleOrbit;
-	bool m_bThirtyDegreeSteps;
 	double m_dAngleError;
+
+	// number of orbits the trail holds
+	int m_nTrailOrbits;
+
+	// the trail projected into logical units
 	vector<CPoint> m_OrbitPoints;
 
+	// number of the sample of the trail history at the first orbit point
+	long long m_nOrbitFirstSample;
+
+	// the projection the orbit points were made with
+	TRAIL_PROJECTION m_TrailProjection;
+
+	// number of orbit points whose segments have been damaged since they
+	// were replaced in the trail history
+	int m_nTrailStale;
+
+	// true if the trail has changed since the last frame
+	bool m_bTrailDamage;
+
+	// logical bounds of the points of the trail that changed since the
+	// last frame
+	CRect m_rectTrailDamage;
+
+	// the file the trajectory is recorded to
+	ofstream m_RecordFile;
+
+	// records every time slice the model runs while recording, which is
+	// declared before the simulation so the thread stops before it closes
+	CTrajectoryRecorder m_Recorder;
+
+	// runs the model on a thread of its own while the view is running
+	CSimulation m_Simulation;
+
+	// the positions at the end of each hour the simulation ran since the
+	// last frame
+	vector<SIMULATION_POSITION> m_Positions;
+
+	// number of batches the simulation had run as of the last frame
+	long long m_nLastBatch;
+
+	// the simulated time and the wall time of the last fast forward
+	CString m_csFastForward;
+
+	// grid over the segments of the orbit trail
+	CTrailIndex m_TrailIndex;
+
+	// segments of the trail inside the area being drawn
+	vector<int> m_VisibleSegments;
+
+	// levels of detail of the orbit trail
+	CTrailDetail m_TrailDetail;
+
+	// runs of a level of detail inside the area being drawn
+	vector<TRAIL_RUN> m_TrailRuns;
+
+	// the geometry of the moon's vectors and their arrowheads
+	CMoonVectors m_MoonVectors;
+
+	// pens, brushes and fonts used by the display lists
+	CDisplayStyles m_Styles;
+
+	// the parts of the view that do not change as the moon moves
+	CDisplayList m_StaticList;
+
+	// the parts of the view recorded again every frame
+	CDisplayList m_DynamicList;
+
+	// draws the display lists on a device context
+	CGdiDisplayTarget m_GdiTarget;
+
+	// decides when the background bitmap has to be drawn again
+	CLayerCache m_BackgroundCache;
+
+	// the parts of the view that do not move for the current zoom,
+	// scroll position and window size
+	CBitmap m_bmBackground;
+
+	// the last frame drawn, kept between paints as the back buffer
+	CBitmap m_bmFrame;
+
+	// the moving parts recorded to work out where they are drawn
+	CDisplayList m_MovingList;
+
+	// client pixels where the moving parts were drawn on the last frame
+	CDamageRegion m_PreviousDamage;
+
+	// client pixels to draw again on the next paint
+	CDamageRegion m_Damage;
+
 	// properties
 public:
 	// pointer to the document class
@@ -62,12 +160,13 @@ public:
 	// stop the model after a single orbit
 	bool GetSingleOrbit()
 	{
-		return m_bSingleOrbit;
+		return Document->SingleOrbit;
 	}
 	// stop the model after a single orbit
 	void SetSingleOrbit( bool value )
 	{
-		m_bSingleOrbit = value;
+		Document->SingleOrbit = value;
+		m_Simulation.SetSingleOrbit( value );
 	}
 	// stop the model after a single orbit
 	__declspec( property( get = GetSingleOrbit, put = SetSingleOrbit ) )
@@ -76,17 +175,82 @@ public:
 	// stop the model every 30 degrees
 	bool GetThirtyDegreeSteps()
 	{
-		return m_bThirtyDegreeSteps;
+		return Document->ThirtyDegreeSteps;
 	}
 	// stop the model every 30 degrees
 	void SetThirtyDegreeSteps( bool value )
 	{
-		m_bThirtyDegreeSteps = value;
+		Document->ThirtyDegreeSteps = value;
+		m_Simulation.SetThirtyDegreeSteps( value );
 	}
 	// stop the model every 30 degrees
 	__declspec( property( get = GetThirtyDegreeSteps, put = SetThirtyDegreeSteps ) )
 		bool ThirtyDegreeSteps;
 
+	// the trail in meters from the earth over the last few orbits
+	inline CTrailHistory& GetTrailHistory()
+	{
+		return Document->TrailHistory;
+	}
+	// the trail in meters from the earth over the last few orbits
+	__declspec( property( get = GetTrailHistory ) )
+		CTrailHistory& TrailHistory;
+
+	// simulated seconds in a second of wall time or zero to run the model
+	// as fast as the CPU allows
+	double GetTimeWarp()
+	{
+		return m_Simulation.GetTimeWarp();
+	}
+	// simulated seconds in a second of wall time or zero to run the model
+	// as fast as the CPU allows
+	void SetTimeWarp( double value )
+	{
+		m_Simulation.SetTimeWarp( value );
+	}
+	// simulated seconds in a second of wall time or zero to run the model
+	// as fast as the CPU allows
+	__declspec( property( get = GetTimeWarp, put = SetTimeWarp ) )
+		double TimeWarp;
+
+	// most seconds the model runs in a frame or zero for no limit
+	double GetFrameBudget()
+	{
+		return m_Simulation.GetFrameBudget();
+	}
+	// most seconds the model runs in a frame or zero for no limit
+	void SetFrameBudget( double value )
+	{
+		m_Simulation.SetFrameBudget( value );
+	}
+	// most seconds the model runs in a frame or zero for no limit
+	__declspec( property( get = GetFrameBudget, put = SetFrameBudget ) )
+		double FrameBudget;
+
+	// smoothed number of time slices the model runs in a second
+	double GetStepsPerSecond()
+	{
+		return m_Simulation.GetStepsPerSecond();
+	}
+	// smoothed number of time slices the model runs in a second
+	__declspec( property( get = GetStepsPerSecond ) )
+		double StepsPerSecond;
+
+	// number of orbits the trail holds
+	int GetTrailOrbits()
+	{
+		return m_nTrailOrbits;
+	}
+	// number of orbits the trail holds where the trail is cleared when
+	// the next point is added
+	void SetTrailOrbits( int value )
+	{
+		m_nTrailOrbits = max( value, 1 );
+	}
+	// number of orbits the trail holds
+	__declspec( property( get = GetTrailOrbits, put = SetTrailOrbits ) )
+		int TrailOrbits;
+
 	// get bottom of view in inches
 	double GetBottomOfView()
 	{
@@ -115,9 +279,11 @@ public:
 	// horizontal velocity in meters per second
 	double GetHorizontalVelocity()
 	{
-		// earth moon angle in radians forming the triangle
-		// on the display
-		const double dRadians = AngleInRadians;
+		// center of the moon on the screen forming the earth moon
+		// triangle on the display
+		CPoint ptMoon = MoonCenterRelativeToEarth;
+		const double dX = ptMoon.x;
+		const double dY = ptMoon.y;
 
 		// the velocity corresponds to the hypotenuse of the
 		// triangle 
@@ -127,8 +293,10 @@ public:
 		// opposite of the angle and since the velocity
 		// is actually perpendicular to the hypotenuse
 		// it is appropriate here to calculate the 
-		// horizontal velocity 
-		const double dSine = sin( dRadians );
+		// horizontal velocity. The sine is the opposite side
+		// divided by the hypotenuse, so the angle is not needed.
+		const double dH = sqrt( dX * dX + dY * dY );
+		const double dSine = dH == 0 ? 0 : dY / dH;
 
 		// the sine of the angle multiplied by the velocity (hypotenuse 
 		// of the triangle) yields the horizontal velocity
@@ -142,9 +310,11 @@ public:
 	// vertical velocity in meters per second
 	double GetVerticalVelocity()
 	{
-		// earth moon angle in radians forming the triangle
-		// on the display
-		const double dRadians = AngleInRadians;
+		// center of the moon on the screen forming the earth moon
+		// triangle on the display
+		CPoint ptMoon = MoonCenterRelativeToEarth;
+		const double dX = ptMoon.x;
+		const double dY = ptMoon.y;
 
 		// the velocity corresponds to the hypotenuse of the
 		// triangle 
@@ -154,8 +324,11 @@ public:
 		// adjacent to the angle and since the velocity
 		// is actually perpendicular to the hypotenuse
 		// it is appropriate here to calculate the 
-		// vertical velocity 
-		const double dCosine = cos( dRadians );
+		// vertical velocity. The angle is from -90 to 90 degrees,
+		// so the cosine is the length of the adjacent side divided
+		// by the hypotenuse.
+		const double dH = sqrt( dX * dX + dY * dY );
+		const double dCosine = dH == 0 ? 1 : fabs( dX ) / dH;
 
 		// the cosine of the angle multiplied by the velocity (hypotenuse 
 		// of the triangle) yields the vertical velocity
@@ -172,18 +345,14 @@ public:
 		// center of the moon on the screen
 		CPoint ptMoon = MoonCenterRelativeToEarth;
 
-		const int nX = ptMoon.x;
-		const int nY = ptMoon.y;
-
-		// length of the hypotenuse using the Pythagorean theorem
-		// i.e. square root of the sum of the squares of the sides
-		const double dH = sqrt( double( nX * nX + nY * nY ) );
+		const double dX = ptMoon.x;
+		const double dY = ptMoon.y;
 
-		// sine of the angle is the ratio of the opposite side / hypotenuse 
-		const double dSine = double( nY ) / dH;
-
-		// angle in radians is the arc sine of the sine of the angle
-		const double value = asin( dSine );
+		// the angle is the arc sine of the opposite side divided by
+		// the hypotenuse, which is the arc tangent of the opposite side
+		// divided by the length of the adjacent side (the arc tangent
+		// does not need the hypotenuse and is zero at the center)
+		const double value = CFastTrig<CTrigPhysics>::Atan2( dY, fabs( dX ) );
 
 		return value;
 	}
@@ -194,11 +363,15 @@ public:
 	// angle in degrees of the moon
 	double GetAngleInDegrees()
 	{
-		// angle in radians
-		const double dRadians = AngleInRadians;
+		// center of the moon on the screen
+		CPoint ptMoon = MoonCenterRelativeToEarth;
 
-		// angle in degrees 
-		const double value = CHelper::GetDegrees( dRadians );
+		// angle in degrees directly from the triangle (see
+		// GetAngleInRadians)
+		const double value = CFastTrig<CTrigPhysics>::Atan2Degrees
+		(
+			double( ptMoon.y ), fabs( double( ptMoon.x ) )
+		);
 
 		// record the angle
 		AngleInDegrees = value;
@@ -218,14 +391,15 @@ public:
 	// text angle in degrees of the moon
 	double GetTextAngleInDegrees()
 	{
-		// angle in radians
-		const double dRadians = AngleInRadians;
-
-		// angle in degrees 
-		double value = CHelper::GetDegrees( dRadians );
-
 		CPoint ptMoon = MoonCenterRelativeToEarth;
 
+		// angle in degrees directly from the triangle (see
+		// GetAngleInRadians)
+		double value = CFastTrig<CTrigPhysics>::Atan2Degrees
+		(
+			double( ptMoon.y ), fabs( double( ptMoon.x ) )
+		);
+
 		// if the moon is to the left of the earth,
 		// convert the angle to one less than -90
 		// degrees
@@ -466,53 +640,111 @@ public:
 public:
 	// protected methods
 protected:
-	// add the current moon position to the historical points of the lunar orbit
-	void AddOrbitalPoint();
+	// add a moon position in meters to the historical points of the lunar
+	// orbit
+	void AddOrbitalPoint( double dX, double dY );
 
-	// update the position of the moon for a day
+	// bring the orbit points up to date with the trail history
+	void SyncTrail();
+
+	// add the given orbit points to the parts of the trail that changed
+	// since the last frame
+	void DamageTrail( int nFirstPoint, int nLastPoint );
+
+	// the constants of the propagation read from the document
+	LUNAR_PARAMETERS GetPropagationParameters();
+
+	// start the simulation thread from the state of the document
+	void StartSimulation();
+
+	// stop the simulation thread and any recording without taking the
+	// state the thread reached
+	void StopSimulation();
+
+	// update the position of the moon from the simulation
 	void UpdateMoonPosition();
 
-	// render the lunar orbit 
-	void RenderLunarOrbit( CDC* pDC );
+	// update the vectors from the position of the moon in the document
+	void UpdateMoonVectors();
+
+	// run the model to the next stop condition without drawing
+	void FastForward();
+
+	// start recording every time slice to the given file
+	void StartRecording( const CString& csPath );
+
+	// write the rest of the recording and close the file
+	void StopRecording();
+
+	// render the parts of the view that do not move
+	void RenderBackground( CDC* pDC );
+
+	// render the parts of the view that move with the moon
+	void RenderForeground( CDC* pDC );
+
+	// render the moon, its vectors and the text that changes with them
+	void RenderMovingParts( CDisplayList& list );
+
+	// invalidate where the moving parts were drawn on the last frame
+	// and where they will be drawn on the next one
+	void InvalidateMovingParts();
+
+	// create the bitmap compatible with the device context unless it
+	// already has the given size and return true if it was created
+	bool CreateBitmap( CDC* pDC, CBitmap& bitmap, int nWidth, int nHeight );
+
+	// render the lunar orbit inside the given area at the level of detail
+	// of the given number of logical units in a pixel
+	void RenderLunarOrbit
+	(
+		CDisplayList& list, const CRect& rectClip, double dUnitsPerPixel
+	);
 
 	// render the equations of motion
-	void RenderEquations( CDC* pDC );
+	void RenderEquations( CDisplayList& list );
 
 	// render the initial condition text
-	void RenderInitialConditions( CDC* pDC );
+	void RenderInitialConditions( CDisplayList& list );
 
 	// render the distance text information
-	void RenderDistanceText( CDC* pDC );
+	void RenderDistanceText( CDisplayList& list );
 
 	// render the gravity text information
-	void RenderGravityText( CDC* pDC );
+	void RenderGravityText( CDisplayList& list );
 
 	// render the velocity text information
-	void RenderVelocityText( CDC* pDC );
+	void RenderVelocityText( CDisplayList& list );
 
 	// render the grid labels
-	void RenderGridLabels( CDC* pDC );
+	void RenderGridLabels( CDisplayList& list );
 
 	// render the grid
-	void RenderGrid( CDC* pDC );
+	void RenderGrid( CDisplayList& list );
 
 	// render the scale labels in inches
-	void RenderScale( CDC* pDC );
+	void RenderScale( CDisplayList& list );
 
 	// render the moon's shape
-	void RenderMoon( CDC* pDC );
+	void RenderMoon( CDisplayList& list );
 
 	// render the earth's shape
-	void RenderEarth( CDC* pDC );
+	void RenderEarth( CDisplayList& list );
 
 	// render distance vector
-	void RenderDistance( CDC* pDC );
+	void RenderDistance( CDisplayList& list );
 
 	// render acceleration vector
-	void RenderAcceleration( CDC* pDC );
+	void RenderAcceleration( CDisplayList& list );
 
 	// render velocity vector
-	void RenderVelocity( CDC* pDC );
+	void RenderVelocity( CDisplayList& list );
+
+	// record one of the moon's vectors with the arrowhead built for it
+	void RecordMoonVector
+	(
+		CDisplayList& list, CMagnitudeVector& vector,
+		CMoonVectors::MOON_VECTOR eVector
+	);
 
 
 // Overrides
@@ -527,6 +759,7 @@ public:
 	virtual BOOL PreCreateWindow(CREATESTRUCT& cs);
 protected:
 	virtual void OnInitialUpdate(); // called first time after construct
+	virtual void OnUpdate( CView* pSender, LPARAM lHint, CObject* pHint );
 	virtual BOOL OnPreparePrinting(CPrintInfo* pInfo);
 	virtual void OnBeginPrinting(CDC* pDC, CPrintInfo* pInfo);
 	virtual void OnPrint( CDC* pDC, CPrintInfo* pInfo );
@@ -561,6 +794,10 @@ public:
 	afx_msg void OnUpdateEditSingleorbit( CCmdUI *pCmdUI );
 	afx_msg void OnEdit30DegSteps();
 	afx_msg void OnUpdateEdit30DegSteps( CCmdUI *pCmdUI );
+	afx_msg void OnEditFastForward();
+	afx_msg void OnUpdateEditFastForward( CCmdUI *pCmdUI );
+	afx_msg void OnEditRecord();
+	afx_msg void OnUpdateEditRecord( CCmdUI *pCmdUI );
 };
 
 #ifndef _DEBUG  // debug version in LunarOrbitView.cpp
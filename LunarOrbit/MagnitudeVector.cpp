@@ -4,9 +4,48 @@
 #include "stdafx.h"
 #include "MagnitudeVector.h"
 #include <vector>
+#include <list>
 
 using namespace std;
 
+/////////////////////////////////////////////////////////////////////////////
+// compare every member of the style
+bool CVectorStyle::operator==( const CVectorStyle& rhs ) const
+{
+	return
+		m_csEngineeringUnits == rhs.m_csEngineeringUnits &&
+		m_csDescription == rhs.m_csDescription &&
+		m_dArrowheadLength == rhs.m_dArrowheadLength &&
+		m_dArrowheadAngle == rhs.m_dArrowheadAngle &&
+		m_bDrawArc == rhs.m_bDrawArc &&
+		m_dThickness == rhs.m_dThickness &&
+		m_dTextHeight == rhs.m_dTextHeight &&
+		m_rgbColor == rhs.m_rgbColor &&
+		m_nDecimals == rhs.m_nDecimals &&
+		m_csNumericalFormat == rhs.m_csNumericalFormat;
+
+} // operator==
+
+/////////////////////////////////////////////////////////////////////////////
+// the shared copy of the given style where the list keeps the address of
+// each style stable and the application only has a handful of styles
+const CVectorStyle* CVectorStyle::Intern( const CVectorStyle& style )
+{
+	static list<CVectorStyle> styles;
+
+	for ( const CVectorStyle& interned : styles )
+	{
+		if ( interned == style )
+		{
+			return &interned;
+		}
+	}
+
+	styles.push_back( style );
+	return &styles.back();
+
+} // Intern
+
 /////////////////////////////////////////////////////////////////////////////
 // returns a line representing one side of the arrowhead
 // drawn at a positive or negative angle offset from the vector's
@@ -236,3 +275,72 @@ void CMagnitudeVector::Draw( CDC * pDC )
 } // Draw
 
 /////////////////////////////////////////////////////////////////////////////
+// record the vector and its description into the display list using pens,
+// brushes and fonts from the given styles
+void CMagnitudeVector::Record( CDisplayList& list, CDisplayStyles& styles )
+{
+	CLinear lineArrowheadPos = CreateArrowhead( true );
+	CLinear lineArrowheadNeg = CreateArrowhead( false );
+	Record
+	(
+		list, styles, lineArrowheadPos.SecondPoint,
+		lineArrowheadNeg.SecondPoint
+	);
+
+} // Record
+
+/////////////////////////////////////////////////////////////////////////////
+// record the vector and its description into the display list using pens,
+// brushes and fonts from the given styles, where the arrowhead points were
+// built ahead of time (see CMoonVectors)
+void CMagnitudeVector::Record
+(
+	CDisplayList& list, CDisplayStyles& styles, CPoint ptPos, CPoint ptNeg
+)
+{
+	const int nThick = InchesToLogical( Thickness );
+	const COLORREF rgbColor = Color;
+	const int nPen = styles.AddPen( DISPLAY_PEN_SOLID, nThick, rgbColor );
+	const int nBrush = styles.AddBrush( rgbColor );
+
+	// get the vector points
+	CPoint pt1 = FirstPoint;
+	CPoint pt2 = SecondPoint;
+
+	// the vector
+	list.Line( nPen, pt1.x, pt1.y, pt2.x, pt2.y );
+
+	// the arrowhead as a polygon
+	const DISPLAY_POINT arrow[ 4 ] =
+	{
+		{ pt2.x, pt2.y }, { ptPos.x, ptPos.y }, { ptNeg.x, ptNeg.y },
+		{ pt2.x, pt2.y }
+	};
+	list.Polygon( nPen, nBrush, arrow, 4 );
+
+	// a dotted arc of the vector angle where the radius is 1/4 of the
+	// length of the vector
+	const double dAngle = Degrees;
+	if ( DrawArc )
+	{
+		const int nPenArc = styles.AddPen( DISPLAY_PEN_DOT, nThick, rgbColor );
+		const int nRadius = int( Length * 1.0 / 4.0 );
+		list.Arc( nPenArc, pt1.x, pt1.y, nRadius, 0.0f, float( dAngle ) );
+	}
+
+	// the text label centered at the mid-point of the vector and rotated
+	// the same as the vector (see DrawMagnitude)
+	const int nTextHeight = InchesToLogical( TextHeight );
+	const int nFont = styles.AddFont( _T( "Arial" ), nTextHeight );
+	const int nX = pt1.x + ( pt2.x - pt1.x ) / 2;
+	const int nY = pt1.y + ( pt2.y - pt1.y ) / 2;
+	const CString csText = Description;
+	list.Text
+	(
+		nFont, int( dAngle * 10 ), DISPLAY_ALIGN_CENTER | DISPLAY_ALIGN_BOTTOM,
+		rgbColor, nX, nY, csText
+	);
+
+} // Record
+
+/////////////////////////////////////////////////////////////////////////////
@@ -3,20 +3,37 @@
 /////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "Linear.h"
+#include "DisplayList.h"
+#include <type_traits>
 
 /////////////////////////////////////////////////////////////////////////////
-// a class representing a magnitude and direction where the base CLinear
-// class controls the direction
-class CMagnitudeVector : public CLinear
+// the geometry of a magnitude vector as a plain value that can be copied
+// every frame without touching the heap
+struct VECTOR_GEOMETRY
 {
-	// public definitions
-public:
+	double dX1; // x co-ordinate of the first point
+	double dY1; // y co-ordinate of the first point
+	double dX2; // x co-ordinate of the second point
+	double dY2; // y co-ordinate of the second point
+	double dRealMagnitude; // value associated with the vector
+};
 
-// protected data
-protected:
-	// magnitude of the vector
-	double m_dRealMagnitude;
+static_assert
+(
+	std::is_trivially_copyable<VECTOR_GEOMETRY>::value,
+	"VECTOR_GEOMETRY must stay a plain value"
+);
 
+/////////////////////////////////////////////////////////////////////////////
+// The style and label of a magnitude vector which is shared by all of the
+// vectors drawn the same way (a flyweight). Styles are interned, so a
+// vector only holds a pointer to its style and copying a vector copies no
+// strings. A style is never changed once interned; changing a property of
+// a vector points it to the interned style holding the new value.
+class CVectorStyle
+{
+	// public data
+public:
 	// units of magnitude
 	CString m_csEngineeringUnits;
 
@@ -45,13 +62,70 @@ protected:
 	// number of decimal places for magnitude text output
 	int m_nDecimals;
 
-	// numerical format character for magnitude text: 
-	// "i": integer 
-	// "e": exponential
-	// "f": floating point
-	// "g": automatically picks between "f" and "e"
+	// numerical format character for magnitude text (see
+	// CMagnitudeVector::NumericalFormat)
 	CString m_csNumericalFormat;
 
+	// public methods
+public:
+	// compare every member of the style
+	bool operator==( const CVectorStyle& rhs ) const;
+
+	// The shared copy of the given style which lives for the life of the
+	// application. Styles are interned from the user interface thread.
+	static const CVectorStyle* Intern( const CVectorStyle& style );
+
+	// public constructor
+public:
+	// the default style of a magnitude vector
+	CVectorStyle()
+	{
+		m_dArrowheadAngle = 15; // 15 degree offset from the vector angle
+		m_dArrowheadLength = 0.1; // length of arrowhead in inches
+		m_rgbColor = RGB( 255, 0, 0 ); // red
+		m_dThickness = 0.02; // inches
+		m_dTextHeight = 0.18; // inches
+		m_nDecimals = 3; // three decimal places of precision
+		m_csNumericalFormat = _T( "e" ); // exponential floating point format
+		m_bDrawArc = true;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a class representing a magnitude and direction where the base CLinear
+// class controls the direction
+class CMagnitudeVector : public CLinear
+{
+	// public definitions
+public:
+
+// protected data
+protected:
+	// magnitude of the vector
+	double m_dRealMagnitude;
+
+	// the shared style and label of the vector
+	const CVectorStyle* m_pStyle;
+
+// protected methods
+protected:
+	// point this vector to the interned style holding the new value of
+	// the given member unless the value is unchanged
+	template <class T> void SetStyleMember
+	(
+		T CVectorStyle::* pMember, const T& value
+	)
+	{
+		if ( m_pStyle->*pMember == value )
+		{
+			return;
+		}
+
+		CVectorStyle style = *m_pStyle;
+		style.*pMember = value;
+		m_pStyle = CVectorStyle::Intern( style );
+	}
+
 // public properties
 public:
 	// value associated with the vector
@@ -71,12 +145,12 @@ public:
 	// units of magnitude
 	inline CString GetEngineeringUnits()
 	{
-		return m_csEngineeringUnits;
+		return m_pStyle->m_csEngineeringUnits;
 	}
 	// units of magnitude
 	inline void SetEngineeringUnits( CString value )
 	{
-		m_csEngineeringUnits = value;
+		SetStyleMember( &CVectorStyle::m_csEngineeringUnits, value );
 	}
 	// units of magnitude
 	__declspec( property( get = GetEngineeringUnits, put = SetEngineeringUnits  ) )
@@ -85,12 +159,12 @@ public:
 	// description of the value
 	inline CString GetDescription()
 	{
-		return m_csDescription;
+		return m_pStyle->m_csDescription;
 	}
 	// description of the value
 	inline void SetDescription( CString value )
 	{
-		m_csDescription = value;
+		SetStyleMember( &CVectorStyle::m_csDescription, value );
 	}
 	// description of the value
 	__declspec( property( get = GetDescription, put = SetDescription  ) )
@@ -99,12 +173,12 @@ public:
 	// length of arrowhead in inches
 	inline double GetArrowheadLength()
 	{
-		return m_dArrowheadLength;
+		return m_pStyle->m_dArrowheadLength;
 	}
 	// length of arrowhead in inches
 	inline void SetArrowheadLength( double value )
 	{
-		m_dArrowheadLength = value;
+		SetStyleMember( &CVectorStyle::m_dArrowheadLength, value );
 	}
 	// length of arrowhead in inches
 	__declspec( property( get = GetArrowheadLength, put = SetArrowheadLength  ) )
@@ -114,13 +188,13 @@ public:
 	// (rotated around second point of vector)
 	inline double GetArrowheadAngle()
 	{
-		return m_dArrowheadAngle;
+		return m_pStyle->m_dArrowheadAngle;
 	}
 	// angle in degrees of the arrowhead with respect to vector
 	// (rotated around second point of vector)
 	inline void SetArrowheadAngle( double value )
 	{
-		m_dArrowheadAngle = value;
+		SetStyleMember( &CVectorStyle::m_dArrowheadAngle, value );
 	}
 	// angle in degrees of the arrowhead with respect to vector
 	// (rotated around second point of vector)
@@ -130,12 +204,12 @@ public:
 	// draw an arc of the angle
 	inline bool GetDrawArc()
 	{
-		return m_bDrawArc;
+		return m_pStyle->m_bDrawArc;
 	}
 	// draw an arc of the angle
 	inline void SetDrawArc( bool value )
 	{
-		m_bDrawArc = value;
+		SetStyleMember( &CVectorStyle::m_bDrawArc, value );
 	}
 	// draw an arc of the angle
 	__declspec( property( get = GetDrawArc, put = SetDrawArc  ) )
@@ -144,12 +218,12 @@ public:
 	// thickness of the vector in inches
 	inline double GetThickness()
 	{
-		return m_dThickness;
+		return m_pStyle->m_dThickness;
 	}
 	// thickness of the vector in inches
 	inline void SetThickness( double value )
 	{
-		m_dThickness = value;
+		SetStyleMember( &CVectorStyle::m_dThickness, value );
 	}
 	// thickness of the vector in inches
 	__declspec( property( get = GetThickness, put = SetThickness  ) )
@@ -158,12 +232,12 @@ public:
 	// text height in inches
 	inline double GetTextHeight()
 	{
-		return m_dTextHeight;
+		return m_pStyle->m_dTextHeight;
 	}
 	// text height in inches
 	inline void SetTextHeight( double value )
 	{
-		m_dTextHeight = value;
+		SetStyleMember( &CVectorStyle::m_dTextHeight, value );
 	}
 	// text height in inches
 	__declspec( property( get = GetTextHeight, put = SetTextHeight  ) )
@@ -172,12 +246,12 @@ public:
 	// color of the vector
 	inline COLORREF GetColor()
 	{
-		return m_rgbColor;
+		return m_pStyle->m_rgbColor;
 	}
 	// color of the vector
 	inline void SetColor( COLORREF value )
 	{
-		m_rgbColor = value;
+		SetStyleMember( &CVectorStyle::m_rgbColor, value );
 	}
 	// color of the vector
 	__declspec( property( get = GetColor, put = SetColor  ) )
@@ -186,12 +260,12 @@ public:
 	// number of decimal places for magnitude text output
 	inline int GetDecimals()
 	{
-		return m_nDecimals;
+		return m_pStyle->m_nDecimals;
 	}
 	// number of decimal places for magnitude text output
 	inline void SetDecimals( int value )
 	{
-		m_nDecimals = value;
+		SetStyleMember( &CVectorStyle::m_nDecimals, value );
 	}
 	// number of decimal places for magnitude text output
 	__declspec( property( get = GetDecimals, put = SetDecimals  ) )
@@ -204,7 +278,7 @@ public:
 	// "g": automatically picks between "f" and "e"
 	inline CString GetNumericalFormat()
 	{
-		return m_csNumericalFormat;
+		return m_pStyle->m_csNumericalFormat;
 	}
 	// numerical format character for magnitude text: 
 	// "i": integer 
@@ -213,7 +287,7 @@ public:
 	// "g": automatically picks between "f" and "e"
 	inline void SetNumericalFormat( CString value )
 	{
-		m_csNumericalFormat = value;
+		SetStyleMember( &CVectorStyle::m_csNumericalFormat, value );
 	}
 	// numerical format character for magnitude text: 
 	// "i": integer 
@@ -223,17 +297,51 @@ public:
 	__declspec( property( get = GetNumericalFormat, put = SetNumericalFormat ) )
 		CString NumericalFormat;
 
-	// get the X vector
-	CMagnitudeVector GetVectorX()
+	// the shared style and label of the vector
+	inline const CVectorStyle* GetStyle()
 	{
-		// copy this vector to the return value
-		CMagnitudeVector value = *this;
+		return m_pStyle;
+	}
+	// the shared style and label of the vector
+	inline void SetStyle( const CVectorStyle* value )
+	{
+		m_pStyle = value;
+	}
+	// the shared style and label of the vector
+	__declspec( property( get = GetStyle, put = SetStyle ) )
+		const CVectorStyle* Style;
 
-		// default to not drawing the arc
-		value.DrawArc = false;
+	// the end points and magnitude of the vector
+	VECTOR_GEOMETRY GetGeometry()
+	{
+		VECTOR_GEOMETRY value;
+		value.dX1 = X1;
+		value.dY1 = Y1;
+		value.dX2 = X2;
+		value.dY2 = Y2;
+		value.dRealMagnitude = RealMagnitude;
+		return value;
+	}
+	// the end points and magnitude of the vector
+	void SetGeometry( const VECTOR_GEOMETRY& value )
+	{
+		X1 = value.dX1;
+		Y1 = value.dY1;
+		X2 = value.dX2;
+		Y2 = value.dY2;
+		RealMagnitude = value.dRealMagnitude;
+	}
+	// the end points and magnitude of the vector
+	__declspec( property( get = GetGeometry, put = SetGeometry ) )
+		VECTOR_GEOMETRY Geometry;
+
+	// the geometry of the X component of the vector
+	VECTOR_GEOMETRY GetGeometryX()
+	{
+		VECTOR_GEOMETRY value = Geometry;
 
 		// the X vector is horizontal so the Y values are the same
-		value.Y2 = Y1;
+		value.dY2 = value.dY1;
 
 		// the absolute length of the current vector
 		const double dLength = Length;
@@ -245,28 +353,25 @@ public:
 			const int nDir = DirectionX;
 
 			// length of the X vector
-			const double dLengthX = nDir * value.Length;
+			const double dLengthX = nDir * fabs( value.dX2 - value.dX1 );
 
 			// the new real magnitude is the proportion of the lengths
-			value.RealMagnitude = RealMagnitude * dLengthX / dLength;
+			value.dRealMagnitude = RealMagnitude * dLengthX / dLength;
 		}
 
 		return value;
 	}
-	// get the X vector
-	__declspec( property( get = GetVectorX ) ) CMagnitudeVector VectorX;
+	// the geometry of the X component of the vector
+	__declspec( property( get = GetGeometryX ) )
+		VECTOR_GEOMETRY GeometryX;
 
-	// get the Y vector
-	CMagnitudeVector GetVectorY()
+	// the geometry of the Y component of the vector
+	VECTOR_GEOMETRY GetGeometryY()
 	{
-		// copy this vector to the return value
-		CMagnitudeVector value = *this;
-
-		// default to not drawing the arc
-		value.DrawArc = false;
+		VECTOR_GEOMETRY value = Geometry;
 
 		// the Y vector is vertical so the X values are the same
-		value.X2 = X1;
+		value.dX2 = value.dX1;
 
 		// the absolute length of the current vector
 		const double dLength = Length;
@@ -278,14 +383,49 @@ public:
 			const int nDir = DirectionY;
 
 			// length of the Y vector
-			const double dLengthY = nDir * value.Length;
+			const double dLengthY = nDir * fabs( value.dY2 - value.dY1 );
 
 			// the new real magnitude is the proportion of the lengths
-			value.RealMagnitude = RealMagnitude * dLengthY / dLength;
+			value.dRealMagnitude = RealMagnitude * dLengthY / dLength;
 		}
 
 		return value;
 	}
+	// the geometry of the Y component of the vector
+	__declspec( property( get = GetGeometryY ) )
+		VECTOR_GEOMETRY GeometryY;
+
+	// get the X vector
+	CMagnitudeVector GetVectorX()
+	{
+		// copy this vector to the return value which shares the style
+		CMagnitudeVector value = *this;
+
+		// default to not drawing the arc
+		value.DrawArc = false;
+
+		// the horizontal component
+		value.Geometry = GeometryX;
+
+		return value;
+	}
+	// get the X vector
+	__declspec( property( get = GetVectorX ) ) CMagnitudeVector VectorX;
+
+	// get the Y vector
+	CMagnitudeVector GetVectorY()
+	{
+		// copy this vector to the return value which shares the style
+		CMagnitudeVector value = *this;
+
+		// default to not drawing the arc
+		value.DrawArc = false;
+
+		// the vertical component
+		value.Geometry = GeometryY;
+
+		return value;
+	}
 	// get the Y vector
 	__declspec( property( get = GetVectorY ) ) CMagnitudeVector VectorY;
 
@@ -336,26 +476,13 @@ protected:
 
 // public methods
 public:
-	// copies an input vector to this vector
-	CMagnitudeVector operator=( CMagnitudeVector& in )
-	{
-		X1 = in.X1;
-		X2 = in.X2;
-		Y1 = in.Y1;
-		Y2 = in.Y2;
-		UpIncrement = in.UpIncrement;
+	// copies an input vector to this vector where the style is shared
+	CMagnitudeVector& operator=( const CMagnitudeVector& in )
+	{
+		CLinear::operator=( in );
 		Map = in.Map;
-		RealMagnitude = in.RealMagnitude;
-		EngineeringUnits = in.EngineeringUnits;
-		Description = in.Description;
-		ArrowheadLength = in.ArrowheadLength;
-		ArrowheadAngle = in.ArrowheadAngle;
-		DrawArc = in.DrawArc;
-		Thickness = in.Thickness;
-		TextHeight = in.TextHeight;
-		Color = in.Color;
-		Decimals = in.Decimals;
-		NumericalFormat = in.NumericalFormat;
+		m_dRealMagnitude = in.m_dRealMagnitude;
+		m_pStyle = in.m_pStyle;
 
 		return *this;
 	}
@@ -369,6 +496,18 @@ public:
 	// draw on given device context
 	void Draw( CDC* pDC );
 
+	// record the vector and its description into the display list
+	// using pens, brushes and fonts from the given styles
+	void Record( CDisplayList& list, CDisplayStyles& styles );
+
+	// record the vector with the given second points of the two sides of
+	// its arrowhead
+	void Record
+	(
+		CDisplayList& list, CDisplayStyles& styles, CPoint ptPos,
+		CPoint ptNeg
+	);
+
 	// generate font characteristics from given font enumeration, where
 	// the enumeration is based on Atlas PDF definition
 	static void BuildFont
@@ -398,15 +537,19 @@ public:
 	// constructor
 	CMagnitudeVector()
 	{
-		ArrowheadAngle = 15; // 15 degree offset from the vector angle
-		ArrowheadLength = 0.1; // length of arrowhead in inches
 		RealMagnitude = 0; // default magnitude of the vector
-		Color = RGB( 255, 0, 0 ); // red
-		Thickness = 0.02; // inches
-		TextHeight = 0.18; // inches
-		Decimals = 3; // three decimal places of precision
-		NumericalFormat = _T( "e" ); // exponential floating point format
-		DrawArc = true;
+
+		// the default style (red arrows with 15 degree arrowheads, 0.02
+		// inch lines and 0.18 inch labels in exponential format) is
+		// interned once and shared by every new vector
+		static const CVectorStyle* pDefault =
+			CVectorStyle::Intern( CVectorStyle() );
+		m_pStyle = pDefault;
+	}
+	// copy constructor which shares the style
+	CMagnitudeVector( const CMagnitudeVector& in )
+	{
+		*this = in;
 	}
 	// destructor
 	virtual ~CMagnitudeVector()
@@ -0,0 +1,93 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "MoonVectors.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// The batches hold every segment from the start, so an update only
+// replaces their points, and the arrowheads are built once so their
+// arrays have the size they keep.
+CMoonVectors::CMoonVectors()
+{
+	for ( int nForce = 0; nForce < FORCES; nForce++ )
+	{
+		m_Forces.Add( 0, 0, 0, 0 );
+	}
+
+	// gravity keeps its direction and the velocity is 90 degrees out of
+	// phase with it (rotation around the earth is counter-clockwise when
+	// looking down toward the north pole of the earth)
+	m_Turns[ FORCE_GRAVITY ] = CLinearBatch::GetRotation( 0 );
+	m_Turns[ FORCE_VELOCITY ] = CLinearBatch::GetRotation( -90 );
+
+	for ( int nVector = 0; nVector < MOON_VECTORS; nVector++ )
+	{
+		m_Vectors.Add( 0, 0, 0, 0 );
+	}
+	m_Vectors.CreateArrowheads( 0, 0, m_Positive, m_Negative );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// increment amount to move up the DC one pixel (1 or -1)
+void CMoonVectors::SetUpIncrement( int value )
+{
+	m_Forces.SetUpIncrement( value );
+	m_Vectors.SetUpIncrement( value );
+
+} // SetUpIncrement
+
+/////////////////////////////////////////////////////////////////////////////
+// Move the vectors to the moon at the given position in logical units and
+// build the sides of the arrowheads. The gravity and velocity vectors are
+// given their lengths and turns together, and then each of the three
+// vectors and its components are copied into the batch of nine, where
+// the X component runs along the vector's run and the Y component along
+// its rise.
+void CMoonVectors::Update
+(
+	double dMoonX, double dMoonY, double dEarthX, double dEarthY,
+	double dGravityLength, double dVelocityLength,
+	double dArrowheadLength, double dArrowheadAngle
+)
+{
+	const double lengths[ FORCES ] = { dGravityLength, dVelocityLength };
+	for ( int nForce = 0; nForce < FORCES; nForce++ )
+	{
+		m_Forces.SetPoints( nForce, dMoonX, dMoonY, dEarthX, dEarthY );
+	}
+	m_Forces.SetLength( lengths );
+	m_Forces.RotateAroundFirstPoint( m_Turns );
+
+	const double dGravityX = m_Forces.GetX2( FORCE_GRAVITY );
+	const double dGravityY = m_Forces.GetY2( FORCE_GRAVITY );
+	const double dVelocityX = m_Forces.GetX2( FORCE_VELOCITY );
+	const double dVelocityY = m_Forces.GetY2( FORCE_VELOCITY );
+
+	const struct
+	{
+		int nVector;
+		double dX2;
+		double dY2;
+	} ends[] =
+	{
+		{ MOON_DISTANCE, dEarthX, dEarthY },
+		{ MOON_GRAVITY, dGravityX, dGravityY },
+		{ MOON_VELOCITY, dVelocityX, dVelocityY },
+	};
+
+	for ( const auto& end : ends )
+	{
+		const int nVector = end.nVector;
+		m_Vectors.SetPoints( nVector, dMoonX, dMoonY, end.dX2, end.dY2 );
+		m_Vectors.SetPoints( nVector + 1, dMoonX, dMoonY, end.dX2, dMoonY );
+		m_Vectors.SetPoints( nVector + 2, dMoonX, dMoonY, dMoonX, end.dY2 );
+	}
+
+	m_Vectors.CreateArrowheads
+	(
+		dArrowheadLength, dArrowheadAngle, m_Positive, m_Negative
+	);
+
+} // Update
+
+/////////////////////////////////////////////////////////////////////////////
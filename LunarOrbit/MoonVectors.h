@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "LinearBatch.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// The geometry of the distance, gravity and velocity vectors of the moon
+// and their X and Y components, worked out for each frame as a
+// CLinearBatch instead of one CLinear at a time. Every vector starts at
+// the moon, the distance vector ends at the earth, the gravity vector
+// points at the earth and the velocity vector is turned 90 degrees
+// clockwise from it, as CLunarOrbitView::UpdateMoonVectors draws them.
+// The two sides of the arrowheads of all nine vectors are built in the
+// same pass.
+//
+// The batches are sized when the vectors are constructed, so a frame does
+// not touch the heap. The vectors do not depend on MFC.
+class CMoonVectors
+{
+	// public definitions
+public:
+	// the vectors in the order they are kept in the batches
+	enum MOON_VECTOR
+	{
+		MOON_DISTANCE, // moon to earth
+		MOON_DISTANCE_X, // X component of the distance
+		MOON_DISTANCE_Y, // Y component of the distance
+		MOON_GRAVITY, // acceleration of gravity
+		MOON_GRAVITY_X, // X component of gravity
+		MOON_GRAVITY_Y, // Y component of gravity
+		MOON_VELOCITY, // velocity
+		MOON_VELOCITY_X, // X component of the velocity
+		MOON_VELOCITY_Y, // Y component of the velocity
+		MOON_VECTORS // number of vectors
+	};
+
+	// protected definitions
+protected:
+	// the vectors that are given a length and a turn
+	enum MOON_FORCE
+	{
+		FORCE_GRAVITY, // gravity
+		FORCE_VELOCITY, // velocity
+		FORCES // number of vectors given a length and a turn
+	};
+
+	// protected data
+protected:
+	// the gravity and velocity vectors while they are given their
+	// lengths and turns
+	CLinearBatch m_Forces;
+
+	// the turn of each of the forces
+	LINEAR_ROTATION m_Turns[ FORCES ];
+
+	// the nine vectors
+	CLinearBatch m_Vectors;
+
+	// the sides of the arrowheads at the second point of each vector
+	// turned either way from the reverse of the vector
+	CLinearBatch m_Positive;
+	CLinearBatch m_Negative;
+
+	// public properties
+public:
+	// the nine vectors in the order of MOON_VECTOR
+	const CLinearBatch& GetVectors() const
+	{
+		return m_Vectors;
+	}
+
+	// the side of each arrowhead turned the positive way
+	const CLinearBatch& GetPositiveArrowheads() const
+	{
+		return m_Positive;
+	}
+
+	// the side of each arrowhead turned the negative way
+	const CLinearBatch& GetNegativeArrowheads() const
+	{
+		return m_Negative;
+	}
+
+	// increment amount to move up the DC one pixel (1 or -1)
+	int GetUpIncrement() const
+	{
+		return m_Vectors.GetUpIncrement();
+	}
+	// increment amount to move up the DC one pixel (1 or -1)
+	void SetUpIncrement( int value = -1 );
+
+	// public methods
+public:
+	// Move the vectors to the moon at the given position in logical
+	// units, where the gravity and velocity vectors have the given
+	// lengths, and build the sides of the arrowheads with the given
+	// length in logical units and angle in degrees.
+	void Update
+	(
+		double dMoonX, double dMoonY, double dEarthX, double dEarthY,
+		double dGravityLength, double dVelocityLength,
+		double dArrowheadLength, double dArrowheadAngle
+	);
+
+	// public construction
+public:
+	CMoonVectors();
+};
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,398 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "PeriodicOrbit.h"
+#include <algorithm>
+#include <thread>
+
+/////////////////////////////////////////////////////////////////////////////
+// copy the position and velocity of a state into four components
+static void GetComponents( const LUNAR_STATE& state, double dValues[ 4 ] )
+{
+	dValues[ 0 ] = state.dX;
+	dValues[ 1 ] = state.dY;
+	dValues[ 2 ] = state.dVx;
+	dValues[ 3 ] = state.dVy;
+
+} // GetComponents
+
+/////////////////////////////////////////////////////////////////////////////
+// copy four components into the position and velocity of a state and
+// update the acceleration of gravity to match the position
+static void SetComponents
+(
+	LUNAR_STATE& state, const double dValues[ 4 ], double dGravityRatio
+)
+{
+	state.dX = dValues[ 0 ];
+	state.dY = dValues[ 1 ];
+	state.dVx = dValues[ 2 ];
+	state.dVy = dValues[ 3 ];
+	state.dAx = -dGravityRatio * state.dX;
+	state.dAy = -dGravityRatio * state.dY;
+
+} // SetComponents
+
+/////////////////////////////////////////////////////////////////////////////
+CPeriodicOrbitFinder::CPeriodicOrbitFinder
+(
+	double dGravityRatio, double dSampleTime
+)
+{
+	m_dGravityRatio = dGravityRatio;
+	m_dSampleTime = dSampleTime;
+	m_eIntegrator = INTEGRATOR_RK4;
+	m_nSegments = 8;
+	m_nMaximumIterations = 20;
+	m_dTolerance = 1e-10;
+	m_nThreads = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// integrate each segment for the given duration along with its state
+// transition matrix where the segments are divided among worker threads
+void CPeriodicOrbitFinder::PropagateSegments
+(
+	vector<SEGMENT>& segments, double dDuration, int nSteps
+)
+{
+	const int nSegments = (int)segments.size();
+
+	int nThreads = m_nThreads;
+	if ( nThreads <= 0 )
+	{
+		nThreads = (int)thread::hardware_concurrency();
+	}
+	nThreads = max( 1, min( nThreads, nSegments ) );
+
+	LUNAR_PARAMETERS params = {};
+	params.dGravityRatio = m_dGravityRatio;
+	params.dSampleTime = dDuration / nSteps;
+
+	const INTEGRATOR eIntegrator = m_eIntegrator;
+
+	// each worker integrates every nThreads'th segment so the segments
+	// are independent and no locking is needed
+	auto work = [ & ]( int nFirst )
+	{
+		for ( int nSegment = nFirst; nSegment < nSegments; nSegment += nThreads )
+		{
+			SEGMENT& segment = segments[ nSegment ];
+			segment.end = segment.start;
+			segment.end.dTime = 0;
+
+			CVariationalPropagator::Propagate
+			(
+				eIntegrator, segment.end, params, nSteps, segment.sensitivity
+			);
+		}
+	};
+
+	// the calling thread does its share of the work
+	vector<thread> workers;
+	for ( int nThread = 1; nThread < nThreads; nThread++ )
+	{
+		workers.push_back( thread( work, nThread ) );
+	}
+	work( 0 );
+
+	for ( auto& worker : workers )
+	{
+		worker.join();
+	}
+
+} // PropagateSegments
+
+/////////////////////////////////////////////////////////////////////////////
+// solve the square system in place by Gaussian elimination with partial
+// pivoting where the matrix is stored by rows and the solution replaces
+// the right hand side
+bool CPeriodicOrbitFinder::Solve
+(
+	vector<double>& matrix, vector<double>& rhs, int n
+)
+{
+	for ( int nColumn = 0; nColumn < n; nColumn++ )
+	{
+		// the largest pivot in the column
+		int nPivot = nColumn;
+		for ( int nRow = nColumn + 1; nRow < n; nRow++ )
+		{
+			if
+			(
+				fabs( matrix[ nRow * n + nColumn ] ) >
+				fabs( matrix[ nPivot * n + nColumn ] )
+			)
+			{
+				nPivot = nRow;
+			}
+		}
+
+		const double dPivot = matrix[ nPivot * n + nColumn ];
+		if ( dPivot == 0 )
+		{
+			return false;
+		}
+
+		if ( nPivot != nColumn )
+		{
+			for ( int n2 = 0; n2 < n; n2++ )
+			{
+				swap( matrix[ nPivot * n + n2 ], matrix[ nColumn * n + n2 ] );
+			}
+			swap( rhs[ nPivot ], rhs[ nColumn ] );
+		}
+
+		for ( int nRow = nColumn + 1; nRow < n; nRow++ )
+		{
+			const double dFactor = matrix[ nRow * n + nColumn ] / dPivot;
+			if ( dFactor == 0 )
+			{
+				continue;
+			}
+			for ( int n2 = nColumn; n2 < n; n2++ )
+			{
+				matrix[ nRow * n + n2 ] -= dFactor * matrix[ nColumn * n + n2 ];
+			}
+			rhs[ nRow ] -= dFactor * rhs[ nColumn ];
+		}
+	}
+
+	// back substitution
+	for ( int nRow = n - 1; nRow >= 0; nRow-- )
+	{
+		double dSum = rhs[ nRow ];
+		for ( int n2 = nRow + 1; n2 < n; n2++ )
+		{
+			dSum -= matrix[ nRow * n + n2 ] * rhs[ n2 ];
+		}
+		rhs[ nRow ] = dSum / matrix[ nRow * n + nRow ];
+	}
+
+	return true;
+
+} // Solve
+
+/////////////////////////////////////////////////////////////////////////////
+// Correct the initial conditions and period of an orbit near the guess.
+// The unknowns are the four components of the start of each segment
+// followed by the period, and the equations are the mismatch between the
+// end of each segment and the start of the next (the last segment wraps
+// around to the first) followed by the phase and family conditions. The
+// unknowns and equations are scaled by the size of the orbit, the orbital
+// speed and the time scale of the model so they are of similar magnitude.
+bool CPeriodicOrbitFinder::Find
+(
+	const LUNAR_STATE& guess, double dPeriod, PERIODIC_ORBIT& orbit
+)
+{
+	const double dK = m_dGravityRatio;
+	const int nSegments = m_nSegments;
+	const int nUnknowns = 4 * nSegments + 1;
+	const int nEquations = 4 * nSegments + 2;
+	const int nPeriod = 4 * nSegments;
+
+	// the X distance of the first segment is held fixed
+	const double dDistance = guess.dX;
+
+	// characteristic length, speed and time of the orbit
+	const double dRoot = sqrt( dK );
+	const double dLength =
+		max( 1.0, sqrt( guess.dX * guess.dX + guess.dY * guess.dY ) );
+	const double dSpeed = dLength * dRoot;
+	const double dTimeScale = 1 / dRoot;
+	const double dScale[ 4 ] = { dLength, dLength, dSpeed, dSpeed };
+
+	// the number of time slices per segment is fixed for the whole solve
+	// so the integrated map changes smoothly with the period
+	const int nSteps =
+		max( 1, (int)ceil( dPeriod / nSegments / m_dSampleTime ) );
+
+	// the initial segments are taken from a single integration of the guess
+	vector<SEGMENT> segments( nSegments );
+	{
+		CStateVector<double, 4> y;
+		GetComponents( guess, &y[ 0 ] );
+		const double dSlice = dPeriod / nSegments / nSteps;
+		for ( int nSegment = 0; nSegment < nSegments; nSegment++ )
+		{
+			segments[ nSegment ].start = guess;
+			SetComponents( segments[ nSegment ].start, &y[ 0 ], dK );
+			CPropagator::Integrate( m_eIntegrator, y, dK, dSlice, nSteps );
+		}
+	}
+
+	vector<double> residuals( nEquations );
+	vector<double> jacobian( nEquations * nUnknowns );
+	vector<double> normal( nUnknowns * nUnknowns );
+	vector<double> step( nUnknowns );
+
+	orbit.bConverged = false;
+	orbit.nIterations = 0;
+
+	for ( int nIteration = 0; nIteration <= m_nMaximumIterations; nIteration++ )
+	{
+		const double dDuration = dPeriod / nSegments;
+		PropagateSegments( segments, dDuration, nSteps );
+
+		// the scaled mismatch and the scaled Jacobian
+		fill( jacobian.begin(), jacobian.end(), 0.0 );
+		double dResidual = 0;
+		for ( int nSegment = 0; nSegment < nSegments; nSegment++ )
+		{
+			const SEGMENT& segment = segments[ nSegment ];
+			const int nNext = ( nSegment + 1 ) % nSegments;
+
+			double dEnd[ 4 ];
+			double dStart[ 4 ];
+			GetComponents( segment.end, dEnd );
+			GetComponents( segments[ nNext ].start, dStart );
+
+			// the slope of the state at the end of the segment
+			const double dSlope[ 4 ] =
+			{
+				dEnd[ 2 ], dEnd[ 3 ], -dK * dEnd[ 0 ], -dK * dEnd[ 1 ]
+			};
+
+			for ( int i = 0; i < 4; i++ )
+			{
+				const int nRow = nSegment * 4 + i;
+				double* pRow = &jacobian[ nRow * nUnknowns ];
+
+				residuals[ nRow ] = ( dEnd[ i ] - dStart[ i ] ) / dScale[ i ];
+				dResidual = max( dResidual, fabs( residuals[ nRow ] ) );
+
+				for ( int j = 0; j < 4; j++ )
+				{
+					pRow[ nSegment * 4 + j ] +=
+						segment.sensitivity.dTransition[ i ][ j ] *
+						dScale[ j ] / dScale[ i ];
+				}
+				pRow[ nNext * 4 + i ] -= 1;
+
+				// each segment lasts a fraction of the period
+				pRow[ nPeriod ] =
+					dSlope[ i ] / nSegments * dTimeScale / dScale[ i ];
+			}
+		}
+
+		// the first segment starts on the X axis at the given distance
+		const int nPhase = nSegments * 4;
+		const int nFamily = nPhase + 1;
+		residuals[ nPhase ] = segments[ 0 ].start.dY / dLength;
+		residuals[ nFamily ] = ( segments[ 0 ].start.dX - dDistance ) / dLength;
+		jacobian[ nPhase * nUnknowns + 1 ] = 1;
+		jacobian[ nFamily * nUnknowns + 0 ] = 1;
+		dResidual = max( dResidual, fabs( residuals[ nPhase ] ) );
+		dResidual = max( dResidual, fabs( residuals[ nFamily ] ) );
+
+		orbit.state = segments[ 0 ].start;
+		orbit.state.dTime = 0;
+		orbit.dPeriod = dPeriod;
+		orbit.nIterations = nIteration;
+		orbit.dResidual = dResidual;
+
+		if ( dResidual < m_dTolerance )
+		{
+			orbit.bConverged = true;
+			break;
+		}
+		if ( nIteration == m_nMaximumIterations )
+		{
+			break;
+		}
+
+		// the normal equations of the Gauss-Newton step with a small
+		// damping term, so the step has no component along directions
+		// the equations do not determine (the minimum norm step)
+		double dLargest = 0;
+		for ( int i = 0; i < nUnknowns; i++ )
+		{
+			for ( int j = i; j < nUnknowns; j++ )
+			{
+				double dSum = 0;
+				for ( int nRow = 0; nRow < nEquations; nRow++ )
+				{
+					dSum +=
+						jacobian[ nRow * nUnknowns + i ] *
+						jacobian[ nRow * nUnknowns + j ];
+				}
+				normal[ i * nUnknowns + j ] = dSum;
+				normal[ j * nUnknowns + i ] = dSum;
+			}
+			dLargest = max( dLargest, normal[ i * nUnknowns + i ] );
+
+			double dSum = 0;
+			for ( int nRow = 0; nRow < nEquations; nRow++ )
+			{
+				dSum -= jacobian[ nRow * nUnknowns + i ] * residuals[ nRow ];
+			}
+			step[ i ] = dSum;
+		}
+		const double dDamping = max( dLargest, 1.0 ) * 1e-12;
+		for ( int i = 0; i < nUnknowns; i++ )
+		{
+			normal[ i * nUnknowns + i ] += dDamping;
+		}
+
+		if ( !Solve( normal, step, nUnknowns ) )
+		{
+			break;
+		}
+
+		// apply the step in the original units
+		for ( int nSegment = 0; nSegment < nSegments; nSegment++ )
+		{
+			double dStart[ 4 ];
+			GetComponents( segments[ nSegment ].start, dStart );
+			for ( int i = 0; i < 4; i++ )
+			{
+				dStart[ i ] += step[ nSegment * 4 + i ] * dScale[ i ];
+			}
+			SetComponents( segments[ nSegment ].start, dStart, dK );
+		}
+		dPeriod += step[ nPeriod ] * dTimeScale;
+	}
+
+	return orbit.bConverged;
+
+} // Find
+
+/////////////////////////////////////////////////////////////////////////////
+// find a member of the family for each X distance where each member is
+// started from the previous converged member scaled to the new distance
+vector<PERIODIC_ORBIT> CPeriodicOrbitFinder::FindFamily
+(
+	const LUNAR_STATE& guess, double dPeriod,
+	const vector<double>& distances
+)
+{
+	vector<PERIODIC_ORBIT> family;
+	family.reserve( distances.size() );
+
+	LUNAR_STATE start = guess;
+	for ( const double dDistance : distances )
+	{
+		// scale the position and velocity to the new distance
+		const double dRatio = start.dX == 0 ? 1 : dDistance / start.dX;
+		start.dX = dDistance;
+		start.dY *= dRatio;
+		start.dVx *= dRatio;
+		start.dVy *= dRatio;
+
+		PERIODIC_ORBIT orbit;
+		Find( start, dPeriod, orbit );
+		family.push_back( orbit );
+
+		if ( orbit.bConverged )
+		{
+			start = orbit.state;
+			dPeriod = orbit.dPeriod;
+		}
+	}
+
+	return family;
+
+} // FindFamily
+
+/////////////////////////////////////////////////////////////////////////////
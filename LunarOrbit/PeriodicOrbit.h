@@ -0,0 +1,190 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Variational.h"
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// a periodic orbit found by CPeriodicOrbitFinder
+struct PERIODIC_ORBIT
+{
+	// corrected initial conditions of the orbit
+	LUNAR_STATE state;
+
+	// corrected period in seconds
+	double dPeriod;
+
+	// number of Newton iterations used
+	int nIterations;
+
+	// largest mismatch between the segments at the last iteration scaled
+	// by the size of the orbit
+	double dResidual;
+
+	// true if the residual fell below the tolerance
+	bool bConverged;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Finds periodic orbits of the lunar model with Newton multiple shooting.
+// The orbit is divided into segments whose initial states and the period
+// are the unknowns. Each iteration integrates the segments in parallel
+// with their state transition matrices (see Variational.h), which form the
+// Jacobian of the mismatch between the end of each segment and the start
+// of the next. Two more conditions fix the orbit: the first segment starts
+// on the X axis (the phase) and at the requested X distance (the member of
+// the family). The minimum norm Gauss-Newton step is used because the
+// conditions are redundant along the flow and, in a model where every
+// orbit closes, the speed along the orbit is not determined by them.
+class CPeriodicOrbitFinder
+{
+	// protected definitions
+protected:
+	// a segment of the orbit integrated by one worker
+	struct SEGMENT
+	{
+		LUNAR_STATE start; // the state at the start of the segment
+		LUNAR_STATE end; // the state at the end of the segment
+		LUNAR_SENSITIVITY sensitivity; // derivative of end by start
+	};
+
+	// protected data
+protected:
+	// acceleration of gravity divided by the radius of the orbit
+	double m_dGravityRatio;
+
+	// nominal length of a time slice in seconds, where the time slice
+	// is adjusted so each segment is a whole number of slices
+	double m_dSampleTime;
+
+	// method used to integrate the segments
+	INTEGRATOR m_eIntegrator;
+
+	// number of segments the orbit is divided into
+	int m_nSegments;
+
+	// maximum number of Newton iterations
+	int m_nMaximumIterations;
+
+	// largest scaled mismatch accepted as a closed orbit
+	double m_dTolerance;
+
+	// number of worker threads integrating the segments (zero for one
+	// per hardware thread)
+	int m_nThreads;
+
+	// public methods
+public:
+	// acceleration of gravity divided by the radius of the orbit
+	double GetGravityRatio() const
+	{
+		return m_dGravityRatio;
+	}
+	// acceleration of gravity divided by the radius of the orbit
+	void SetGravityRatio( double value )
+	{
+		m_dGravityRatio = value;
+	}
+
+	// nominal length of a time slice in seconds
+	double GetSampleTime() const
+	{
+		return m_dSampleTime;
+	}
+	// nominal length of a time slice in seconds
+	void SetSampleTime( double value )
+	{
+		m_dSampleTime = value;
+	}
+
+	// method used to integrate the segments
+	INTEGRATOR GetIntegrator() const
+	{
+		return m_eIntegrator;
+	}
+	// method used to integrate the segments
+	void SetIntegrator( INTEGRATOR value )
+	{
+		m_eIntegrator = value;
+	}
+
+	// number of segments the orbit is divided into
+	int GetSegments() const
+	{
+		return m_nSegments;
+	}
+	// number of segments the orbit is divided into
+	void SetSegments( int value )
+	{
+		m_nSegments = value < 1 ? 1 : value;
+	}
+
+	// maximum number of Newton iterations
+	int GetMaximumIterations() const
+	{
+		return m_nMaximumIterations;
+	}
+	// maximum number of Newton iterations
+	void SetMaximumIterations( int value )
+	{
+		m_nMaximumIterations = value;
+	}
+
+	// largest scaled mismatch accepted as a closed orbit
+	double GetTolerance() const
+	{
+		return m_dTolerance;
+	}
+	// largest scaled mismatch accepted as a closed orbit
+	void SetTolerance( double value )
+	{
+		m_dTolerance = value;
+	}
+
+	// number of worker threads (zero for one per hardware thread)
+	int GetThreads() const
+	{
+		return m_nThreads;
+	}
+	// number of worker threads (zero for one per hardware thread)
+	void SetThreads( int value )
+	{
+		m_nThreads = value;
+	}
+
+	// correct the initial conditions and period of an orbit near the
+	// given guess where the X distance of the guess is held fixed
+	bool Find
+	(
+		const LUNAR_STATE& guess, double dPeriod, PERIODIC_ORBIT& orbit
+	);
+
+	// Find a family of orbits, one for each X distance, where each member
+	// is started from the previous member scaled to the new distance.
+	vector<PERIODIC_ORBIT> FindFamily
+	(
+		const LUNAR_STATE& guess, double dPeriod,
+		const vector<double>& distances
+	);
+
+	// protected methods
+protected:
+	// integrate each segment for the given duration in parallel
+	void PropagateSegments
+	(
+		vector<SEGMENT>& segments, double dDuration, int nSteps
+	);
+
+	// solve the square system in place by Gaussian elimination with
+	// partial pivoting and return false if the matrix is singular
+	static bool Solve( vector<double>& matrix, vector<double>& rhs, int n );
+
+	// public construction
+public:
+	CPeriodicOrbitFinder( double dGravityRatio, double dSampleTime );
+};
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,439 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cmath>
+#include "RungeKutta.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// the state of the moon at an instant of the simulation where the
+// coordinates are relative to the earth in meters (the same convention
+// used by CLunarOrbitDoc::MoonX and CLunarOrbitDoc::MoonY)
+struct LUNAR_STATE
+{
+	double dX; // X distance in meters
+	double dY; // Y distance in meters
+	double dVx; // X velocity in meters per second
+	double dVy; // Y velocity in meters per second
+	double dAx; // X acceleration of gravity in meters per second squared
+	double dAy; // Y acceleration of gravity in meters per second squared
+	double dTime; // running time in seconds
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// constants of a propagation batch that are read once before the step
+// loop begins instead of through property getters on every time slice
+struct LUNAR_PARAMETERS
+{
+	// acceleration of gravity divided by the radius of the orbit so the
+	// acceleration in either direction is -dGravityRatio * distance
+	double dGravityRatio;
+
+	// length of a time slice in seconds
+	double dSampleTime;
+
+	// meters per screen inch (CLunarOrbitDoc::MoonScaling)
+	double dMoonScaling;
+
+	// logical pixels per inch (CBaseDoc::Map)
+	int nMap;
+
+	// margin of error in degrees when testing for 30 degree steps
+	double dAngleError;
+
+	// running time in seconds before 30 degree steps are tested so the
+	// model is not stopped on the initial reading
+	double dThirtyDegreeDelay;
+
+	// running time in seconds before the end of a single orbit is tested
+	double dSingleOrbitDelay;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the integrator the original model was written with: positions advance
+// with the previous velocity and velocities advance with the previous
+// acceleration (Newton's equations of motion applied to a time slice)
+class CEulerIntegrator
+{
+public:
+	// advance the state by one time slice
+	static inline void Step
+	(
+		LUNAR_STATE& state, const LUNAR_PARAMETERS& params
+	)
+	{
+		const double dK = params.dGravityRatio;
+		const double dSt = params.dSampleTime;
+
+		// the acceleration of gravity using right triangle proportion
+		const double dNewAx = -dK * state.dX;
+		const double dNewAy = -dK * state.dY;
+
+		// v = u + at
+		const double dNewVx = state.dVx + state.dAx * dSt;
+		const double dNewVy = state.dVy + state.dAy * dSt;
+
+		// s = ut
+		state.dX += state.dVx * dSt;
+		state.dY += state.dVy * dSt;
+
+		state.dVx = dNewVx;
+		state.dVy = dNewVy;
+		state.dAx = dNewAx;
+		state.dAy = dNewAy;
+		state.dTime += dSt;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the equations of motion of the moon as a first order system for the
+// Runge-Kutta kernel where the state is ( x, y, vx, vy ) and the 
+// acceleration in either direction is -k times the distance. The scalar
+// type is a template parameter so the same equations can be propagated
+// with the dual numbers of Dual.h to differentiate the final state.
+template <class T> class CLunarSystem
+{
+	// protected data
+protected:
+	// acceleration of gravity divided by the radius of the orbit
+	T m_K;
+
+	// public definitions
+public:
+	enum { Size = 4 };
+	typedef CStateVector<T, Size> VECTOR;
+
+	// public methods
+public:
+	// the derivative of the state
+	RUNGE_KUTTA_INLINE void GetDerivative( const VECTOR& y, VECTOR& dy ) const
+	{
+		dy[ 0 ] = y[ 2 ];
+		dy[ 1 ] = y[ 3 ];
+		dy[ 2 ] = -m_K * y[ 0 ];
+		dy[ 3 ] = -m_K * y[ 1 ];
+	}
+
+	// public constructor
+public:
+	CLunarSystem( const T& k )
+	{
+		m_K = k;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// adapts an explicit Runge-Kutta method to the integrator interface used by
+// CPropagator. The acceleration kept in the state is not used by the method
+// and is only updated for display at the end of the step.
+template <class TTableau> class CRungeKuttaIntegrator
+{
+public:
+	// advance the state by one time slice
+	static RUNGE_KUTTA_INLINE void Step
+	(
+		LUNAR_STATE& state, const LUNAR_PARAMETERS& params
+	)
+	{
+		const double dK = params.dGravityRatio;
+		const CLunarSystem<double> system( dK );
+
+		CLunarSystem<double>::VECTOR y;
+		y[ 0 ] = state.dX;
+		y[ 1 ] = state.dY;
+		y[ 2 ] = state.dVx;
+		y[ 3 ] = state.dVy;
+
+		CRungeKutta<TTableau>::Step( system, y, params.dSampleTime );
+
+		state.dX = y[ 0 ];
+		state.dY = y[ 1 ];
+		state.dVx = y[ 2 ];
+		state.dVy = y[ 3 ];
+		state.dAx = -dK * state.dX;
+		state.dAy = -dK * state.dY;
+		state.dTime += params.dSampleTime;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the integrators that can be selected at runtime
+enum INTEGRATOR
+{
+	INTEGRATOR_EULER, // the original lagged Euler scheme
+	INTEGRATOR_RALSTON, // Ralston's second order method
+	INTEGRATOR_SSPRK3, // third order strong stability preserving
+	INTEGRATOR_RK4, // classic fourth order Runge-Kutta
+	INTEGRATOR_TSITOURAS5, // Tsitouras' fifth order method
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the recorder of the step loop when the time slices are not recorded,
+// which compiles away
+class CNullRecorder
+{
+public:
+	// record the state of a time slice
+	static inline void Record( const LUNAR_STATE& /*state*/ )
+	{
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Propagates the lunar state through a batch of time slices. The step loop
+// is generated as a template instantiation for each combination of stop
+// conditions and integrator so the conditions that are not active compile
+// away and the hot loop is straight-line arithmetic. The runtime flags are
+// read once per batch by Propagate which selects the instantiation.
+class CPropagator
+{
+	// public methods
+public:
+	// The angle in degrees of the distance vector (moon to earth) as it
+	// would be drawn, i.e. quantized to logical pixels the same way as
+	// CLunarOrbitDoc::MoonCenterRelativeToEarth and measured the same way
+	// as CLinear::Degrees with an up increment of -1.
+	static inline double GetDistanceDegrees( int nX, int nY )
+	{
+		const double dRadians = atan2( double( -nY ), double( nX ) );
+		const double dDegrees = 180 * dRadians / 3.1415926535897932384626433832795;
+		return dDegrees;
+	}
+
+	// the moon's position relative to the earth in logical pixels 
+	static inline void GetLogicalPosition
+	(
+		const LUNAR_STATE& state, const LUNAR_PARAMETERS& params,
+		int& nX, int& nY
+	)
+	{
+		const double dScaling = params.dMoonScaling;
+		const int nMap = params.nMap;
+		nX = int( state.dX / dScaling * nMap );
+		nY = int( state.dY / dScaling * nMap );
+	}
+
+	// is the distance vector at the given logical position on a 30 degree
+	// step within the margin of error
+	static inline bool IsThirtyDegreeStep
+	(
+		int nX, int nY, const LUNAR_PARAMETERS& params
+	)
+	{
+		const double dAngle = GetDistanceDegrees( nX, nY );
+		const double dMod = fmod( dAngle, 30.0 );
+		return fabs( dMod ) < params.dAngleError;
+	}
+
+	// Advance a state of any scalar type nSteps time slices with the given
+	// Runge-Kutta method, where k is the gravity ratio. Instantiated with
+	// the dual numbers of Dual.h, the derivatives of the final state with
+	// respect to the seeded variables are computed in the same pass.
+	template <class TTableau, class T>
+	static void Integrate
+	(
+		CStateVector<T, 4>& y, const T& k, double dSampleTime, int nSteps
+	)
+	{
+		const CLunarSystem<T> system( k );
+		for ( int nStep = 0; nStep < nSteps; nStep++ )
+		{
+			CRungeKutta<TTableau>::Step( system, y, dSampleTime );
+		}
+	}
+
+	// Advance a state of any scalar type with the runtime integrator. The
+	// original lagged Euler scheme is replaced by RK4 for this run so the
+	// derivatives are those of the equations of motion.
+	template <class T>
+	static void Integrate
+	(
+		INTEGRATOR eIntegrator, CStateVector<T, 4>& y, const T& k,
+		double dSampleTime, int nSteps
+	)
+	{
+		switch ( eIntegrator )
+		{
+			case INTEGRATOR_RALSTON:
+				Integrate<CTableauRalston>( y, k, dSampleTime, nSteps );
+				break;
+			case INTEGRATOR_SSPRK3:
+				Integrate<CTableauSSPRK3>( y, k, dSampleTime, nSteps );
+				break;
+			case INTEGRATOR_TSITOURAS5:
+				Integrate<CTableauTsitouras5>( y, k, dSampleTime, nSteps );
+				break;
+			default:
+				Integrate<CTableauRK4>( y, k, dSampleTime, nSteps );
+				break;
+		}
+	}
+
+	// Advance the state up to nSteps time slices with the stop conditions
+	// fixed at compile time. Returns true if a stop condition was reached.
+	// Reaching a 30 degree step is reported but the batch is completed,
+	// while the end of a single orbit stops before the step that would
+	// begin the next orbit. The state of each time slice taken is given to
+	// the recorder.
+	template
+	<
+		class TIntegrator, bool bThirtyDegreeSteps, bool bSingleOrbit,
+		class TRecorder
+	>
+	static bool Run
+	(
+		LUNAR_STATE& state, const LUNAR_PARAMETERS& params, int nSteps,
+		TRecorder& recorder
+	)
+	{
+		bool bDone = false;
+
+		// the angle is measured in logical pixels, so it is only measured
+		// again when the moon moves to a different pixel
+		int nLastX = 0;
+		int nLastY = 0;
+		bool bLastThirty = false;
+		bool bMeasured = false;
+
+		for ( int nStep = 0; nStep < nSteps; nStep++ )
+		{
+			LUNAR_STATE next = state;
+			TIntegrator::Step( next, params );
+
+			// do not begin testing for an hour so we are not stopped on
+			// the initial reading
+			if ( bThirtyDegreeSteps && state.dTime > params.dThirtyDegreeDelay )
+			{
+				int nX, nY;
+				GetLogicalPosition( next, params, nX, nY );
+				if ( !bMeasured || nX != nLastX || nY != nLastY )
+				{
+					bLastThirty = IsThirtyDegreeStep( nX, nY, params );
+					nLastX = nX;
+					nLastY = nY;
+					bMeasured = true;
+				}
+				if ( bLastThirty )
+				{
+					bDone = true;
+				}
+			}
+
+			// if the X distance starts increasing after the delay, we
+			// have reached the beginning of the orbit
+			if ( bSingleOrbit && state.dTime > params.dSingleOrbitDelay )
+			{
+				if ( next.dX - state.dX > 0 )
+				{
+					return true;
+				}
+			}
+
+			state = next;
+			recorder.Record( state );
+		}
+
+		return bDone;
+	}
+
+	// select the instantiation of the step loop matching the runtime
+	// stop conditions and advance the state up to nSteps time slices
+	template <class TIntegrator, class TRecorder>
+	static bool Propagate
+	(
+		LUNAR_STATE& state, const LUNAR_PARAMETERS& params, int nSteps,
+		bool bThirtyDegreeSteps, bool bSingleOrbit, TRecorder& recorder
+	)
+	{
+		if ( bThirtyDegreeSteps )
+		{
+			if ( bSingleOrbit )
+			{
+				return Run<TIntegrator, true, true>
+				(
+					state, params, nSteps, recorder
+				);
+			}
+			return Run<TIntegrator, true, false>
+			(
+				state, params, nSteps, recorder
+			);
+		}
+		if ( bSingleOrbit )
+		{
+			return Run<TIntegrator, false, true>
+			(
+				state, params, nSteps, recorder
+			);
+		}
+		return Run<TIntegrator, false, false>
+		(
+			state, params, nSteps, recorder
+		);
+	}
+
+	// select the integrator and the stop conditions at runtime and
+	// advance the state up to nSteps time slices giving the state of each
+	// time slice taken to the recorder
+	template <class TRecorder>
+	static bool Propagate
+	(
+		INTEGRATOR eIntegrator, LUNAR_STATE& state,
+		const LUNAR_PARAMETERS& params, int nSteps,
+		bool bThirtyDegreeSteps, bool bSingleOrbit, TRecorder& recorder
+	)
+	{
+		switch ( eIntegrator )
+		{
+			case INTEGRATOR_RALSTON:
+				return Propagate<CRungeKuttaIntegrator<CTableauRalston>>
+				(
+					state, params, nSteps, bThirtyDegreeSteps, bSingleOrbit,
+					recorder
+				);
+			case INTEGRATOR_SSPRK3:
+				return Propagate<CRungeKuttaIntegrator<CTableauSSPRK3>>
+				(
+					state, params, nSteps, bThirtyDegreeSteps, bSingleOrbit,
+					recorder
+				);
+			case INTEGRATOR_RK4:
+				return Propagate<CRungeKuttaIntegrator<CTableauRK4>>
+				(
+					state, params, nSteps, bThirtyDegreeSteps, bSingleOrbit,
+					recorder
+				);
+			case INTEGRATOR_TSITOURAS5:
+				return Propagate<CRungeKuttaIntegrator<CTableauTsitouras5>>
+				(
+					state, params, nSteps, bThirtyDegreeSteps, bSingleOrbit,
+					recorder
+				);
+			default:
+				return Propagate<CEulerIntegrator>
+				(
+					state, params, nSteps, bThirtyDegreeSteps, bSingleOrbit,
+					recorder
+				);
+		}
+	}
+
+	// select the integrator and the stop conditions at runtime and
+	// advance the state up to nSteps time slices
+	static bool Propagate
+	(
+		INTEGRATOR eIntegrator, LUNAR_STATE& state,
+		const LUNAR_PARAMETERS& params, int nSteps,
+		bool bThirtyDegreeSteps, bool bSingleOrbit
+	)
+	{
+		CNullRecorder recorder;
+		return Propagate
+		(
+			eIntegrator, state, params, nSteps, bThirtyDegreeSteps,
+			bSingleOrbit, recorder
+		);
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
@@ -22,13 +22,15 @@
 #define ID_EDIT_SINGLEORBIT             32775
 #define ID_EDIT_30DEGSTEPS              32776
 #define ID_BUTTON32777                  32777
+#define ID_EDIT_FASTFORWARD             32778
+#define ID_EDIT_RECORD                  32779
 
 // Next default values for new objects
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        310
-#define _APS_NEXT_COMMAND_VALUE         32778
+#define _APS_NEXT_COMMAND_VALUE         32780
 #define _APS_NEXT_CONTROL_VALUE         1000
 #define _APS_NEXT_SYMED_VALUE           310
 #endif
@@ -0,0 +1,390 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// Explicit Runge-Kutta methods described by Butcher tableaus. A method is
+// added by declaring a class with the number of stages, the order and the
+// A, B and C coefficients as constexpr functions. CRungeKutta unrolls the
+// stages at compile time, so every coefficient is a constant in the
+// generated code and terms with a zero coefficient are never evaluated.
+//
+// The kernel is written against a system class that provides:
+//	typedef ... VECTOR; // a fixed size state with operator[]
+//	enum { Size = N }; // number of components in the state
+//	void GetDerivative( const VECTOR& y, VECTOR& dy ) const;
+//
+// This header does not depend on MFC.
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// the stages are only straight-line arithmetic when the whole kernel is
+// inlined into the step loop, so inlining is not left to the optimizer
+#ifdef _MSC_VER
+#define RUNGE_KUTTA_INLINE __forceinline
+#else
+#define RUNGE_KUTTA_INLINE inline __attribute__(( always_inline ))
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// fixed size state vector stored as a contiguous array
+template <class T, int N> class CStateVector
+{
+	// public data
+public:
+	T m_Values[ N ];
+
+	// public methods
+public:
+	// component access
+	inline T& operator[]( int nIndex )
+	{
+		return m_Values[ nIndex ];
+	}
+	// component access
+	inline const T& operator[]( int nIndex ) const
+	{
+		return m_Values[ nIndex ];
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// classic fourth order Runge-Kutta
+class CTableauRK4
+{
+public:
+	enum { Stages = 4, Order = 4 };
+
+	static constexpr double A( int i, int j )
+	{
+		const double a[ 4 ][ 4 ] =
+		{
+			{ 0.0, 0.0, 0.0, 0.0 },
+			{ 0.5, 0.0, 0.0, 0.0 },
+			{ 0.0, 0.5, 0.0, 0.0 },
+			{ 0.0, 0.0, 1.0, 0.0 },
+		};
+		return a[ i ][ j ];
+	}
+	static constexpr double B( int i )
+	{
+		const double b[ 4 ] = { 1.0 / 6, 1.0 / 3, 1.0 / 3, 1.0 / 6 };
+		return b[ i ];
+	}
+	static constexpr double C( int i )
+	{
+		const double c[ 4 ] = { 0.0, 0.5, 0.5, 1.0 };
+		return c[ i ];
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Ralston's second order method (minimum truncation error of the two
+// stage methods)
+class CTableauRalston
+{
+public:
+	enum { Stages = 2, Order = 2 };
+
+	static constexpr double A( int i, int j )
+	{
+		const double a[ 2 ][ 2 ] =
+		{
+			{ 0.0, 0.0 },
+			{ 2.0 / 3, 0.0 },
+		};
+		return a[ i ][ j ];
+	}
+	static constexpr double B( int i )
+	{
+		const double b[ 2 ] = { 1.0 / 4, 3.0 / 4 };
+		return b[ i ];
+	}
+	static constexpr double C( int i )
+	{
+		const double c[ 2 ] = { 0.0, 2.0 / 3 };
+		return c[ i ];
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// third order strong stability preserving Runge-Kutta (Shu-Osher)
+class CTableauSSPRK3
+{
+public:
+	enum { Stages = 3, Order = 3 };
+
+	static constexpr double A( int i, int j )
+	{
+		const double a[ 3 ][ 3 ] =
+		{
+			{ 0.0, 0.0, 0.0 },
+			{ 1.0, 0.0, 0.0 },
+			{ 0.25, 0.25, 0.0 },
+		};
+		return a[ i ][ j ];
+	}
+	static constexpr double B( int i )
+	{
+		const double b[ 3 ] = { 1.0 / 6, 1.0 / 6, 2.0 / 3 };
+		return b[ i ];
+	}
+	static constexpr double C( int i )
+	{
+		const double c[ 3 ] = { 0.0, 1.0, 0.5 };
+		return c[ i ];
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Tsitouras' fifth order method (the fifth order solution of the 5(4)
+// pair, where the last stage is only used for error estimation)
+class CTableauTsitouras5
+{
+public:
+	enum { Stages = 7, Order = 5 };
+
+	static constexpr double A( int i, int j )
+	{
+		const double a[ 7 ][ 7 ] =
+		{
+			{ 0, 0, 0, 0, 0, 0, 0 },
+			{ 0.161, 0, 0, 0, 0, 0, 0 },
+			{ -0.008480655492356989, 0.335480655492357, 0, 0, 0, 0, 0 },
+			{
+				2.897153057105493, -6.359448489975075, 4.3622954328695815,
+				0, 0, 0, 0
+			},
+			{
+				5.325864828439257, -11.748883564062828, 7.4955393428898365,
+				-0.09249506636175525, 0, 0, 0
+			},
+			{
+				5.86145544294642, -12.92096931784711, 8.159367898576159,
+				-0.071584973281401, -0.028269050394068383, 0, 0
+			},
+			{
+				0.09646076681806523, 0.01, 0.4798896504144996,
+				1.379008574103742, -3.290069515436081, 2.324710524099774, 0
+			},
+		};
+		return a[ i ][ j ];
+	}
+	static constexpr double B( int i )
+	{
+		const double b[ 7 ] =
+		{
+			0.09646076681806523, 0.01, 0.4798896504144996,
+			1.379008574103742, -3.290069515436081, 2.324710524099774, 0
+		};
+		return b[ i ];
+	}
+	static constexpr double C( int i )
+	{
+		const double c[ 7 ] =
+		{
+			0, 0.161, 0.327, 0.9, 0.9800255409045097, 1, 1
+		};
+		return c[ i ];
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// compile time checks of a tableau: the method must be explicit, each row
+// of A must sum to C and the weights must sum to one
+template <class TTableau> class CTableauCheck
+{
+	// absolute value usable in a constant expression
+	static constexpr double Magnitude( double dValue )
+	{
+		return dValue < 0 ? -dValue : dValue;
+	}
+
+public:
+	// returns true if the tableau is consistent within the given error
+	static constexpr bool IsConsistent( double dError = 1e-12 )
+	{
+		double dSumB = 0;
+		for ( int i = 0; i < TTableau::Stages; i++ )
+		{
+			double dSumA = 0;
+			for ( int j = 0; j < TTableau::Stages; j++ )
+			{
+				if ( j >= i && TTableau::A( i, j ) != 0 )
+				{
+					return false; // not explicit
+				}
+				dSumA += TTableau::A( i, j );
+			}
+			if ( Magnitude( dSumA - TTableau::C( i ) ) > dError )
+			{
+				return false;
+			}
+			dSumB += TTableau::B( i );
+		}
+		return Magnitude( dSumB - 1 ) <= dError;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// y += dFactor * x over the first N components of a state, unrolled so the
+// result does not depend on the optimizer's loop unrolling heuristics
+template <class TVector, int N> class CAddScaled
+{
+public:
+	static RUNGE_KUTTA_INLINE void Add
+	(
+		TVector& y, double dFactor, const TVector& x
+	)
+	{
+		CAddScaled<TVector, N - 1>::Add( y, dFactor, x );
+		y[ N - 1 ] += dFactor * x[ N - 1 ];
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end of the recursion over the components
+template <class TVector> class CAddScaled<TVector, 0>
+{
+public:
+	static RUNGE_KUTTA_INLINE void Add( TVector&, double, const TVector& )
+	{
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// adds h * A( I, J - 1 ) * k[ J - 1 ] for the first J slopes of stage I
+template <class TTableau, class TSystem, int I, int J> class CRungeKuttaTerms
+{
+public:
+	typedef typename TSystem::VECTOR VECTOR;
+
+	static RUNGE_KUTTA_INLINE void Add( VECTOR& y, const VECTOR* k, double h )
+	{
+		CRungeKuttaTerms<TTableau, TSystem, I, J - 1>::Add( y, k, h );
+
+		constexpr double a = TTableau::A( I, J - 1 );
+		if ( a != 0 )
+		{
+			CAddScaled<VECTOR, TSystem::Size>::Add( y, h * a, k[ J - 1 ] );
+		}
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end of the recursion over the slopes of a stage
+template <class TTableau, class TSystem, int I>
+class CRungeKuttaTerms<TTableau, TSystem, I, 0>
+{
+public:
+	typedef typename TSystem::VECTOR VECTOR;
+
+	static RUNGE_KUTTA_INLINE void Add( VECTOR&, const VECTOR*, double )
+	{
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// evaluates the slopes of the first I stages
+template <class TTableau, class TSystem, int I> class CRungeKuttaStages
+{
+public:
+	typedef typename TSystem::VECTOR VECTOR;
+
+	static RUNGE_KUTTA_INLINE void Evaluate
+	(
+		const TSystem& system, const VECTOR& y, VECTOR* k, double h
+	)
+	{
+		CRungeKuttaStages<TTableau, TSystem, I - 1>::Evaluate( system, y, k, h );
+
+		// the state at this stage
+		VECTOR yStage = y;
+		CRungeKuttaTerms<TTableau, TSystem, I - 1, I - 1>::Add( yStage, k, h );
+
+		// the slope at this stage
+		system.GetDerivative( yStage, k[ I - 1 ] );
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end of the recursion over the stages
+template <class TTableau, class TSystem>
+class CRungeKuttaStages<TTableau, TSystem, 0>
+{
+public:
+	typedef typename TSystem::VECTOR VECTOR;
+
+	static RUNGE_KUTTA_INLINE void Evaluate
+	(
+		const TSystem&, const VECTOR&, VECTOR*, double
+	)
+	{
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// adds h * B( J - 1 ) * k[ J - 1 ] for the first J slopes
+template <class TTableau, class TSystem, int J> class CRungeKuttaWeights
+{
+public:
+	typedef typename TSystem::VECTOR VECTOR;
+
+	static RUNGE_KUTTA_INLINE void Add( VECTOR& y, const VECTOR* k, double h )
+	{
+		CRungeKuttaWeights<TTableau, TSystem, J - 1>::Add( y, k, h );
+
+		constexpr double b = TTableau::B( J - 1 );
+		if ( b != 0 )
+		{
+			CAddScaled<VECTOR, TSystem::Size>::Add( y, h * b, k[ J - 1 ] );
+		}
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end of the recursion over the weights
+template <class TTableau, class TSystem>
+class CRungeKuttaWeights<TTableau, TSystem, 0>
+{
+public:
+	typedef typename TSystem::VECTOR VECTOR;
+
+	static RUNGE_KUTTA_INLINE void Add( VECTOR&, const VECTOR*, double )
+	{
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a single step of an explicit Runge-Kutta method on an autonomous system
+template <class TTableau> class CRungeKutta
+{
+	static_assert
+	(
+		CTableauCheck<TTableau>::IsConsistent(),
+		"Butcher tableau is not explicit or its rows do not sum to C"
+	);
+
+public:
+	// advance y by the time step h
+	template <class TSystem> static RUNGE_KUTTA_INLINE void Step
+	(
+		const TSystem& system, typename TSystem::VECTOR& y, double h
+	)
+	{
+		typedef typename TSystem::VECTOR VECTOR;
+
+		// slopes of the stages
+		VECTOR k[ TTableau::Stages ];
+		CRungeKuttaStages<TTableau, TSystem, TTableau::Stages>::Evaluate
+		(
+			system, y, k, h
+		);
+
+		// weighted sum of the slopes
+		CRungeKuttaWeights<TTableau, TSystem, TTableau::Stages>::Add( y, k, h );
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
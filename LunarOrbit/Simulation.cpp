@@ -0,0 +1,361 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "Simulation.h"
+#include <chrono>
+
+using namespace std::chrono;
+
+/////////////////////////////////////////////////////////////////////////////
+CSimulation::CSimulation()
+{
+	m_Start = LUNAR_STATE();
+	m_nPositionCapacity = 0;
+	m_nPositionTail = 0;
+	m_Params = LUNAR_PARAMETERS();
+	m_eIntegrator = INTEGRATOR_EULER;
+	m_nBatchSteps = 1;
+	m_pRecorder = nullptr;
+	m_dTimeWarp = 0;
+	m_dFrameBudget = 0;
+	m_dFrameInterval = 1.0 / 60;
+	m_dStepCost = 0;
+	m_dStepsPerSecond = 0;
+	m_bThirtyDegreeSteps = false;
+	m_bSingleOrbit = false;
+	m_bStop = false;
+	SetPositionCapacity( 1024 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+CSimulation::~CSimulation()
+{
+	Stop();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// simulated seconds in a second of wall time or zero for as fast as the
+// CPU allows, where a thread waiting for the old pace is woken
+void CSimulation::SetTimeWarp( double value )
+{
+	{
+		lock_guard<mutex> lock( m_WakeMutex );
+		m_dTimeWarp = value > 0 ? value : 0;
+	}
+	m_Wake.notify_all();
+
+} // SetTimeWarp
+
+/////////////////////////////////////////////////////////////////////////////
+// most positions kept between two calls to TakeSnapshot, which can only
+// be set while the thread is stopped
+void CSimulation::SetPositionCapacity( int value )
+{
+	if ( IsRunning() )
+	{
+		return;
+	}
+
+	m_nPositionCapacity = max( value, 1 );
+	m_PositionX.reset( new atomic<double>[ m_nPositionCapacity ] );
+	m_PositionY.reset( new atomic<double>[ m_nPositionCapacity ] );
+	m_nPositionTail = 0;
+
+} // SetPositionCapacity
+
+/////////////////////////////////////////////////////////////////////////////
+// Start the thread from the given state advancing nBatchSteps time slices
+// a batch, where the thread is stopped first if it is running.
+void CSimulation::Start
+(
+	const LUNAR_STATE& state, const LUNAR_PARAMETERS& params,
+	INTEGRATOR eIntegrator, int nBatchSteps
+)
+{
+	Stop();
+
+	// the user interface sees the starting state until the first batch
+	SIMULATION_SNAPSHOT snapshot;
+	snapshot.state = state;
+	snapshot.nBatch = 0;
+	snapshot.bDone = false;
+	m_Snapshots.Reset( snapshot );
+	m_nPositionTail = 0;
+
+	m_Start = state;
+	m_Params = params;
+	m_eIntegrator = eIntegrator;
+	m_nBatchSteps = max( nBatchSteps, 1 );
+	m_dStepCost = 0;
+	m_dStepsPerSecond = 0;
+	m_bStop = false;
+	m_Thread = thread( &CSimulation::Run, this );
+
+} // Start
+
+/////////////////////////////////////////////////////////////////////////////
+// stop the thread and wait for it to finish its batch
+void CSimulation::Stop()
+{
+	if ( !m_Thread.joinable() )
+	{
+		return;
+	}
+
+	{
+		// the flag is set under the lock so the thread cannot miss the
+		// notification between testing the flag and waiting
+		lock_guard<mutex> lock( m_WakeMutex );
+		m_bStop = true;
+	}
+	m_Wake.notify_all();
+	m_Thread.join();
+
+} // Stop
+
+/////////////////////////////////////////////////////////////////////////////
+// Take the newest snapshot and replace the contents of the vector with the
+// positions of the batches up to it not yet taken, from the oldest to the
+// newest. A position is read and then claimed by moving the tail past it,
+// and if the thread moved the tail first to replace the position, what was
+// read is thrown away and the next position is read instead. If the thread
+// replaced positions up to the end of the snapshot while they were being
+// taken, a newer snapshot is taken so the positions still end at it, where
+// the thread publishes a snapshot newer than the tail before it moves the
+// tail unless the ring holds a single position. The vector never holds more
+// positions than the ring, so it is only allocated if it has less capacity
+// than the ring.
+const SIMULATION_SNAPSHOT& CSimulation::TakeSnapshot
+(
+	vector<SIMULATION_POSITION>& positions
+)
+{
+	m_Snapshots.Update();
+
+	positions.clear();
+	long long nTail = m_nPositionTail.load( memory_order_acquire );
+
+	// the batch after the last position taken
+	long long nTaken = nTail;
+	for ( ;; )
+	{
+		const long long nBatch = m_Snapshots.GetFront().nBatch;
+		if ( nTail >= nBatch && nTaken < nBatch && m_Snapshots.Update() )
+		{
+			continue;
+		}
+		if ( nTail >= nBatch )
+		{
+			break;
+		}
+
+		const int nIndex = int( nTail % m_nPositionCapacity );
+		SIMULATION_POSITION position;
+		position.dX = m_PositionX[ nIndex ].load( memory_order_relaxed );
+		position.dY = m_PositionY[ nIndex ].load( memory_order_relaxed );
+
+		// a failed exchange loads the tail the thread moved on to
+		if
+		(
+			m_nPositionTail.compare_exchange_strong
+			(
+				nTail, nTail + 1, memory_order_acq_rel
+			)
+		)
+		{
+			// positions taken while catching up with a newer snapshot
+			// replace the oldest taken as the ring does
+			if ( (int)positions.size() == m_nPositionCapacity )
+			{
+				positions.erase( positions.begin() );
+			}
+			positions.push_back( position );
+			nTail++;
+			nTaken = nTail;
+		}
+	}
+
+	return m_Snapshots.GetFront();
+
+} // TakeSnapshot
+
+/////////////////////////////////////////////////////////////////////////////
+// Hand the state at the end of a batch to the user interface. When the
+// ring is full the oldest position is given up by moving the tail past
+// it, unless the user interface has just taken it, and either way the
+// slot is free to write. The position is written before the snapshot is
+// published, so a snapshot never refers to a position that is not there.
+void CSimulation::AddBatch
+(
+	const LUNAR_STATE& state, long long nBatch, bool bDone
+)
+{
+	long long nTail = m_nPositionTail.load( memory_order_acquire );
+	if ( nBatch - nTail >= m_nPositionCapacity )
+	{
+		m_nPositionTail.compare_exchange_strong
+		(
+			nTail, nTail + 1, memory_order_acq_rel
+		);
+	}
+
+	const int nIndex = int( nBatch % m_nPositionCapacity );
+	m_PositionX[ nIndex ].store( state.dX, memory_order_relaxed );
+	m_PositionY[ nIndex ].store( state.dY, memory_order_relaxed );
+
+	SIMULATION_SNAPSHOT& snapshot = m_Snapshots.GetBack();
+	snapshot.state = state;
+	snapshot.nBatch = nBatch + 1;
+	snapshot.bDone = bDone;
+	m_Snapshots.Publish();
+
+} // AddBatch
+
+/////////////////////////////////////////////////////////////////////////////
+// Advance the state a batch at a time until stopped. With a time warp the
+// thread waits after each batch until the wall time since the time warp
+// was last changed has caught up with the simulated time, so the pace
+// does not drift however long the batches take. A pace more than a frame
+// interval behind is started again from now, so a machine that cannot
+// keep up runs as fast as it can instead of catching up in a burst.
+//
+// With a frame budget the thread also waits for the next frame interval
+// once the next batch would take the time it has spent integrating in
+// this one past the budget, where the cost of the batch is the smoothed
+// cost of a time slice. The time spent integrating and the time slices
+// run in each frame interval are smoothed into the cost of a time slice
+// and the time slices run in a second.
+void CSimulation::Run()
+{
+	// weight of the newest measurement in the smoothed values
+	const double dSmoothing = 0.125;
+
+	LUNAR_STATE state = m_Start;
+	long long nBatch = 0;
+
+	// the wall time and the simulated time the pace is measured from
+	steady_clock::time_point start = steady_clock::now();
+	double dStartTime = state.dTime;
+	double dTimeWarp = m_dTimeWarp;
+
+	// the start of the frame interval, the seconds spent integrating in it
+	// and the time slices run in it
+	steady_clock::time_point frame = start;
+	double dBusy = 0;
+	long long nFrameSteps = 0;
+
+	while ( !m_bStop )
+	{
+		const steady_clock::time_point before = steady_clock::now();
+		bool bDone = false;
+		if ( m_pRecorder == nullptr )
+		{
+			bDone = CPropagator::Propagate
+			(
+				m_eIntegrator, state, m_Params, m_nBatchSteps,
+				m_bThirtyDegreeSteps, m_bSingleOrbit
+			);
+		}
+		else
+		{
+			bDone = CPropagator::Propagate
+			(
+				m_eIntegrator, state, m_Params, m_nBatchSteps,
+				m_bThirtyDegreeSteps, m_bSingleOrbit, *m_pRecorder
+			);
+		}
+		const steady_clock::time_point after = steady_clock::now();
+		AddBatch( state, nBatch, bDone );
+		nBatch++;
+		if ( bDone )
+		{
+			break;
+		}
+
+		// The cost of a time slice and the rate are measured over each
+		// frame interval and smoothed, where a batch belongs to the frame
+		// interval it started in. A batch is too short to time on its own
+		// when the thread can be switched out in the middle of it.
+		const double dInterval = m_dFrameInterval;
+		const double dElapsed = duration<double>( before - frame ).count();
+		if ( dElapsed >= dInterval && dElapsed > 0 && nFrameSteps > 0 )
+		{
+			const double dCost = dBusy / nFrameSteps;
+			const double dStepCost = m_dStepCost;
+			m_dStepCost =
+				dStepCost > 0 ?
+				dStepCost + ( dCost - dStepCost ) * dSmoothing :
+				dCost;
+
+			const double dRate = nFrameSteps / dElapsed;
+			const double dStepsPerSecond = m_dStepsPerSecond;
+			m_dStepsPerSecond =
+				dStepsPerSecond > 0 ?
+				dStepsPerSecond + ( dRate - dStepsPerSecond ) * dSmoothing :
+				dRate;
+
+			frame = before;
+			dBusy = 0;
+			nFrameSteps = 0;
+		}
+		dBusy += duration<double>( after - before ).count();
+		nFrameSteps += m_nBatchSteps;
+		const duration<double> interval( dInterval );
+		const steady_clock::duration frameInterval =
+			duration_cast<steady_clock::duration>( interval );
+
+		// a new time warp is measured from now
+		if ( m_dTimeWarp != dTimeWarp )
+		{
+			start = after;
+			dStartTime = state.dTime;
+			dTimeWarp = m_dTimeWarp;
+		}
+
+		// the time the next batch is due to keep to the time warp
+		steady_clock::time_point due = after;
+		if ( dTimeWarp > 0 )
+		{
+			const duration<double> wall
+			(
+				( state.dTime - dStartTime ) / dTimeWarp
+			);
+			due = start + duration_cast<steady_clock::duration>( wall );
+			if ( after - due > frameInterval )
+			{
+				start = after;
+				dStartTime = state.dTime;
+				due = after;
+			}
+		}
+
+		// the next batch waits for the next frame interval if it does not
+		// fit in the budget of this one
+		const double dBudget = m_dFrameBudget;
+		double dStepCost = m_dStepCost;
+		if ( dStepCost <= 0 )
+		{
+			dStepCost = dBusy / nFrameSteps;
+		}
+		if ( dBudget > 0 && dBusy + dStepCost * m_nBatchSteps > dBudget )
+		{
+			due = max( due, frame + frameInterval );
+		}
+		if ( due <= after )
+		{
+			continue;
+		}
+
+		unique_lock<mutex> lock( m_WakeMutex );
+		m_Wake.wait_until
+		(
+			lock, due, [ & ]
+			{
+				return m_bStop || m_dTimeWarp != dTimeWarp;
+			}
+		);
+	}
+
+} // Run
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,269 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Propagator.h"
+#include "TrajectoryRecorder.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// the state of the simulation at the end of a batch as handed to the user
+// interface
+struct SIMULATION_SNAPSHOT
+{
+	// position, velocity, acceleration and simulated time of the moon
+	LUNAR_STATE state;
+
+	// number of batches run since the thread was started
+	long long nBatch;
+
+	// true once a stop condition has been reached
+	bool bDone;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the position of the moon in meters at the end of a batch
+struct SIMULATION_POSITION
+{
+	double dX; // X distance in meters
+	double dY; // Y distance in meters
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Runs the propagator on a thread of its own, so the speed of the model
+// does not depend on the timer of the view or on how long a frame takes
+// to paint. The state is advanced a batch of time slices at a time (an
+// hour in the view) and handed to the user interface, which takes the
+// newest snapshot and the positions of the batches it has not seen yet
+// whenever it draws a frame.
+//
+// Nothing the thread hands over is guarded by a lock, so the integrator
+// never waits for the user interface. The snapshot goes through a
+// CTripleBuffer, and the positions go through a ring the thread writes
+// and the user interface reads, where a full ring replaces its oldest
+// position. The user interface only takes the positions up to the batch
+// of its snapshot, so the trail always ends where the moon is drawn.
+//
+// The time warp is the number of simulated seconds run in a second of
+// wall time, where the thread waits between batches to keep to it, and a
+// time warp of zero runs the batches as fast as the CPU allows. The frame
+// budget is the most wall time the thread spends integrating in a frame
+// interval, so a fast machine plays the time warp back and a slow one
+// runs as many time slices as fit in the budget instead of taking the
+// whole of a core. The thread measures the cost of a time slice to tell
+// whether the next batch fits, and keeps a smoothed count of the time
+// slices it runs in a second. The thread stops when a stop condition of
+// the propagator is reached or when it is told to. With a recorder, every
+// time slice the thread runs is recorded. The simulation does not depend
+// on MFC.
+class CSimulation
+{
+	// protected data
+protected:
+	// the thread running the batches
+	thread m_Thread;
+
+	// wakes the thread from waiting between batches when it is stopped
+	// or the time warp is changed
+	mutex m_WakeMutex;
+	condition_variable m_Wake;
+
+	// the state the thread starts from
+	LUNAR_STATE m_Start;
+
+	// snapshots from the thread to the user interface
+	CTripleBuffer<SIMULATION_SNAPSHOT> m_Snapshots;
+
+	// positions at the end of the batches by batch number modulo the
+	// capacity of the ring, kept as atomic values because the thread can
+	// replace the oldest while the user interface is reading it
+	unique_ptr<atomic<double>[]> m_PositionX;
+	unique_ptr<atomic<double>[]> m_PositionY;
+
+	// number of positions the ring holds
+	int m_nPositionCapacity;
+
+	// number of the oldest batch whose position has not been taken,
+	// which both threads advance
+	atomic<long long> m_nPositionTail;
+
+	// constants of the propagation
+	LUNAR_PARAMETERS m_Params;
+
+	// method used to advance the state each time slice
+	INTEGRATOR m_eIntegrator;
+
+	// number of time slices in a batch
+	int m_nBatchSteps;
+
+	// records every time slice run or null
+	CTrajectoryRecorder* m_pRecorder;
+
+	// simulated seconds in a second of wall time or zero for as fast as
+	// the CPU allows
+	atomic<double> m_dTimeWarp;
+
+	// most seconds spent integrating in a frame interval or zero for no
+	// limit
+	atomic<double> m_dFrameBudget;
+
+	// seconds in a frame interval
+	atomic<double> m_dFrameInterval;
+
+	// smoothed seconds taken by a time slice
+	atomic<double> m_dStepCost;
+
+	// smoothed number of time slices run in a second of wall time
+	atomic<double> m_dStepsPerSecond;
+
+	// stop when the moon is on a 30 degree step
+	atomic<bool> m_bThirtyDegreeSteps;
+
+	// stop at the end of a single orbit
+	atomic<bool> m_bSingleOrbit;
+
+	// tells the thread to stop
+	atomic<bool> m_bStop;
+
+	// public methods
+public:
+	// simulated seconds in a second of wall time or zero for as fast as
+	// the CPU allows
+	double GetTimeWarp() const
+	{
+		return m_dTimeWarp;
+	}
+	// simulated seconds in a second of wall time or zero for as fast as
+	// the CPU allows
+	void SetTimeWarp( double value );
+
+	// most seconds spent integrating in a frame interval or zero for no
+	// limit
+	double GetFrameBudget() const
+	{
+		return m_dFrameBudget;
+	}
+	// most seconds spent integrating in a frame interval or zero for no
+	// limit
+	void SetFrameBudget( double value )
+	{
+		m_dFrameBudget = value > 0 ? value : 0;
+	}
+
+	// seconds in a frame interval
+	double GetFrameInterval() const
+	{
+		return m_dFrameInterval;
+	}
+	// seconds in a frame interval
+	void SetFrameInterval( double value )
+	{
+		m_dFrameInterval = value > 0 ? value : 0;
+	}
+
+	// smoothed seconds taken by a time slice
+	double GetStepCost() const
+	{
+		return m_dStepCost;
+	}
+
+	// smoothed number of time slices run in a second of wall time
+	double GetStepsPerSecond() const
+	{
+		return m_dStepsPerSecond;
+	}
+
+	// stop when the moon is on a 30 degree step
+	bool GetThirtyDegreeSteps() const
+	{
+		return m_bThirtyDegreeSteps;
+	}
+	// stop when the moon is on a 30 degree step
+	void SetThirtyDegreeSteps( bool value )
+	{
+		m_bThirtyDegreeSteps = value;
+	}
+
+	// stop at the end of a single orbit
+	bool GetSingleOrbit() const
+	{
+		return m_bSingleOrbit;
+	}
+	// stop at the end of a single orbit
+	void SetSingleOrbit( bool value )
+	{
+		m_bSingleOrbit = value;
+	}
+
+	// most positions kept between two calls to TakeSnapshot
+	int GetPositionCapacity() const
+	{
+		return m_nPositionCapacity;
+	}
+	// most positions kept between two calls to TakeSnapshot, which can
+	// only be set while the thread is stopped
+	void SetPositionCapacity( int value );
+
+	// records every time slice run or null
+	CTrajectoryRecorder* GetRecorder() const
+	{
+		return m_pRecorder;
+	}
+	// records every time slice run or null, which can only be set while
+	// the thread is stopped
+	void SetRecorder( CTrajectoryRecorder* value )
+	{
+		if ( !IsRunning() )
+		{
+			m_pRecorder = value;
+		}
+	}
+
+	// true while the thread is running batches
+	bool IsRunning() const
+	{
+		return m_Thread.joinable();
+	}
+
+	// Start the thread from the given state advancing nBatchSteps time
+	// slices a batch, where the thread is stopped first if it is running.
+	void Start
+	(
+		const LUNAR_STATE& state, const LUNAR_PARAMETERS& params,
+		INTEGRATOR eIntegrator, int nBatchSteps
+	);
+
+	// stop the thread and wait for it to finish its batch
+	void Stop();
+
+	// Take the newest snapshot and replace the contents of the vector with
+	// the positions of the batches up to it not yet taken, from the oldest
+	// to the newest. Only the user interface thread calls this.
+	const SIMULATION_SNAPSHOT& TakeSnapshot
+	(
+		vector<SIMULATION_POSITION>& positions
+	);
+
+	// protected methods
+protected:
+	// advance the state a batch at a time until stopped
+	void Run();
+
+	// hand the state at the end of a batch to the user interface
+	void AddBatch( const LUNAR_STATE& state, long long nBatch, bool bDone );
+
+	// public construction
+public:
+	CSimulation();
+	virtual ~CSimulation();
+};
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,641 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "SoftwareTarget.h"
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <cmath>
+
+// pi to convert degrees to radians
+static const double SOFTWARE_PI = 3.14159265358979323846;
+
+// length in pixels of the lines that approximate a curve
+static const double CURVE_STEP = 3.0;
+
+// most lines used to approximate a curve
+static const int MAX_CURVE_LINES = 360;
+
+// horizontal scale of a glyph compared to its vertical scale, which gives
+// the average character width of 2/5 of the height that CBaseView::BuildFont
+// asks for
+static const double GLYPH_ASPECT =
+	0.4 * CGlyphAtlas::CELL_ROWS / CGlyphAtlas::CELL_COLUMNS;
+
+// slant of italic text in pixels across per pixel up
+static const double ITALIC_SLANT = 0.2;
+
+/////////////////////////////////////////////////////////////////////////////
+CSoftwareTarget::CSoftwareTarget( const CDisplayStyles& styles ) :
+	m_Styles( styles )
+{
+	m_pLayer = nullptr;
+	m_nLeftOffset = 0;
+	m_nTopOffset = 0;
+	m_dScale = 1;
+	m_rectClip.left = 0;
+	m_rectClip.top = 0;
+	m_rectClip.right = 0;
+	m_rectClip.bottom = 0;
+	m_colorBack = DisplayColor( 255, 255, 255 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Map the logical width of the view onto the given width in pixels with
+// the logical point at the top left corner of the layer, like SetDrawDC
+// followed by render.
+void CSoftwareTarget::SetMapping
+(
+	long nLeftOffset, long nTopOffset, int nLogicalWidth, int nPixelWidth
+)
+{
+	m_nLeftOffset = nLeftOffset;
+	m_nTopOffset = nTopOffset;
+	m_dScale = nLogicalWidth > 0 ? double( nPixelWidth ) / nLogicalWidth : 1;
+
+} // SetMapping
+
+/////////////////////////////////////////////////////////////////////////////
+// replay the list into the whole layer
+void CSoftwareTarget::Draw( CPixelLayer& layer, const CDisplayList& list )
+{
+	const DISPLAY_RECT rectClip =
+	{
+		0, 0, layer.GetWidth(), layer.GetHeight()
+	};
+	Draw( layer, list, rectClip );
+
+} // Draw
+
+/////////////////////////////////////////////////////////////////////////////
+// replay the list into the given pixels of the layer
+void CSoftwareTarget::Draw
+(
+	CPixelLayer& layer, const CDisplayList& list, const DISPLAY_RECT& rectClip
+)
+{
+	if ( SetLayer( layer, rectClip ) )
+	{
+		list.Replay( *this );
+	}
+	m_pLayer = nullptr;
+
+} // Draw
+
+/////////////////////////////////////////////////////////////////////////////
+// Start drawing into the given pixels of the layer and return false if
+// none of them are inside of the layer. The drawing methods can be called
+// directly afterwards.
+bool CSoftwareTarget::SetLayer
+(
+	CPixelLayer& layer, const DISPLAY_RECT& rectClip
+)
+{
+	m_pLayer = &layer;
+	m_rectClip.left = max( rectClip.left, 0L );
+	m_rectClip.top = max( rectClip.top, 0L );
+	m_rectClip.right = min( rectClip.right, long( layer.GetWidth() ) );
+	m_rectClip.bottom = min( rectClip.bottom, long( layer.GetHeight() ) );
+
+	return
+		m_rectClip.left < m_rectClip.right &&
+		m_rectClip.top < m_rectClip.bottom;
+
+} // SetLayer
+
+/////////////////////////////////////////////////////////////////////////////
+// width of the pen in pixels which is at least one pixel
+double CSoftwareTarget::GetPenWidth( const DISPLAY_PEN& pen ) const
+{
+	return max( pen.nWidth * m_dScale, 1.0 );
+
+} // GetPenWidth
+
+/////////////////////////////////////////////////////////////////////////////
+// fill the pixels of a row from the left edge up to the right edge
+void CSoftwareTarget::FillSpan
+(
+	int nRow, double dLeft, double dRight, LAYER_PIXEL pixel
+)
+{
+	if ( nRow < m_rectClip.top || nRow >= m_rectClip.bottom )
+	{
+		return;
+	}
+
+	const long nFirst = max( long( ceil( dLeft ) ), m_rectClip.left );
+	const long nLast = min( long( ceil( dRight ) ), m_rectClip.right );
+	if ( nFirst >= nLast )
+	{
+		return;
+	}
+
+	LAYER_PIXEL* pRow = m_pLayer->GetRow( nRow );
+	fill( pRow + nFirst, pRow + nLast, pixel );
+
+} // FillSpan
+
+/////////////////////////////////////////////////////////////////////////////
+// Draw a line of the given width with round ends. Each row of pixels
+// crosses the line in one span because the shape is convex, and the span
+// is the union of where the row crosses the band along the line and the
+// two circles at its ends. A dotted pen tests each pixel of the span
+// against its distance along the outline.
+void CSoftwareTarget::StrokeLine
+(
+	const SOFTWARE_POINT& pt1, const SOFTWARE_POINT& pt2,
+	const DISPLAY_PEN& pen, double dDistance
+)
+{
+	const double dRadius = GetPenWidth( pen ) / 2;
+
+	// nothing to do for a line outside of the clipping rectangle, which is
+	// most of the lines of a long polyline drawn into a small rectangle
+	if
+	(
+		max( pt1.x, pt2.x ) + dRadius < m_rectClip.left ||
+		min( pt1.x, pt2.x ) - dRadius > m_rectClip.right ||
+		max( pt1.y, pt2.y ) + dRadius < m_rectClip.top ||
+		min( pt1.y, pt2.y ) - dRadius > m_rectClip.bottom
+	)
+	{
+		return;
+	}
+
+	const double dX = pt2.x - pt1.x;
+	const double dY = pt2.y - pt1.y;
+	const double dLength = sqrt( dX * dX + dY * dY );
+
+	// unit vectors along and across the line
+	const double dAlongX = dLength > 0 ? dX / dLength : 1;
+	const double dAlongY = dLength > 0 ? dY / dLength : 0;
+	const double dAcrossX = -dAlongY;
+	const double dAcrossY = dAlongX;
+
+	const bool bDotted = pen.eStyle == DISPLAY_PEN_DOT;
+	const double dDot = max( 2 * dRadius, 2.0 );
+	const LAYER_PIXEL pixel = GetLayerPixel( pen.color );
+
+	const int nFirstRow =
+		max
+		(
+			int( ceil( min( pt1.y, pt2.y ) - dRadius ) ),
+			int( m_rectClip.top )
+		);
+	const int nLastRow =
+		min
+		(
+			int( ceil( max( pt1.y, pt2.y ) + dRadius ) ),
+			int( m_rectClip.bottom )
+		);
+
+	for ( int nRow = nFirstRow; nRow < nLastRow; nRow++ )
+	{
+		double dLeft = HUGE_VAL;
+		double dRight = -HUGE_VAL;
+
+		// the circles at the ends of the line
+		const SOFTWARE_POINT* pEnds[ 2 ] = { &pt1, &pt2 };
+		for ( const SOFTWARE_POINT* pEnd : pEnds )
+		{
+			const double dRowY = nRow - pEnd->y;
+			if ( fabs( dRowY ) < dRadius )
+			{
+				const double dHalf = sqrt( dRadius * dRadius - dRowY * dRowY );
+				dLeft = min( dLeft, pEnd->x - dHalf );
+				dRight = max( dRight, pEnd->x + dHalf );
+			}
+		}
+
+		// the band along the line is where the distance along the line is
+		// between zero and the length and the distance across the line is
+		// less than the radius
+		const double dRowY = nRow - pt1.y;
+		double dBandLeft = -HUGE_VAL;
+		double dBandRight = HUGE_VAL;
+		const double dRates[ 2 ] = { dAlongX, dAcrossX };
+		const double dOffsets[ 2 ] = { dRowY * dAlongY, dRowY * dAcrossY };
+		const double dLows[ 2 ] = { 0, -dRadius };
+		const double dHighs[ 2 ] = { dLength, dRadius };
+		for ( int nLimit = 0; nLimit < 2; nLimit++ )
+		{
+			const double dRate = dRates[ nLimit ];
+			const double dOffset = dOffsets[ nLimit ];
+			if ( fabs( dRate ) < 1e-12 )
+			{
+				if ( dOffset < dLows[ nLimit ] || dOffset >= dHighs[ nLimit ] )
+				{
+					dBandRight = dBandLeft;
+				}
+				continue;
+			}
+
+			double dLow = ( dLows[ nLimit ] - dOffset ) / dRate;
+			double dHigh = ( dHighs[ nLimit ] - dOffset ) / dRate;
+			if ( dLow > dHigh )
+			{
+				swap( dLow, dHigh );
+			}
+			dBandLeft = max( dBandLeft, pt1.x + dLow );
+			dBandRight = min( dBandRight, pt1.x + dHigh );
+		}
+		if ( dBandLeft < dBandRight )
+		{
+			dLeft = min( dLeft, dBandLeft );
+			dRight = max( dRight, dBandRight );
+		}
+
+		if ( dLeft >= dRight )
+		{
+			continue;
+		}
+
+		if ( !bDotted )
+		{
+			FillSpan( nRow, dLeft, dRight, pixel );
+			continue;
+		}
+
+		// a dotted line is on for a dot and off for a dot along its length
+		const long nFirst = max( long( ceil( dLeft ) ), m_rectClip.left );
+		const long nLast = min( long( ceil( dRight ) ), m_rectClip.right );
+		LAYER_PIXEL* pRow = m_pLayer->GetRow( nRow );
+		for ( long nColumn = nFirst; nColumn < nLast; nColumn++ )
+		{
+			double dAlong =
+				( nColumn - pt1.x ) * dAlongX + dRowY * dAlongY;
+			dAlong = min( max( dAlong, 0.0 ), dLength ) + dDistance;
+			if ( fmod( dAlong, 2 * dDot ) < dDot )
+			{
+				pRow[ nColumn ] = pixel;
+			}
+		}
+	}
+
+} // StrokeLine
+
+/////////////////////////////////////////////////////////////////////////////
+// draw connected lines through the points with the pen
+void CSoftwareTarget::StrokeOutline
+(
+	int nPen, const SOFTWARE_POINT* pPoints, int nPoints, bool bClosed
+)
+{
+	if ( nPen < 0 || nPoints < 1 )
+	{
+		return;
+	}
+
+	const DISPLAY_PEN& pen = m_Styles.GetPen( nPen );
+	double dDistance = 0;
+	const int nLines = bClosed ? nPoints : nPoints - 1;
+	for ( int nLine = 0; nLine < max( nLines, 1 ); nLine++ )
+	{
+		const SOFTWARE_POINT& pt1 = pPoints[ nLine ];
+		const SOFTWARE_POINT& pt2 = pPoints[ ( nLine + 1 ) % nPoints ];
+		StrokeLine( pt1, pt2, pen, dDistance );
+		dDistance += hypot( pt2.x - pt1.x, pt2.y - pt1.y );
+	}
+
+} // StrokeOutline
+
+/////////////////////////////////////////////////////////////////////////////
+// Fill the inside of the points by the even-odd rule GDI uses. Each row
+// of pixels is filled between alternate crossings with the edges, where an
+// edge includes its top end and excludes its bottom end so a vertex is
+// crossed once.
+void CSoftwareTarget::FillOutline
+(
+	int nBrush, const SOFTWARE_POINT* pPoints, int nPoints
+)
+{
+	if ( nBrush < 0 || nPoints < 3 )
+	{
+		return;
+	}
+
+	double dTop = pPoints[ 0 ].y;
+	double dBottom = pPoints[ 0 ].y;
+	for ( int nPoint = 1; nPoint < nPoints; nPoint++ )
+	{
+		dTop = min( dTop, pPoints[ nPoint ].y );
+		dBottom = max( dBottom, pPoints[ nPoint ].y );
+	}
+
+	const LAYER_PIXEL pixel =
+		GetLayerPixel( m_Styles.GetBrush( nBrush ).color );
+	const int nFirstRow = max( int( ceil( dTop ) ), int( m_rectClip.top ) );
+	const int nLastRow =
+		min( int( ceil( dBottom ) ), int( m_rectClip.bottom ) );
+
+	for ( int nRow = nFirstRow; nRow < nLastRow; nRow++ )
+	{
+		m_Crossings.clear();
+		for ( int nPoint = 0; nPoint < nPoints; nPoint++ )
+		{
+			const SOFTWARE_POINT& pt1 = pPoints[ nPoint ];
+			const SOFTWARE_POINT& pt2 = pPoints[ ( nPoint + 1 ) % nPoints ];
+			const double dEdgeTop = min( pt1.y, pt2.y );
+			const double dEdgeBottom = max( pt1.y, pt2.y );
+			if ( nRow >= dEdgeTop && nRow < dEdgeBottom )
+			{
+				m_Crossings.push_back
+				(
+					pt1.x + ( nRow - pt1.y ) * ( pt2.x - pt1.x ) /
+					( pt2.y - pt1.y )
+				);
+			}
+		}
+
+		sort( m_Crossings.begin(), m_Crossings.end() );
+		const int nCrossings = (int)m_Crossings.size();
+		for ( int nCrossing = 0; nCrossing + 1 < nCrossings; nCrossing += 2 )
+		{
+			FillSpan
+			(
+				nRow, m_Crossings[ nCrossing ], m_Crossings[ nCrossing + 1 ],
+				pixel
+			);
+		}
+	}
+
+} // FillOutline
+
+/////////////////////////////////////////////////////////////////////////////
+void CSoftwareTarget::Line
+(
+	int nPen, const DISPLAY_POINT& pt1, const DISPLAY_POINT& pt2
+)
+{
+	m_Outline.resize( 2 );
+	m_Outline[ 0 ] = ToPixel( pt1 );
+	m_Outline[ 1 ] = ToPixel( pt2 );
+	StrokeOutline( nPen, m_Outline.data(), 2, false );
+
+} // Line
+
+/////////////////////////////////////////////////////////////////////////////
+void CSoftwareTarget::Polyline
+(
+	int nPen, const DISPLAY_POINT* pPoints, int nPoints
+)
+{
+	m_Outline.resize( nPoints );
+	for ( int nPoint = 0; nPoint < nPoints; nPoint++ )
+	{
+		m_Outline[ nPoint ] = ToPixel( pPoints[ nPoint ] );
+	}
+	StrokeOutline( nPen, m_Outline.data(), nPoints, false );
+
+} // Polyline
+
+/////////////////////////////////////////////////////////////////////////////
+void CSoftwareTarget::Polygon
+(
+	int nPen, int nBrush, const DISPLAY_POINT* pPoints, int nPoints
+)
+{
+	m_Outline.resize( nPoints );
+	for ( int nPoint = 0; nPoint < nPoints; nPoint++ )
+	{
+		m_Outline[ nPoint ] = ToPixel( pPoints[ nPoint ] );
+	}
+	FillOutline( nBrush, m_Outline.data(), nPoints );
+	StrokeOutline( nPen, m_Outline.data(), nPoints, true );
+
+} // Polygon
+
+/////////////////////////////////////////////////////////////////////////////
+// the inside is filled a row at a time from the equation of the ellipse
+// and the outline is drawn as short lines
+void CSoftwareTarget::Ellipse
+(
+	int nPen, int nBrush,
+	const DISPLAY_POINT& ptTopLeft, const DISPLAY_POINT& ptBottomRight
+)
+{
+	const SOFTWARE_POINT ptTL = ToPixel( ptTopLeft );
+	const SOFTWARE_POINT ptBR = ToPixel( ptBottomRight );
+	const double dCenterX = ( ptTL.x + ptBR.x ) / 2;
+	const double dCenterY = ( ptTL.y + ptBR.y ) / 2;
+	const double dRadiusX = fabs( ptBR.x - ptTL.x ) / 2;
+	const double dRadiusY = fabs( ptBR.y - ptTL.y ) / 2;
+
+	if ( nBrush >= 0 && dRadiusX > 0 && dRadiusY > 0 )
+	{
+		const LAYER_PIXEL pixel =
+			GetLayerPixel( m_Styles.GetBrush( nBrush ).color );
+		const int nFirstRow =
+			max( int( ceil( dCenterY - dRadiusY ) ), int( m_rectClip.top ) );
+		const int nLastRow =
+			min( int( ceil( dCenterY + dRadiusY ) ), int( m_rectClip.bottom ) );
+		for ( int nRow = nFirstRow; nRow < nLastRow; nRow++ )
+		{
+			const double dRowY = ( nRow - dCenterY ) / dRadiusY;
+			const double dHalf =
+				dRadiusX * sqrt( max( 1 - dRowY * dRowY, 0.0 ) );
+			FillSpan( nRow, dCenterX - dHalf, dCenterX + dHalf, pixel );
+		}
+	}
+
+	// Ramanujan's approximation of the perimeter sets the number of lines
+	const double dPerimeter =
+		SOFTWARE_PI *
+		(
+			3 * ( dRadiusX + dRadiusY ) -
+			sqrt( ( 3 * dRadiusX + dRadiusY ) * ( dRadiusX + 3 * dRadiusY ) )
+		);
+	const int nLines =
+		min( max( int( dPerimeter / CURVE_STEP ), 8 ), MAX_CURVE_LINES );
+	m_Outline.resize( nLines );
+	for ( int nLine = 0; nLine < nLines; nLine++ )
+	{
+		const double dAngle = 2 * SOFTWARE_PI * nLine / nLines;
+		m_Outline[ nLine ].x = dCenterX + dRadiusX * cos( dAngle );
+		m_Outline[ nLine ].y = dCenterY + dRadiusY * sin( dAngle );
+	}
+	StrokeOutline( nPen, m_Outline.data(), nLines, true );
+
+} // Ellipse
+
+/////////////////////////////////////////////////////////////////////////////
+// the arc is drawn as short lines counter clockwise on the screen for a
+// positive sweep, the same direction as the angle of rotated text
+void CSoftwareTarget::Arc
+(
+	int nPen, const DISPLAY_POINT& ptCenter, int nRadius,
+	float fStartAngle, float fSweepAngle
+)
+{
+	const SOFTWARE_POINT ptPixel = ToPixel( ptCenter );
+	const double dRadius = nRadius * m_dScale;
+	const double dStart = fStartAngle * SOFTWARE_PI / 180;
+	const double dSweep = fSweepAngle * SOFTWARE_PI / 180;
+	const int nLines =
+		min
+		(
+			max( int( fabs( dSweep ) * dRadius / CURVE_STEP ), 1 ),
+			MAX_CURVE_LINES
+		);
+
+	m_Outline.resize( nLines + 1 );
+	for ( int nPoint = 0; nPoint <= nLines; nPoint++ )
+	{
+		const double dAngle = dStart + dSweep * nPoint / nLines;
+		m_Outline[ nPoint ].x = ptPixel.x + dRadius * cos( dAngle );
+		m_Outline[ nPoint ].y = ptPixel.y - dRadius * sin( dAngle );
+	}
+	StrokeOutline( nPen, m_Outline.data(), nLines + 1, false );
+
+} // Arc
+
+/////////////////////////////////////////////////////////////////////////////
+// Draw text from the glyphs of the atlas scaled to the height of the font.
+// The text is laid out along a line turned counter clockwise by the
+// escapement, so every pixel of the rectangle around the turned text is
+// turned back into the layout of the text to find the glyph dot it shows.
+// The alignment places the point on the text the way SetTextAlign does and
+// opaque text fills its character cells with the back color.
+void CSoftwareTarget::Text
+(
+	int nFont, int nEscapement, int nAlign, DISPLAY_COLOR color,
+	const DISPLAY_POINT& pt, const wchar_t* pText, int nLength
+)
+{
+	if ( nLength < 1 )
+	{
+		return;
+	}
+
+	const DISPLAY_FONT& font = m_Styles.GetFont( nFont );
+	const double dCellY = max( font.nHeight * m_dScale, 1.0 ) /
+		CGlyphAtlas::CELL_ROWS;
+	const double dCellX = dCellY * GLYPH_ASPECT;
+	const double dWidth = dCellX * CGlyphAtlas::CELL_COLUMNS * nLength;
+	const double dHeight = dCellY * CGlyphAtlas::CELL_ROWS;
+
+	// the top left corner of the text relative to the point
+	double dLeft = 0;
+	switch ( nAlign & DISPLAY_ALIGN_HORIZONTAL )
+	{
+		case DISPLAY_ALIGN_CENTER:
+		{
+			dLeft = -dWidth / 2;
+			break;
+		}
+		case DISPLAY_ALIGN_RIGHT:
+		{
+			dLeft = -dWidth;
+			break;
+		}
+	}
+	double dTop = 0;
+	switch ( nAlign & DISPLAY_ALIGN_VERTICAL )
+	{
+		case DISPLAY_ALIGN_BASELINE:
+		{
+			dTop = -dCellY * CGlyphAtlas::CELL_ASCENT;
+			break;
+		}
+		case DISPLAY_ALIGN_BOTTOM:
+		{
+			dTop = -dHeight;
+			break;
+		}
+	}
+
+	// the layout is turned counter clockwise on the screen, where the
+	// Y axis points down
+	const double dAngle = nEscapement * SOFTWARE_PI / 1800;
+	const double dCos = cos( dAngle );
+	const double dSin = sin( dAngle );
+	const SOFTWARE_POINT ptOrigin = ToPixel( pt );
+
+	// the rectangle of pixels around the turned text
+	double dMinX = HUGE_VAL;
+	double dMinY = HUGE_VAL;
+	double dMaxX = -HUGE_VAL;
+	double dMaxY = -HUGE_VAL;
+	const double dRight = dLeft + dWidth;
+	const double dBottom = dTop + dHeight;
+	const double dCornersX[ 4 ] = { dLeft, dRight, dLeft, dRight };
+	const double dCornersY[ 4 ] = { dTop, dTop, dBottom, dBottom };
+	for ( int nCorner = 0; nCorner < 4; nCorner++ )
+	{
+		const double dX =
+			ptOrigin.x + dCornersX[ nCorner ] * dCos +
+			dCornersY[ nCorner ] * dSin;
+		const double dY =
+			ptOrigin.y - dCornersX[ nCorner ] * dSin +
+			dCornersY[ nCorner ] * dCos;
+		dMinX = min( dMinX, dX );
+		dMinY = min( dMinY, dY );
+		dMaxX = max( dMaxX, dX );
+		dMaxY = max( dMaxY, dY );
+	}
+
+	const long nFirstColumn = max( long( ceil( dMinX ) ), m_rectClip.left );
+	const long nLastColumn = min( long( ceil( dMaxX ) ), m_rectClip.right );
+	const long nFirstRow = max( long( ceil( dMinY ) ), m_rectClip.top );
+	const long nLastRow = min( long( ceil( dMaxY ) ), m_rectClip.bottom );
+
+	const bool bOpaque = ( nAlign & DISPLAY_ALIGN_OPAQUE ) != 0;
+	const LAYER_PIXEL pixelText = GetLayerPixel( color );
+	const LAYER_PIXEL pixelBack = GetLayerPixel( m_colorBack );
+	const double dBaseline = dTop + dCellY * CGlyphAtlas::CELL_ASCENT;
+
+	for ( long nRow = nFirstRow; nRow < nLastRow; nRow++ )
+	{
+		LAYER_PIXEL* pRow = m_pLayer->GetRow( nRow );
+		const double dY = nRow - ptOrigin.y;
+		for ( long nColumn = nFirstColumn; nColumn < nLastColumn; nColumn++ )
+		{
+			// turn the pixel back into the layout of the text
+			const double dX = nColumn - ptOrigin.x;
+			double dAlong = dX * dCos - dY * dSin - dLeft;
+			const double dDown = dX * dSin + dY * dCos;
+			if ( font.bItalic )
+			{
+				dAlong -= ( dBaseline - dDown ) * ITALIC_SLANT;
+			}
+
+			const double dCellRow = ( dDown - dTop ) / dCellY;
+			const double dCellColumn = dAlong / dCellX;
+			if
+			(
+				dCellRow < 0 || dCellRow >= CGlyphAtlas::CELL_ROWS ||
+				dCellColumn < 0 ||
+				dCellColumn >= CGlyphAtlas::CELL_COLUMNS * nLength
+			)
+			{
+				continue;
+			}
+
+			const int nCellColumn = int( dCellColumn );
+			const int nCharacter = nCellColumn / CGlyphAtlas::CELL_COLUMNS;
+			const int nGlyphColumn =
+				nCellColumn - nCharacter * CGlyphAtlas::CELL_COLUMNS;
+			const int nGlyphRow = int( dCellRow ) - CGlyphAtlas::GLYPH_TOP;
+			const unsigned char* pGlyph =
+				CGlyphAtlas::GetGlyph( pText[ nCharacter ] );
+
+			// bold text also shows the dot to the left of each pixel
+			const bool bSet =
+				CGlyphAtlas::IsSet( pGlyph, nGlyphColumn, nGlyphRow ) ||
+				(
+					font.bBold &&
+					CGlyphAtlas::IsSet( pGlyph, nGlyphColumn - 1, nGlyphRow )
+				);
+			if ( bSet )
+			{
+				pRow[ nColumn ] = pixelText;
+			}
+			else if ( bOpaque )
+			{
+				pRow[ nColumn ] = pixelBack;
+			}
+		}
+	}
+
+} // Text
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,184 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "DisplayList.h"
+#include "LayerCache.h"
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// a point in pixels where pixel (n, m) is sampled at (n, m)
+struct SOFTWARE_POINT
+{
+	double x;
+	double y;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// A display target that draws into a CPixelLayer with the CPU, so a frame
+// can be drawn off screen without a device context, such as on Linux or in
+// a test. It draws the subset of GDI the views use: pens with a width,
+// solid and dotted, solid brushes, lines, polylines, polygons, ellipses,
+// arcs and rotated text from the built in glyphs of CGlyphAtlas.
+//
+// The mapping follows CBaseView: the drawing is in logical units (the Map
+// of the document is 1000 units per inch) and the mapping is isotropic
+// with the logical width of the view fitted to the width of the layer, as
+// SetDrawDC does, and shifted by the scroll position, as render does. The
+// Y axis points down. Shapes are not anti-aliased and the pixels are
+// written as red, green, blue and alpha bytes with an opaque alpha.
+class CSoftwareTarget : public CDisplayTarget
+{
+	// protected data
+protected:
+	// the styles the handles refer to
+	const CDisplayStyles& m_Styles;
+
+	// the layer being drawn into
+	CPixelLayer* m_pLayer;
+
+	// logical co-ordinates of the top left corner of the layer
+	long m_nLeftOffset;
+	long m_nTopOffset;
+
+	// pixels per logical unit
+	double m_dScale;
+
+	// the pixels that can be drawn where the right and bottom edges are
+	// outside
+	DISPLAY_RECT m_rectClip;
+
+	// the color behind opaque text
+	DISPLAY_COLOR m_colorBack;
+
+	// points of the outline being drawn, kept between commands
+	vector<SOFTWARE_POINT> m_Outline;
+
+	// crossings of a row of pixels with the edges of a polygon
+	vector<double> m_Crossings;
+
+	// public methods
+public:
+	// pixels per logical unit
+	double GetScale() const
+	{
+		return m_dScale;
+	}
+
+	// the color behind opaque text
+	DISPLAY_COLOR GetBackColor() const
+	{
+		return m_colorBack;
+	}
+	// the color behind opaque text
+	void SetBackColor( DISPLAY_COLOR value )
+	{
+		m_colorBack = value;
+	}
+
+	// Map the logical width of the view onto the given width in pixels
+	// with the logical point at the top left corner of the layer, like
+	// SetDrawDC followed by render.
+	void SetMapping
+	(
+		long nLeftOffset, long nTopOffset, int nLogicalWidth, int nPixelWidth
+	);
+
+	// the pixel of a logical point
+	SOFTWARE_POINT ToPixel( const DISPLAY_POINT& pt ) const
+	{
+		SOFTWARE_POINT value;
+		value.x = ( pt.x - m_nLeftOffset ) * m_dScale;
+		value.y = ( pt.y - m_nTopOffset ) * m_dScale;
+		return value;
+	}
+
+	// replay the list into the whole layer
+	void Draw( CPixelLayer& layer, const CDisplayList& list );
+
+	// replay the list into the given pixels of the layer
+	void Draw
+	(
+		CPixelLayer& layer, const CDisplayList& list,
+		const DISPLAY_RECT& rectClip
+	);
+
+	// Start drawing into the given pixels of the layer and return false
+	// if none of them are inside of the layer. The drawing methods can be
+	// called directly afterwards, as when each tile of a layer is drawn
+	// with only the commands that touch it.
+	bool SetLayer( CPixelLayer& layer, const DISPLAY_RECT& rectClip );
+
+	// the pixel value of a color
+	static LAYER_PIXEL GetLayerPixel( DISPLAY_COLOR color )
+	{
+		return LAYER_PIXEL( color & 0xffffff ) | 0xff000000;
+	}
+
+	// protected methods
+protected:
+	// width of the pen in pixels which is at least one pixel
+	double GetPenWidth( const DISPLAY_PEN& pen ) const;
+
+	// fill the pixels of a row from the left edge up to the right edge
+	void FillSpan( int nRow, double dLeft, double dRight, LAYER_PIXEL pixel );
+
+	// Draw a line of the given width with round ends. The distance is how
+	// far along the outline the line starts, which keeps the dots of a
+	// dotted pen in step from one line to the next.
+	void StrokeLine
+	(
+		const SOFTWARE_POINT& pt1, const SOFTWARE_POINT& pt2,
+		const DISPLAY_PEN& pen, double dDistance
+	);
+
+	// draw connected lines through the points with the pen
+	void StrokeOutline
+	(
+		int nPen, const SOFTWARE_POINT* pPoints, int nPoints, bool bClosed
+	);
+
+	// fill the inside of the points by the even-odd rule GDI uses
+	void FillOutline
+	(
+		int nBrush, const SOFTWARE_POINT* pPoints, int nPoints
+	);
+
+	// public overrides
+public:
+	void Line
+	(
+		int nPen, const DISPLAY_POINT& pt1, const DISPLAY_POINT& pt2
+	) override;
+	void Polyline
+	(
+		int nPen, const DISPLAY_POINT* pPoints, int nPoints
+	) override;
+	void Polygon
+	(
+		int nPen, int nBrush, const DISPLAY_POINT* pPoints, int nPoints
+	) override;
+	void Ellipse
+	(
+		int nPen, int nBrush,
+		const DISPLAY_POINT& ptTopLeft, const DISPLAY_POINT& ptBottomRight
+	) override;
+	void Arc
+	(
+		int nPen, const DISPLAY_POINT& ptCenter, int nRadius,
+		float fStartAngle, float fSweepAngle
+	) override;
+	void Text
+	(
+		int nFont, int nEscapement, int nAlign, DISPLAY_COLOR color,
+		const DISPLAY_POINT& pt, const wchar_t* pText, int nLength
+	) override;
+
+	// public construction
+public:
+	CSoftwareTarget( const CDisplayStyles& styles );
+};
+
+/////////////////////////////////////////////////////////////////////////////
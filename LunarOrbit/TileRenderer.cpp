@@ -0,0 +1,258 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "TileRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// pixels added around the bounding rectangle of a command, which covers
+// the rounding of the mapping and pens narrower than a pixel
+static const int BIN_MARGIN = 2;
+
+// lines in a run of a solid polyline listed in the tiles on its own
+static const int POLYLINE_RUN = 32;
+
+/////////////////////////////////////////////////////////////////////////////
+CTileRenderer::CTileRenderer( const CDisplayStyles& styles ) :
+	m_Styles( styles )
+{
+	m_nLeftOffset = 0;
+	m_nTopOffset = 0;
+	m_nLogicalWidth = 1;
+	m_nPixelWidth = 1;
+	m_nTileSize = 128;
+	m_nThreads = 0;
+	m_bErase = true;
+	m_colorBack = DisplayColor( 255, 255, 255 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// width and height of a tile in pixels
+void CTileRenderer::SetTileSize( int value )
+{
+	m_nTileSize = max( value, 16 );
+
+} // SetTileSize
+
+/////////////////////////////////////////////////////////////////////////////
+// Map the logical width of the view onto the given width in pixels with
+// the logical point at the top left corner of the layer, like SetDrawDC
+// followed by render.
+void CTileRenderer::SetMapping
+(
+	long nLeftOffset, long nTopOffset, int nLogicalWidth, int nPixelWidth
+)
+{
+	m_nLeftOffset = nLeftOffset;
+	m_nTopOffset = nTopOffset;
+	m_nLogicalWidth = nLogicalWidth;
+	m_nPixelWidth = nPixelWidth;
+
+} // SetMapping
+
+/////////////////////////////////////////////////////////////////////////////
+// Cut the layer into tiles and list each command in the tiles it touches.
+// The commands are visited in order, so each tile lists its commands in
+// drawing order. The lists keep their storage from one layer to the next.
+void CTileRenderer::Bin( const CPixelLayer& layer, const CDisplayList& list )
+{
+	const int nWidth = layer.GetWidth();
+	const int nHeight = layer.GetHeight();
+	const int nColumns = ( nWidth + m_nTileSize - 1 ) / m_nTileSize;
+	const int nRows = ( nHeight + m_nTileSize - 1 ) / m_nTileSize;
+
+	m_Tiles.resize( size_t( nColumns ) * nRows );
+	for ( int nRow = 0; nRow < nRows; nRow++ )
+	{
+		for ( int nColumn = 0; nColumn < nColumns; nColumn++ )
+		{
+			TILE_BIN& tile = m_Tiles[ nRow * nColumns + nColumn ];
+			tile.rect.left = nColumn * m_nTileSize;
+			tile.rect.top = nRow * m_nTileSize;
+			tile.rect.right =
+				min( tile.rect.left + m_nTileSize, long( nWidth ) );
+			tile.rect.bottom =
+				min( tile.rect.top + m_nTileSize, long( nHeight ) );
+			tile.commands.clear();
+		}
+	}
+
+	const int nCommands = list.GetCommandCount();
+	for ( int nCommand = 0; nCommand < nCommands; nCommand++ )
+	{
+		const DISPLAY_COMMAND& command = list.GetCommand( nCommand );
+		TILE_COMMAND entry = { nCommand, 0, 0 };
+
+		const bool bRuns =
+			command.eType == DISPLAY_POLYLINE && command.nPen >= 0 &&
+			command.nPoints > POLYLINE_RUN + 1 &&
+			m_Styles.GetPen( command.nPen ).eStyle == DISPLAY_PEN_SOLID;
+		if ( !bRuns )
+		{
+			Bin( layer, list.GetBounds( nCommand, m_Styles ), entry );
+			continue;
+		}
+
+		// runs of lines that share their end points, bounded by their
+		// points and the width of the pen
+		const DISPLAY_POINT* pPoints = list.GetPoints( nCommand );
+		const long nPen = m_Styles.GetPen( command.nPen ).nWidth / 2 + 1;
+		for
+		(
+			int nFirst = 0; nFirst < command.nPoints - 1;
+			nFirst += POLYLINE_RUN
+		)
+		{
+			entry.nFirstPoint = nFirst;
+			entry.nPoints = min( POLYLINE_RUN + 1, command.nPoints - nFirst );
+
+			DISPLAY_RECT rect =
+			{
+				pPoints[ nFirst ].x, pPoints[ nFirst ].y,
+				pPoints[ nFirst ].x, pPoints[ nFirst ].y
+			};
+			for ( int nPoint = 1; nPoint < entry.nPoints; nPoint++ )
+			{
+				const DISPLAY_POINT& pt = pPoints[ nFirst + nPoint ];
+				rect.left = min( rect.left, pt.x );
+				rect.top = min( rect.top, pt.y );
+				rect.right = max( rect.right, pt.x );
+				rect.bottom = max( rect.bottom, pt.y );
+			}
+			rect.left -= nPen;
+			rect.top -= nPen;
+			rect.right += nPen + 1;
+			rect.bottom += nPen + 1;
+
+			Bin( layer, rect, entry );
+		}
+	}
+
+} // Bin
+
+/////////////////////////////////////////////////////////////////////////////
+// list the command or run of a polyline in the tiles its logical rectangle
+// touches
+void CTileRenderer::Bin
+(
+	const CPixelLayer& layer, const DISPLAY_RECT& rect,
+	const TILE_COMMAND& command
+)
+{
+	const int nWidth = layer.GetWidth();
+	const int nHeight = layer.GetHeight();
+	const int nColumns = ( nWidth + m_nTileSize - 1 ) / m_nTileSize;
+	const double dScale =
+		m_nLogicalWidth > 0 ? double( m_nPixelWidth ) / m_nLogicalWidth : 1;
+
+	// the rectangle in pixels
+	const int nLeft =
+		int( floor( ( rect.left - m_nLeftOffset ) * dScale ) ) - BIN_MARGIN;
+	const int nTop =
+		int( floor( ( rect.top - m_nTopOffset ) * dScale ) ) - BIN_MARGIN;
+	const int nRight =
+		int( ceil( ( rect.right - m_nLeftOffset ) * dScale ) ) + BIN_MARGIN;
+	const int nBottom =
+		int( ceil( ( rect.bottom - m_nTopOffset ) * dScale ) ) + BIN_MARGIN;
+	if ( nRight <= 0 || nBottom <= 0 || nLeft >= nWidth || nTop >= nHeight )
+	{
+		return;
+	}
+
+	// the tiles the rectangle touches
+	const int nFirstColumn = max( nLeft, 0 ) / m_nTileSize;
+	const int nLastColumn = min( nRight - 1, nWidth - 1 ) / m_nTileSize;
+	const int nFirstRow = max( nTop, 0 ) / m_nTileSize;
+	const int nLastRow = min( nBottom - 1, nHeight - 1 ) / m_nTileSize;
+	for ( int nRow = nFirstRow; nRow <= nLastRow; nRow++ )
+	{
+		TILE_BIN* pTile = &m_Tiles[ nRow * nColumns + nFirstColumn ];
+		for ( int nColumn = nFirstColumn; nColumn <= nLastColumn; nColumn++ )
+		{
+			pTile->commands.push_back( command );
+			pTile++;
+		}
+	}
+
+} // Bin
+
+/////////////////////////////////////////////////////////////////////////////
+// draw the list into the layer with the worker threads
+void CTileRenderer::Draw( CPixelLayer& layer, const CDisplayList& list )
+{
+	Bin( layer, list );
+
+	const int nTiles = GetTileCount();
+	int nThreads = m_nThreads;
+	if ( nThreads <= 0 )
+	{
+		nThreads = (int)thread::hardware_concurrency();
+	}
+	nThreads = max( 1, min( nThreads, nTiles ) );
+
+	const LAYER_PIXEL pixelBack = CSoftwareTarget::GetLayerPixel( m_colorBack );
+
+	// each worker draws every nThreads'th tile, which spreads the busy
+	// parts of the page among the workers, and the tiles do not share
+	// pixels so no locking is needed
+	auto work = [ & ]( int nFirst )
+	{
+		CSoftwareTarget target( m_Styles );
+		target.SetMapping
+		(
+			m_nLeftOffset, m_nTopOffset, m_nLogicalWidth, m_nPixelWidth
+		);
+		target.SetBackColor( m_colorBack );
+
+		for ( int nTile = nFirst; nTile < nTiles; nTile += nThreads )
+		{
+			const TILE_BIN& tile = m_Tiles[ nTile ];
+			const DISPLAY_RECT& rect = tile.rect;
+			if ( m_bErase )
+			{
+				for ( int nRow = int( rect.top ); nRow < rect.bottom; nRow++ )
+				{
+					LAYER_PIXEL* pRow = layer.GetRow( nRow );
+					fill( pRow + rect.left, pRow + rect.right, pixelBack );
+				}
+			}
+			if ( tile.commands.empty() || !target.SetLayer( layer, rect ) )
+			{
+				continue;
+			}
+
+			for ( const TILE_COMMAND& command : tile.commands )
+			{
+				if ( command.nPoints == 0 )
+				{
+					list.Replay( target, command.nCommand );
+					continue;
+				}
+
+				target.Polyline
+				(
+					list.GetCommand( command.nCommand ).nPen,
+					list.GetPoints( command.nCommand ) + command.nFirstPoint,
+					command.nPoints
+				);
+			}
+		}
+	};
+
+	// the calling thread does its share of the work
+	vector<thread> workers;
+	for ( int nThread = 1; nThread < nThreads; nThread++ )
+	{
+		workers.push_back( thread( work, nThread ) );
+	}
+	work( 0 );
+
+	for ( auto& worker : workers )
+	{
+		worker.join();
+	}
+
+} // Draw
+
+/////////////////////////////////////////////////////////////////////////////
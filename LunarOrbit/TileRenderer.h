@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "SoftwareTarget.h"
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// a command listed in a tile, or a run of the lines of a polyline
+struct TILE_COMMAND
+{
+	int nCommand; // index of the command in the list
+	int nFirstPoint; // first point of the run of a polyline
+	int nPoints; // points in the run or zero for the whole command
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a square of pixels and the commands that draw in it
+struct TILE_BIN
+{
+	DISPLAY_RECT rect; // pixels of the tile (right and bottom outside)
+	vector<TILE_COMMAND> commands; // commands in drawing order
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Draws a display list into a large layer, such as an export of the page
+// at print resolution, with the CPU cores in parallel. The layer is cut
+// into square tiles and each command is listed in every tile its bounding
+// rectangle touches, then worker threads draw the tiles with a
+// CSoftwareTarget each, clipped to the tile and replaying only the
+// commands listed for it. No two tiles share a pixel, so the workers
+// write the layer without locking, and the commands of a tile keep their
+// drawing order, so the result is the same as drawing the list in one
+// piece.
+//
+// A long solid polyline such as the orbit trail crosses most of the page,
+// so it is listed as short runs of lines each in only the tiles it
+// touches. A dotted polyline is listed whole, which keeps its dots in
+// step along its length.
+//
+// The mapping is the same as CSoftwareTarget, from logical units of the
+// view (Map = 1000 units per inch) to the pixels of the layer.
+class CTileRenderer
+{
+	// protected data
+protected:
+	// the styles the handles refer to
+	const CDisplayStyles& m_Styles;
+
+	// logical co-ordinates of the top left corner of the layer
+	long m_nLeftOffset;
+	long m_nTopOffset;
+
+	// logical width mapped onto the pixel width
+	int m_nLogicalWidth;
+	int m_nPixelWidth;
+
+	// width and height of a tile in pixels
+	int m_nTileSize;
+
+	// number of worker threads (zero for one per hardware thread)
+	int m_nThreads;
+
+	// true if each tile is filled with the back color before drawing
+	bool m_bErase;
+
+	// the color of erased tiles and behind opaque text
+	DISPLAY_COLOR m_colorBack;
+
+	// the tiles by row from the top left corner
+	vector<TILE_BIN> m_Tiles;
+
+	// public methods
+public:
+	// width and height of a tile in pixels
+	int GetTileSize() const
+	{
+		return m_nTileSize;
+	}
+	// width and height of a tile in pixels
+	void SetTileSize( int value );
+
+	// number of worker threads (zero for one per hardware thread)
+	int GetThreads() const
+	{
+		return m_nThreads;
+	}
+	// number of worker threads (zero for one per hardware thread)
+	void SetThreads( int value )
+	{
+		m_nThreads = value;
+	}
+
+	// true if each tile is filled with the back color before drawing
+	bool GetErase() const
+	{
+		return m_bErase;
+	}
+	// true if each tile is filled with the back color before drawing
+	void SetErase( bool value )
+	{
+		m_bErase = value;
+	}
+
+	// the color of erased tiles and behind opaque text
+	DISPLAY_COLOR GetBackColor() const
+	{
+		return m_colorBack;
+	}
+	// the color of erased tiles and behind opaque text
+	void SetBackColor( DISPLAY_COLOR value )
+	{
+		m_colorBack = value;
+	}
+
+	// number of tiles of the last layer drawn
+	int GetTileCount() const
+	{
+		return (int)m_Tiles.size();
+	}
+
+	// the tile at the given index
+	const TILE_BIN& GetTile( int nTile ) const
+	{
+		return m_Tiles[ nTile ];
+	}
+
+	// Map the logical width of the view onto the given width in pixels
+	// with the logical point at the top left corner of the layer, like
+	// SetDrawDC followed by render.
+	void SetMapping
+	(
+		long nLeftOffset, long nTopOffset, int nLogicalWidth, int nPixelWidth
+	);
+
+	// draw the list into the layer with the worker threads
+	void Draw( CPixelLayer& layer, const CDisplayList& list );
+
+	// protected methods
+protected:
+	// cut the layer into tiles and list each command in the tiles it
+	// touches
+	void Bin( const CPixelLayer& layer, const CDisplayList& list );
+
+	// list the command or run of a polyline in the tiles its logical
+	// rectangle touches
+	void Bin
+	(
+		const CPixelLayer& layer, const DISPLAY_RECT& rect,
+		const TILE_COMMAND& command
+	);
+
+	// public construction
+public:
+	CTileRenderer( const CDisplayStyles& styles );
+};
+
+/////////////////////////////////////////////////////////////////////////////
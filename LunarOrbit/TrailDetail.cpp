@@ -0,0 +1,216 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "TrailDetail.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// the diagonal of a cell compared to its width
+static const double CELL_DIAGONAL = 1.41421356237309505;
+
+// farthest apart in cells two ends of a keyed line can be
+static const int MAX_LINE_CELLS = 127;
+
+/////////////////////////////////////////////////////////////////////////////
+// the tolerance of the first level in logical units and the number of
+// levels
+CTrailDetail::CTrailDetail( double dTolerance, int nLevels )
+{
+	m_nPoints = 0;
+	m_Levels.resize( max( nLevels, 1 ) );
+
+	double dCell = dTolerance;
+	for ( TRAIL_LEVEL& level : m_Levels )
+	{
+		level.dTolerance = dCell;
+		dCell *= 2;
+	}
+	Clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// remove all of the points
+void CTrailDetail::Clear()
+{
+	m_nPoints = 0;
+	for ( TRAIL_LEVEL& level : m_Levels )
+	{
+		level.points.clear();
+		level.runs.clear();
+		level.lines.clear();
+		level.bLast = false;
+		level.nLastColumn = 0;
+		level.nLastRow = 0;
+		level.ptLast.x = 0;
+		level.ptLast.y = 0;
+		level.bLastKept = false;
+	}
+
+} // Clear
+
+/////////////////////////////////////////////////////////////////////////////
+// Key of a line between two cells or -1 if the cells are too far apart to
+// be keyed. The key is the lower cell in 24 bits of column and row and the
+// step to the other cell in 8 bits each, so the key is the same in either
+// direction.
+long long CTrailDetail::GetLineKey
+(
+	int nColumn1, int nRow1, int nColumn2, int nRow2
+)
+{
+	if
+	(
+		nColumn2 < nColumn1 || ( nColumn2 == nColumn1 && nRow2 < nRow1 )
+	)
+	{
+		swap( nColumn1, nColumn2 );
+		swap( nRow1, nRow2 );
+	}
+
+	const int nStepX = nColumn2 - nColumn1;
+	const int nStepY = nRow2 - nRow1;
+	if ( nStepX > MAX_LINE_CELLS || abs( nStepY ) > MAX_LINE_CELLS )
+	{
+		return -1;
+	}
+
+	return
+		( (long long)( nColumn1 & 0xffffff ) << 40 ) |
+		( (long long)( nRow1 & 0xffffff ) << 16 ) |
+		( (long long)( nStepX & 0xff ) << 8 ) |
+		(long long)( nStepY & 0xff );
+
+} // GetLineKey
+
+/////////////////////////////////////////////////////////////////////////////
+// add a point to the end of the trail at every level
+void CTrailDetail::AddPoint( long nX, long nY )
+{
+	m_nPoints++;
+
+	DISPLAY_POINT pt;
+	pt.x = nX;
+	pt.y = nY;
+
+	for ( TRAIL_LEVEL& level : m_Levels )
+	{
+		const int nColumn = (int)floor( nX / level.dTolerance );
+		const int nRow = (int)floor( nY / level.dTolerance );
+
+		// the first point starts the level without a line
+		if ( !level.bLast )
+		{
+			level.bLast = true;
+			level.nLastColumn = nColumn;
+			level.nLastRow = nRow;
+			level.ptLast = pt;
+			level.bLastKept = false;
+			continue;
+		}
+
+		// the point stays in the cell of the last point
+		if ( nColumn == level.nLastColumn && nRow == level.nLastRow )
+		{
+			continue;
+		}
+
+		// a line already kept ends the run and the next line kept starts
+		// a new one, where lines too long to key are always kept
+		const long long nKey =
+			GetLineKey( level.nLastColumn, level.nLastRow, nColumn, nRow );
+		if ( nKey < 0 || level.lines.insert( nKey ).second )
+		{
+			if ( !level.bLastKept )
+			{
+				level.runs.push_back( (int)level.points.size() );
+				level.points.push_back( level.ptLast );
+			}
+			level.points.push_back( pt );
+			level.bLastKept = true;
+		}
+		else
+		{
+			level.bLastKept = false;
+		}
+
+		level.nLastColumn = nColumn;
+		level.nLastRow = nRow;
+		level.ptLast = pt;
+	}
+
+} // AddPoint
+
+/////////////////////////////////////////////////////////////////////////////
+// The coarsest level whose error is less than the given number of logical
+// units in a pixel, or -1 if even the finest level is too coarse and the
+// trail should be drawn in full.
+int CTrailDetail::FindLevel( double dUnitsPerPixel ) const
+{
+	int value = -1;
+	const int nLevels = GetLevelCount();
+	for ( int nLevel = 0; nLevel < nLevels; nLevel++ )
+	{
+		if ( m_Levels[ nLevel ].dTolerance * CELL_DIAGONAL > dUnitsPerPixel )
+		{
+			break;
+		}
+		value = nLevel;
+	}
+	return value;
+
+} // FindLevel
+
+/////////////////////////////////////////////////////////////////////////////
+// Find the runs of the level with lines touching the rectangle where the
+// runs are cut where the lines leave the rectangle. A level holds few
+// points at the scale it is drawn at, so every line is tested.
+void CTrailDetail::FindRuns
+(
+	int nLevel, const DISPLAY_RECT& rect, vector<TRAIL_RUN>& runs
+) const
+{
+	runs.clear();
+
+	const TRAIL_LEVEL& level = m_Levels[ nLevel ];
+	const int nRuns = (int)level.runs.size();
+	const int nPoints = (int)level.points.size();
+	for ( int nRun = 0; nRun < nRuns; nRun++ )
+	{
+		const int nFirst = level.runs[ nRun ];
+		const int nLast = nRun + 1 < nRuns ? level.runs[ nRun + 1 ] : nPoints;
+
+		// the run being extended or -1
+		int nStart = -1;
+		for ( int nPoint = nFirst; nPoint + 1 < nLast; nPoint++ )
+		{
+			const DISPLAY_POINT& pt1 = level.points[ nPoint ];
+			const DISPLAY_POINT& pt2 = level.points[ nPoint + 1 ];
+			const bool bInside =
+				min( pt1.x, pt2.x ) <= rect.right &&
+				max( pt1.x, pt2.x ) >= rect.left &&
+				min( pt1.y, pt2.y ) <= rect.bottom &&
+				max( pt1.y, pt2.y ) >= rect.top;
+
+			if ( bInside && nStart < 0 )
+			{
+				nStart = nPoint;
+			}
+			else if ( !bInside && nStart >= 0 )
+			{
+				TRAIL_RUN run = { nStart, nPoint - nStart + 1 };
+				runs.push_back( run );
+				nStart = -1;
+			}
+		}
+
+		if ( nStart >= 0 )
+		{
+			TRAIL_RUN run = { nStart, nLast - nStart };
+			runs.push_back( run );
+		}
+	}
+
+} // FindRuns
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "DisplayList.h"
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// a run of connected points of a level of detail
+struct TRAIL_RUN
+{
+	int nFirstPoint; // index of the first point of the run
+	int nPoints; // number of points in the run
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the trail simplified to a tolerance, where the points are kept as runs
+// because lines already drawn by an earlier part of the trail are left out
+struct TRAIL_LEVEL
+{
+	double dTolerance; // width and height of a cell in logical units
+	vector<DISPLAY_POINT> points; // the points of all of the runs
+	vector<int> runs; // index of the first point of each run
+
+	// lines between cells that are in the runs
+	unordered_set<long long> lines;
+
+	bool bLast; // true if a point has been added
+	int nLastColumn; // column of the cell of the last point added
+	int nLastRow; // row of the cell of the last point added
+	DISPLAY_POINT ptLast; // the point that stands for the last cell
+	bool bLastKept; // true if the last point ends the last run
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Levels of detail of the orbit trail, so drawing the trail costs the
+// same however many points it has. Level n divides the plane into square
+// cells 2^n times the tolerance of the first level and keeps the first
+// point of the trail to enter each cell, leaving out the points that
+// follow it in the same cell, so a level is off by less than the diagonal
+// of its cells. A line between two cells that has already been kept is
+// not kept again, so an orbit traced over and over adds nothing once its
+// cells are known. The levels are built as the points are added, a few
+// operations per level per point, and are never rebuilt.
+//
+// The renderer picks the coarsest level whose error is less than a pixel
+// for the current logical to device scale. The detail does not depend on
+// MFC and works in the logical units of the view.
+class CTrailDetail
+{
+	// protected data
+protected:
+	// the levels from the finest to the coarsest
+	vector<TRAIL_LEVEL> m_Levels;
+
+	// number of points added
+	int m_nPoints;
+
+	// public methods
+public:
+	// number of points added
+	int GetPointCount() const
+	{
+		return m_nPoints;
+	}
+
+	// number of levels
+	int GetLevelCount() const
+	{
+		return (int)m_Levels.size();
+	}
+
+	// the level at the given index
+	const TRAIL_LEVEL& GetLevel( int nLevel ) const
+	{
+		return m_Levels[ nLevel ];
+	}
+
+	// remove all of the points
+	void Clear();
+
+	// add a point to the end of the trail at every level
+	void AddPoint( long nX, long nY );
+
+	// The coarsest level whose error is less than the given number of
+	// logical units in a pixel, or -1 if even the finest level is too
+	// coarse and the trail should be drawn in full.
+	int FindLevel( double dUnitsPerPixel ) const;
+
+	// Find the runs of the level with lines touching the rectangle where
+	// the runs are cut where the lines leave the rectangle.
+	void FindRuns
+	(
+		int nLevel, const DISPLAY_RECT& rect, vector<TRAIL_RUN>& runs
+	) const;
+
+	// protected methods
+protected:
+	// key of a line between two cells or -1 if the cells are too far
+	// apart to be keyed
+	static long long GetLineKey
+	(
+		int nColumn1, int nRow1, int nColumn2, int nRow2
+	);
+
+	// public construction
+public:
+	// the tolerance of the first level in logical units and the number
+	// of levels
+	CTrailDetail( double dTolerance = 1, int nLevels = 16 );
+};
+
+/////////////////////////////////////////////////////////////////////////////
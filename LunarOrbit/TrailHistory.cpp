@@ -0,0 +1,606 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "TrailHistory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+/////////////////////////////////////////////////////////////////////////////
+// SSE2 is part of every x64 target and is optional for 32 bit targets
+#if defined( _M_X64 ) || defined( __SSE2__ ) || \
+	( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define TRAIL_HISTORY_SSE2
+#include <emmintrin.h>
+#endif
+
+// the meters a sample is rounded to unless the resolution is set
+static const double DEFAULT_RESOLUTION = 1000;
+
+// longest step between samples in a chunk in resolutions
+static const double MAX_STEP = 32767;
+
+// largest change of step between samples in a chunk that is not wide in
+// resolutions
+static const int MAX_CHANGE = 127;
+
+/////////////////////////////////////////////////////////////////////////////
+CTrailHistory::CTrailHistory( int nCapacity )
+{
+	m_nCapacity = 0;
+	m_dResolution = DEFAULT_RESOLUTION;
+	m_nFirstChunk = 0;
+	m_nChunks = 0;
+	m_nCount = 0;
+	m_nTotal = 0;
+	SetCapacity( nCapacity );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Least number of samples held when the ring is full where the samples are
+// removed. One chunk more than the capacity needs is allocated, so there
+// is always a chunk to replace while the capacity is held by the others.
+void CTrailHistory::SetCapacity( int value )
+{
+	m_nCapacity = max( value, 0 );
+
+	const int nChunks = m_nCapacity == 0 ?
+		0 : ( m_nCapacity + CHUNK_SAMPLES - 1 ) / CHUNK_SAMPLES + 1;
+	const TRAIL_CHUNK chunk = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 2 };
+	m_Chunks.assign( nChunks, chunk );
+	m_Steps.assign( size_t( nChunks ) * CHUNK_SAMPLES, 0 );
+	Clear();
+
+} // SetCapacity
+
+/////////////////////////////////////////////////////////////////////////////
+// meters a sample is rounded to where the samples are removed
+void CTrailHistory::SetResolution( double value )
+{
+	m_dResolution = value > 0 ? value : DEFAULT_RESOLUTION;
+	Clear();
+
+} // SetResolution
+
+/////////////////////////////////////////////////////////////////////////////
+// remove all of the samples
+void CTrailHistory::Clear()
+{
+	m_nFirstChunk = 0;
+	m_nChunks = 0;
+	m_nCount = 0;
+	m_nTotal = 0;
+
+} // Clear
+
+/////////////////////////////////////////////////////////////////////////////
+// add a sample replacing the oldest ones when the ring is full
+void CTrailHistory::Add( double dX, double dY )
+{
+	const int nChunks = (int)m_Chunks.size();
+	if ( nChunks == 0 )
+	{
+		return;
+	}
+
+	// the sample in resolutions
+	const double dSampleX = floor( dX / m_dResolution + 0.5 );
+	const double dSampleY = floor( dY / m_dResolution + 0.5 );
+
+	// the sample is added to the newest chunk unless the chunk is full or
+	// the step is too long, and a chunk of changes is followed by a wide
+	// chunk when the change of step is too large
+	int nSampleBytes = 2;
+	if ( m_nChunks > 0 )
+	{
+		const int nIndex = GetChunkIndex( m_nChunks - 1 );
+		TRAIL_CHUNK& chunk = m_Chunks[ nIndex ];
+		const double dStepX = dSampleX - chunk.dBaseX - chunk.nLastX;
+		const double dStepY = dSampleY - chunk.dBaseY - chunk.nLastY;
+		if ( fabs( dStepX ) <= MAX_STEP && fabs( dStepY ) <= MAX_STEP )
+		{
+			const int nStepX = int( dStepX );
+			const int nStepY = int( dStepY );
+			short* pSamples = GetSamples( nIndex );
+			bool bAdded = false;
+			if ( chunk.nSampleBytes == 4 )
+			{
+				if ( chunk.nCount < WIDE_SAMPLES )
+				{
+					pSamples[ chunk.nCount * 2 ] = short( nStepX );
+					pSamples[ chunk.nCount * 2 + 1 ] = short( nStepY );
+					bAdded = true;
+				}
+			}
+			else if ( chunk.nCount < CHUNK_SAMPLES )
+			{
+				// the second sample keeps its step in the chunk, so its
+				// change is zero
+				signed char* pChanges = (signed char*)pSamples;
+				const int nChangeX =
+					chunk.nCount == 1 ? 0 : nStepX - chunk.nStepX;
+				const int nChangeY =
+					chunk.nCount == 1 ? 0 : nStepY - chunk.nStepY;
+				if
+				(
+					abs( nChangeX ) <= MAX_CHANGE &&
+					abs( nChangeY ) <= MAX_CHANGE
+				)
+				{
+					if ( chunk.nCount == 1 )
+					{
+						chunk.nFirstStepX = nStepX;
+						chunk.nFirstStepY = nStepY;
+					}
+					pChanges[ chunk.nCount * 2 ] = (signed char)nChangeX;
+					pChanges[ chunk.nCount * 2 + 1 ] = (signed char)nChangeY;
+					bAdded = true;
+				}
+				else
+				{
+					nSampleBytes = 4;
+				}
+			}
+
+			if ( bAdded )
+			{
+				chunk.nLastX += nStepX;
+				chunk.nLastY += nStepY;
+				chunk.nStepX = nStepX;
+				chunk.nStepY = nStepY;
+				chunk.nCount++;
+				m_nCount++;
+				m_nTotal++;
+				return;
+			}
+		}
+	}
+
+	// the oldest chunk is replaced when every chunk is in use
+	if ( m_nChunks == nChunks )
+	{
+		m_nCount -= m_Chunks[ m_nFirstChunk ].nCount;
+		m_nFirstChunk = m_nFirstChunk + 1 < nChunks ? m_nFirstChunk + 1 : 0;
+		m_nChunks--;
+	}
+
+	// a new chunk starts from the sample
+	const int nIndex = GetChunkIndex( m_nChunks );
+	TRAIL_CHUNK& chunk = m_Chunks[ nIndex ];
+	chunk.dBaseX = dSampleX;
+	chunk.dBaseY = dSampleY;
+	chunk.nCount = 1;
+	chunk.nLastX = 0;
+	chunk.nLastY = 0;
+	chunk.nStepX = 0;
+	chunk.nStepY = 0;
+	chunk.nFirstStepX = 0;
+	chunk.nFirstStepY = 0;
+	chunk.nSampleBytes = nSampleBytes;
+
+	// the first sample is zero either way
+	short* pSamples = GetSamples( nIndex );
+	pSamples[ 0 ] = 0;
+	pSamples[ 1 ] = 0;
+
+	m_nChunks++;
+	m_nCount++;
+	m_nTotal++;
+
+} // Add
+
+/////////////////////////////////////////////////////////////////////////////
+// Write the capacity, the resolution and the samples held to the
+// checkpoint. The chunks in use are written from the oldest to the newest
+// with only the changes or steps of their samples, so a history that is
+// not full takes no more room than its samples.
+void CTrailHistory::Save( CCheckpoint& checkpoint ) const
+{
+	checkpoint.Put( m_nCapacity );
+	checkpoint.Put( m_dResolution );
+	checkpoint.Put( m_nChunks );
+	checkpoint.Put( m_nTotal );
+
+	for ( int nChunk = 0; nChunk < m_nChunks; nChunk++ )
+	{
+		const int nIndex = GetChunkIndex( nChunk );
+		const TRAIL_CHUNK& chunk = m_Chunks[ nIndex ];
+		checkpoint.Put( chunk );
+		checkpoint.PutArray( GetSamples( nIndex ), GetSampleShorts( chunk ) );
+	}
+
+} // Save
+
+/////////////////////////////////////////////////////////////////////////////
+// Read a history written by Save in place of this one and return false if
+// the checkpoint does not hold one, in which case this history is
+// unchanged. The history is read into a new one with the oldest chunk
+// first, which adds, decodes and projects the same as the ring it was
+// written from.
+bool CTrailHistory::Load( CCheckpoint& checkpoint )
+{
+	int nCapacity = 0;
+	double dResolution = 0;
+	int nChunks = 0;
+	long long nTotal = 0;
+	if
+	(
+		!checkpoint.Get( nCapacity ) || !checkpoint.Get( dResolution ) ||
+		!checkpoint.Get( nChunks ) || !checkpoint.Get( nTotal )
+	)
+	{
+		return false;
+	}
+	if ( nCapacity < 0 || !( dResolution > 0 ) )
+	{
+		return false;
+	}
+
+	CTrailHistory history( nCapacity );
+	history.m_dResolution = dResolution;
+	if ( nChunks < 0 || nChunks > (int)history.m_Chunks.size() )
+	{
+		return false;
+	}
+
+	int nCount = 0;
+	for ( int nChunk = 0; nChunk < nChunks; nChunk++ )
+	{
+		TRAIL_CHUNK& chunk = history.m_Chunks[ nChunk ];
+		if ( !checkpoint.Get( chunk ) )
+		{
+			return false;
+		}
+		if ( chunk.nSampleBytes != 2 && chunk.nSampleBytes != 4 )
+		{
+			return false;
+		}
+		const int nMaxCount =
+			chunk.nSampleBytes == 4 ? WIDE_SAMPLES : CHUNK_SAMPLES;
+		if ( chunk.nCount < 1 || chunk.nCount > nMaxCount )
+		{
+			return false;
+		}
+		if
+		(
+			!checkpoint.GetArray
+			(
+				history.GetSamples( nChunk ), GetSampleShorts( chunk )
+			)
+		)
+		{
+			return false;
+		}
+		nCount += chunk.nCount;
+	}
+	if ( nTotal < nCount )
+	{
+		return false;
+	}
+
+	history.m_nChunks = nChunks;
+	history.m_nCount = nCount;
+	history.m_nTotal = nTotal;
+	swap( *this, history );
+	return true;
+
+} // Load
+
+/////////////////////////////////////////////////////////////////////////////
+// Find the chunk in use holding the given sample counting from the oldest
+// held and change the sample to count from the start of that chunk. The
+// number of chunks in use is returned if the sample is not held.
+int CTrailHistory::FindChunk( int& nSample ) const
+{
+	int nChunk = 0;
+	for ( ; nChunk < m_nChunks; nChunk++ )
+	{
+		const int nCount = m_Chunks[ GetChunkIndex( nChunk ) ].nCount;
+		if ( nSample < nCount )
+		{
+			break;
+		}
+		nSample -= nCount;
+	}
+	return nChunk;
+
+} // FindChunk
+
+#ifdef TRAIL_HISTORY_SSE2
+/////////////////////////////////////////////////////////////////////////////
+// Add up the x and y values of two samples held as x and y pairs of 32 bit
+// integers onto the x and y values carried in both halves of the sum, and
+// carry the totals of the second sample on to the next register.
+static inline __m128i AddUp( __m128i pairs, __m128i& sum )
+{
+	pairs = _mm_add_epi32( pairs, _mm_slli_si128( pairs, 8 ) );
+	pairs = _mm_add_epi32( pairs, sum );
+	sum = _mm_shuffle_epi32( pairs, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	return pairs;
+
+} // AddUp
+
+/////////////////////////////////////////////////////////////////////////////
+// Store the positions of two samples held as x and y pairs of 32 bit
+// integers in resolutions from the base as meters.
+static inline void StorePositions
+(
+	__m128i pairs, __m128d baseX, __m128d baseY, __m128d resolution,
+	double* pX, double* pY
+)
+{
+	// the two x values are moved below the two y values
+	pairs = _mm_shuffle_epi32( pairs, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+	const __m128d x = _mm_cvtepi32_pd( pairs );
+	const __m128d y = _mm_cvtepi32_pd( _mm_srli_si128( pairs, 8 ) );
+	_mm_storeu_pd( pX, _mm_mul_pd( _mm_add_pd( x, baseX ), resolution ) );
+	_mm_storeu_pd( pY, _mm_mul_pd( _mm_add_pd( y, baseY ), resolution ) );
+
+} // StorePositions
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// Decode every sample of the chunk at the given storage index into meters
+// where the buffers hold CHUNK_SAMPLES. Each position is the base of the
+// chunk plus the sum of the steps up to it, multiplied by the resolution,
+// where each step of a chunk of changes is the first step plus the sum of
+// the changes up to it, so both ways of decoding give exactly the same
+// meters. With SSE2 the changes and steps of four samples are added up in
+// two registers of x and y pairs, which may decode a few stale samples
+// past the end of the chunk into the buffers.
+void CTrailHistory::DecodeChunk( int nIndex, double* pX, double* pY ) const
+{
+#ifdef TRAIL_HISTORY_SSE2
+	const TRAIL_CHUNK& chunk = m_Chunks[ nIndex ];
+	const short* pSamples = GetSamples( nIndex );
+	const int nCount = chunk.nCount;
+	const __m128d resolution = _mm_set1_pd( m_dResolution );
+
+	if ( chunk.nSampleBytes == 4 )
+	{
+		const __m128d baseX = _mm_set1_pd( chunk.dBaseX );
+		const __m128d baseY = _mm_set1_pd( chunk.dBaseY );
+
+		// the x and y position of the last sample decoded in both halves
+		__m128i sum = _mm_setzero_si128();
+		for ( int n = 0; n < nCount; n += 4 )
+		{
+			// x and y steps of two samples in each register widened to 32
+			// bits
+			const __m128i steps =
+				_mm_loadu_si128( (const __m128i*)( pSamples + n * 2 ) );
+			__m128i lo = _mm_unpacklo_epi16( steps, steps );
+			__m128i hi = _mm_unpackhi_epi16( steps, steps );
+			lo = _mm_srai_epi32( lo, 16 );
+			hi = _mm_srai_epi32( hi, 16 );
+
+			lo = AddUp( lo, sum );
+			hi = AddUp( hi, sum );
+			StorePositions( lo, baseX, baseY, resolution, pX + n, pY + n );
+			StorePositions
+			(
+				hi, baseX, baseY, resolution, pX + n + 2, pY + n + 2
+			);
+		}
+		return;
+	}
+
+	// Adding up the steps from the first step gives each position plus the
+	// first step, so the first step is taken from the base. The base and
+	// the step are whole numbers, so the difference is exact.
+	const __m128d baseX = _mm_set1_pd( chunk.dBaseX - chunk.nFirstStepX );
+	const __m128d baseY = _mm_set1_pd( chunk.dBaseY - chunk.nFirstStepY );
+	const signed char* pChanges = (const signed char*)pSamples;
+
+	// the x and y step and position of the last sample decoded in both
+	// halves
+	__m128i step = _mm_setr_epi32
+	(
+		chunk.nFirstStepX, chunk.nFirstStepY,
+		chunk.nFirstStepX, chunk.nFirstStepY
+	);
+	__m128i sum = _mm_setzero_si128();
+	for ( int n = 0; n < nCount; n += 4 )
+	{
+		// x and y changes of four samples widened to 16 bits and then two
+		// samples in each register widened to 32 bits
+		__m128i changes =
+			_mm_loadl_epi64( (const __m128i*)( pChanges + n * 2 ) );
+		changes = _mm_srai_epi16( _mm_unpacklo_epi8( changes, changes ), 8 );
+		__m128i lo = _mm_unpacklo_epi16( changes, changes );
+		__m128i hi = _mm_unpackhi_epi16( changes, changes );
+		lo = _mm_srai_epi32( lo, 16 );
+		hi = _mm_srai_epi32( hi, 16 );
+
+		// the changes add up to the steps and the steps to the positions
+		lo = AddUp( AddUp( lo, step ), sum );
+		hi = AddUp( AddUp( hi, step ), sum );
+		StorePositions( lo, baseX, baseY, resolution, pX + n, pY + n );
+		StorePositions( hi, baseX, baseY, resolution, pX + n + 2, pY + n + 2 );
+	}
+#else
+	DecodeChunkScalar( nIndex, pX, pY );
+#endif
+
+} // DecodeChunk
+
+/////////////////////////////////////////////////////////////////////////////
+// Decode the chunk at the given storage index one sample at a time, which
+// gives the same meters as DecodeChunk for the samples of the chunk.
+void CTrailHistory::DecodeChunkScalar
+(
+	int nIndex, double* pX, double* pY
+) const
+{
+	const TRAIL_CHUNK& chunk = m_Chunks[ nIndex ];
+	const short* pSamples = GetSamples( nIndex );
+	const int nCount = chunk.nCount;
+	const double dResolution = m_dResolution;
+
+	int nX = 0;
+	int nY = 0;
+	if ( chunk.nSampleBytes == 4 )
+	{
+		for ( int n = 0; n < nCount; n++ )
+		{
+			nX += pSamples[ n * 2 ];
+			nY += pSamples[ n * 2 + 1 ];
+			pX[ n ] = ( chunk.dBaseX + nX ) * dResolution;
+			pY[ n ] = ( chunk.dBaseY + nY ) * dResolution;
+		}
+		return;
+	}
+
+	// the step before the first sample is taken as the first step, so the
+	// zero changes of the first two samples step from minus the first step
+	// to zero and on to the first step
+	const signed char* pChanges = (const signed char*)pSamples;
+	int nStepX = chunk.nFirstStepX;
+	int nStepY = chunk.nFirstStepY;
+	nX = -nStepX;
+	nY = -nStepY;
+	for ( int n = 0; n < nCount; n++ )
+	{
+		nStepX += pChanges[ n * 2 ];
+		nStepY += pChanges[ n * 2 + 1 ];
+		nX += nStepX;
+		nY += nStepY;
+		pX[ n ] = ( chunk.dBaseX + nX ) * dResolution;
+		pY[ n ] = ( chunk.dBaseY + nY ) * dResolution;
+	}
+
+} // DecodeChunkScalar
+
+/////////////////////////////////////////////////////////////////////////////
+// Decode the given samples counting from the oldest held into meters, as
+// when the trail is exported.
+void CTrailHistory::Decode
+(
+	int nFirst, int nCount, double* pX, double* pY
+) const
+{
+	double dX[ CHUNK_SAMPLES ];
+	double dY[ CHUNK_SAMPLES ];
+
+	int nSample = nFirst;
+	for
+	(
+		int nChunk = FindChunk( nSample );
+		nCount > 0 && nChunk < m_nChunks; nChunk++
+	)
+	{
+		const int nIndex = GetChunkIndex( nChunk );
+		DecodeChunk( nIndex, dX, dY );
+
+		const int nPart = min( nCount, m_Chunks[ nIndex ].nCount - nSample );
+		copy( dX + nSample, dX + nSample + nPart, pX );
+		copy( dY + nSample, dY + nSample + nPart, pY );
+		pX += nPart;
+		pY += nPart;
+		nCount -= nPart;
+		nSample = 0;
+	}
+
+} // Decode
+
+/////////////////////////////////////////////////////////////////////////////
+// Project the given samples counting from the oldest held into logical
+// units, decoding and projecting a chunk at a time so the meters stay in
+// the cache between the two.
+void CTrailHistory::Project
+(
+	const TRAIL_PROJECTION& projection, int nFirst, int nCount,
+	DISPLAY_POINT* pPoints
+) const
+{
+	double dX[ CHUNK_SAMPLES ];
+	double dY[ CHUNK_SAMPLES ];
+
+	int nSample = nFirst;
+	for
+	(
+		int nChunk = FindChunk( nSample );
+		nCount > 0 && nChunk < m_nChunks; nChunk++
+	)
+	{
+		const int nIndex = GetChunkIndex( nChunk );
+		DecodeChunk( nIndex, dX, dY );
+
+		const int nPart = min( nCount, m_Chunks[ nIndex ].nCount - nSample );
+		Project( projection, dX + nSample, dY + nSample, nPart, pPoints );
+		pPoints += nPart;
+		nCount -= nPart;
+		nSample = 0;
+	}
+
+} // Project
+
+/////////////////////////////////////////////////////////////////////////////
+// Project contiguous samples in meters into logical units. Each sample
+// is divided by the scaling, multiplied by the map and truncated in the
+// same order as GetMoonCenter, so a projected sample is the point the
+// moon was drawn at unless rounding to the resolution crossed a logical
+// unit. Pairs of samples are projected together with SSE2 when the
+// compiler targets it and a DISPLAY_POINT is a pair of 32 bit integers, as
+// it is on Windows, and the rest are projected by ProjectScalar.
+void CTrailHistory::Project
+(
+	const TRAIL_PROJECTION& projection, const double* pX, const double* pY,
+	int nCount, DISPLAY_POINT* pPoints
+)
+{
+	int n = 0;
+
+#ifdef TRAIL_HISTORY_SSE2
+	if ( sizeof( DISPLAY_POINT ) == 2 * sizeof( int ) )
+	{
+		const __m128d scaling = _mm_set1_pd( projection.dMoonScaling );
+		const __m128d map = _mm_set1_pd( projection.nMap );
+		const __m128i earthX = _mm_set1_epi32( int( projection.nEarthX ) );
+		const __m128i earthY = _mm_set1_epi32( int( projection.nEarthY ) );
+		for ( ; n + 2 <= nCount; n += 2 )
+		{
+			const __m128i x = _mm_cvttpd_epi32
+			(
+				_mm_mul_pd( _mm_div_pd( _mm_loadu_pd( pX + n ), scaling ), map )
+			);
+			const __m128i y = _mm_cvttpd_epi32
+			(
+				_mm_mul_pd( _mm_div_pd( _mm_loadu_pd( pY + n ), scaling ), map )
+			);
+
+			// the moon is offset from the earth by the negated position
+			// and the x and y values are interleaved into two points
+			const __m128i points = _mm_unpacklo_epi32
+			(
+				_mm_sub_epi32( earthX, x ), _mm_sub_epi32( earthY, y )
+			);
+			_mm_storeu_si128( (__m128i*)( pPoints + n ), points );
+		}
+	}
+#endif
+
+	ProjectScalar( projection, pX + n, pY + n, nCount - n, pPoints + n );
+
+} // Project
+
+/////////////////////////////////////////////////////////////////////////////
+// Project contiguous samples in meters into logical units one at a time,
+// which gives the same points as Project.
+void CTrailHistory::ProjectScalar
+(
+	const TRAIL_PROJECTION& projection, const double* pX, const double* pY,
+	int nCount, DISPLAY_POINT* pPoints
+)
+{
+	const double dScaling = projection.dMoonScaling;
+	const double dMap = projection.nMap;
+	for ( int n = 0; n < nCount; n++ )
+	{
+		pPoints[ n ].x = projection.nEarthX - int( pX[ n ] / dScaling * dMap );
+		pPoints[ n ].y = projection.nEarthY - int( pY[ n ] / dScaling * dMap );
+	}
+
+} // ProjectScalar
+
+/////////////////////////////////////////////////////////////////////////////
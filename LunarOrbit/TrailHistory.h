@@ -0,0 +1,262 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Checkpoint.h"
+#include "DisplayList.h"
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// how positions in meters relative to the earth map to logical units, the
+// same arithmetic as CLunarOrbitDoc::GetMoonCenter
+struct TRAIL_PROJECTION
+{
+	long nEarthX; // logical x co-ordinate of the center of the earth
+	long nEarthY; // logical y co-ordinate of the center of the earth
+	double dMoonScaling; // meters in an inch on the screen
+	int nMap; // logical units in an inch
+
+	// true if every member is the same
+	bool operator==( const TRAIL_PROJECTION& rhs ) const
+	{
+		return
+			nEarthX == rhs.nEarthX && nEarthY == rhs.nEarthY &&
+			dMoonScaling == rhs.dMoonScaling && nMap == rhs.nMap;
+	}
+
+	// true if any member is different
+	bool operator!=( const TRAIL_PROJECTION& rhs ) const
+	{
+		return !( *this == rhs );
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a run of samples stored as changes of step or as steps from the first
+// one
+struct TRAIL_CHUNK
+{
+	double dBaseX; // x co-ordinate of the first sample in resolutions
+	double dBaseY; // y co-ordinate of the first sample in resolutions
+	int nCount; // number of samples in the chunk
+	int nLastX; // x co-ordinate of the last sample from the first one
+	int nLastY; // y co-ordinate of the last sample from the first one
+	int nStepX; // x step from the sample before the last one
+	int nStepY; // y step from the sample before the last one
+	int nFirstStepX; // x step from the first sample to the second one
+	int nFirstStepY; // y step from the first sample to the second one
+	int nSampleBytes; // 2 for 8 bit changes of step or 4 for 16 bit steps
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// The positions of the moon along its trail in meters relative to the
+// earth, kept in a ring of fixed capacity so the simulation can run for
+// any length of time while the trail holds the most recent orbits. The
+// storage is allocated when the capacity is set and the oldest samples
+// are replaced when it is full, so adding never allocates. Samples are
+// numbered from the first one ever added, so a reader can tell which
+// samples it has already seen and which have been replaced.
+//
+// The samples are rounded to the resolution (a kilometer unless it is
+// set) and stored in chunks, where each chunk starts from a base of its
+// own. The step from one sample to the next changes slowly along an
+// orbit, by about 35 kilometers an hour at the distance of the moon, so a
+// chunk keeps the step from its first sample to the second one and then
+// each sample as the 8 bit change from the step before. A sample takes two
+// bytes instead of the sixteen of two doubles, so a century of hourly
+// samples fits in a couple of megabytes. When a change is too large for 8
+// bits, as it is close to the earth, the next chunk keeps 16 bit steps
+// from the sample before instead, which holds half as many samples in
+// the same storage, and the chunk after that tries changes again. A step
+// too long for 16 bits starts a new chunk. When every chunk is in use the
+// oldest chunk is replaced, so the ring holds at least its capacity unless
+// wide chunks or steps that long have closed chunks early. Each sample is rounded from
+// its own position, so the error never grows past half of the
+// resolution.
+//
+// Samples are decoded a chunk at a time, adding up the changes and steps
+// four samples at a time with SSE2 where the compiler targets it, and
+// projected to logical units when they are drawn, so the trail follows
+// any change to the scale of the orbit on the page. The history does not
+// depend on MFC.
+class CTrailHistory
+{
+	// public definitions
+public:
+	enum
+	{
+		CHUNK_SAMPLES = 256, // most samples in a chunk of changes
+		WIDE_SAMPLES = 128, // most samples in a chunk of steps
+	};
+
+	// protected data
+protected:
+	// the chunks by storage index
+	vector<TRAIL_CHUNK> m_Chunks;
+
+	// The samples of each chunk where the samples of chunk n start at
+	// n * CHUNK_SAMPLES. The samples are pairs of 8 bit x and y changes of
+	// step or, in a wide chunk, pairs of 16 bit x and y steps, and the
+	// first sample of a chunk is zero.
+	vector<short> m_Steps;
+
+	// least number of samples held when the ring is full
+	int m_nCapacity;
+
+	// meters a sample is rounded to
+	double m_dResolution;
+
+	// storage index of the oldest chunk
+	int m_nFirstChunk;
+
+	// number of chunks in use
+	int m_nChunks;
+
+	// number of samples held
+	int m_nCount;
+
+	// number of samples ever added
+	long long m_nTotal;
+
+	// public methods
+public:
+	// least number of samples held when the ring is full
+	int GetCapacity() const
+	{
+		return m_nCapacity;
+	}
+	// least number of samples held when the ring is full where the
+	// samples are removed
+	void SetCapacity( int value );
+
+	// most samples held, which is at least the capacity
+	int GetMaxCount() const
+	{
+		return (int)m_Chunks.size() * CHUNK_SAMPLES;
+	}
+
+	// meters a sample is rounded to
+	double GetResolution() const
+	{
+		return m_dResolution;
+	}
+	// meters a sample is rounded to where the samples are removed
+	void SetResolution( double value );
+
+	// number of samples held
+	int GetCount() const
+	{
+		return m_nCount;
+	}
+
+	// number of samples ever added
+	long long GetTotal() const
+	{
+		return m_nTotal;
+	}
+
+	// number of the oldest sample held counting from the first one ever
+	// added
+	long long GetFirstSample() const
+	{
+		return m_nTotal - m_nCount;
+	}
+
+	// number of bytes of storage used by the samples
+	size_t GetStorageSize() const
+	{
+		return
+			m_Chunks.size() * sizeof( TRAIL_CHUNK ) +
+			m_Steps.size() * sizeof( short );
+	}
+
+	// remove all of the samples
+	void Clear();
+
+	// add a sample replacing the oldest ones when the ring is full
+	void Add( double dX, double dY );
+
+	// Decode the given samples counting from the oldest held into meters,
+	// as when the trail is exported.
+	void Decode( int nFirst, int nCount, double* pX, double* pY ) const;
+
+	// Project the given samples counting from the oldest held into
+	// logical units, decoding and projecting a chunk at a time.
+	void Project
+	(
+		const TRAIL_PROJECTION& projection, int nFirst, int nCount,
+		DISPLAY_POINT* pPoints
+	) const;
+
+	// write the capacity, the resolution and the samples held to the
+	// checkpoint
+	void Save( CCheckpoint& checkpoint ) const;
+
+	// Read a history written by Save in place of this one and return
+	// false if the checkpoint does not hold one, in which case this
+	// history is unchanged.
+	bool Load( CCheckpoint& checkpoint );
+
+	// protected methods
+protected:
+	// storage index of the given chunk counting from the oldest in use
+	int GetChunkIndex( int nChunk ) const
+	{
+		const int nIndex = m_nFirstChunk + nChunk;
+		const int nChunks = (int)m_Chunks.size();
+		return nIndex < nChunks ? nIndex : nIndex - nChunks;
+	}
+
+	// Find the chunk in use holding the given sample counting from the
+	// oldest held and change the sample to count from the start of that
+	// chunk.
+	int FindChunk( int& nSample ) const;
+
+	// the samples of the chunk at the given storage index, which are
+	// read as signed char unless the chunk is wide
+	short* GetSamples( int nIndex )
+	{
+		return &m_Steps[ size_t( nIndex ) * CHUNK_SAMPLES ];
+	}
+	const short* GetSamples( int nIndex ) const
+	{
+		return &m_Steps[ size_t( nIndex ) * CHUNK_SAMPLES ];
+	}
+
+	// number of shorts holding the samples of a chunk
+	static size_t GetSampleShorts( const TRAIL_CHUNK& chunk )
+	{
+		return size_t( chunk.nCount ) * chunk.nSampleBytes / sizeof( short );
+	}
+
+	// decode every sample of the chunk at the given storage index into
+	// meters where the buffers hold CHUNK_SAMPLES
+	void DecodeChunk( int nIndex, double* pX, double* pY ) const;
+
+	// decode the chunk one sample at a time, which gives the same meters
+	// as DecodeChunk
+	void DecodeChunkScalar( int nIndex, double* pX, double* pY ) const;
+
+	// project contiguous samples in meters into logical units
+	static void Project
+	(
+		const TRAIL_PROJECTION& projection, const double* pX,
+		const double* pY, int nCount, DISPLAY_POINT* pPoints
+	);
+
+	// project the samples one at a time, which gives the same points as
+	// Project
+	static void ProjectScalar
+	(
+		const TRAIL_PROJECTION& projection, const double* pX,
+		const double* pY, int nCount, DISPLAY_POINT* pPoints
+	);
+
+	// public construction
+public:
+	CTrailHistory( int nCapacity = 0 );
+};
+
+/////////////////////////////////////////////////////////////////////////////
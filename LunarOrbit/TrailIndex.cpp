@@ -0,0 +1,363 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "TrailIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+/////////////////////////////////////////////////////////////////////////////
+CTrailIndex::CTrailIndex( double dCellSize )
+{
+	m_dCellSize = dCellSize;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// width and height of a grid cell where the segments are indexed again
+// for the new size
+void CTrailIndex::SetCellSize( double value )
+{
+	m_dCellSize = value;
+	m_Cells.clear();
+
+	const int nSegments = GetSegmentCount();
+	for ( int nSegment = 0; nSegment < nSegments; nSegment++ )
+	{
+		IndexSegment( nSegment );
+	}
+
+} // SetCellSize
+
+/////////////////////////////////////////////////////////////////////////////
+// remove all of the points
+void CTrailIndex::Clear()
+{
+	m_X.clear();
+	m_Y.clear();
+	m_Cells.clear();
+
+} // Clear
+
+/////////////////////////////////////////////////////////////////////////////
+// add a point to the end of the trail and index the segment that joins
+// it to the previous point
+void CTrailIndex::AddPoint( double dX, double dY )
+{
+	m_X.push_back( dX );
+	m_Y.push_back( dY );
+
+	const int nSegments = GetSegmentCount();
+	if ( nSegments > 0 )
+	{
+		IndexSegment( nSegments - 1 );
+	}
+
+} // AddPoint
+
+/////////////////////////////////////////////////////////////////////////////
+// column or row of the cell containing the co-ordinate
+int CTrailIndex::GetCell( double dValue ) const
+{
+	return (int)floor( dValue / m_dCellSize );
+
+} // GetCell
+
+/////////////////////////////////////////////////////////////////////////////
+// key of the cell in the hash table
+long long CTrailIndex::GetKey( int nColumn, int nRow )
+{
+	return ( (long long)nColumn << 32 ) | (unsigned int)nRow;
+
+} // GetKey
+
+/////////////////////////////////////////////////////////////////////////////
+// list the segment in every cell its bounding rectangle touches
+void CTrailIndex::IndexSegment( int nSegment )
+{
+	const int nColumn1 = GetCell( min( m_X[ nSegment ], m_X[ nSegment + 1 ] ) );
+	const int nColumn2 = GetCell( max( m_X[ nSegment ], m_X[ nSegment + 1 ] ) );
+	const int nRow1 = GetCell( min( m_Y[ nSegment ], m_Y[ nSegment + 1 ] ) );
+	const int nRow2 = GetCell( max( m_Y[ nSegment ], m_Y[ nSegment + 1 ] ) );
+
+	for ( int nColumn = nColumn1; nColumn <= nColumn2; nColumn++ )
+	{
+		for ( int nRow = nRow1; nRow <= nRow2; nRow++ )
+		{
+			m_Cells[ GetKey( nColumn, nRow ) ].push_back( nSegment );
+		}
+	}
+
+} // IndexSegment
+
+/////////////////////////////////////////////////////////////////////////////
+// Test the segment from ( dX1, dY1 ) to ( dX2, dY2 ) against the given
+// segment of the trail and return the crossing point. Parallel segments
+// are not considered to cross.
+bool CTrailIndex::Intersect
+(
+	double dX1, double dY1, double dX2, double dY2, int nSegment,
+	double& dX, double& dY
+) const
+{
+	const double dRun1 = dX2 - dX1;
+	const double dRise1 = dY2 - dY1;
+	const double dRun2 = m_X[ nSegment + 1 ] - m_X[ nSegment ];
+	const double dRise2 = m_Y[ nSegment + 1 ] - m_Y[ nSegment ];
+	const double dDenominator = dRun1 * dRise2 - dRise1 * dRun2;
+	if ( dDenominator == 0 )
+	{
+		return false;
+	}
+
+	// fractions of the way along each segment to the crossing
+	const double dRunStart = m_X[ nSegment ] - dX1;
+	const double dRiseStart = m_Y[ nSegment ] - dY1;
+	const double dT = ( dRunStart * dRise2 - dRiseStart * dRun2 ) / dDenominator;
+	const double dU = ( dRunStart * dRise1 - dRiseStart * dRun1 ) / dDenominator;
+	if ( dT < 0 || dT > 1 || dU < 0 || dU > 1 )
+	{
+		return false;
+	}
+
+	dX = dX1 + dT * dRun1;
+	dY = dY1 + dT * dRise1;
+	return true;
+
+} // Intersect
+
+/////////////////////////////////////////////////////////////////////////////
+// Find the point nearest to the given co-ordinates within the given radius
+// and return false if there is none.
+bool CTrailIndex::FindNearestPoint
+(
+	double dX, double dY, double dRadius, int& nPoint
+) const
+{
+	double dBest = dRadius * dRadius;
+	bool value = false;
+
+	// a trail of one point has no segments to index it
+	if ( GetPointCount() == 1 )
+	{
+		const double dRun = m_X[ 0 ] - dX;
+		const double dRise = m_Y[ 0 ] - dY;
+		if ( dRun * dRun + dRise * dRise <= dBest )
+		{
+			nPoint = 0;
+			value = true;
+		}
+		return value;
+	}
+
+	const int nColumn1 = GetCell( dX - dRadius );
+	const int nColumn2 = GetCell( dX + dRadius );
+	const int nRow1 = GetCell( dY - dRadius );
+	const int nRow2 = GetCell( dY + dRadius );
+
+	for ( int nColumn = nColumn1; nColumn <= nColumn2; nColumn++ )
+	{
+		for ( int nRow = nRow1; nRow <= nRow2; nRow++ )
+		{
+			const auto cell = m_Cells.find( GetKey( nColumn, nRow ) );
+			if ( cell == m_Cells.end() )
+			{
+				continue;
+			}
+
+			// both ends of every segment in the cell are candidates
+			for ( const int nSegment : cell->second )
+			{
+				for ( int nEnd = nSegment; nEnd <= nSegment + 1; nEnd++ )
+				{
+					const double dRun = m_X[ nEnd ] - dX;
+					const double dRise = m_Y[ nEnd ] - dY;
+					const double dDistance = dRun * dRun + dRise * dRise;
+					if ( dDistance <= dBest )
+					{
+						dBest = dDistance;
+						nPoint = nEnd;
+						value = true;
+					}
+				}
+			}
+		}
+	}
+
+	return value;
+
+} // FindNearestPoint
+
+/////////////////////////////////////////////////////////////////////////////
+// Find the segments whose bounding rectangles touch the rectangle in
+// ascending order.
+void CTrailIndex::FindSegments
+(
+	double dLeft, double dTop, double dRight, double dBottom,
+	vector<int>& segments
+) const
+{
+	segments.clear();
+
+	const double dMinX = min( dLeft, dRight );
+	const double dMaxX = max( dLeft, dRight );
+	const double dMinY = min( dTop, dBottom );
+	const double dMaxY = max( dTop, dBottom );
+	const int nColumn1 = GetCell( dMinX );
+	const int nColumn2 = GetCell( dMaxX );
+	const int nRow1 = GetCell( dMinY );
+	const int nRow2 = GetCell( dMaxY );
+	const int nSegments = GetSegmentCount();
+
+	// a rectangle covering more cells than there are segments is
+	// answered faster by looking at every segment
+	const double dCells =
+		( double( nColumn2 ) - nColumn1 + 1 ) * ( double( nRow2 ) - nRow1 + 1 );
+	if ( dCells > nSegments )
+	{
+		for ( int nSegment = 0; nSegment < nSegments; nSegment++ )
+		{
+			segments.push_back( nSegment );
+		}
+	}
+	else
+	{
+		for ( int nColumn = nColumn1; nColumn <= nColumn2; nColumn++ )
+		{
+			for ( int nRow = nRow1; nRow <= nRow2; nRow++ )
+			{
+				const auto cell = m_Cells.find( GetKey( nColumn, nRow ) );
+				if ( cell != m_Cells.end() )
+				{
+					segments.insert
+					(
+						segments.end(), cell->second.begin(), cell->second.end()
+					);
+				}
+			}
+		}
+
+		// a segment is listed in every cell it touches
+		sort( segments.begin(), segments.end() );
+		segments.erase
+		(
+			unique( segments.begin(), segments.end() ), segments.end()
+		);
+	}
+
+	// the cells are larger than the rectangle, so the bounding rectangles
+	// of the candidates are tested against it
+	const auto outside = [&]( int nSegment )
+	{
+		const double dX1 = m_X[ nSegment ];
+		const double dX2 = m_X[ nSegment + 1 ];
+		const double dY1 = m_Y[ nSegment ];
+		const double dY2 = m_Y[ nSegment + 1 ];
+		return
+			max( dX1, dX2 ) < dMinX || min( dX1, dX2 ) > dMaxX ||
+			max( dY1, dY2 ) < dMinY || min( dY1, dY2 ) > dMaxY;
+	};
+	segments.erase
+	(
+		remove_if( segments.begin(), segments.end(), outside ), segments.end()
+	);
+
+} // FindSegments
+
+/////////////////////////////////////////////////////////////////////////////
+// Find where each of the query lines crosses the trail where the first
+// segment of each crossing is the index of the query line.
+void CTrailIndex::FindCrossings
+(
+	const vector<TRAIL_LINE>& lines, vector<TRAIL_CROSSING>& crossings
+) const
+{
+	crossings.clear();
+
+	vector<int> segments;
+	const int nLines = (int)lines.size();
+	for ( int nLine = 0; nLine < nLines; nLine++ )
+	{
+		const TRAIL_LINE& line = lines[ nLine ];
+		FindSegments( line.dX1, line.dY1, line.dX2, line.dY2, segments );
+
+		for ( const int nSegment : segments )
+		{
+			TRAIL_CROSSING crossing;
+			if
+			(
+				Intersect
+				(
+					line.dX1, line.dY1, line.dX2, line.dY2, nSegment,
+					crossing.dX, crossing.dY
+				)
+			)
+			{
+				crossing.nSegment1 = nLine;
+				crossing.nSegment2 = nSegment;
+				crossings.push_back( crossing );
+			}
+		}
+	}
+
+} // FindCrossings
+
+/////////////////////////////////////////////////////////////////////////////
+// Find where the trail crosses itself. Only the segments that share a cell
+// are tested, and a crossing is reported by the cell that contains it,
+// which is always one of the cells both segments are listed in, so each
+// crossing is reported once.
+void CTrailIndex::FindSelfCrossings( vector<TRAIL_CROSSING>& crossings ) const
+{
+	crossings.clear();
+
+	for ( const auto& cell : m_Cells )
+	{
+		const int nColumn = (int)( cell.first >> 32 );
+		const int nRow = (int)( cell.first & 0xffffffff );
+		const vector<int>& segments = cell.second;
+		const int nSegments = (int)segments.size();
+
+		for ( int n1 = 0; n1 < nSegments; n1++ )
+		{
+			const int nSegment1 = segments[ n1 ];
+			for ( int n2 = n1 + 1; n2 < nSegments; n2++ )
+			{
+				const int nSegment2 = segments[ n2 ];
+
+				// neighbors share a point and always touch
+				if ( abs( nSegment1 - nSegment2 ) < 2 )
+				{
+					continue;
+				}
+
+				TRAIL_CROSSING crossing;
+				if
+				(
+					!Intersect
+					(
+						m_X[ nSegment1 ], m_Y[ nSegment1 ],
+						m_X[ nSegment1 + 1 ], m_Y[ nSegment1 + 1 ],
+						nSegment2, crossing.dX, crossing.dY
+					)
+				)
+				{
+					continue;
+				}
+
+				if
+				(
+					GetCell( crossing.dX ) == nColumn &&
+					GetCell( crossing.dY ) == nRow
+				)
+				{
+					crossing.nSegment1 = min( nSegment1, nSegment2 );
+					crossing.nSegment2 = max( nSegment1, nSegment2 );
+					crossings.push_back( crossing );
+				}
+			}
+		}
+	}
+
+} // FindSelfCrossings
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,147 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// a point where two segments cross
+struct TRAIL_CROSSING
+{
+	int nSegment1; // index of the first segment (or query line)
+	int nSegment2; // index of the second segment
+	double dX; // x co-ordinate of the crossing
+	double dY; // y co-ordinate of the crossing
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// a line used to query the trail
+struct TRAIL_LINE
+{
+	double dX1; // x co-ordinate of point 1
+	double dY1; // y co-ordinate of point 1
+	double dX2; // x co-ordinate of point 2
+	double dY2; // y co-ordinate of point 2
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// A uniform grid over the segments of a polyline such as the orbit trail,
+// where segment n joins point n to point n + 1. Each segment is listed in
+// every grid cell its bounding rectangle touches, so a query only visits
+// the cells around the area it asks about instead of every segment. The
+// cells are kept in a hash table, so the trail can grow in any direction
+// without resizing the grid.
+//
+// The index does not depend on MFC and works in any units, typically the
+// logical co-ordinates of the view.
+class CTrailIndex
+{
+	// protected data
+protected:
+	vector<double> m_X; // x co-ordinates of the points
+	vector<double> m_Y; // y co-ordinates of the points
+
+	// width and height of a grid cell
+	double m_dCellSize;
+
+	// segments listed by the key of each cell they touch
+	unordered_map<long long, vector<int>> m_Cells;
+
+	// public methods
+public:
+	// number of points in the trail
+	int GetPointCount() const
+	{
+		return (int)m_X.size();
+	}
+
+	// number of segments in the trail
+	int GetSegmentCount() const
+	{
+		const int nPoints = GetPointCount();
+		return nPoints < 2 ? 0 : nPoints - 1;
+	}
+
+	// x co-ordinate of the given point
+	double GetX( int nPoint ) const
+	{
+		return m_X[ nPoint ];
+	}
+
+	// y co-ordinate of the given point
+	double GetY( int nPoint ) const
+	{
+		return m_Y[ nPoint ];
+	}
+
+	// width and height of a grid cell
+	double GetCellSize() const
+	{
+		return m_dCellSize;
+	}
+	// width and height of a grid cell where the segments are indexed
+	// again for the new size
+	void SetCellSize( double value );
+
+	// remove all of the points
+	void Clear();
+
+	// add a point to the end of the trail and index the segment that
+	// joins it to the previous point
+	void AddPoint( double dX, double dY );
+
+	// Find the point nearest to the given co-ordinates within the given
+	// radius and return false if there is none.
+	bool FindNearestPoint
+	(
+		double dX, double dY, double dRadius, int& nPoint
+	) const;
+
+	// Find the segments whose bounding rectangles touch the rectangle in
+	// ascending order, so consecutive segments form runs of the polyline
+	// that can be drawn together.
+	void FindSegments
+	(
+		double dLeft, double dTop, double dRight, double dBottom,
+		vector<int>& segments
+	) const;
+
+	// Find where each of the query lines crosses the trail where the
+	// first segment of each crossing is the index of the query line.
+	void FindCrossings
+	(
+		const vector<TRAIL_LINE>& lines, vector<TRAIL_CROSSING>& crossings
+	) const;
+
+	// Find where the trail crosses itself, where segments that share a
+	// point are not tested against each other.
+	void FindSelfCrossings( vector<TRAIL_CROSSING>& crossings ) const;
+
+	// protected methods
+protected:
+	// column or row of the cell containing the co-ordinate
+	int GetCell( double dValue ) const;
+
+	// key of the cell in the hash table
+	static long long GetKey( int nColumn, int nRow );
+
+	// list the segment in every cell its bounding rectangle touches
+	void IndexSegment( int nSegment );
+
+	// Test the segment from ( dX1, dY1 ) to ( dX2, dY2 ) against the
+	// given segment of the trail and return the crossing point.
+	bool Intersect
+	(
+		double dX1, double dY1, double dX2, double dY2, int nSegment,
+		double& dX, double& dY
+	) const;
+
+	// public construction
+public:
+	CTrailIndex( double dCellSize = 100 );
+};
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,497 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "TrajectoryArchive.h"
+#include "Checkpoint.h"
+#include <algorithm>
+#include <cstdint>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the most time slices in a block of a file that is not damaged
+static const unsigned MAX_BLOCK_STEPS = 1 << 24;
+
+#ifdef _WIN32
+/////////////////////////////////////////////////////////////////////////////
+// Map the whole of an open file for reading and close the file, where the
+// view keeps the mapping open once the handles are closed. Returns null
+// if the file is empty or does not fit in the address space.
+static const unsigned char* MapFile( HANDLE hFile, size_t& nSize )
+{
+	if ( hFile == INVALID_HANDLE_VALUE )
+	{
+		return nullptr;
+	}
+
+	const unsigned char* pData = nullptr;
+	LARGE_INTEGER size;
+	if
+	(
+		GetFileSizeEx( hFile, &size ) && size.QuadPart > 0 &&
+		(unsigned long long)size.QuadPart <= SIZE_MAX
+	)
+	{
+		HANDLE hMapping =
+			CreateFileMappingW( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		if ( hMapping != nullptr )
+		{
+			pData = (const unsigned char*)
+				MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+			CloseHandle( hMapping );
+			nSize = size_t( size.QuadPart );
+		}
+	}
+	CloseHandle( hFile );
+	return pData;
+
+} // MapFile
+
+/////////////////////////////////////////////////////////////////////////////
+// unmap the bytes of a file
+static void UnmapFile( const unsigned char* pData, size_t /*nSize*/ )
+{
+	UnmapViewOfFile( pData );
+
+} // UnmapFile
+#else
+/////////////////////////////////////////////////////////////////////////////
+// Map the whole of an open file for reading and close the file, where the
+// mapping stays once the file is closed. Returns null if the file is
+// empty or does not fit in the address space.
+static const unsigned char* MapFile( int nFile, size_t& nSize )
+{
+	if ( nFile < 0 )
+	{
+		return nullptr;
+	}
+
+	const unsigned char* pData = nullptr;
+	struct stat status;
+	if
+	(
+		fstat( nFile, &status ) == 0 && status.st_size > 0 &&
+		(unsigned long long)status.st_size <= SIZE_MAX
+	)
+	{
+		void* pMapping = mmap
+		(
+			nullptr, size_t( status.st_size ), PROT_READ, MAP_PRIVATE, nFile,
+			0
+		);
+		if ( pMapping != MAP_FAILED )
+		{
+			pData = (const unsigned char*)pMapping;
+			nSize = size_t( status.st_size );
+		}
+	}
+	close( nFile );
+	return pData;
+
+} // MapFile
+
+/////////////////////////////////////////////////////////////////////////////
+// unmap the bytes of a file
+static void UnmapFile( const unsigned char* pData, size_t nSize )
+{
+	munmap( (void*)pData, nSize );
+
+} // UnmapFile
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+CTrajectoryArchive::CTrajectoryArchive()
+{
+	m_pData = nullptr;
+	m_nSize = 0;
+	m_pIndex = nullptr;
+	m_nBlocks = 0;
+	m_nSteps = 0;
+	m_nBlockSteps = 0;
+	m_nBlock = -1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+CTrajectoryArchive::~CTrajectoryArchive()
+{
+	Close();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Map the file at the given path and return false if it cannot be mapped
+// or is not a complete recording, where an open file is closed first.
+bool CTrajectoryArchive::Open( const char* pPath )
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA
+	(
+		pPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr
+	);
+	m_pData = MapFile( hFile, m_nSize );
+#else
+	m_pData = MapFile( open( pPath, O_RDONLY ), m_nSize );
+#endif
+
+	if ( !Validate() )
+	{
+		Close();
+		return false;
+	}
+	return true;
+
+} // Open
+
+#ifdef _WIN32
+/////////////////////////////////////////////////////////////////////////////
+// Map the file at the given path and return false if it cannot be mapped
+// or is not a complete recording, where an open file is closed first.
+bool CTrajectoryArchive::Open( const wchar_t* pPath )
+{
+	Close();
+
+	HANDLE hFile = CreateFileW
+	(
+		pPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr
+	);
+	m_pData = MapFile( hFile, m_nSize );
+
+	if ( !Validate() )
+	{
+		Close();
+		return false;
+	}
+	return true;
+
+} // Open
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// unmap the file
+void CTrajectoryArchive::Close()
+{
+	if ( m_pData != nullptr )
+	{
+		UnmapFile( m_pData, m_nSize );
+	}
+
+	m_pData = nullptr;
+	m_nSize = 0;
+	m_pIndex = nullptr;
+	m_nBlocks = 0;
+	m_nSteps = 0;
+	m_nBlockSteps = 0;
+	m_nBlock = -1;
+	m_States.clear();
+
+} // Close
+
+/////////////////////////////////////////////////////////////////////////////
+// Check the header and the footer of the mapped file and find the index,
+// where the index must fill the space between the blocks and the footer.
+// Only the first and last bytes of the file are read, and each block is
+// checked when it is decoded, so the time taken does not depend on the
+// size of the file.
+bool CTrajectoryArchive::Validate()
+{
+	if ( m_pData == nullptr )
+	{
+		return false;
+	}
+	if ( m_nSize < sizeof( TRAJECTORY_HEADER ) + sizeof( TRAJECTORY_FOOTER ) )
+	{
+		return false;
+	}
+
+	TRAJECTORY_HEADER header;
+	memcpy( &header, m_pData, sizeof( header ) );
+	if
+	(
+		header.nMagic != TRAJECTORY_MAGIC ||
+		header.nVersion != TRAJECTORY_VERSION ||
+		header.nColumns != CTrajectoryCodec::COLUMNS ||
+		header.nBlockSteps == 0 || header.nBlockSteps > MAX_BLOCK_STEPS
+	)
+	{
+		return false;
+	}
+
+	// a recording that was not closed has no footer
+	TRAJECTORY_FOOTER footer;
+	const size_t nIndexEnd = m_nSize - sizeof( footer );
+	memcpy( &footer, m_pData + nIndexEnd, sizeof( footer ) );
+	if ( footer.nMagic != TRAJECTORY_MAGIC )
+	{
+		return false;
+	}
+	if
+	(
+		footer.nIndexOffset < (long long)sizeof( header ) ||
+		(unsigned long long)footer.nIndexOffset > nIndexEnd ||
+		footer.nBlocks < 0 || footer.nSteps < 0
+	)
+	{
+		return false;
+	}
+
+	const size_t nIndexBytes = nIndexEnd - size_t( footer.nIndexOffset );
+	if
+	(
+		nIndexBytes % sizeof( TRAJECTORY_INDEX ) != 0 ||
+		nIndexBytes / sizeof( TRAJECTORY_INDEX ) !=
+			(unsigned long long)footer.nBlocks
+	)
+	{
+		return false;
+	}
+
+	m_pIndex = m_pData + footer.nIndexOffset;
+	m_nBlocks = footer.nBlocks;
+	m_nSteps = footer.nSteps;
+	m_nBlockSteps = int( header.nBlockSteps );
+	m_nBlock = -1;
+	return true;
+
+} // Validate
+
+/////////////////////////////////////////////////////////////////////////////
+// Decode the given block into the states unless it is already there and
+// return false if it is damaged. The block must lie between the header
+// and the index, agree with its index entry and its CRC, and decode to
+// states that agree with its time range.
+bool CTrajectoryArchive::LoadBlock( long long nBlock )
+{
+	if ( nBlock == m_nBlock )
+	{
+		return true;
+	}
+	m_nBlock = -1;
+
+	const TRAJECTORY_INDEX index = GetIndex( nBlock );
+	const long long nIndexOffset = (long long)( m_pIndex - m_pData );
+	if
+	(
+		index.nOffset < (long long)sizeof( TRAJECTORY_HEADER ) ||
+		index.nOffset > nIndexOffset - (long long)sizeof( TRAJECTORY_BLOCK )
+	)
+	{
+		return false;
+	}
+
+	TRAJECTORY_BLOCK block;
+	memcpy( &block, m_pData + index.nOffset, sizeof( block ) );
+	const long long nStart = index.nOffset + sizeof( block );
+	if
+	(
+		block.nFirstStep != index.nFirstStep ||
+		block.dFirstTime != index.dFirstTime ||
+		block.dLastTime != index.dLastTime ||
+		block.nCount < 1 || block.nCount > m_nBlockSteps ||
+		block.nBytes < 0 || block.nBytes > nIndexOffset - nStart
+	)
+	{
+		return false;
+	}
+
+	const unsigned char* pBytes = m_pData + nStart;
+	if ( CCheckpoint::GetCRC( pBytes, block.nBytes ) != block.nCRC )
+	{
+		return false;
+	}
+
+	m_States.resize( block.nCount );
+	if
+	(
+		!CTrajectoryCodec::Decode
+		(
+			pBytes, block.nBytes, block.nCount, m_States.data()
+		)
+	)
+	{
+		return false;
+	}
+	if
+	(
+		m_States.front().dTime != block.dFirstTime ||
+		m_States.back().dTime != block.dLastTime
+	)
+	{
+		return false;
+	}
+
+	m_nBlock = nBlock;
+	return true;
+
+} // LoadBlock
+
+/////////////////////////////////////////////////////////////////////////////
+// Get the state at the given running time in seconds and return false if
+// the time is outside the recording or the block holding it is damaged.
+// The block is the last one that starts at or before the time, and a time
+// after its last time slice is interpolated between it and the first time
+// slice of the next block.
+bool CTrajectoryArchive::GetState( double dTime, LUNAR_STATE& state )
+{
+	if ( !IsOpen() )
+	{
+		return false;
+	}
+
+	// the first block that starts after the time
+	long long nLow = 0;
+	long long nHigh = m_nBlocks;
+	while ( nLow < nHigh )
+	{
+		const long long nMiddle = nLow + ( nHigh - nLow ) / 2;
+		if ( GetIndex( nMiddle ).dFirstTime <= dTime )
+		{
+			nLow = nMiddle + 1;
+		}
+		else
+		{
+			nHigh = nMiddle;
+		}
+	}
+	if ( nLow == 0 )
+	{
+		return false;
+	}
+
+	const long long nBlock = nLow - 1;
+	if ( !LoadBlock( nBlock ) )
+	{
+		return false;
+	}
+
+	if ( dTime <= m_States.back().dTime )
+	{
+		// the first time slice after the time, which is not the first one
+		// of the block because the block starts at or before the time
+		const vector<LUNAR_STATE>::const_iterator after = upper_bound
+		(
+			m_States.begin(), m_States.end(), dTime,
+			[]( double dValue, const LUNAR_STATE& value )
+			{
+				return dValue < value.dTime;
+			}
+		);
+		if ( after == m_States.end() )
+		{
+			state = m_States.back();
+			return true;
+		}
+		Interpolate( *( after - 1 ), *after, dTime, state );
+		return true;
+	}
+
+	// between the last time slice of the block and the next block
+	if ( nBlock + 1 >= m_nBlocks )
+	{
+		return false;
+	}
+	const LUNAR_STATE before = m_States.back();
+	if ( !LoadBlock( nBlock + 1 ) )
+	{
+		return false;
+	}
+	Interpolate( before, m_States.front(), dTime, state );
+	return true;
+
+} // GetState
+
+/////////////////////////////////////////////////////////////////////////////
+// Get the state of the time slice with the given number and return false
+// if there is no such time slice or its block is damaged.
+bool CTrajectoryArchive::GetStep( long long nStep, LUNAR_STATE& state )
+{
+	if ( !IsOpen() || nStep < 0 || nStep >= m_nSteps )
+	{
+		return false;
+	}
+
+	// the first block that starts after the time slice
+	long long nLow = 0;
+	long long nHigh = m_nBlocks;
+	while ( nLow < nHigh )
+	{
+		const long long nMiddle = nLow + ( nHigh - nLow ) / 2;
+		if ( GetIndex( nMiddle ).nFirstStep <= nStep )
+		{
+			nLow = nMiddle + 1;
+		}
+		else
+		{
+			nHigh = nMiddle;
+		}
+	}
+	if ( nLow == 0 || !LoadBlock( nLow - 1 ) )
+	{
+		return false;
+	}
+
+	const long long nOffset = nStep - GetIndex( nLow - 1 ).nFirstStep;
+	if ( nOffset >= (long long)m_States.size() )
+	{
+		return false;
+	}
+	state = m_States[ size_t( nOffset ) ];
+	return true;
+
+} // GetStep
+
+/////////////////////////////////////////////////////////////////////////////
+// Interpolate the state at the given time between the states of two time
+// slices. The position is the cubic Hermite polynomial through the two
+// positions with the two velocities as its slopes, the velocity is the
+// same with the accelerations, and the acceleration is linear. At the time
+// of either time slice the state is that time slice.
+void CTrajectoryArchive::Interpolate
+(
+	const LUNAR_STATE& before, const LUNAR_STATE& after, double dTime,
+	LUNAR_STATE& state
+)
+{
+	const double dStep = after.dTime - before.dTime;
+	if ( dStep <= 0 )
+	{
+		state = before;
+		return;
+	}
+
+	// the Hermite basis functions of the fraction of the time slice
+	const double dS = ( dTime - before.dTime ) / dStep;
+	const double dS2 = dS * dS;
+	const double dS3 = dS2 * dS;
+	const double dH00 = 2 * dS3 - 3 * dS2 + 1;
+	const double dH10 = ( dS3 - 2 * dS2 + dS ) * dStep;
+	const double dH01 = 3 * dS2 - 2 * dS3;
+	const double dH11 = ( dS3 - dS2 ) * dStep;
+
+	state.dX =
+		dH00 * before.dX + dH10 * before.dVx +
+		dH01 * after.dX + dH11 * after.dVx;
+	state.dY =
+		dH00 * before.dY + dH10 * before.dVy +
+		dH01 * after.dY + dH11 * after.dVy;
+	state.dVx =
+		dH00 * before.dVx + dH10 * before.dAx +
+		dH01 * after.dVx + dH11 * after.dAx;
+	state.dVy =
+		dH00 * before.dVy + dH10 * before.dAy +
+		dH01 * after.dVy + dH11 * after.dAy;
+	state.dAx = before.dAx + ( after.dAx - before.dAx ) * dS;
+	state.dAy = before.dAy + ( after.dAy - before.dAy ) * dS;
+	state.dTime = dTime;
+
+} // Interpolate
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,147 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "TrajectoryCodec.h"
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// Reads a file written by CTrajectoryRecorder for the state at any time.
+// The file is mapped into memory instead of read, so opening it only
+// touches the header and the footer however large the file is, and the
+// pages of a block are read by the system when the block is decoded.
+//
+// The index at the end of the file gives the time range and the offset of
+// each block, so the block holding a time is found by a binary search of
+// the index and is the only block decoded. The block is checked against
+// its index entry and its CRC before it is decoded, and the last block
+// decoded is kept for the next query. A time between two time slices is
+// interpolated with cubic Hermite polynomials, where the position is
+// interpolated with the velocity as its derivative and the velocity with
+// the acceleration, which keeps the error well under that of the time
+// slice itself. The blocks are searched as if the running time only
+// increases, as it does in a run.
+//
+// The whole file is mapped at once, so a large file needs a 64 bit build.
+// An archive is read by one thread at a time. The archive does not depend
+// on MFC.
+class CTrajectoryArchive
+{
+	// protected data
+protected:
+	// the bytes of the file mapped into memory or null when closed
+	const unsigned char* m_pData;
+
+	// number of bytes in the file
+	size_t m_nSize;
+
+	// the index of the blocks in the file, which is not aligned because
+	// the encoded blocks before it are not
+	const unsigned char* m_pIndex;
+
+	// the number of blocks and time slices in the file
+	long long m_nBlocks;
+	long long m_nSteps;
+
+	// most time slices in a block
+	int m_nBlockSteps;
+
+	// number of the block decoded into the states or -1
+	long long m_nBlock;
+
+	// the states of the block decoded
+	vector<LUNAR_STATE> m_States;
+
+	// public methods
+public:
+	// true while a file is open
+	bool IsOpen() const
+	{
+		return m_pData != nullptr;
+	}
+
+	// number of blocks in the file
+	long long GetBlocks() const
+	{
+		return m_nBlocks;
+	}
+
+	// number of time slices in the file
+	long long GetSteps() const
+	{
+		return m_nSteps;
+	}
+
+	// the index entry of the given block
+	TRAJECTORY_INDEX GetIndex( long long nBlock ) const
+	{
+		TRAJECTORY_INDEX index;
+		memcpy
+		(
+			&index, m_pIndex + nBlock * sizeof( TRAJECTORY_INDEX ),
+			sizeof( index )
+		);
+		return index;
+	}
+
+	// running time of the first time slice in seconds
+	double GetFirstTime() const
+	{
+		return m_nBlocks > 0 ? GetIndex( 0 ).dFirstTime : 0;
+	}
+
+	// running time of the last time slice in seconds
+	double GetLastTime() const
+	{
+		return m_nBlocks > 0 ? GetIndex( m_nBlocks - 1 ).dLastTime : 0;
+	}
+
+	// Map the file at the given path and return false if it cannot be
+	// mapped or is not a complete recording, where an open file is closed
+	// first.
+	bool Open( const char* pPath );
+#ifdef _WIN32
+	bool Open( const wchar_t* pPath );
+#endif
+
+	// unmap the file
+	void Close();
+
+	// Get the state at the given running time in seconds and return false
+	// if the time is outside the recording or the block holding it is
+	// damaged.
+	bool GetState( double dTime, LUNAR_STATE& state );
+
+	// Get the state of the time slice with the given number and return
+	// false if there is no such time slice or its block is damaged.
+	bool GetStep( long long nStep, LUNAR_STATE& state );
+
+	// protected methods
+protected:
+	// check the header and the footer of the mapped file and find the
+	// index
+	bool Validate();
+
+	// decode the given block into the states unless it is already there
+	// and return false if it is damaged
+	bool LoadBlock( long long nBlock );
+
+	// Interpolate the state at the given time between the states of two
+	// time slices.
+	static void Interpolate
+	(
+		const LUNAR_STATE& before, const LUNAR_STATE& after, double dTime,
+		LUNAR_STATE& state
+	);
+
+	// public construction
+public:
+	CTrajectoryArchive();
+	virtual ~CTrajectoryArchive();
+};
+
+/////////////////////////////////////////////////////////////////////////////
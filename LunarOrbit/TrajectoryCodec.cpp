@@ -0,0 +1,343 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "TrajectoryCodec.h"
+#include <cstdint>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static_assert
+(
+	sizeof( LUNAR_STATE ) == CTrajectoryCodec::COLUMNS * sizeof( uint64_t ),
+	"a lunar state is read as one 64 bit pattern a column"
+);
+
+// bits in the width of a difference written with its width
+static const int WIDTH_BITS = 6;
+
+// a difference narrower than the last one by this many bits or more is
+// written with its own width
+static const int WIDTH_SLACK = WIDTH_BITS;
+
+/////////////////////////////////////////////////////////////////////////////
+// number of significant bits of a value that is not zero
+static inline int GetWidth( uint64_t value )
+{
+#ifdef _MSC_VER
+	int nWidth = 0;
+	for ( ; value >> 32; value >>= 32 )
+	{
+		nWidth += 32;
+	}
+	unsigned long nIndex = 0;
+	_BitScanReverse( &nIndex, (unsigned long)value );
+	return nWidth + int( nIndex ) + 1;
+#else
+	return 64 - __builtin_clzll( value );
+#endif
+
+} // GetWidth
+
+/////////////////////////////////////////////////////////////////////////////
+// the prediction and the width of the last difference of a column
+struct TRAJECTORY_COLUMN
+{
+	uint64_t nLast[ 3 ]; // bit patterns of the last three values
+	int nHistory; // number of values seen up to three
+	int nWidth; // width of the last difference written with its width
+
+	// Extrapolate the bit patterns of the values seen, which is exact for
+	// a column that grows by the same amount every step.
+	uint64_t Predict() const
+	{
+		switch ( nHistory )
+		{
+			case 0:
+				return 0;
+			case 1:
+				return nLast[ 0 ];
+			case 2:
+				return 2 * nLast[ 0 ] - nLast[ 1 ];
+			default:
+				return 3 * nLast[ 0 ] - 3 * nLast[ 1 ] + nLast[ 2 ];
+		}
+	}
+
+	// remember the bit pattern of a value
+	void Add( uint64_t nValue )
+	{
+		nLast[ 2 ] = nLast[ 1 ];
+		nLast[ 1 ] = nLast[ 0 ];
+		nLast[ 0 ] = nValue;
+		nHistory = nHistory < 3 ? nHistory + 1 : 3;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// writes bits from the most significant down into memory that has room
+class CBitWriter
+{
+	// protected data
+protected:
+	// the next byte to write
+	unsigned char* m_pNext;
+
+	// bits not yet written in the low bits
+	uint64_t m_nAccumulator;
+
+	// number of bits in the accumulator
+	int m_nBits;
+
+	// public methods
+public:
+	// write the low bits of the value where there are 1 to 64 bits
+	void Write( uint64_t nValue, int nBits )
+	{
+		if ( nBits < 64 )
+		{
+			nValue &= ( uint64_t( 1 ) << nBits ) - 1;
+		}
+
+		const int nFree = 64 - m_nBits;
+		if ( nBits < nFree )
+		{
+			m_nAccumulator = ( m_nAccumulator << nBits ) | nValue;
+			m_nBits += nBits;
+			return;
+		}
+
+		// the accumulator is filled and written out a byte at a time
+		const int nRest = nBits - nFree;
+		const uint64_t nWord =
+			( nFree == 64 ? 0 : m_nAccumulator << nFree ) |
+			( nValue >> nRest );
+		for ( int nShift = 56; nShift >= 0; nShift -= 8 )
+		{
+			*m_pNext++ = (unsigned char)( nWord >> nShift );
+		}
+
+		m_nAccumulator =
+			nRest == 0 ? 0 : nValue & ( ( uint64_t( 1 ) << nRest ) - 1 );
+		m_nBits = nRest;
+	}
+
+	// write the bits left padded with zeros to a whole byte and return the
+	// next byte
+	unsigned char* Finish()
+	{
+		while ( m_nBits >= 8 )
+		{
+			m_nBits -= 8;
+			*m_pNext++ = (unsigned char)( m_nAccumulator >> m_nBits );
+		}
+		if ( m_nBits > 0 )
+		{
+			*m_pNext++ = (unsigned char)( m_nAccumulator << ( 8 - m_nBits ) );
+			m_nBits = 0;
+		}
+		return m_pNext;
+	}
+
+	// public construction
+public:
+	CBitWriter( unsigned char* pBytes )
+	{
+		m_pNext = pBytes;
+		m_nAccumulator = 0;
+		m_nBits = 0;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// reads bits from the most significant down where reading past the end
+// gives zeros and is remembered
+class CBitReader
+{
+	// protected data
+protected:
+	// the next byte to read and the end of the bytes
+	const unsigned char* m_pNext;
+	const unsigned char* m_pEnd;
+
+	// bits not yet read in the high bits
+	uint64_t m_nAccumulator;
+
+	// number of bits in the accumulator
+	int m_nBits;
+
+	// true once more bits were read than there are
+	bool m_bOverrun;
+
+	// protected methods
+protected:
+	// read 0 to 32 bits
+	uint64_t ReadShort( int nBits )
+	{
+		if ( m_nBits < nBits )
+		{
+			while ( m_nBits <= 56 && m_pNext < m_pEnd )
+			{
+				m_nAccumulator |= uint64_t( *m_pNext++ ) << ( 56 - m_nBits );
+				m_nBits += 8;
+			}
+			if ( m_nBits < nBits )
+			{
+				m_bOverrun = true;
+				m_nBits = nBits;
+			}
+		}
+		if ( nBits == 0 )
+		{
+			return 0;
+		}
+
+		const uint64_t nValue = m_nAccumulator >> ( 64 - nBits );
+		m_nAccumulator <<= nBits;
+		m_nBits -= nBits;
+		return nValue;
+	}
+
+	// public methods
+public:
+	// true once more bits were read than there are
+	bool IsOverrun() const
+	{
+		return m_bOverrun;
+	}
+
+	// read 0 to 64 bits
+	uint64_t Read( int nBits )
+	{
+		if ( nBits <= 32 )
+		{
+			return ReadShort( nBits );
+		}
+		const uint64_t nHigh = ReadShort( nBits - 32 );
+		return ( nHigh << 32 ) | ReadShort( 32 );
+	}
+
+	// public construction
+public:
+	CBitReader( const unsigned char* pBytes, size_t nBytes )
+	{
+		m_pNext = pBytes;
+		m_pEnd = pBytes + nBytes;
+		m_nAccumulator = 0;
+		m_nBits = 0;
+		m_bOverrun = false;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Replace the bytes with the encoding of the given states. The bytes are
+// sized for the longest encoding before any are written, so writing a bit
+// never has to test for room, and cut to the length used at the end.
+void CTrajectoryCodec::Encode
+(
+	const LUNAR_STATE* pStates, int nCount, vector<unsigned char>& bytes
+)
+{
+	bytes.resize( size_t( nCount ) * MAX_STEP_BYTES + sizeof( uint64_t ) );
+	CBitWriter writer( bytes.data() );
+
+	TRAJECTORY_COLUMN columns[ COLUMNS ] = {};
+	for ( int nStep = 0; nStep < nCount; nStep++ )
+	{
+		uint64_t nValues[ COLUMNS ];
+		memcpy( nValues, &pStates[ nStep ], sizeof( LUNAR_STATE ) );
+
+		for ( int nColumn = 0; nColumn < COLUMNS; nColumn++ )
+		{
+			TRAJECTORY_COLUMN& column = columns[ nColumn ];
+			const uint64_t nValue = nValues[ nColumn ];
+
+			// the difference from the prediction zigzag encoded
+			const uint64_t nDifference = nValue - column.Predict();
+			const uint64_t nZigzag =
+				( nDifference << 1 ) ^ ( 0 - ( nDifference >> 63 ) );
+			column.Add( nValue );
+
+			if ( nZigzag == 0 )
+			{
+				writer.Write( 0, 1 );
+				continue;
+			}
+
+			const int nWidth = GetWidth( nZigzag );
+			if
+			(
+				nWidth <= column.nWidth &&
+				column.nWidth - nWidth < WIDTH_SLACK
+			)
+			{
+				writer.Write( 2, 2 );
+				writer.Write( nZigzag, column.nWidth );
+				continue;
+			}
+
+			writer.Write( 3, 2 );
+			writer.Write( uint64_t( nWidth - 1 ), WIDTH_BITS );
+			writer.Write( nZigzag, nWidth );
+			column.nWidth = nWidth;
+		}
+	}
+
+	const unsigned char* pEnd = writer.Finish();
+	bytes.resize( size_t( pEnd - bytes.data() ) );
+
+} // Encode
+
+/////////////////////////////////////////////////////////////////////////////
+// Decode the given number of states and return false if the bytes run out
+// first or do not hold an encoding.
+bool CTrajectoryCodec::Decode
+(
+	const unsigned char* pBytes, size_t nBytes, int nCount,
+	LUNAR_STATE* pStates
+)
+{
+	CBitReader reader( pBytes, nBytes );
+
+	TRAJECTORY_COLUMN columns[ COLUMNS ] = {};
+	for ( int nStep = 0; nStep < nCount; nStep++ )
+	{
+		uint64_t nValues[ COLUMNS ];
+		for ( int nColumn = 0; nColumn < COLUMNS; nColumn++ )
+		{
+			TRAJECTORY_COLUMN& column = columns[ nColumn ];
+
+			uint64_t nZigzag = 0;
+			if ( reader.Read( 1 ) != 0 )
+			{
+				if ( reader.Read( 1 ) == 0 )
+				{
+					// a width is only reused once one has been written
+					if ( column.nWidth == 0 )
+					{
+						return false;
+					}
+					nZigzag = reader.Read( column.nWidth );
+				}
+				else
+				{
+					column.nWidth = int( reader.Read( WIDTH_BITS ) ) + 1;
+					nZigzag = reader.Read( column.nWidth );
+				}
+			}
+
+			const uint64_t nDifference =
+				( nZigzag >> 1 ) ^ ( 0 - ( nZigzag & 1 ) );
+			const uint64_t nValue = column.Predict() + nDifference;
+			column.Add( nValue );
+			nValues[ nColumn ] = nValue;
+		}
+		memcpy( &pStates[ nStep ], nValues, sizeof( LUNAR_STATE ) );
+	}
+
+	return !reader.IsOverrun();
+
+} // Decode
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,115 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Propagator.h"
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// the first and last bytes of a file of recorded trajectories ("LOTR" in
+// the file)
+static const unsigned TRAJECTORY_MAGIC = 0x52544F4C;
+
+// version of the format of a file of recorded trajectories
+static const unsigned TRAJECTORY_VERSION = 2;
+
+/////////////////////////////////////////////////////////////////////////////
+// the start of a file of recorded trajectories
+struct TRAJECTORY_HEADER
+{
+	unsigned nMagic; // TRAJECTORY_MAGIC
+	unsigned nVersion; // version of the format of the file
+	unsigned nColumns; // number of values recorded for each time slice
+	unsigned nBlockSteps; // most time slices in a block
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the header in front of the encoded bytes of a block in a file of
+// recorded trajectories
+struct TRAJECTORY_BLOCK
+{
+	long long nFirstStep; // number of the first time slice of the block
+	double dFirstTime; // running time of the first time slice in seconds
+	double dLastTime; // running time of the last time slice in seconds
+	int nCount; // number of time slices in the block
+	int nBytes; // number of encoded bytes after the header
+	unsigned nCRC; // CRC-32 of the encoded bytes
+	unsigned nReserved; // zero
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// an entry of the index of the blocks at the end of a file of recorded
+// trajectories
+struct TRAJECTORY_INDEX
+{
+	long long nOffset; // offset of the TRAJECTORY_BLOCK in the file
+	long long nFirstStep; // number of the first time slice of the block
+	double dFirstTime; // running time of the first time slice in seconds
+	double dLastTime; // running time of the last time slice in seconds
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the last bytes of a file of recorded trajectories, which follow an
+// index entry for each block in the order they were written
+struct TRAJECTORY_FOOTER
+{
+	long long nIndexOffset; // offset of the first TRAJECTORY_INDEX
+	long long nBlocks; // number of blocks and index entries
+	long long nSteps; // number of time slices in the file
+	unsigned nReserved; // zero
+	unsigned nMagic; // TRAJECTORY_MAGIC
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Encodes a block of lunar states without loss in the manner of Gorilla,
+// the time series compression of Facebook's in-memory database, where
+// each of the seven values of a state is a column encoded on its own.
+//
+// A value is predicted from the same column of the last three states by
+// extrapolating their bit patterns as integers, which are a delta of
+// delta of delta apart, and only the difference from the prediction is
+// kept. The states of a time slice are so smooth that the difference is
+// a few bits, and the running time, which grows by the same time slice
+// every step, is predicted exactly. The difference is zigzag encoded so
+// small negative differences are small numbers, and written with control
+// bits like those of Gorilla:
+//
+//	0 - the value is the prediction
+//	10 - the difference fits the width of the last difference written
+//	11 - 6 bits of width less one followed by the difference
+//
+// Differences are taken instead of the exclusive or of Gorilla because an
+// exclusive or of two bit patterns a few units apart can set every bit
+// up to the carry. Each block starts again with no prediction, so any
+// block can be decoded without the ones before it. The codec does not
+// depend on MFC.
+class CTrajectoryCodec
+{
+	// public definitions
+public:
+	enum
+	{
+		COLUMNS = 7, // values in a state
+		MAX_STEP_BYTES = 63, // most bytes taken by the values of a state
+	};
+
+	// public methods
+public:
+	// replace the bytes with the encoding of the given states
+	static void Encode
+	(
+		const LUNAR_STATE* pStates, int nCount, vector<unsigned char>& bytes
+	);
+
+	// Decode the given number of states and return false if the bytes run
+	// out first or do not hold an encoding.
+	static bool Decode
+	(
+		const unsigned char* pBytes, size_t nBytes, int nCount,
+		LUNAR_STATE* pStates
+	);
+};
+
+/////////////////////////////////////////////////////////////////////////////
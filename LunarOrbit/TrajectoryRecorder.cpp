@@ -0,0 +1,278 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#include "TrajectoryRecorder.h"
+#include "Checkpoint.h"
+
+/////////////////////////////////////////////////////////////////////////////
+CTrajectoryRecorder::CTrajectoryRecorder()
+{
+	m_pStream = nullptr;
+	m_pBlock = nullptr;
+	m_nNextFill = 0;
+	m_nNextWrite = 0;
+	m_nFilled = 0;
+	m_bWriting = false;
+	m_bClosing = false;
+	m_nSteps = 0;
+	m_nBytes = 0;
+	m_bFailed = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+CTrajectoryRecorder::~CTrajectoryRecorder()
+{
+	Close();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Start recording to the given binary stream with the given number of
+// encoder threads, or half the hardware threads for zero, where a
+// recording in progress is closed first. The pool has two blocks for each
+// thread so a thread can take the next block as soon as it is done with
+// one, and two more for the integrator to fill.
+bool CTrajectoryRecorder::Open( ostream& stream, int nThreads )
+{
+	Close();
+
+	TRAJECTORY_HEADER header;
+	header.nMagic = TRAJECTORY_MAGIC;
+	header.nVersion = TRAJECTORY_VERSION;
+	header.nColumns = CTrajectoryCodec::COLUMNS;
+	header.nBlockSteps = BLOCK_STEPS;
+	stream.write( (const char*)&header, sizeof( header ) );
+	if ( !stream )
+	{
+		return false;
+	}
+
+	if ( nThreads <= 0 )
+	{
+		nThreads = max( int( thread::hardware_concurrency() ) / 2, 1 );
+	}
+
+	const int nBlocks = 2 * nThreads + 2;
+	for ( int nBlock = 0; nBlock < nBlocks; nBlock++ )
+	{
+		unique_ptr<RECORDER_BLOCK> pBlock( new RECORDER_BLOCK );
+		pBlock->states.resize( BLOCK_STEPS );
+		pBlock->nCount = 0;
+		pBlock->nSequence = 0;
+		pBlock->nFirstStep = 0;
+		m_Free.push_back( pBlock.get() );
+		m_Blocks.push_back( move( pBlock ) );
+	}
+	m_pBlock = m_Free.front();
+	m_Free.pop_front();
+
+	m_pStream = &stream;
+	m_nNextFill = 0;
+	m_nNextWrite = 0;
+	m_nFilled = 0;
+	m_bWriting = false;
+	m_bClosing = false;
+	m_nSteps = 0;
+	m_nBytes = sizeof( header );
+	m_bFailed = false;
+	m_Index.clear();
+
+	for ( int nThread = 0; nThread < nThreads; nThread++ )
+	{
+		m_Threads.push_back( thread( &CTrajectoryRecorder::Encode, this ) );
+	}
+	return true;
+
+} // Open
+
+/////////////////////////////////////////////////////////////////////////////
+// Write the time slices recorded, stop the encoder threads and return
+// false if writing to the stream failed. The threads finish every block
+// queued before they return, and then the index follows the blocks.
+bool CTrajectoryRecorder::Close()
+{
+	if ( !IsOpen() )
+	{
+		return true;
+	}
+
+	if ( m_pBlock->nCount > 0 )
+	{
+		Submit();
+	}
+
+	{
+		lock_guard<mutex> lock( m_Mutex );
+		m_bClosing = true;
+	}
+	m_Changed.notify_all();
+	for ( thread& encoder : m_Threads )
+	{
+		encoder.join();
+	}
+
+	WriteIndex();
+	m_pStream->flush();
+	const bool bValue = !m_bFailed && !m_pStream->fail();
+
+	m_Threads.clear();
+	m_Free.clear();
+	m_Blocks.clear();
+	m_Index.clear();
+	m_pBlock = nullptr;
+	m_pStream = nullptr;
+	return bValue;
+
+} // Close
+
+/////////////////////////////////////////////////////////////////////////////
+// hand the block being filled to the encoders and take a free block to
+// fill, waiting for one if there are none
+void CTrajectoryRecorder::Submit()
+{
+	unique_lock<mutex> lock( m_Mutex );
+	m_pBlock->nSequence = m_nNextFill++;
+	m_pBlock->nFirstStep = m_nFilled;
+	m_nFilled += m_pBlock->nCount;
+	m_Full.push_back( m_pBlock );
+	m_Changed.notify_all();
+
+	m_Changed.wait
+	(
+		lock, [ & ]
+		{
+			return !m_Free.empty();
+		}
+	);
+	m_pBlock = m_Free.front();
+	m_Free.pop_front();
+	m_pBlock->nCount = 0;
+
+} // Submit
+
+/////////////////////////////////////////////////////////////////////////////
+// Encode full blocks and write them in order until closed. A block is
+// encoded outside the lock, so the threads encode blocks at the same time,
+// and then waits with the encoded blocks until the blocks before it are
+// written. One thread at a time writes the blocks that are next in order,
+// and a block written is free to fill again.
+void CTrajectoryRecorder::Encode()
+{
+	unique_lock<mutex> lock( m_Mutex );
+	for ( ;; )
+	{
+		m_Changed.wait
+		(
+			lock, [ & ]
+			{
+				return !m_Full.empty() || m_bClosing;
+			}
+		);
+		if ( m_Full.empty() )
+		{
+			return;
+		}
+
+		RECORDER_BLOCK* pBlock = m_Full.front();
+		m_Full.pop_front();
+		lock.unlock();
+		CTrajectoryCodec::Encode
+		(
+			pBlock->states.data(), pBlock->nCount, pBlock->bytes
+		);
+		lock.lock();
+		m_Encoded[ pBlock->nSequence ] = pBlock;
+
+		while
+		(
+			!m_bWriting && !m_Encoded.empty() &&
+			m_Encoded.begin()->first == m_nNextWrite
+		)
+		{
+			RECORDER_BLOCK* pNext = m_Encoded.begin()->second;
+			m_Encoded.erase( m_Encoded.begin() );
+			m_bWriting = true;
+			lock.unlock();
+			WriteBlock( *pNext );
+			lock.lock();
+			m_bWriting = false;
+			m_nNextWrite++;
+			m_Free.push_back( pNext );
+			m_Changed.notify_all();
+		}
+	}
+
+} // Encode
+
+/////////////////////////////////////////////////////////////////////////////
+// write an encoded block to the stream, where nothing more is written once
+// writing has failed
+void CTrajectoryRecorder::WriteBlock( const RECORDER_BLOCK& block )
+{
+	if ( m_bFailed )
+	{
+		return;
+	}
+
+	TRAJECTORY_BLOCK header;
+	header.nFirstStep = block.nFirstStep;
+	header.dFirstTime = block.states[ 0 ].dTime;
+	header.dLastTime = block.states[ block.nCount - 1 ].dTime;
+	header.nCount = block.nCount;
+	header.nBytes = int( block.bytes.size() );
+	header.nCRC = CCheckpoint::GetCRC( block.bytes.data(), block.bytes.size() );
+	header.nReserved = 0;
+
+	m_pStream->write( (const char*)&header, sizeof( header ) );
+	m_pStream->write( (const char*)block.bytes.data(), block.bytes.size() );
+	if ( !*m_pStream )
+	{
+		m_bFailed = true;
+		return;
+	}
+
+	// the block starts where the bytes written so far end
+	TRAJECTORY_INDEX index;
+	index.nOffset = m_nBytes;
+	index.nFirstStep = header.nFirstStep;
+	index.dFirstTime = header.dFirstTime;
+	index.dLastTime = header.dLastTime;
+	m_Index.push_back( index );
+
+	m_nSteps += block.nCount;
+	m_nBytes += sizeof( header ) + block.bytes.size();
+
+} // WriteBlock
+
+/////////////////////////////////////////////////////////////////////////////
+// write the index of the blocks and the footer to the stream once every
+// block has been written, where nothing is written once writing has failed
+void CTrajectoryRecorder::WriteIndex()
+{
+	if ( m_bFailed )
+	{
+		return;
+	}
+
+	TRAJECTORY_FOOTER footer;
+	footer.nIndexOffset = m_nBytes;
+	footer.nBlocks = (long long)m_Index.size();
+	footer.nSteps = m_nSteps;
+	footer.nReserved = 0;
+	footer.nMagic = TRAJECTORY_MAGIC;
+
+	m_pStream->write
+	(
+		(const char*)m_Index.data(), m_Index.size() * sizeof( TRAJECTORY_INDEX )
+	);
+	m_pStream->write( (const char*)&footer, sizeof( footer ) );
+	if ( !*m_pStream )
+	{
+		m_bFailed = true;
+		return;
+	}
+
+	m_nBytes += m_Index.size() * sizeof( TRAJECTORY_INDEX ) + sizeof( footer );
+
+} // WriteIndex
+
+/////////////////////////////////////////////////////////////////////////////
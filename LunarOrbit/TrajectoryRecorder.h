@@ -0,0 +1,179 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "TrajectoryCodec.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// Records the state of every time slice of a run to a stream compressed
+// by CTrajectoryCodec. The file is a TRAJECTORY_HEADER followed by blocks
+// of up to BLOCK_STEPS time slices, each a TRAJECTORY_BLOCK followed by
+// its encoded bytes. Closing the recorder writes a TRAJECTORY_INDEX for
+// each block and then a TRAJECTORY_FOOTER, so CTrajectoryArchive can find
+// any block from the end of the file without reading the blocks.
+//
+// The propagator hands each state to Record, which only copies it into
+// the block being filled, so the integrator pays a copy of a state for a
+// time slice. A full block is handed to the encoder threads, which encode
+// the blocks and write them to the stream in the order they were filled,
+// and the integrator goes on filling a free block. There is a fixed pool
+// of blocks, so the memory used does not grow, and the integrator only
+// waits when the encoders have fallen behind by the whole pool. The
+// recorder does not depend on MFC.
+class CTrajectoryRecorder
+{
+	// public definitions
+public:
+	enum
+	{
+		BLOCK_STEPS = 4096, // most time slices in a block
+	};
+
+	// protected definitions
+protected:
+	// a block of time slices and its encoding
+	struct RECORDER_BLOCK
+	{
+		// the states of the time slices filled
+		vector<LUNAR_STATE> states;
+
+		// the encoding of the states
+		vector<unsigned char> bytes;
+
+		// number of time slices filled
+		int nCount;
+
+		// number of the block in the order it was filled
+		long long nSequence;
+
+		// number of the first time slice of the block
+		long long nFirstStep;
+	};
+
+	// protected data
+protected:
+	// the stream written to or null when closed
+	ostream* m_pStream;
+
+	// every block of the pool
+	vector<unique_ptr<RECORDER_BLOCK>> m_Blocks;
+
+	// the block the integrator is filling
+	RECORDER_BLOCK* m_pBlock;
+
+	// the threads encoding and writing blocks
+	vector<thread> m_Threads;
+
+	// guards the queues and the order of writing
+	mutex m_Mutex;
+
+	// signaled when a block is queued, freed or the recorder closes
+	condition_variable m_Changed;
+
+	// blocks free to fill
+	deque<RECORDER_BLOCK*> m_Free;
+
+	// full blocks waiting to be encoded
+	deque<RECORDER_BLOCK*> m_Full;
+
+	// encoded blocks waiting for the blocks before them to be written
+	map<long long, RECORDER_BLOCK*> m_Encoded;
+
+	// number of the next block to fill and the next block to write
+	long long m_nNextFill;
+	long long m_nNextWrite;
+
+	// number of time slices handed to the encoders
+	long long m_nFilled;
+
+	// true while a thread is writing a block
+	bool m_bWriting;
+
+	// tells the threads to finish the blocks queued and return
+	bool m_bClosing;
+
+	// number of time slices and bytes written to the stream
+	atomic<long long> m_nSteps;
+	atomic<long long> m_nBytes;
+
+	// an entry for each block written, which only the thread writing a
+	// block adds to
+	vector<TRAJECTORY_INDEX> m_Index;
+
+	// true once writing to the stream failed
+	atomic<bool> m_bFailed;
+
+	// public methods
+public:
+	// true while recording
+	bool IsOpen() const
+	{
+		return m_pStream != nullptr;
+	}
+
+	// number of time slices written to the stream
+	long long GetSteps() const
+	{
+		return m_nSteps;
+	}
+
+	// number of bytes written to the stream
+	long long GetBytes() const
+	{
+		return m_nBytes;
+	}
+
+	// Start recording to the given binary stream with the given number of
+	// encoder threads, or half the hardware threads for zero. The stream
+	// must outlive the recording. Returns false if the header could not be
+	// written.
+	bool Open( ostream& stream, int nThreads = 0 );
+
+	// Write the time slices recorded, stop the encoder threads and return
+	// false if writing to the stream failed.
+	bool Close();
+
+	// copy the state of a time slice into the block being filled, which is
+	// only done while recording
+	inline void Record( const LUNAR_STATE& state )
+	{
+		m_pBlock->states[ m_pBlock->nCount ] = state;
+		if ( ++m_pBlock->nCount == BLOCK_STEPS )
+		{
+			Submit();
+		}
+	}
+
+	// protected methods
+protected:
+	// hand the block being filled to the encoders and take a free block
+	// to fill, waiting for one if there are none
+	void Submit();
+
+	// encode full blocks and write them in order until closed
+	void Encode();
+
+	// write an encoded block to the stream
+	void WriteBlock( const RECORDER_BLOCK& block );
+
+	// write the index of the blocks and the footer to the stream
+	void WriteIndex();
+
+	// public construction
+public:
+	CTrajectoryRecorder();
+	virtual ~CTrajectoryRecorder();
+};
+
+/////////////////////////////////////////////////////////////////////////////
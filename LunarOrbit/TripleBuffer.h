@@ -0,0 +1,100 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <atomic>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+// Hands the newest value from one writer thread to one reader thread
+// without a lock. There are three slots: the writer fills the back slot,
+// the reader looks at the front slot and the middle slot holds the value
+// passed between them. Publishing swaps the back slot with the middle one
+// and marks it fresh, and updating swaps the front slot with the middle
+// one if it is fresh, so each slot belongs to one thread at a time and
+// the reader never sees a value the writer is still filling. Neither side
+// ever waits for the other, and the reader skips any values published
+// while it was not looking.
+template <class T> class CTripleBuffer
+{
+	// protected definitions
+protected:
+	enum
+	{
+		INDEX_MASK = 3, // the bits of the index of a slot
+		FRESH = 4, // set when the middle slot has not been read
+	};
+
+	// protected data
+protected:
+	// the back, middle and front slots in any order
+	T m_Slots[ 3 ];
+
+	// index of the middle slot and the fresh flag
+	atomic<int> m_nMiddle;
+
+	// index of the slot the writer fills
+	int m_nBack;
+
+	// index of the slot the reader looks at
+	int m_nFront;
+
+	// public methods
+public:
+	// the slot the writer fills before publishing it
+	T& GetBack()
+	{
+		return m_Slots[ m_nBack ];
+	}
+
+	// the slot the reader looks at, which is the newest value published
+	// as of the last update
+	const T& GetFront() const
+	{
+		return m_Slots[ m_nFront ];
+	}
+
+	// hand the back slot to the reader and take the middle slot back
+	void Publish()
+	{
+		const int nMiddle =
+			m_nMiddle.exchange( m_nBack | FRESH, memory_order_acq_rel );
+		m_nBack = nMiddle & INDEX_MASK;
+	}
+
+	// look at the newest value published and return false if nothing has
+	// been published since the last update
+	bool Update()
+	{
+		if ( ( m_nMiddle.load( memory_order_relaxed ) & FRESH ) == 0 )
+		{
+			return false;
+		}
+		const int nMiddle =
+			m_nMiddle.exchange( m_nFront, memory_order_acq_rel );
+		m_nFront = nMiddle & INDEX_MASK;
+		return true;
+	}
+
+	// put the value in every slot, which is only done while neither
+	// thread is using the buffer
+	void Reset( const T& value )
+	{
+		m_Slots[ 0 ] = value;
+		m_Slots[ 1 ] = value;
+		m_Slots[ 2 ] = value;
+		m_nBack = 0;
+		m_nMiddle = 1;
+		m_nFront = 2;
+	}
+
+	// public construction
+public:
+	CTripleBuffer()
+	{
+		Reset( T() );
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
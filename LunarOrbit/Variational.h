@@ -0,0 +1,311 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Propagator.h"
+#include "Dual.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// The variational equations of the lunar model are integrated alongside the
+// state in the same Runge-Kutta kernel, so one augmented run produces the
+// state transition matrix (the derivative of the final state with respect
+// to the initial state) and the derivative of the final state with respect
+// to the gravity ratio. The sensitivities to the model's initial conditions
+// and the Lyapunov indicators are derived from those.
+//
+// The model is two dimensional, so the state transition matrix is 4x4 with
+// the components ordered ( x, y, vx, vy ).
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// the results of a variational propagation
+struct LUNAR_SENSITIVITY
+{
+	// state transition matrix where dTransition[ i ][ j ] is the
+	// derivative of final component i with respect to initial component j
+	double dTransition[ 4 ][ 4 ];
+
+	// derivative of the final state with respect to the gravity ratio
+	double dGravityRatio[ 4 ];
+
+	// derivative of the final state with respect to the speed of the moon
+	// along its initial direction of travel (CLunarOrbitDoc::LunarVelocity)
+	double dLunarVelocity[ 4 ];
+
+	// derivative of the final state with respect to the radius of the
+	// orbit (CLunarOrbitDoc::MoonDistance) which moves the initial
+	// position and changes the gravity ratio
+	double dMoonDistance[ 4 ];
+
+	// fast Lyapunov indicator: log10 of the largest column norm of the
+	// state transition matrix
+	double dFastLyapunov;
+
+	// finite time Lyapunov exponent: natural log of the largest singular
+	// value of the state transition matrix divided by the elapsed time
+	double dLyapunovExponent;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the final state and its exact derivatives with respect to the model's
+// parameters computed by propagating dual numbers (see Dual.h)
+struct LUNAR_DERIVATIVES
+{
+	// the final state ( x, y, vx, vy )
+	double dState[ 4 ];
+
+	// derivative of the final state with respect to the radius of the
+	// orbit (CLunarOrbitDoc::MoonDistance)
+	double dMoonDistance[ 4 ];
+
+	// derivative of the final state with respect to the initial speed of
+	// the moon (CLunarOrbitDoc::LunarVelocity)
+	double dLunarVelocity[ 4 ];
+
+	// derivative of the final state with respect to the mass of the earth
+	// (CLunarOrbitDoc::MassOfTheEarth)
+	double dMassOfTheEarth[ 4 ];
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the lunar equations of motion augmented with the variational equations
+// where the state is ( x, y, vx, vy ), followed by the four columns of the
+// state transition matrix, followed by the derivative with respect to k
+class CLunarVariationalSystem
+{
+	// protected data
+protected:
+	// acceleration of gravity divided by the radius of the orbit
+	double m_dK;
+
+	// public definitions
+public:
+	enum
+	{
+		Size = 24, // number of components in the augmented state
+		Transition = 4, // index of the first column of the matrix
+		Parameter = 20, // index of the derivative with respect to k
+	};
+	typedef CStateVector<double, Size> VECTOR;
+
+	// public methods
+public:
+	// The derivative of the augmented state. The Jacobian of the equations
+	// of motion is constant, [ 0 I ; -kI 0 ], so each column of the matrix
+	// obeys the same equations as the state, and the derivative with
+	// respect to k has the additional forcing term ( 0, 0, -x, -y ).
+	RUNGE_KUTTA_INLINE void GetDerivative( const VECTOR& y, VECTOR& dy ) const
+	{
+		const double dK = m_dK;
+
+		for ( int nColumn = 0; nColumn < 6; nColumn++ )
+		{
+			const int n = nColumn * 4;
+			dy[ n + 0 ] = y[ n + 2 ];
+			dy[ n + 1 ] = y[ n + 3 ];
+			dy[ n + 2 ] = -dK * y[ n + 0 ];
+			dy[ n + 3 ] = -dK * y[ n + 1 ];
+		}
+
+		dy[ Parameter + 2 ] -= y[ 0 ];
+		dy[ Parameter + 3 ] -= y[ 1 ];
+	}
+
+	// public constructor
+public:
+	CLunarVariationalSystem( double dK )
+	{
+		m_dK = dK;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// propagates the lunar state together with its variational equations
+class CVariationalPropagator
+{
+	// protected methods
+protected:
+	// length of four components
+	static inline double GetNorm( const double* pValues )
+	{
+		return sqrt
+		(
+			pValues[ 0 ] * pValues[ 0 ] + pValues[ 1 ] * pValues[ 1 ] +
+			pValues[ 2 ] * pValues[ 2 ] + pValues[ 3 ] * pValues[ 3 ]
+		);
+	}
+
+	// the largest singular value of the state transition matrix by power
+	// iteration on the transpose times the matrix
+	static double GetLargestSingularValue( const double dMatrix[ 4 ][ 4 ] )
+	{
+		double dProduct[ 4 ][ 4 ];
+		for ( int i = 0; i < 4; i++ )
+		{
+			for ( int j = 0; j < 4; j++ )
+			{
+				double dSum = 0;
+				for ( int n = 0; n < 4; n++ )
+				{
+					dSum += dMatrix[ n ][ i ] * dMatrix[ n ][ j ];
+				}
+				dProduct[ i ][ j ] = dSum;
+			}
+		}
+
+		double dVector[ 4 ] = { 1, 1, 1, 1 };
+		double dEigenvalue = 0;
+		for ( int nIteration = 0; nIteration < 100; nIteration++ )
+		{
+			double dNext[ 4 ];
+			for ( int i = 0; i < 4; i++ )
+			{
+				dNext[ i ] = 0;
+				for ( int j = 0; j < 4; j++ )
+				{
+					dNext[ i ] += dProduct[ i ][ j ] * dVector[ j ];
+				}
+			}
+
+			const double dNorm = GetNorm( dNext );
+			if ( dNorm == 0 )
+			{
+				return 0;
+			}
+			for ( int i = 0; i < 4; i++ )
+			{
+				dVector[ i ] = dNext[ i ] / dNorm;
+			}
+			dEigenvalue = dNorm;
+		}
+
+		return sqrt( dEigenvalue );
+	}
+
+	// public methods
+public:
+	// Advance the state nSteps time slices with the given Runge-Kutta
+	// method and return the sensitivities of the final state. The
+	// sensitivities to LunarVelocity and MoonDistance assume the starting
+	// state holds the model's initial conditions, i.e. the speed is
+	// applied along the initial velocity and the radius along the initial
+	// position.
+	template <class TTableau>
+	static void Propagate
+	(
+		LUNAR_STATE& state, const LUNAR_PARAMETERS& params, int nSteps,
+		LUNAR_SENSITIVITY& sensitivity
+	)
+	{
+		typedef CLunarVariationalSystem SYSTEM;
+		const double dK = params.dGravityRatio;
+		const SYSTEM system( dK );
+
+		// the state followed by the identity matrix and a zero
+		// derivative with respect to k
+		SYSTEM::VECTOR y;
+		for ( int n = 0; n < SYSTEM::Size; n++ )
+		{
+			y[ n ] = 0;
+		}
+		y[ 0 ] = state.dX;
+		y[ 1 ] = state.dY;
+		y[ 2 ] = state.dVx;
+		y[ 3 ] = state.dVy;
+		for ( int n = 0; n < 4; n++ )
+		{
+			y[ SYSTEM::Transition + n * 4 + n ] = 1;
+		}
+
+		// directions of the initial position and velocity
+		const double dRadius = sqrt( state.dX * state.dX + state.dY * state.dY );
+		const double dSpeed = sqrt( state.dVx * state.dVx + state.dVy * state.dVy );
+		const double dUx = dRadius == 0 ? 0 : state.dX / dRadius;
+		const double dUy = dRadius == 0 ? 0 : state.dY / dRadius;
+		const double dWx = dSpeed == 0 ? 0 : state.dVx / dSpeed;
+		const double dWy = dSpeed == 0 ? 0 : state.dVy / dSpeed;
+
+		for ( int nStep = 0; nStep < nSteps; nStep++ )
+		{
+			CRungeKutta<TTableau>::Step( system, y, params.dSampleTime );
+		}
+
+		state.dX = y[ 0 ];
+		state.dY = y[ 1 ];
+		state.dVx = y[ 2 ];
+		state.dVy = y[ 3 ];
+		state.dAx = -dK * state.dX;
+		state.dAy = -dK * state.dY;
+		state.dTime += nSteps * params.dSampleTime;
+
+		// columns of the matrix are stored one after another
+		for ( int i = 0; i < 4; i++ )
+		{
+			for ( int j = 0; j < 4; j++ )
+			{
+				sensitivity.dTransition[ i ][ j ] =
+					y[ SYSTEM::Transition + j * 4 + i ];
+			}
+			sensitivity.dGravityRatio[ i ] = y[ SYSTEM::Parameter + i ];
+		}
+
+		// k is the acceleration of gravity divided by the radius, i.e.
+		// GM / R^3, so dk/dR = -3k / R
+		const double dGravityByRadius = dRadius == 0 ? 0 : -3 * dK / dRadius;
+
+		double dFastLyapunov = 0;
+		for ( int i = 0; i < 4; i++ )
+		{
+			const double( &dRow )[ 4 ] = sensitivity.dTransition[ i ];
+
+			sensitivity.dLunarVelocity[ i ] =
+				dRow[ 2 ] * dWx + dRow[ 3 ] * dWy;
+
+			sensitivity.dMoonDistance[ i ] =
+				dRow[ 0 ] * dUx + dRow[ 1 ] * dUy +
+				sensitivity.dGravityRatio[ i ] * dGravityByRadius;
+
+			const double dColumn = GetNorm( &y[ SYSTEM::Transition + i * 4 ] );
+			if ( dColumn > dFastLyapunov )
+			{
+				dFastLyapunov = dColumn;
+			}
+		}
+		sensitivity.dFastLyapunov = log10( dFastLyapunov );
+
+		const double dElapsed = nSteps * params.dSampleTime;
+		const double dSingular =
+			GetLargestSingularValue( sensitivity.dTransition );
+		sensitivity.dLyapunovExponent =
+			dElapsed == 0 ? 0 : log( dSingular ) / dElapsed;
+	}
+
+	// Advance the state with the variational equations using the runtime
+	// integrator. The original lagged Euler scheme is not the flow of a
+	// differential equation, so it is replaced by RK4 for this run.
+	static void Propagate
+	(
+		INTEGRATOR eIntegrator, LUNAR_STATE& state,
+		const LUNAR_PARAMETERS& params, int nSteps,
+		LUNAR_SENSITIVITY& sensitivity
+	)
+	{
+		switch ( eIntegrator )
+		{
+			case INTEGRATOR_RALSTON:
+				Propagate<CTableauRalston>( state, params, nSteps, sensitivity );
+				break;
+			case INTEGRATOR_SSPRK3:
+				Propagate<CTableauSSPRK3>( state, params, nSteps, sensitivity );
+				break;
+			case INTEGRATOR_TSITOURAS5:
+				Propagate<CTableauTsitouras5>( state, params, nSteps, sensitivity );
+				break;
+			default:
+				Propagate<CTableauRK4>( state, params, nSteps, sensitivity );
+				break;
+		}
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
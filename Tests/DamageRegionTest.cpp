@@ -0,0 +1,316 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Checks that a CDamageRegion keeps its rectangles apart and under its
+// limit while covering everything added to it, and that the region
+// CLunarOrbitView::InvalidateMovingParts builds for an orbit of the moon
+// is a small part of the client area.
+#include "DamageRegion.h"
+#include "TestCheck.h"
+#include <algorithm>
+
+// size of the client area in pixels
+static const int CLIENT_WIDTH = 1280;
+static const int CLIENT_HEIGHT = 960;
+
+// size of the area the random rectangles are added in
+static const int AREA_SIZE = 600;
+
+// The largest part of the client area the orbit is allowed to damage on
+// average, which was 13.8% when the region was written.
+static const double MAX_DAMAGED = 0.16;
+
+/////////////////////////////////////////////////////////////////////////////
+// a repeatable value from zero up to the given limit
+static long GetRandom( long nLimit )
+{
+	static unsigned int nState = 1;
+	nState = nState * 1103515245 + 12345;
+	return long( ( nState >> 8 ) % nLimit );
+
+} // GetRandom
+
+/////////////////////////////////////////////////////////////////////////////
+// check that no two rectangles of the region overlap, that the region is
+// within its limit and that its area is the sum of its rectangles
+static void CheckRegion( const CDamageRegion& region )
+{
+	const int nRects = region.GetCount();
+	CHECK( nRects <= region.GetMaxRects() );
+
+	long long nArea = 0;
+	for ( int nRect = 0; nRect < nRects; nRect++ )
+	{
+		const DISPLAY_RECT& rect = region.GetRect( nRect );
+		CHECK( rect.right > rect.left && rect.bottom > rect.top );
+		nArea += CDamageRegion::GetArea( rect );
+		for ( int nOther = nRect + 1; nOther < nRects; nOther++ )
+		{
+			CHECK( !CDamageRegion::Overlaps( rect, region.GetRect( nOther ) ) );
+		}
+	}
+	CHECK( region.GetArea() == nArea );
+
+} // CheckRegion
+
+/////////////////////////////////////////////////////////////////////////////
+// true if every pixel of the rectangle is in the region
+static bool IsCovered( const CDamageRegion& region, const DISPLAY_RECT& rect )
+{
+	for ( long nY = rect.top; nY < rect.bottom; nY++ )
+	{
+		for ( long nX = rect.left; nX < rect.right; nX++ )
+		{
+			bool bCovered = false;
+			for ( int nRect = 0; nRect < region.GetCount(); nRect++ )
+			{
+				const DISPLAY_RECT& cover = region.GetRect( nRect );
+				if
+				(
+					nX >= cover.left && nX < cover.right &&
+					nY >= cover.top && nY < cover.bottom
+				)
+				{
+					bCovered = true;
+					break;
+				}
+			}
+			if ( !bCovered )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+
+} // IsCovered
+
+/////////////////////////////////////////////////////////////////////////////
+// random rectangles added to regions of several limits
+static void TestRandom()
+{
+	const int limits[] = { 1, 2, 4, 8, 16 };
+	for ( const int nMaxRects : limits )
+	{
+		CDamageRegion region( nMaxRects );
+		CHECK( region.GetMaxRects() == nMaxRects );
+
+		vector<DISPLAY_RECT> added;
+		for ( int nAdd = 0; nAdd < 300; nAdd++ )
+		{
+			const long nLeft = GetRandom( AREA_SIZE - 60 );
+			const long nTop = GetRandom( AREA_SIZE - 60 );
+			const long nWidth = 1 + GetRandom( 60 );
+			const long nHeight = 1 + GetRandom( 60 );
+			const DISPLAY_RECT rect =
+			{
+				nLeft, nTop, nLeft + nWidth, nTop + nHeight
+			};
+			region.Add( rect );
+			added.push_back( rect );
+			CheckRegion( region );
+
+			// every rectangle added so far is still covered, checked
+			// now and then to keep the test quick
+			if ( nAdd % 25 == 24 )
+			{
+				for ( const DISPLAY_RECT& old : added )
+				{
+					CHECK( IsCovered( region, old ) );
+				}
+			}
+		}
+	}
+
+} // TestRandom
+
+/////////////////////////////////////////////////////////////////////////////
+// the merges that cost nothing and the rectangles that are ignored
+static void TestMerges()
+{
+	CDamageRegion region;
+
+	// empty rectangles are ignored
+	const DISPLAY_RECT empty = { 10, 10, 10, 20 };
+	const DISPLAY_RECT inverted = { 10, 20, 20, 10 };
+	region.Add( empty );
+	region.Add( inverted );
+	CHECK( region.IsEmpty() );
+
+	// two rectangles side by side become one
+	const DISPLAY_RECT left = { 0, 0, 10, 10 };
+	const DISPLAY_RECT right = { 10, 0, 20, 10 };
+	region.Add( left );
+	region.Add( right );
+	CHECK( region.GetCount() == 1 );
+	CHECK( region.GetArea() == 200 );
+
+	// a rectangle inside the region changes nothing
+	const DISPLAY_RECT inside = { 2, 2, 8, 8 };
+	region.Add( inside );
+	CHECK( region.GetCount() == 1 );
+	CHECK( region.GetArea() == 200 );
+
+	// a rectangle apart from it is kept on its own
+	const DISPLAY_RECT apart = { 100, 100, 110, 110 };
+	region.Add( apart );
+	CHECK( region.GetCount() == 2 );
+	CHECK( region.GetArea() == 300 );
+	const DISPLAY_RECT bounds = region.GetBounds();
+	CHECK( bounds.left == 0 && bounds.top == 0 );
+	CHECK( bounds.right == 110 && bounds.bottom == 110 );
+	CHECK( region.IsInsideBounds( inside ) );
+
+	region.Clear();
+	CHECK( region.IsEmpty() );
+	CHECK( region.GetArea() == 0 );
+
+} // TestMerges
+
+/////////////////////////////////////////////////////////////////////////////
+// Record the moving parts of a frame in client pixels: the moon with its
+// label, three vectors with their arrowheads, arcs and labels and the
+// blocks of text whose values change every frame.
+static void RecordFrame
+(
+	CDisplayList& list, CDisplayStyles& styles, double dOrbit
+)
+{
+	const int nPen = styles.AddPen( DISPLAY_PEN_SOLID, 2, 0 );
+	const int nBrush = styles.AddBrush( 0 );
+	const int nFont = styles.AddFont( L"Arial", 24 );
+	const int nSmallFont = styles.AddFont( L"Arial", 17 );
+	const long nX = 640 + long( 380 * cos( dOrbit ) );
+	const long nY = 480 - long( 380 * sin( dOrbit ) );
+
+	list.Ellipse( nPen, nBrush, nX - 16, nY - 16, nX + 16, nY + 16 );
+	list.Text
+	(
+		nSmallFont, 0, DISPLAY_ALIGN_LEFT, 0, nX + 16, nY, L"-384400,12345"
+	);
+
+	for ( int nVector = 0; nVector < 3; nVector++ )
+	{
+		const double dLength = 60 + 40 * nVector;
+		const double dAngle = dOrbit + nVector * 1.2;
+		const long nX2 = nX + long( dLength * cos( dAngle ) );
+		const long nY2 = nY - long( dLength * sin( dAngle ) );
+		list.Line( nPen, nX, nY, nX2, nY2 );
+		const DISPLAY_POINT arrow[ 4 ] =
+		{
+			{ nX2, nY2 }, { nX2 - 8, nY2 - 3 }, { nX2 - 8, nY2 + 3 },
+			{ nX2, nY2 }
+		};
+		list.Polygon( nPen, nBrush, arrow, 4 );
+		const float fDegrees = float( dAngle * 180 / 3.14159265358979 );
+		list.Arc( nPen, nX, nY, int( dLength / 4 ), 0, fDegrees );
+		list.Text
+		(
+			nSmallFont, int( fDegrees * 10 ) % 3600,
+			DISPLAY_ALIGN_CENTER | DISPLAY_ALIGN_BOTTOM, 0,
+			( nX + nX2 ) / 2, ( nY + nY2 ) / 2, L"V"
+		);
+
+		// the block of text with the values of the vector
+		for ( int nLine = 0; nLine < 4; nLine++ )
+		{
+			list.Text
+			(
+				nFont, 0, DISPLAY_ALIGN_RIGHT | DISPLAY_ALIGN_BASELINE, 0,
+				240 + nVector * 400, 850 + nLine * 24, L"V=1.023e+03 m/s"
+			);
+		}
+	}
+
+	for ( int nLine = 0; nLine < 4; nLine++ )
+	{
+		list.Text
+		(
+			nFont, 0, DISPLAY_ALIGN_RIGHT | DISPLAY_ALIGN_BASELINE, 0,
+			1260, 40 + nLine * 24, L"Period=12.34 days"
+		);
+	}
+
+} // RecordFrame
+
+/////////////////////////////////////////////////////////////////////////////
+// The region of each frame of an orbit, built as InvalidateMovingParts
+// builds it from the bounds of the moving parts of the last frame and the
+// next one, covers both frames and is a small part of the client area.
+static void TestOrbit()
+{
+	CDisplayStyles styles;
+	CDisplayList list;
+	CDamageRegion previous;
+	CDamageRegion damage;
+	vector<DISPLAY_RECT> previousBounds;
+	long long nDamaged = 0;
+	const int nFrames = 720;
+
+	for ( int nFrame = 0; nFrame < nFrames; nFrame++ )
+	{
+		list.Clear();
+		RecordFrame( list, styles, nFrame * 2 * 3.14159265358979 / nFrames );
+
+		CDamageRegion current;
+		vector<DISPLAY_RECT> bounds;
+		for ( int nCommand = 0; nCommand < list.GetCommandCount(); nCommand++ )
+		{
+			DISPLAY_RECT rect = list.GetBounds( nCommand, styles );
+			rect.left--;
+			rect.top--;
+			rect.right++;
+			rect.bottom++;
+			current.Add( rect );
+			bounds.push_back( rect );
+		}
+
+		damage.Clear();
+		damage.Add( previous );
+		damage.Add( current );
+		CheckRegion( damage );
+		for ( const DISPLAY_RECT& rect : bounds )
+		{
+			CHECK( IsCovered( damage, rect ) );
+		}
+		for ( const DISPLAY_RECT& rect : previousBounds )
+		{
+			CHECK( IsCovered( damage, rect ) );
+		}
+		previous = current;
+		previousBounds = bounds;
+
+		// the damage inside the client area
+		for ( int nRect = 0; nRect < damage.GetCount(); nRect++ )
+		{
+			DISPLAY_RECT rect = damage.GetRect( nRect );
+			rect.left = max( rect.left, 0L );
+			rect.top = max( rect.top, 0L );
+			rect.right = min( rect.right, long( CLIENT_WIDTH ) );
+			rect.bottom = min( rect.bottom, long( CLIENT_HEIGHT ) );
+			if ( rect.right > rect.left && rect.bottom > rect.top )
+			{
+				nDamaged += CDamageRegion::GetArea( rect );
+			}
+		}
+	}
+
+	const double dDamaged =
+		double( nDamaged ) / nFrames / ( CLIENT_WIDTH * CLIENT_HEIGHT );
+	printf( "the orbit damages %.1f%% of the client area\n", 100 * dDamaged );
+	CHECK( dDamaged < MAX_DAMAGED );
+
+} // TestOrbit
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	TestMerges();
+	TestRandom();
+	TestOrbit();
+
+	return GetTestResult( "DamageRegionTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,243 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Records frames the way CLunarOrbitView::OnDraw does, with a static list
+// recorded once and a dynamic list recorded again every frame from the
+// geometry of CMoonVectors, and replays both lists onto CDisplayCounter
+// to check the number of commands, points and styles of each frame.
+#include "DisplayList.h"
+#include "MoonVectors.h"
+#include "TestCheck.h"
+
+// frames recorded
+static const int FRAMES = 100;
+
+// lines of the grid, points of the scale and labels of the static list
+static const int GRID_LINES = 20;
+static const int SCALE_POINTS = 5;
+static const int LABELS = 3;
+
+// points of the trail of the moon in the dynamic list
+static const int TRAIL_POINTS = 32;
+
+/////////////////////////////////////////////////////////////////////////////
+// record the grid, the scale, the labels and the earth as the view records
+// them into its static list
+static void RecordStatic( CDisplayList& list, CDisplayStyles& styles )
+{
+	const int nGridPen =
+		styles.AddPen( DISPLAY_PEN_DOT, 1, DisplayColor( 192, 192, 192 ) );
+	for ( int n = 0; n < GRID_LINES / 2; n++ )
+	{
+		list.Line( nGridPen, n * 1000, 0, n * 1000, -8500 );
+		list.Line( nGridPen, 0, -n * 1000, 11000, -n * 1000 );
+	}
+
+	const int nPen = styles.AddPen( DISPLAY_PEN_SOLID, 10, 0 );
+	DISPLAY_POINT scale[ SCALE_POINTS ];
+	for ( int n = 0; n < SCALE_POINTS; n++ )
+	{
+		scale[ n ].x = 500 + n * 250;
+		scale[ n ].y = n % 2 == 0 ? -8000 : -8050;
+	}
+	list.Polyline( nPen, scale, SCALE_POINTS );
+
+	const int nFont = styles.AddFont( L"Arial", 150 );
+	for ( int n = 0; n < LABELS; n++ )
+	{
+		list.Text( nFont, 0, 0, 0, 500, -500 - n * 200, L"label" );
+	}
+
+	const int nBrush = styles.AddBrush( DisplayColor( 0, 128, 255 ) );
+	list.Ellipse( nPen, nBrush, 5000, -3750, 6000, -4750 );
+
+} // RecordStatic
+
+/////////////////////////////////////////////////////////////////////////////
+// Record the moon, its trail and its vectors as the view records them into
+// its dynamic list, where each vector is a line with a polygon for its
+// arrowhead and the three main vectors also have a dotted arc of their
+// angle and a label.
+static void RecordDynamic
+(
+	CDisplayList& list, CDisplayStyles& styles, const CMoonVectors& vectors
+)
+{
+	const CLinearBatch& batch = vectors.GetVectors();
+	const CLinearBatch& positive = vectors.GetPositiveArrowheads();
+	const CLinearBatch& negative = vectors.GetNegativeArrowheads();
+
+	const int nTrailPen = styles.AddPen( DISPLAY_PEN_SOLID, 5, 0 );
+	DISPLAY_POINT trail[ TRAIL_POINTS ];
+	for ( int n = 0; n < TRAIL_POINTS; n++ )
+	{
+		trail[ n ].x = long( batch.GetX1( 0 ) ) - n * 10;
+		trail[ n ].y = long( batch.GetY1( 0 ) ) + n * 10;
+	}
+	list.Polyline( nTrailPen, trail, TRAIL_POINTS );
+
+	const long nMoonX = long( batch.GetX1( 0 ) );
+	const long nMoonY = long( batch.GetY1( 0 ) );
+	const int nMoonBrush = styles.AddBrush( DisplayColor( 128, 128, 128 ) );
+	list.Ellipse
+	(
+		nTrailPen, nMoonBrush, nMoonX - 100, nMoonY - 100, nMoonX + 100,
+		nMoonY + 100
+	);
+
+	const int nFont = styles.AddFont( L"Arial", 100, true );
+	for ( int n = 0; n < CMoonVectors::MOON_VECTORS; n++ )
+	{
+		// each of the three kinds of vector has its own color
+		const int nKind = n / 3;
+		const DISPLAY_COLOR color = DisplayColor
+		(
+			nKind == 0 ? 255 : 0, nKind == 1 ? 255 : 0, nKind == 2 ? 255 : 0
+		);
+		const int nPen = styles.AddPen( DISPLAY_PEN_SOLID, 10, color );
+		const int nBrush = styles.AddBrush( color );
+
+		const long nX2 = long( batch.GetX2( n ) );
+		const long nY2 = long( batch.GetY2( n ) );
+		list.Line( nPen, nMoonX, nMoonY, nX2, nY2 );
+		const DISPLAY_POINT arrow[ 4 ] =
+		{
+			{ nX2, nY2 },
+			{ long( positive.GetX2( n ) ), long( positive.GetY2( n ) ) },
+			{ long( negative.GetX2( n ) ), long( negative.GetY2( n ) ) },
+			{ nX2, nY2 }
+		};
+		list.Polygon( nPen, nBrush, arrow, 4 );
+
+		if ( n % 3 == 0 )
+		{
+			const int nArcPen = styles.AddPen( DISPLAY_PEN_DOT, 10, color );
+			list.Arc( nArcPen, nMoonX, nMoonY, 250, 0.0f, 45.0f );
+			list.Text( nFont, 450, 0, color, nX2, nY2, L"1.000 km" );
+		}
+	}
+
+} // RecordDynamic
+
+/////////////////////////////////////////////////////////////////////////////
+// the styles return the handles of the styles they already hold
+static void TestStyles()
+{
+	CDisplayStyles styles;
+	const int nPen = styles.AddPen( DISPLAY_PEN_SOLID, 10, 5 );
+	CHECK( styles.AddPen( DISPLAY_PEN_SOLID, 10, 5 ) == nPen );
+	CHECK( styles.AddPen( DISPLAY_PEN_DOT, 10, 5 ) != nPen );
+	CHECK( styles.AddPen( DISPLAY_PEN_SOLID, 11, 5 ) != nPen );
+	CHECK( styles.AddPen( DISPLAY_PEN_SOLID, 10, 6 ) != nPen );
+	CHECK( styles.GetPenCount() == 4 );
+
+	const int nBrush = styles.AddBrush( 7 );
+	CHECK( styles.AddBrush( 7 ) == nBrush );
+	CHECK( styles.AddBrush( 8 ) != nBrush );
+	CHECK( styles.GetBrushCount() == 2 );
+
+	const int nFont = styles.AddFont( L"Arial", 100 );
+	CHECK( styles.AddFont( L"Arial", 100 ) == nFont );
+	CHECK( styles.AddFont( L"Arial", 100, true ) != nFont );
+	CHECK( styles.AddFont( L"Arial", 100, false, true ) != nFont );
+	CHECK( styles.AddFont( L"Times", 100 ) != nFont );
+	CHECK( styles.AddFont( L"Arial", 120 ) != nFont );
+	CHECK( styles.GetFontCount() == 5 );
+
+} // TestStyles
+
+/////////////////////////////////////////////////////////////////////////////
+// record and replay frames of a moon going around the earth
+static void TestFrames()
+{
+	CDisplayStyles styles;
+	CDisplayList staticList;
+	CDisplayList dynamicList;
+	CMoonVectors vectors;
+	vectors.SetUpIncrement( -1 );
+
+	// what each frame is expected to draw
+	const int nMainVectors = CMoonVectors::MOON_VECTORS / 3;
+	const int nStaticCommands = GRID_LINES + 1 + LABELS + 1;
+	const int nStaticPoints = 2 * GRID_LINES + SCALE_POINTS + LABELS + 2;
+	const int nDynamicCommands =
+		2 + 2 * CMoonVectors::MOON_VECTORS + 2 * nMainVectors;
+	const int nDynamicPoints =
+		TRAIL_POINTS + 2 + 6 * CMoonVectors::MOON_VECTORS + 2 * nMainVectors;
+
+	int nPens = 0;
+	int nBrushes = 0;
+	int nFonts = 0;
+	for ( int nFrame = 0; nFrame < FRAMES; nFrame++ )
+	{
+		const double dOrbit = nFrame * 0.0628;
+		vectors.Update
+		(
+			5500 + 4000 * cos( dOrbit ), -4250 - 4000 * sin( dOrbit ),
+			5500, -4250, 2000, 1000, 100, 15
+		);
+
+		// the static list is only recorded when it is empty
+		if ( staticList.IsEmpty() )
+		{
+			RecordStatic( staticList, styles );
+		}
+		dynamicList.Clear();
+		RecordDynamic( dynamicList, styles, vectors );
+
+		CDisplayCounter counter;
+		staticList.Replay( counter );
+		CHECK( counter.GetTotal() == nStaticCommands );
+		CHECK( counter.GetPoints() == nStaticPoints );
+		CHECK( counter.GetCount( DISPLAY_LINE ) == GRID_LINES );
+		CHECK( counter.GetCount( DISPLAY_TEXT ) == LABELS );
+		CHECK( staticList.GetCommandCount() == nStaticCommands );
+
+		counter.Reset();
+		dynamicList.Replay( counter );
+		CHECK( counter.GetTotal() == nDynamicCommands );
+		CHECK( counter.GetPoints() == nDynamicPoints );
+		CHECK( counter.GetCount( DISPLAY_LINE ) == CMoonVectors::MOON_VECTORS );
+		CHECK
+		(
+			counter.GetCount( DISPLAY_POLYGON ) == CMoonVectors::MOON_VECTORS
+		);
+		CHECK( counter.GetCount( DISPLAY_ARC ) == nMainVectors );
+		CHECK( counter.GetCount( DISPLAY_TEXT ) == nMainVectors );
+		CHECK( counter.GetCount( DISPLAY_POLYLINE ) == 1 );
+		CHECK( counter.GetCount( DISPLAY_ELLIPSE ) == 1 );
+		CHECK( dynamicList.GetCommandCount() == nDynamicCommands );
+
+		// recording the same styles again does not grow the table
+		if ( nFrame == 0 )
+		{
+			nPens = styles.GetPenCount();
+			nBrushes = styles.GetBrushCount();
+			nFonts = styles.GetFontCount();
+		}
+		CHECK( styles.GetPenCount() == nPens );
+		CHECK( styles.GetBrushCount() == nBrushes );
+		CHECK( styles.GetFontCount() == nFonts );
+	}
+
+	// a solid and a dotted pen for each kind of vector, the grid pen, the
+	// black pens of the static list and the trail, a brush for the earth,
+	// the moon and each kind of vector and a font for the labels of each
+	// list
+	CHECK( nPens == 9 );
+	CHECK( nBrushes == 5 );
+	CHECK( nFonts == 2 );
+
+} // TestFrames
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	TestStyles();
+	TestFrames();
+
+	return GetTestResult( "DisplayListTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
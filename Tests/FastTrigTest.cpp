@@ -0,0 +1,124 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Checks the polynomial sine, cosine and arc tangent of each accuracy
+// against the library, one value at a time and for arrays, which are done
+// in pairs with SSE2 when the compiler targets it and leave an odd value
+// for the scalar tail.
+#include "FastTrig.h"
+#include "TestCheck.h"
+#include <vector>
+
+using namespace std;
+
+// number of angles and points checked
+static const int SAMPLES = 100001;
+
+// The error allowed in degrees on top of the error of the accuracy,
+// because the library is given degrees converted to radians, which is
+// rounded, where the polynomials are given the reduced angle.
+static const double DEGREES_ERROR = 1e-14;
+
+/////////////////////////////////////////////////////////////////////////////
+// a repeatable value from -1 to 1
+static double GetRandom()
+{
+	static unsigned int nState = 12345;
+	nState = nState * 1664525 + 1013904223;
+	return nState / 2147483648.0 - 1;
+
+} // GetRandom
+
+/////////////////////////////////////////////////////////////////////////////
+// compare one accuracy with the library
+template <class TAccuracy> static void TestAccuracy()
+{
+	typedef CFastTrig<TAccuracy> TRIG;
+	const double dError = TAccuracy::MaximumError();
+	const double dPI = 3.1415926535897932384626433832795;
+
+	// angles within a thousand radians and points of every quadrant
+	// including the axes and the origin
+	vector<double> x( SAMPLES );
+	vector<double> y( SAMPLES );
+	for ( int n = 0; n < SAMPLES; n++ )
+	{
+		x[ n ] = 1000 * GetRandom();
+		y[ n ] = 5 * GetRandom();
+	}
+	const double axes[][ 2 ] =
+	{
+		{ 0, 0 }, { -5, 0 }, { 0, 3 }, { 0, -3 }, { 3, 3 }, { -3, -3 },
+		{ 1e-300, 1 }, { 1, 1e-300 }
+	};
+	for ( int n = 0; n < int( sizeof( axes ) / sizeof( axes[ 0 ] ) ); n++ )
+	{
+		x[ n ] = axes[ n ][ 0 ];
+		y[ n ] = axes[ n ][ 1 ];
+	}
+
+	vector<double> sines( SAMPLES );
+	vector<double> cosines( SAMPLES );
+	vector<double> angles( SAMPLES );
+	TRIG::SinCos( x.data(), sines.data(), cosines.data(), SAMPLES );
+	TRIG::Atan2( y.data(), x.data(), angles.data(), SAMPLES );
+
+	for ( int n = 0; n < SAMPLES; n++ )
+	{
+		const double dSine = sin( x[ n ] );
+		const double dCosine = cos( x[ n ] );
+		const double dAngle = atan2( y[ n ], x[ n ] );
+
+		double dFastSine;
+		double dFastCosine;
+		TRIG::SinCos( x[ n ], dFastSine, dFastCosine );
+		CHECK_NEAR( dFastSine, dSine, dError );
+		CHECK_NEAR( dFastCosine, dCosine, dError );
+		CHECK_NEAR( TRIG::Sin( x[ n ] ), dSine, dError );
+		CHECK_NEAR( TRIG::Cos( x[ n ] ), dCosine, dError );
+		CHECK_NEAR( TRIG::Atan2( y[ n ], x[ n ] ), dAngle, dError );
+
+		CHECK_NEAR( sines[ n ], dSine, dError );
+		CHECK_NEAR( cosines[ n ], dCosine, dError );
+		CHECK_NEAR( angles[ n ], dAngle, dError );
+
+		// the same angles in degrees
+		TRIG::SinCosDegrees( x[ n ], dFastSine, dFastCosine );
+		const double dRadians = x[ n ] * dPI / 180;
+		CHECK_NEAR( dFastSine, sin( dRadians ), dError + DEGREES_ERROR );
+		CHECK_NEAR( dFastCosine, cos( dRadians ), dError + DEGREES_ERROR );
+		CHECK_NEAR
+		(
+			TRIG::Atan2Degrees( y[ n ], x[ n ] ), dAngle * 180 / dPI,
+			( dError + DEGREES_ERROR ) * 180 / dPI
+		);
+	}
+
+	// multiples of 90 degrees are exact
+	for ( int nTurn = -8; nTurn <= 8; nTurn++ )
+	{
+		double dSine;
+		double dCosine;
+		TRIG::SinCosDegrees( nTurn * 90.0, dSine, dCosine );
+		const int nQuadrant = ( nTurn % 4 + 4 ) % 4;
+		const double quadrants[ 4 ][ 2 ] =
+		{
+			{ 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 }
+		};
+		CHECK( dSine == quadrants[ nQuadrant ][ 0 ] );
+		CHECK( dCosine == quadrants[ nQuadrant ][ 1 ] );
+	}
+
+} // TestAccuracy
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	TestAccuracy<CTrigScreen>();
+	TestAccuracy<CTrigPhysics>();
+
+	return GetTestResult( "FastTrigTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,191 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Checks when CLayerCache asks for the background to be drawn again and
+// how CPixelLayer resizes and copies its pixels.
+#include "LayerCache.h"
+#include "TestCheck.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// the key of a view at full scale scrolled to the top left
+static LAYER_KEY GetKey()
+{
+	LAYER_KEY key;
+	key.dScale = 1;
+	key.dLeftOfView = 0;
+	key.dTopOfView = 0;
+	key.nWidth = 1280;
+	key.nHeight = 960;
+	return key;
+
+} // GetKey
+
+/////////////////////////////////////////////////////////////////////////////
+// a change of any member of the key misses and the same key hits
+static void TestPrepare()
+{
+	CLayerCache cache;
+	const LAYER_KEY key = GetKey();
+	CHECK( !cache.IsValid( key ) );
+
+	// the first frame draws the layer and the next ones reuse it
+	CHECK( cache.Prepare( key ) );
+	CHECK( cache.IsValid( key ) );
+	CHECK( !cache.Prepare( key ) );
+	CHECK( !cache.Prepare( key ) );
+	CHECK( cache.GetMisses() == 1 );
+	CHECK( cache.GetHits() == 2 );
+
+	// each member of the key on its own
+	for ( int nMember = 0; nMember < 5; nMember++ )
+	{
+		LAYER_KEY changed = key;
+		switch ( nMember )
+		{
+			case 0:
+				changed.dScale = 1.25;
+				break;
+			case 1:
+				changed.dLeftOfView = 0.5;
+				break;
+			case 2:
+				changed.dTopOfView = -0.5;
+				break;
+			case 3:
+				changed.nWidth = 1281;
+				break;
+			case 4:
+				changed.nHeight = 959;
+				break;
+		}
+		CHECK( changed != key );
+		CHECK( !cache.IsValid( changed ) );
+		CHECK( cache.Prepare( changed ) );
+		CHECK( !cache.Prepare( changed ) );
+
+		// going back to the key draws the layer again
+		CHECK( cache.Prepare( key ) );
+		CHECK( !cache.IsValid( changed ) );
+	}
+	CHECK( cache.GetMisses() == 11 );
+	CHECK( cache.GetHits() == 7 );
+
+	// an invalidated layer is drawn again for the same key
+	cache.Invalidate();
+	CHECK( !cache.IsValid( key ) );
+	CHECK( cache.Prepare( key ) );
+	CHECK( !cache.Prepare( key ) );
+	CHECK( cache.GetMisses() == 12 );
+	CHECK( cache.GetHits() == 8 );
+
+} // TestPrepare
+
+/////////////////////////////////////////////////////////////////////////////
+// fill a layer with a different value in each pixel
+static void FillPattern( CPixelLayer& layer, LAYER_PIXEL seed )
+{
+	for ( int nRow = 0; nRow < layer.GetHeight(); nRow++ )
+	{
+		for ( int nColumn = 0; nColumn < layer.GetWidth(); nColumn++ )
+		{
+			layer.SetPixel( nColumn, nRow, seed + nRow * 1000 + nColumn );
+		}
+	}
+
+} // FillPattern
+
+/////////////////////////////////////////////////////////////////////////////
+// true if a layer has the pattern of FillPattern
+static bool HasPattern( const CPixelLayer& layer, LAYER_PIXEL seed )
+{
+	for ( int nRow = 0; nRow < layer.GetHeight(); nRow++ )
+	{
+		for ( int nColumn = 0; nColumn < layer.GetWidth(); nColumn++ )
+		{
+			const LAYER_PIXEL value = seed + nRow * 1000 + nColumn;
+			if ( layer.GetPixel( nColumn, nRow ) != value )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+
+} // HasPattern
+
+/////////////////////////////////////////////////////////////////////////////
+// resizing, filling and copying layers
+static void TestPixelLayer()
+{
+	CPixelLayer layer;
+	CHECK( layer.GetWidth() == 0 && layer.GetHeight() == 0 );
+
+	layer.Resize( 37, 21 );
+	CHECK( layer.GetWidth() == 37 && layer.GetHeight() == 21 );
+	FillPattern( layer, 7 );
+	CHECK( layer.GetRow( 3 ) == layer.GetPixels() + 3 * 37 );
+
+	// the same size keeps the pixels
+	layer.Resize( 37, 21 );
+	CHECK( HasPattern( layer, 7 ) );
+
+	// a smaller size keeps the storage
+	const LAYER_PIXEL* pPixels = layer.GetPixels();
+	layer.Resize( 20, 10 );
+	CHECK( layer.GetWidth() == 20 && layer.GetHeight() == 10 );
+	CHECK( layer.GetPixels() == pPixels );
+
+	// negative sizes are empty
+	layer.Resize( -5, 10 );
+	CHECK( layer.GetWidth() == 0 && layer.GetHeight() == 10 );
+
+	layer.Resize( 16, 9 );
+	layer.Fill( 0xffffff );
+	bool bFilled = true;
+	for ( int nRow = 0; nRow < 9; nRow++ )
+	{
+		for ( int nColumn = 0; nColumn < 16; nColumn++ )
+		{
+			bFilled = bFilled && layer.GetPixel( nColumn, nRow ) == 0xffffff;
+		}
+	}
+	CHECK( bFilled );
+
+	// copying takes the size and the pixels of the source whether the
+	// copy is larger, smaller or empty
+	CPixelLayer source;
+	source.Resize( 31, 17 );
+	FillPattern( source, 100 );
+	CPixelLayer copy;
+	copy.CopyFrom( source );
+	CHECK( copy.GetWidth() == 31 && copy.GetHeight() == 17 );
+	CHECK( HasPattern( copy, 100 ) );
+	CHECK( copy.GetPixels() != source.GetPixels() );
+
+	layer.Resize( 200, 100 );
+	layer.Fill( 0 );
+	layer.CopyFrom( source );
+	CHECK( layer.GetWidth() == 31 && layer.GetHeight() == 17 );
+	CHECK( HasPattern( layer, 100 ) );
+
+	// the copy is independent of the source
+	source.SetPixel( 0, 0, 0 );
+	CHECK( HasPattern( copy, 100 ) );
+
+	const CPixelLayer empty;
+	copy.CopyFrom( empty );
+	CHECK( copy.GetWidth() == 0 && copy.GetHeight() == 0 );
+
+} // TestPixelLayer
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	TestPrepare();
+	TestPixelLayer();
+
+	return GetTestResult( "LayerCacheTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
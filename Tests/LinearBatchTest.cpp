@@ -0,0 +1,144 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Checks that setting one length or one rotation for a whole batch gives
+// the same segments as an array of them, for counts that leave a segment
+// for the scalar tail after the pairs done with SSE2, and that the results
+// have the length and angle asked for.
+#include "LinearBatch.h"
+#include "TestCheck.h"
+
+// the largest difference allowed in logical units
+static const double TOLERANCE = 1e-9;
+
+/////////////////////////////////////////////////////////////////////////////
+// a batch of the given number of segments going every which way, with
+// one of them of zero length when there is room for it
+static CLinearBatch CreateBatch( int nCount, int nUp )
+{
+	CLinearBatch batch;
+	batch.SetUpIncrement( nUp );
+	for ( int n = 0; n < nCount; n++ )
+	{
+		const double dX1 = 10.0 * n - 17;
+		const double dY1 = 3.0 - 7.0 * n;
+		const double dAngle = 0.9 * n + 0.3;
+		const double dLength = n == 3 ? 0 : 5.0 + 11.0 * n;
+		batch.Add
+		(
+			dX1, dY1, dX1 + dLength * cos( dAngle ),
+			dY1 + dLength * sin( dAngle )
+		);
+	}
+	return batch;
+
+} // CreateBatch
+
+/////////////////////////////////////////////////////////////////////////////
+// true if the two batches have the same segments
+static bool IsSame( const CLinearBatch& one, const CLinearBatch& two )
+{
+	if ( one.GetCount() != two.GetCount() )
+	{
+		return false;
+	}
+	for ( int n = 0; n < one.GetCount(); n++ )
+	{
+		if
+		(
+			fabs( one.GetX1( n ) - two.GetX1( n ) ) > TOLERANCE ||
+			fabs( one.GetY1( n ) - two.GetY1( n ) ) > TOLERANCE ||
+			fabs( one.GetX2( n ) - two.GetX2( n ) ) > TOLERANCE ||
+			fabs( one.GetY2( n ) - two.GetY2( n ) ) > TOLERANCE
+		)
+		{
+			return false;
+		}
+	}
+	return true;
+
+} // IsSame
+
+/////////////////////////////////////////////////////////////////////////////
+// the length of a segment of the batch
+static double GetLength( const CLinearBatch& batch, int nSegment )
+{
+	return hypot
+	(
+		batch.GetX2( nSegment ) - batch.GetX1( nSegment ),
+		batch.GetY2( nSegment ) - batch.GetY1( nSegment )
+	);
+
+} // GetLength
+
+/////////////////////////////////////////////////////////////////////////////
+// one length for every segment against an array of the same length
+static void TestSetLength( int nCount )
+{
+	const double dLength = 42.5;
+	CLinearBatch uniform = CreateBatch( nCount, -1 );
+	CLinearBatch array = uniform;
+	const vector<double> lengths( nCount, dLength );
+
+	uniform.SetLength( dLength );
+	array.SetLength( lengths.data() );
+	CHECK( IsSame( uniform, array ) );
+
+	for ( int n = 0; n < nCount; n++ )
+	{
+		CHECK_NEAR( GetLength( uniform, n ), dLength, TOLERANCE );
+	}
+
+	// the zero length segment extends to the right
+	if ( nCount > 3 )
+	{
+		const double dX2 = uniform.GetX1( 3 ) + dLength;
+		CHECK_NEAR( uniform.GetX2( 3 ), dX2, TOLERANCE );
+		CHECK_NEAR( uniform.GetY2( 3 ), uniform.GetY1( 3 ), TOLERANCE );
+	}
+
+} // TestSetLength
+
+/////////////////////////////////////////////////////////////////////////////
+// one rotation for every segment against an array of the same rotation,
+// where a quarter turn counter clockwise with the up increment of a
+// device context moves a segment pointing right to point up the page
+static void TestRotate( int nCount, int nUp )
+{
+	const LINEAR_ROTATION rotation = CLinearBatch::GetRotation( 90 );
+	CLinearBatch uniform = CreateBatch( nCount, nUp );
+	CLinearBatch array = uniform;
+	const CLinearBatch before = uniform;
+	const vector<LINEAR_ROTATION> rotations( nCount, rotation );
+
+	uniform.RotateAroundFirstPoint( rotation );
+	array.RotateAroundFirstPoint( rotations.data() );
+	CHECK( IsSame( uniform, array ) );
+
+	for ( int n = 0; n < nCount; n++ )
+	{
+		const double dRun = before.GetX2( n ) - before.GetX1( n );
+		const double dRise = before.GetY2( n ) - before.GetY1( n );
+		const double dNewRun = uniform.GetX2( n ) - uniform.GetX1( n );
+		const double dNewRise = uniform.GetY2( n ) - uniform.GetY1( n );
+		CHECK_NEAR( dNewRun, -nUp * dRise, 1e-6 );
+		CHECK_NEAR( dNewRise, nUp * dRun, 1e-6 );
+	}
+
+} // TestRotate
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	for ( int nCount = 0; nCount <= 7; nCount++ )
+	{
+		TestSetLength( nCount );
+		TestRotate( nCount, -1 );
+		TestRotate( nCount, 1 );
+	}
+
+	return GetTestResult( "LinearBatchTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Checks that the geometry UpdateMoonVectors works out for each frame
+// does not touch the heap once CMoonVectors is constructed, which the
+// ASSERT on CAllocationCounter in UpdateMoonVectors only checks in debug
+// builds of the application. The global operator new of this test counts
+// the allocations of the calling thread.
+#include "MoonVectors.h"
+#include "TestCheck.h"
+#include <cstdlib>
+#include <new>
+
+// frames driven through the vectors
+static const int FRAMES = 10000;
+
+/////////////////////////////////////////////////////////////////////////////
+// number of allocations the calling thread has made
+static long& GetAllocations()
+{
+	static thread_local long nCount = 0;
+	return nCount;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// count the allocation and pass it on to malloc
+void* operator new( size_t nSize )
+{
+	GetAllocations()++;
+	void* pMemory = malloc( nSize == 0 ? 1 : nSize );
+	if ( pMemory == nullptr )
+	{
+		throw bad_alloc();
+	}
+	return pMemory;
+
+} // operator new
+
+/////////////////////////////////////////////////////////////////////////////
+// count the allocation and pass it on to malloc
+void* operator new[]( size_t nSize )
+{
+	return operator new( nSize );
+
+} // operator new[]
+
+/////////////////////////////////////////////////////////////////////////////
+void operator delete( void* pMemory ) noexcept
+{
+	free( pMemory );
+
+} // operator delete
+
+/////////////////////////////////////////////////////////////////////////////
+void operator delete[]( void* pMemory ) noexcept
+{
+	free( pMemory );
+
+} // operator delete[]
+
+/////////////////////////////////////////////////////////////////////////////
+void operator delete( void* pMemory, size_t ) noexcept
+{
+	free( pMemory );
+
+} // operator delete
+
+/////////////////////////////////////////////////////////////////////////////
+void operator delete[]( void* pMemory, size_t ) noexcept
+{
+	free( pMemory );
+
+} // operator delete[]
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	// the allocations of construction are counted, so the check below
+	// would catch a counter that saw nothing
+	const long nBefore = GetAllocations();
+	CMoonVectors vectors;
+	vectors.SetUpIncrement( -1 );
+	CHECK( GetAllocations() > nBefore );
+
+	// a moon going around the earth at the center of a letter page in
+	// thousandths of an inch, with the lengths the view gives the vectors
+	const long nStart = GetAllocations();
+	double dSum = 0;
+	for ( int nFrame = 0; nFrame < FRAMES; nFrame++ )
+	{
+		const double dOrbit = nFrame * 0.01;
+		vectors.Update
+		(
+			5500 + 4000 * cos( dOrbit ), -4250 - 4000 * sin( dOrbit ),
+			5500, -4250, 2000, 1000, 100, 15
+		);
+		dSum += vectors.GetPositiveArrowheads().GetX2( nFrame % 9 );
+	}
+	const long nAllocations = GetAllocations() - nStart;
+	printf
+	(
+		"%d frames, %ld allocations (sum %g)\n", FRAMES, nAllocations, dSum
+	);
+	CHECK( nAllocations == 0 );
+
+	return GetTestResult( "MoonVectorsAllocationTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
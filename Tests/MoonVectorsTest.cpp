@@ -0,0 +1,128 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Checks the geometry CMoonVectors builds for a frame against the way
+// CLunarOrbitView::UpdateMoonVectors built it one CLinear at a time.
+#include "MoonVectors.h"
+#include "TestCheck.h"
+
+// the largest difference allowed in logical units
+static const double TOLERANCE = 1e-6;
+
+// the center of the earth on the page in logical units
+static const double EARTH_X = 5500;
+static const double EARTH_Y = -4250;
+
+// lengths of the gravity, velocity and arrowhead in logical units
+static const double GRAVITY_LENGTH = 2000;
+static const double VELOCITY_LENGTH = 1000;
+static const double ARROWHEAD_LENGTH = 100;
+static const double ARROWHEAD_ANGLE = 15;
+
+/////////////////////////////////////////////////////////////////////////////
+// the length of a segment of the batch
+static double GetLength( const CLinearBatch& batch, int nSegment )
+{
+	return hypot
+	(
+		batch.GetX2( nSegment ) - batch.GetX1( nSegment ),
+		batch.GetY2( nSegment ) - batch.GetY1( nSegment )
+	);
+
+} // GetLength
+
+/////////////////////////////////////////////////////////////////////////////
+// check the vectors of the moon at the given position
+static void TestFrame( CMoonVectors& vectors, double dMoonX, double dMoonY )
+{
+	vectors.Update
+	(
+		dMoonX, dMoonY, EARTH_X, EARTH_Y, GRAVITY_LENGTH, VELOCITY_LENGTH,
+		ARROWHEAD_LENGTH, ARROWHEAD_ANGLE
+	);
+	const CLinearBatch& batch = vectors.GetVectors();
+	CHECK( batch.GetCount() == CMoonVectors::MOON_VECTORS );
+
+	// every vector starts at the moon
+	for ( int n = 0; n < CMoonVectors::MOON_VECTORS; n++ )
+	{
+		CHECK_NEAR( batch.GetX1( n ), dMoonX, TOLERANCE );
+		CHECK_NEAR( batch.GetY1( n ), dMoonY, TOLERANCE );
+	}
+
+	// the distance ends at the earth
+	const int nDistance = CMoonVectors::MOON_DISTANCE;
+	CHECK_NEAR( batch.GetX2( nDistance ), EARTH_X, TOLERANCE );
+	CHECK_NEAR( batch.GetY2( nDistance ), EARTH_Y, TOLERANCE );
+
+	// gravity points at the earth with its own length
+	const double dDistance = hypot( EARTH_X - dMoonX, EARTH_Y - dMoonY );
+	const double dUnitX = ( EARTH_X - dMoonX ) / dDistance;
+	const double dUnitY = ( EARTH_Y - dMoonY ) / dDistance;
+	const int nGravity = CMoonVectors::MOON_GRAVITY;
+	CHECK_NEAR
+	(
+		batch.GetX2( nGravity ), dMoonX + GRAVITY_LENGTH * dUnitX, TOLERANCE
+	);
+	CHECK_NEAR
+	(
+		batch.GetY2( nGravity ), dMoonY + GRAVITY_LENGTH * dUnitY, TOLERANCE
+	);
+
+	// the velocity is gravity turned 90 degrees clockwise on a device
+	// context where moving up is negative
+	const int nVelocity = CMoonVectors::MOON_VELOCITY;
+	CHECK_NEAR
+	(
+		batch.GetX2( nVelocity ), dMoonX - VELOCITY_LENGTH * dUnitY, TOLERANCE
+	);
+	CHECK_NEAR
+	(
+		batch.GetY2( nVelocity ), dMoonY + VELOCITY_LENGTH * dUnitX, TOLERANCE
+	);
+
+	// the components run along the X and Y axes of their vectors
+	for ( int n = 0; n < CMoonVectors::MOON_VECTORS; n += 3 )
+	{
+		CHECK_NEAR( batch.GetX2( n + 1 ), batch.GetX2( n ), TOLERANCE );
+		CHECK_NEAR( batch.GetY2( n + 1 ), dMoonY, TOLERANCE );
+		CHECK_NEAR( batch.GetX2( n + 2 ), dMoonX, TOLERANCE );
+		CHECK_NEAR( batch.GetY2( n + 2 ), batch.GetY2( n ), TOLERANCE );
+	}
+
+	// the sides of each arrowhead start at the end of the vector and have
+	// the length of the arrowhead
+	const CLinearBatch& positive = vectors.GetPositiveArrowheads();
+	const CLinearBatch& negative = vectors.GetNegativeArrowheads();
+	CHECK( positive.GetCount() == CMoonVectors::MOON_VECTORS );
+	CHECK( negative.GetCount() == CMoonVectors::MOON_VECTORS );
+	for ( int n = 0; n < CMoonVectors::MOON_VECTORS; n++ )
+	{
+		CHECK_NEAR( positive.GetX1( n ), batch.GetX2( n ), TOLERANCE );
+		CHECK_NEAR( negative.GetY1( n ), batch.GetY2( n ), TOLERANCE );
+		CHECK_NEAR( GetLength( positive, n ), ARROWHEAD_LENGTH, TOLERANCE );
+		CHECK_NEAR( GetLength( negative, n ), ARROWHEAD_LENGTH, TOLERANCE );
+	}
+
+} // TestFrame
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	CMoonVectors vectors;
+	vectors.SetUpIncrement( -1 );
+	for ( int nFrame = 0; nFrame < 360; nFrame++ )
+	{
+		const double dOrbit = nFrame * 3.14159265358979 / 180;
+		TestFrame
+		(
+			vectors, EARTH_X + 4000 * cos( dOrbit ),
+			EARTH_Y - 4000 * sin( dOrbit )
+		);
+	}
+
+	return GetTestResult( "MoonVectorsTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
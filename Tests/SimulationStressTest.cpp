@@ -0,0 +1,136 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Runs CSimulation with a ring of a few positions while this thread takes
+// snapshots at random intervals, some long enough for the ring to replace
+// positions that were not taken. Every snapshot must hold exactly the
+// state a serial CPropagator run has at the end of its batch, the batch
+// of the snapshots must never go backwards, and the positions taken must
+// be those of increasing batches ending at the batch of the snapshot. The
+// test is meant to be run in a build with ThreadSanitizer as well, which
+// is configured with -DLUNARORBIT_TSAN=ON.
+#include "Simulation.h"
+#include "TestCheck.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace std;
+using namespace std::chrono;
+
+// number of positions the ring of the simulation holds
+static const int POSITION_CAPACITY = 16;
+
+// time slices in a batch
+static const int BATCH_STEPS = 3;
+
+// batches of the serial run, which the simulation is stopped before
+static const int BATCHES = 200000;
+
+// simulated seconds in a second of wall time, which runs the batches in
+// about a second
+static const double TIME_WARP = 60.0 * BATCH_STEPS * BATCHES;
+
+// most seconds the snapshots are taken for
+static const double SECONDS = 1.5;
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	LUNAR_PARAMETERS params = LUNAR_PARAMETERS();
+	params.dGravityRatio = 0.0027 / 3.844e8;
+	params.dSampleTime = 60;
+	params.dMoonScaling = 3.844e8 / 3;
+	params.nMap = 1000;
+	const LUNAR_STATE start = { -3.844e8, 0, 0, 1018.0, -0.0027, 0, 0 };
+
+	// the state at the end of every batch run serially
+	vector<LUNAR_STATE> serial( BATCHES );
+	LUNAR_STATE state = start;
+	for ( int nBatch = 0; nBatch < BATCHES; nBatch++ )
+	{
+		CPropagator::Propagate
+		(
+			INTEGRATOR_RK4, state, params, BATCH_STEPS, false, false
+		);
+		serial[ nBatch ] = state;
+	}
+
+	CSimulation simulation;
+	simulation.SetPositionCapacity( POSITION_CAPACITY );
+	simulation.SetTimeWarp( TIME_WARP );
+	simulation.Start( start, params, INTEGRATOR_RK4, BATCH_STEPS );
+
+	vector<SIMULATION_POSITION> positions;
+	mt19937 random( 1 );
+	long long nLastBatch = 0;
+	long long nSnapshots = 0;
+	long long nTaken = 0;
+	long long nReplaced = 0;
+	const steady_clock::time_point begin = steady_clock::now();
+	while ( duration<double>( steady_clock::now() - begin ).count() < SECONDS )
+	{
+		const SIMULATION_SNAPSHOT& snapshot =
+			simulation.TakeSnapshot( positions );
+		const long long nBatch = snapshot.nBatch;
+		if ( nBatch >= BATCHES )
+		{
+			break;
+		}
+		nSnapshots++;
+
+		// the snapshot is whole and never older than the one before
+		CHECK( nBatch >= nLastBatch );
+		if ( nBatch > 0 )
+		{
+			const LUNAR_STATE& expected = serial[ nBatch - 1 ];
+			CHECK
+			(
+				memcmp( &snapshot.state, &expected, sizeof( expected ) ) == 0
+			);
+		}
+
+		// The positions are of increasing batches after those taken
+		// before, where the ring may have replaced some of them, and the
+		// last one is the batch of the snapshot.
+		long long nPosition = nLastBatch - 1;
+		for ( const SIMULATION_POSITION& position : positions )
+		{
+			long long nNext = nPosition + 1;
+			while
+			(
+				nNext < nBatch && ( serial[ nNext ].dX != position.dX ||
+				serial[ nNext ].dY != position.dY )
+			)
+			{
+				nNext++;
+			}
+			CHECK( nNext < nBatch );
+			nReplaced += nNext - nPosition - 1;
+			nPosition = nNext;
+		}
+		CHECK( positions.empty() || nPosition == nBatch - 1 );
+		CHECK( (int)positions.size() <= POSITION_CAPACITY );
+		nTaken += positions.size();
+		nLastBatch = nBatch;
+
+		// now and then the user interface is too slow for the ring
+		const int nWait =
+			random() % 64 == 0 ? 2000 : int( random() % 200 );
+		this_thread::sleep_for( microseconds( nWait ) );
+	}
+	simulation.Stop();
+
+	printf
+	(
+		"%lld snapshots, %lld positions taken, %lld replaced, %lld batches\n",
+		nSnapshots, nTaken, nReplaced, nLastBatch
+	);
+	CHECK( nSnapshots > 10 );
+	CHECK( nTaken > 0 );
+
+	return GetTestResult( "SimulationStressTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
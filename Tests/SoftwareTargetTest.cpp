@@ -0,0 +1,202 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Draws a known display list with CSoftwareTarget and checks selected
+// pixels of each kind of command, and that text is drawn with the glyphs
+// of CGlyphAtlas in their character cells.
+#include "GlyphAtlas.h"
+#include "SoftwareTarget.h"
+#include "TestCheck.h"
+
+// size of the layer in pixels, which is one pixel per logical unit
+static const int LAYER_WIDTH = 240;
+static const int LAYER_HEIGHT = 120;
+
+// The height of the test font, which gives character cells of 3 by 5
+// pixels, so every dot of a glyph covers whole pixels.
+static const int FONT_HEIGHT = 45;
+static const int CELL_WIDTH = 3;
+static const int CELL_HEIGHT = 5;
+
+// where the text is drawn
+static const long TEXT_X = 10;
+static const long TEXT_Y = 60;
+
+/////////////////////////////////////////////////////////////////////////////
+// the pixels of the colors used
+static const LAYER_PIXEL WHITE =
+	CSoftwareTarget::GetLayerPixel( DisplayColor( 255, 255, 255 ) );
+static const LAYER_PIXEL RED =
+	CSoftwareTarget::GetLayerPixel( DisplayColor( 255, 0, 0 ) );
+static const LAYER_PIXEL GREEN =
+	CSoftwareTarget::GetLayerPixel( DisplayColor( 0, 255, 0 ) );
+static const LAYER_PIXEL BLUE =
+	CSoftwareTarget::GetLayerPixel( DisplayColor( 0, 0, 255 ) );
+static const LAYER_PIXEL BLACK =
+	CSoftwareTarget::GetLayerPixel( DisplayColor( 0, 0, 0 ) );
+static const LAYER_PIXEL YELLOW =
+	CSoftwareTarget::GetLayerPixel( DisplayColor( 255, 255, 0 ) );
+
+/////////////////////////////////////////////////////////////////////////////
+// true if every pixel of the character cell at the given position in the
+// text matches the glyph of the character, where the dots of the glyph
+// are the text color and the rest of the cell is the background
+static bool IsGlyphDrawn
+(
+	const CPixelLayer& layer, wchar_t ch, int nCharacter,
+	LAYER_PIXEL pixelText, LAYER_PIXEL pixelBack
+)
+{
+	const unsigned char* pGlyph = CGlyphAtlas::GetGlyph( ch );
+	const long nCellLeft =
+		TEXT_X + nCharacter * CGlyphAtlas::CELL_COLUMNS * CELL_WIDTH;
+	for ( int nRow = 0; nRow < CGlyphAtlas::CELL_ROWS; nRow++ )
+	{
+		for ( int nColumn = 0; nColumn < CGlyphAtlas::CELL_COLUMNS; nColumn++ )
+		{
+			// the pixel in the middle of the dot
+			const int nX = nCellLeft + nColumn * CELL_WIDTH + CELL_WIDTH / 2;
+			const int nY = TEXT_Y + nRow * CELL_HEIGHT + CELL_HEIGHT / 2;
+			const bool bSet = CGlyphAtlas::IsSet
+			(
+				pGlyph, nColumn, nRow - CGlyphAtlas::GLYPH_TOP
+			);
+			const LAYER_PIXEL expected = bSet ? pixelText : pixelBack;
+			if ( layer.GetPixel( nX, nY ) != expected )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+
+} // IsGlyphDrawn
+
+/////////////////////////////////////////////////////////////////////////////
+// the glyphs of the atlas
+static void TestAtlas()
+{
+	// the rows of the letter A from the top
+	const unsigned char letterA[ CGlyphAtlas::GLYPH_ROWS ] =
+	{
+		0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11
+	};
+	const unsigned char* pGlyph = CGlyphAtlas::GetGlyph( L'A' );
+	for ( int nRow = 0; nRow < CGlyphAtlas::GLYPH_ROWS; nRow++ )
+	{
+		CHECK( pGlyph[ nRow ] == letterA[ nRow ] );
+	}
+	CHECK( !CGlyphAtlas::IsSet( pGlyph, 0, 0 ) );
+	CHECK( CGlyphAtlas::IsSet( pGlyph, 1, 0 ) );
+	CHECK( CGlyphAtlas::IsSet( pGlyph, 4, 3 ) );
+	CHECK( !CGlyphAtlas::IsSet( pGlyph, -1, 3 ) );
+	CHECK( !CGlyphAtlas::IsSet( pGlyph, 5, 3 ) );
+	CHECK( !CGlyphAtlas::IsSet( pGlyph, 0, 7 ) );
+
+	// a space is blank
+	const unsigned char* pSpace = CGlyphAtlas::GetGlyph( L' ' );
+	for ( int nRow = 0; nRow < CGlyphAtlas::GLYPH_ROWS; nRow++ )
+	{
+		CHECK( pSpace[ nRow ] == 0 );
+	}
+
+	// the Latin-1 characters the view draws have their own glyphs and
+	// every other character is the same box
+	const unsigned char* pMissing = CGlyphAtlas::GetGlyph( L'\x2603' );
+	CHECK( CGlyphAtlas::GetGlyph( L'\x4e00' ) == pMissing );
+	CHECK( CGlyphAtlas::GetGlyph( L'\x00b0' ) != pMissing );
+	CHECK( CGlyphAtlas::GetGlyph( L'\x00ba' ) != pMissing );
+	CHECK( CGlyphAtlas::GetGlyph( L'\x00b2' ) != pMissing );
+	CHECK( CGlyphAtlas::GetGlyph( L'\x00bd' ) != pMissing );
+	CHECK( CGlyphAtlas::GetGlyph( L'~' ) != pMissing );
+
+} // TestAtlas
+
+/////////////////////////////////////////////////////////////////////////////
+// draw a line, a polygon, an ellipse and text and check their pixels
+static void TestDraw()
+{
+	CDisplayStyles styles;
+	const int nRedPen =
+		styles.AddPen( DISPLAY_PEN_SOLID, 3, DisplayColor( 255, 0, 0 ) );
+	const int nBlackPen = styles.AddPen( DISPLAY_PEN_SOLID, 1, 0 );
+	const int nBlue = styles.AddBrush( DisplayColor( 0, 0, 255 ) );
+	const int nGreen = styles.AddBrush( DisplayColor( 0, 255, 0 ) );
+	const int nFont = styles.AddFont( L"Arial", FONT_HEIGHT );
+
+	CDisplayList list;
+	list.Line( nRedPen, 10, 10, 50, 10 );
+	const DISPLAY_POINT square[ 4 ] =
+	{
+		{ 60, 10 }, { 100, 10 }, { 100, 50 }, { 60, 50 }
+	};
+	list.Polygon( nBlackPen, nBlue, square, 4 );
+	list.Ellipse( nBlackPen, nGreen, 120, 10, 160, 50 );
+	const wchar_t* pText = L"A\x00b0" L"1\x2603";
+	list.Text
+	(
+		nFont, 0, DISPLAY_ALIGN_LEFT | DISPLAY_ALIGN_TOP,
+		DisplayColor( 255, 0, 0 ), TEXT_X, TEXT_Y, pText
+	);
+	list.Text
+	(
+		nFont, 0, DISPLAY_ALIGN_LEFT | DISPLAY_ALIGN_TOP | DISPLAY_ALIGN_OPAQUE,
+		0, 170, 60, L"B"
+	);
+
+	CPixelLayer layer;
+	layer.Resize( LAYER_WIDTH, LAYER_HEIGHT );
+	layer.Fill( WHITE );
+	CSoftwareTarget target( styles );
+	target.SetBackColor( DisplayColor( 255, 255, 0 ) );
+	target.SetMapping( 0, 0, LAYER_WIDTH, LAYER_WIDTH );
+	CHECK( target.GetScale() == 1 );
+	target.Draw( layer, list );
+
+	// the line is three pixels thick
+	CHECK( layer.GetPixel( 30, 9 ) == RED );
+	CHECK( layer.GetPixel( 30, 10 ) == RED );
+	CHECK( layer.GetPixel( 30, 11 ) == RED );
+	CHECK( layer.GetPixel( 30, 14 ) == WHITE );
+	CHECK( layer.GetPixel( 55, 10 ) == WHITE );
+
+	// the polygon is filled and outlined
+	CHECK( layer.GetPixel( 80, 30 ) == BLUE );
+	CHECK( layer.GetPixel( 80, 10 ) == BLACK );
+	CHECK( layer.GetPixel( 105, 30 ) == WHITE );
+
+	// the ellipse is filled inside its rectangle but not in the corners
+	CHECK( layer.GetPixel( 140, 30 ) == GREEN );
+	CHECK( layer.GetPixel( 122, 12 ) == WHITE );
+	CHECK( layer.GetPixel( 158, 48 ) == WHITE );
+
+	// each character is drawn with its glyph in its cell and the
+	// transparent text leaves the background alone
+	for ( int nCharacter = 0; nCharacter < 4; nCharacter++ )
+	{
+		CHECK
+		(
+			IsGlyphDrawn( layer, pText[ nCharacter ], nCharacter, RED, WHITE )
+		);
+	}
+
+	// the opaque text fills its cell with the back color
+	CHECK( layer.GetPixel( 170, 61 ) == YELLOW );
+	CHECK( layer.GetPixel( 170 + CELL_WIDTH, 66 ) == BLACK );
+
+	// nothing is drawn below the text
+	CHECK( layer.GetPixel( 20, LAYER_HEIGHT - 2 ) == WHITE );
+
+} // TestDraw
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	TestAtlas();
+	TestDraw();
+
+	return GetTestResult( "SoftwareTargetTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,45 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cmath>
+#include <cstdio>
+
+/////////////////////////////////////////////////////////////////////////////
+// The checks of the unit tests, which report each failure with its file
+// and line and count them so main can return the count as its exit code,
+// where any exit code other than zero fails the test under ctest.
+inline int& GetTestFailures()
+{
+	static int nFailures = 0;
+	return nFailures;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// report a failed check
+inline void ReportTestFailure( const char* pFile, int nLine, const char* pText )
+{
+	printf( "%s(%d): check failed: %s\n", pFile, nLine, pText );
+	GetTestFailures()++;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// fail the test if the expression is false
+#define CHECK( expression ) \
+	( ( expression ) ? (void)0 : \
+		ReportTestFailure( __FILE__, __LINE__, #expression ) )
+
+// fail the test if two values are further apart than the tolerance
+#define CHECK_NEAR( a, b, tolerance ) \
+	CHECK( fabs( double( a ) - double( b ) ) <= ( tolerance ) )
+
+/////////////////////////////////////////////////////////////////////////////
+// the exit code of a test, which is the number of failed checks
+inline int GetTestResult( const char* pName )
+{
+	const int nFailures = GetTestFailures();
+	printf( "%s: %d failed checks\n", pName, nFailures );
+	return nFailures;
+}
+
+/////////////////////////////////////////////////////////////////////////////
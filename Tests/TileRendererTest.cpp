@@ -0,0 +1,98 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Checks that CTileRenderer draws a page byte for byte the same as
+// CSoftwareTarget drawing the whole list in one piece, for several tile
+// sizes and numbers of threads, with and without erasing the tiles and
+// with the page scrolled.
+#include "PageScene.h"
+#include "TileRenderer.h"
+#include "TestCheck.h"
+#include <cstring>
+
+// width of the layers in pixels, which is the page at 100 dots per inch
+static const int LAYER_WIDTH = 1100;
+
+// points of the trail of the moon, enough to be cut into runs
+static const int TRAIL_POINTS = 2000;
+
+/////////////////////////////////////////////////////////////////////////////
+// true if the two layers have the same size and bytes
+static bool IsSame( const CPixelLayer& one, const CPixelLayer& two )
+{
+	return
+		one.GetWidth() == two.GetWidth() &&
+		one.GetHeight() == two.GetHeight() &&
+		memcmp
+		(
+			one.GetPixels(), two.GetPixels(),
+			size_t( one.GetWidth() ) * one.GetHeight() * sizeof( LAYER_PIXEL )
+		) == 0;
+
+} // IsSame
+
+/////////////////////////////////////////////////////////////////////////////
+// draw the page both ways with the given scroll position
+static void TestPage
+(
+	const CDisplayStyles& styles, const CDisplayList& list, long nLeft,
+	long nTop
+)
+{
+	const int nHeight = LAYER_WIDTH * PAGE_HEIGHT / PAGE_WIDTH;
+	const DISPLAY_COLOR colorBack = DisplayColor( 250, 245, 230 );
+
+	CPixelLayer serial;
+	serial.Resize( LAYER_WIDTH, nHeight );
+	serial.Fill( CSoftwareTarget::GetLayerPixel( colorBack ) );
+	CSoftwareTarget target( styles );
+	target.SetBackColor( colorBack );
+	target.SetMapping( nLeft, nTop, PAGE_WIDTH, LAYER_WIDTH );
+	target.Draw( serial, list );
+
+	const int tileSizes[] = { 16, 64, 100, 128, 4096 };
+	const int threads[] = { 1, 2, 3, 0 };
+	for ( const int nTileSize : tileSizes )
+	{
+		for ( const int nThreads : threads )
+		{
+			CTileRenderer renderer( styles );
+			renderer.SetMapping( nLeft, nTop, PAGE_WIDTH, LAYER_WIDTH );
+			renderer.SetTileSize( nTileSize );
+			renderer.SetThreads( nThreads );
+			renderer.SetBackColor( colorBack );
+
+			// erased tiles cover whatever was in the layer
+			CPixelLayer tiled;
+			tiled.Resize( LAYER_WIDTH, nHeight );
+			tiled.Fill( 0x12345678 );
+			renderer.Draw( tiled, list );
+			CHECK( IsSame( serial, tiled ) );
+			CHECK( renderer.GetTileCount() > 0 );
+
+			// tiles drawn over the background without erasing
+			renderer.SetErase( false );
+			tiled.Fill( CSoftwareTarget::GetLayerPixel( colorBack ) );
+			renderer.Draw( tiled, list );
+			CHECK( IsSame( serial, tiled ) );
+		}
+	}
+
+} // TestPage
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	CDisplayStyles styles;
+	CDisplayList list;
+	RecordPage( list, styles, TRAIL_POINTS );
+
+	TestPage( styles, list, 0, 0 );
+	TestPage( styles, list, 1234, 567 );
+	TestPage( styles, list, -300, -200 );
+
+	return GetTestResult( "TileRendererTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
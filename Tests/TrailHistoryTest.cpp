@@ -0,0 +1,290 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Checks that CTrailHistory decodes every sample it holds to within half
+// of the resolution of where it was added, with chunks of changes, wide
+// chunks and chunks closed by long steps, that the SSE2 decoding and
+// projection give exactly what the scalar ones give, and that a history
+// read back from a checkpoint decodes and goes on adding the same as the
+// history written. Projection with SSE2 is only done where DISPLAY_POINT
+// is a pair of 32 bit integers, as it is on Windows.
+#include "TrailHistory.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+// least number of samples held
+static const int CAPACITY = 5000;
+
+// samples added, enough to go around the ring twice
+static const int SAMPLES = 12345;
+
+// meters a sample is rounded to
+static const double RESOLUTION = 1000;
+
+/////////////////////////////////////////////////////////////////////////////
+// A position of the moon along an orbit of about 27 days sampled every
+// hour, with stretches where it zigzags too much for changes of step, as
+// wide chunks are needed close to the earth, and jumps too long for 16
+// bit steps.
+static void GetSample( int nSample, double& dX, double& dY )
+{
+	const double dAngle = 6.283185307 * nSample / 655.7;
+	dX = -3.844e8 * cos( dAngle ) + nSample * 37.0;
+	dY = 3.844e8 * sin( dAngle ) - nSample * 11.0;
+	if ( nSample % 3000 < 300 )
+	{
+		dX += ( nSample % 2 ) * 4e5;
+		dY -= ( nSample % 3 ) * 2e5;
+	}
+	if ( nSample % 997 == 0 )
+	{
+		dX += 5e7;
+	}
+
+} // GetSample
+
+/////////////////////////////////////////////////////////////////////////////
+// the history with its protected decoding and projection exposed
+class CTestHistory : public CTrailHistory
+{
+	// public methods
+public:
+	// number of chunks in use with the given bytes a sample
+	int GetChunkCount( int nSampleBytes ) const
+	{
+		int nChunks = 0;
+		for ( int nChunk = 0; nChunk < m_nChunks; nChunk++ )
+		{
+			const TRAIL_CHUNK& chunk = m_Chunks[ GetChunkIndex( nChunk ) ];
+			nChunks += chunk.nSampleBytes == nSampleBytes ? 1 : 0;
+		}
+		return nChunks;
+	}
+
+	// the meters of every chunk in use decode the same both ways
+	void CheckChunks() const
+	{
+		double dX[ CHUNK_SAMPLES ];
+		double dY[ CHUNK_SAMPLES ];
+		double dScalarX[ CHUNK_SAMPLES ];
+		double dScalarY[ CHUNK_SAMPLES ];
+		for ( int nChunk = 0; nChunk < m_nChunks; nChunk++ )
+		{
+			const int nIndex = GetChunkIndex( nChunk );
+			const size_t nBytes = m_Chunks[ nIndex ].nCount * sizeof( double );
+			DecodeChunk( nIndex, dX, dY );
+			DecodeChunkScalar( nIndex, dScalarX, dScalarY );
+			CHECK( memcmp( dX, dScalarX, nBytes ) == 0 );
+			CHECK( memcmp( dY, dScalarY, nBytes ) == 0 );
+		}
+	}
+
+	// the given meters project the same both ways
+	static void CheckProject
+	(
+		const TRAIL_PROJECTION& projection, const double* pX,
+		const double* pY, int nCount
+	)
+	{
+		vector<DISPLAY_POINT> points( nCount + 1 );
+		vector<DISPLAY_POINT> scalar( nCount + 1 );
+		Project( projection, pX, pY, nCount, points.data() );
+		ProjectScalar( projection, pX, pY, nCount, scalar.data() );
+		for ( int n = 0; n < nCount; n++ )
+		{
+			CHECK( points[ n ].x == scalar[ n ].x );
+			CHECK( points[ n ].y == scalar[ n ].y );
+		}
+	}
+
+	// project the given meters one at a time
+	static void ProjectEach
+	(
+		const TRAIL_PROJECTION& projection, const double* pX,
+		const double* pY, int nCount, DISPLAY_POINT* pPoints
+	)
+	{
+		ProjectScalar( projection, pX, pY, nCount, pPoints );
+	}
+
+	// public construction
+public:
+	CTestHistory( int nCapacity = 0 ) : CTrailHistory( nCapacity )
+	{
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// add the given samples to the history
+static void AddSamples( CTrailHistory& history, int nFirst, int nCount )
+{
+	for ( int nSample = nFirst; nSample < nFirst + nCount; nSample++ )
+	{
+		double dX = 0;
+		double dY = 0;
+		GetSample( nSample, dX, dY );
+		history.Add( dX, dY );
+	}
+
+} // AddSamples
+
+/////////////////////////////////////////////////////////////////////////////
+// true if the two histories decode the same samples
+static bool IsSame( const CTrailHistory& one, const CTrailHistory& two )
+{
+	const int nCount = one.GetCount();
+	if ( two.GetCount() != nCount || two.GetTotal() != one.GetTotal() )
+	{
+		return false;
+	}
+
+	vector<double> oneX( nCount );
+	vector<double> oneY( nCount );
+	vector<double> twoX( nCount );
+	vector<double> twoY( nCount );
+	one.Decode( 0, nCount, oneX.data(), oneY.data() );
+	two.Decode( 0, nCount, twoX.data(), twoY.data() );
+	return oneX == twoX && oneY == twoY;
+
+} // IsSame
+
+/////////////////////////////////////////////////////////////////////////////
+// every sample held decodes to where it was added and both ways of
+// decoding and projecting agree
+static void TestDecode()
+{
+	CTestHistory history( CAPACITY );
+	history.SetResolution( RESOLUTION );
+	AddSamples( history, 0, SAMPLES );
+
+	// the zigzags and jumps close chunks early, so the ring holds less
+	// than its capacity
+	const int nCount = history.GetCount();
+	CHECK( history.GetTotal() == SAMPLES );
+	CHECK( nCount > CAPACITY / 2 && nCount <= history.GetMaxCount() );
+	CHECK( history.GetChunkCount( 2 ) > 0 );
+	CHECK( history.GetChunkCount( 4 ) > 0 );
+	history.CheckChunks();
+
+	vector<double> dX( nCount );
+	vector<double> dY( nCount );
+	history.Decode( 0, nCount, dX.data(), dY.data() );
+	const int nFirst = int( history.GetFirstSample() );
+	for ( int n = 0; n < nCount; n++ )
+	{
+		double dSampleX = 0;
+		double dSampleY = 0;
+		GetSample( nFirst + n, dSampleX, dSampleY );
+		CHECK_NEAR( dX[ n ], dSampleX, RESOLUTION / 2 );
+		CHECK_NEAR( dY[ n ], dSampleY, RESOLUTION / 2 );
+	}
+
+	// part of the samples starting in the middle of a chunk
+	const int nPart = 701;
+	vector<double> dPartX( nPart );
+	vector<double> dPartY( nPart );
+	history.Decode( 333, nPart, dPartX.data(), dPartY.data() );
+	CHECK( equal( dPartX.begin(), dPartX.end(), dX.begin() + 333 ) );
+	CHECK( equal( dPartY.begin(), dPartY.end(), dY.begin() + 333 ) );
+
+	// counts that leave a sample for the scalar tail after the pairs
+	const TRAIL_PROJECTION projection = { 5500, 4250, 3.844e8 / 3, 1000 };
+	const int counts[] = { 0, 1, 2, 3, 7, 255, nCount };
+	for ( const int nProject : counts )
+	{
+		CTestHistory::CheckProject
+		(
+			projection, dX.data(), dY.data(), nProject
+		);
+	}
+
+	// projecting a part a chunk at a time gives the same points
+	vector<DISPLAY_POINT> points( nPart );
+	vector<DISPLAY_POINT> scalar( nPart );
+	history.Project( projection, 333, nPart, points.data() );
+	CTestHistory::ProjectEach
+	(
+		projection, dPartX.data(), dPartY.data(), nPart, scalar.data()
+	);
+	for ( int n = 0; n < nPart; n++ )
+	{
+		CHECK( points[ n ].x == scalar[ n ].x );
+		CHECK( points[ n ].y == scalar[ n ].y );
+	}
+
+} // TestDecode
+
+/////////////////////////////////////////////////////////////////////////////
+// a history read back from its checkpoint is the same and goes on the same
+static void TestSaveLoad()
+{
+	CTestHistory history( CAPACITY );
+	history.SetResolution( RESOLUTION );
+	AddSamples( history, 0, SAMPLES );
+
+	CCheckpoint checkpoint;
+	history.Save( checkpoint );
+	checkpoint.SetSize( checkpoint.GetSize() );
+
+	CTestHistory loaded( 10 );
+	CHECK( loaded.Load( checkpoint ) );
+	CHECK( checkpoint.IsEnd() );
+	CHECK( loaded.GetCapacity() == CAPACITY );
+	CHECK( loaded.GetResolution() == RESOLUTION );
+	CHECK( loaded.GetFirstSample() == history.GetFirstSample() );
+	CHECK( IsSame( history, loaded ) );
+	loaded.CheckChunks();
+
+	// the newest chunk is filled in where it was left
+	AddSamples( history, SAMPLES, 3000 );
+	AddSamples( loaded, SAMPLES, 3000 );
+	CHECK( IsSame( history, loaded ) );
+
+	// a short checkpoint leaves the history unchanged
+	CCheckpoint shortened;
+	loaded.Save( shortened );
+	const size_t nSize = shortened.GetSize();
+	shortened.SetSize( nSize - 1 );
+	CTestHistory unchanged( 10 );
+	AddSamples( unchanged, 0, 7 );
+	CHECK( !unchanged.Load( shortened ) );
+	CHECK( unchanged.GetCapacity() == 10 );
+	CHECK( unchanged.GetTotal() == 7 );
+
+	// a chunk with a sample size that is neither changes nor steps fails
+	CCheckpoint corrupt;
+	loaded.Save( corrupt );
+	const size_t nSampleBytes =
+		sizeof( int ) + sizeof( double ) + sizeof( int ) +
+		sizeof( long long ) + offsetof( TRAIL_CHUNK, nSampleBytes );
+	corrupt.GetData()[ nSampleBytes ] = 3;
+	corrupt.SetSize( corrupt.GetSize() );
+	CHECK( !unchanged.Load( corrupt ) );
+	CHECK( unchanged.GetTotal() == 7 );
+
+	// an empty history is read back empty
+	CTestHistory empty( CAPACITY );
+	CCheckpoint blank;
+	empty.Save( blank );
+	blank.SetSize( blank.GetSize() );
+	CHECK( loaded.Load( blank ) );
+	CHECK( loaded.GetCount() == 0 && loaded.GetTotal() == 0 );
+
+} // TestSaveLoad
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	TestDecode();
+	TestSaveLoad();
+
+	return GetTestResult( "TrailHistoryTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,302 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Checks that CTrajectoryArchive gives back every time slice written by
+// CTrajectoryRecorder bit for bit, finds the state at the first time, at
+// the start and end of each block and between blocks, and refuses times
+// outside the recording. Copies of the file with a damaged block, a
+// damaged index entry, a damaged footer or missing bytes at the end must
+// fail to open or fail only the queries of the damaged block.
+#include "TrajectoryArchive.h"
+#include "TrajectoryRecorder.h"
+#include "TestCheck.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace std;
+
+// time slices recorded, which fill three blocks and part of a fourth
+static const int STEPS = 3 * CTrajectoryRecorder::BLOCK_STEPS + 1000;
+
+// the file recorded and the damaged copies, in the working directory
+static const char* RECORDING = "TrajectoryArchiveTest.lot";
+static const char* DAMAGED = "TrajectoryArchiveTest.damaged.lot";
+
+/////////////////////////////////////////////////////////////////////////////
+// keeps every state the propagator hands it
+class CStateList
+{
+	// public data
+public:
+	vector<LUNAR_STATE> m_States;
+
+	// public methods
+public:
+	void Record( const LUNAR_STATE& state )
+	{
+		m_States.push_back( state );
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// the bytes of the given file
+static vector<char> ReadFile( const char* pPath )
+{
+	ifstream file( pPath, ios::binary );
+	return vector<char>
+	(
+		( istreambuf_iterator<char>( file ) ), istreambuf_iterator<char>()
+	);
+
+} // ReadFile
+
+/////////////////////////////////////////////////////////////////////////////
+// replace the given file with the bytes
+static void WriteFile( const char* pPath, const vector<char>& bytes )
+{
+	ofstream file( pPath, ios::binary | ios::trunc );
+	file.write( bytes.data(), bytes.size() );
+
+} // WriteFile
+
+/////////////////////////////////////////////////////////////////////////////
+// true if the two states are the same bit for bit
+static bool IsSame( const LUNAR_STATE& one, const LUNAR_STATE& two )
+{
+	return memcmp( &one, &two, sizeof( LUNAR_STATE ) ) == 0;
+
+} // IsSame
+
+/////////////////////////////////////////////////////////////////////////////
+// the footer at the end of the bytes of a recording
+static TRAJECTORY_FOOTER GetFooter( const vector<char>& bytes )
+{
+	TRAJECTORY_FOOTER footer;
+	memcpy
+	(
+		&footer, bytes.data() + bytes.size() - sizeof( footer ),
+		sizeof( footer )
+	);
+	return footer;
+
+} // GetFooter
+
+/////////////////////////////////////////////////////////////////////////////
+// the index entry of the given block in the bytes of a recording
+static TRAJECTORY_INDEX GetIndex( const vector<char>& bytes, int nBlock )
+{
+	TRAJECTORY_INDEX index;
+	memcpy
+	(
+		&index,
+		bytes.data() + GetFooter( bytes ).nIndexOffset +
+			nBlock * sizeof( index ),
+		sizeof( index )
+	);
+	return index;
+
+} // GetIndex
+
+/////////////////////////////////////////////////////////////////////////////
+// every time slice is read back exactly, and the states at the ends of
+// the blocks and between them are found
+static void TestQueries( const vector<LUNAR_STATE>& states )
+{
+	CTrajectoryArchive archive;
+	CHECK( archive.Open( RECORDING ) );
+	CHECK( archive.GetBlocks() == 4 );
+	CHECK( archive.GetSteps() == STEPS );
+	CHECK( archive.GetFirstTime() == states.front().dTime );
+	CHECK( archive.GetLastTime() == states.back().dTime );
+
+	// every time slice in order and a few out of order
+	LUNAR_STATE state;
+	int nMismatches = 0;
+	for ( int nStep = 0; nStep < STEPS; nStep++ )
+	{
+		if
+		(
+			!archive.GetStep( nStep, state ) ||
+			!IsSame( state, states[ nStep ] )
+		)
+		{
+			nMismatches++;
+		}
+	}
+	CHECK( nMismatches == 0 );
+	for ( int nStep = STEPS - 1; nStep >= 0; nStep -= 997 )
+	{
+		CHECK( archive.GetStep( nStep, state ) );
+		CHECK( IsSame( state, states[ nStep ] ) );
+	}
+	CHECK( !archive.GetStep( -1, state ) );
+	CHECK( !archive.GetStep( STEPS, state ) );
+
+	// the first time, and the first and last time slice of each block
+	for ( long long nBlock = 0; nBlock < archive.GetBlocks(); nBlock++ )
+	{
+		const TRAJECTORY_INDEX index = archive.GetIndex( nBlock );
+		const int nFirst = int( index.nFirstStep );
+		const int nLast = nBlock + 1 < archive.GetBlocks() ?
+			int( archive.GetIndex( nBlock + 1 ).nFirstStep ) - 1 : STEPS - 1;
+		CHECK( archive.GetState( index.dFirstTime, state ) );
+		CHECK( IsSame( state, states[ nFirst ] ) );
+		CHECK( archive.GetState( index.dLastTime, state ) );
+		CHECK( IsSame( state, states[ nLast ] ) );
+	}
+
+	// between the last time slice of a block and the first of the next,
+	// which is the middle of the time slice
+	const int nLast = CTrajectoryRecorder::BLOCK_STEPS - 1;
+	const LUNAR_STATE& before = states[ nLast ];
+	const LUNAR_STATE& after = states[ nLast + 1 ];
+	const double dMiddle = ( before.dTime + after.dTime ) / 2;
+	CHECK( archive.GetState( dMiddle, state ) );
+	CHECK( state.dTime == dMiddle );
+	CHECK_NEAR( state.dX, ( before.dX + after.dX ) / 2, 1 );
+	CHECK_NEAR( state.dY, ( before.dY + after.dY ) / 2, 1 );
+	CHECK_NEAR( state.dVx, ( before.dVx + after.dVx ) / 2, 1e-3 );
+	CHECK_NEAR( state.dVy, ( before.dVy + after.dVy ) / 2, 1e-3 );
+
+	// before the first time slice and past the last one
+	CHECK( !archive.GetState( archive.GetFirstTime() - 0.5, state ) );
+	CHECK( !archive.GetState( archive.GetLastTime() + 0.5, state ) );
+
+	archive.Close();
+	CHECK( !archive.IsOpen() );
+	CHECK( !archive.GetStep( 0, state ) );
+
+} // TestQueries
+
+/////////////////////////////////////////////////////////////////////////////
+// damaged and truncated copies of the recording
+static void TestDamage()
+{
+	const vector<char> bytes = ReadFile( RECORDING );
+	CTrajectoryArchive archive;
+	LUNAR_STATE state;
+
+	// a byte of the encoding of the third block fails only that block
+	vector<char> damaged = bytes;
+	const TRAJECTORY_INDEX third = GetIndex( bytes, 2 );
+	damaged[ size_t( third.nOffset + sizeof( TRAJECTORY_BLOCK ) + 100 ) ] ^= 4;
+	WriteFile( DAMAGED, damaged );
+	CHECK( archive.Open( DAMAGED ) );
+	CHECK( archive.GetStep( 0, state ) );
+	CHECK( !archive.GetStep( third.nFirstStep, state ) );
+	CHECK( !archive.GetState( third.dFirstTime, state ) );
+	CHECK( archive.GetStep( STEPS - 1, state ) );
+
+	// an index entry that points at the wrong block fails that block
+	damaged = bytes;
+	const TRAJECTORY_FOOTER footer = GetFooter( bytes );
+	TRAJECTORY_INDEX index = GetIndex( bytes, 1 );
+	index.nOffset = GetIndex( bytes, 0 ).nOffset;
+	memcpy
+	(
+		damaged.data() + footer.nIndexOffset + sizeof( index ), &index,
+		sizeof( index )
+	);
+	WriteFile( DAMAGED, damaged );
+	CHECK( archive.Open( DAMAGED ) );
+	CHECK( archive.GetStep( 0, state ) );
+	CHECK( !archive.GetStep( index.nFirstStep, state ) );
+	CHECK( archive.GetStep( STEPS - 1, state ) );
+
+	// an index entry that points past the index
+	index.nOffset = footer.nIndexOffset + 8;
+	memcpy
+	(
+		damaged.data() + footer.nIndexOffset + sizeof( index ), &index,
+		sizeof( index )
+	);
+	WriteFile( DAMAGED, damaged );
+	CHECK( archive.Open( DAMAGED ) );
+	CHECK( !archive.GetStep( index.nFirstStep, state ) );
+
+	// a footer whose number of blocks does not fill the index
+	damaged = bytes;
+	TRAJECTORY_FOOTER wrong = footer;
+	wrong.nBlocks++;
+	memcpy
+	(
+		damaged.data() + damaged.size() - sizeof( wrong ), &wrong,
+		sizeof( wrong )
+	);
+	WriteFile( DAMAGED, damaged );
+	CHECK( !archive.Open( DAMAGED ) );
+	CHECK( !archive.IsOpen() );
+
+	// a damaged header
+	damaged = bytes;
+	damaged[ 0 ] ^= 1;
+	WriteFile( DAMAGED, damaged );
+	CHECK( !archive.Open( DAMAGED ) );
+
+	// a file cut short anywhere has no footer, as when the recorder was
+	// not closed
+	const size_t cuts[] =
+	{
+		1, sizeof( TRAJECTORY_FOOTER ), bytes.size() / 2,
+		bytes.size() - sizeof( TRAJECTORY_HEADER ), bytes.size()
+	};
+	for ( const size_t nCut : cuts )
+	{
+		damaged.assign( bytes.begin(), bytes.end() - nCut );
+		WriteFile( DAMAGED, damaged );
+		CHECK( !archive.Open( DAMAGED ) );
+	}
+
+	// a file that does not exist
+	remove( DAMAGED );
+	CHECK( !archive.Open( DAMAGED ) );
+
+	// the recording itself is still good
+	CHECK( archive.Open( RECORDING ) );
+	CHECK( archive.GetStep( STEPS - 1, state ) );
+
+} // TestDamage
+
+/////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	// a time slice of a second along the orbit of the moon
+	LUNAR_PARAMETERS params = LUNAR_PARAMETERS();
+	const double dRadius = 3.844e8;
+	params.dSampleTime = 1;
+	params.dGravityRatio = 0.0027 / dRadius;
+	LUNAR_STATE start = LUNAR_STATE();
+	start.dX = dRadius;
+	start.dVy = 1018;
+	start.dAx = -params.dGravityRatio * dRadius;
+
+	CStateList list;
+	CPropagator::Propagate
+	(
+		INTEGRATOR_RK4, start, params, STEPS, false, false, list
+	);
+	CHECK( (int)list.m_States.size() == STEPS );
+
+	{
+		ofstream file( RECORDING, ios::binary | ios::trunc );
+		CTrajectoryRecorder recorder;
+		CHECK( recorder.Open( file ) );
+		for ( const LUNAR_STATE& state : list.m_States )
+		{
+			recorder.Record( state );
+		}
+		CHECK( recorder.Close() );
+		CHECK( recorder.GetSteps() == STEPS );
+	}
+
+	TestQueries( list.m_States );
+	TestDamage();
+	remove( RECORDING );
+
+	return GetTestResult( "TrajectoryArchiveTest" );
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,93 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2022 by W. T. Block, All Rights Reserved
+/////////////////////////////////////////////////////////////////////////////
+// Prints the states of a recording written by CTrajectoryRecorder, which
+// is read with CTrajectoryArchive:
+//
+//	TrajectoryQuery run.lot
+//		the blocks, time slices and time range of the recording
+//	TrajectoryQuery run.lot 3600 7200.5
+//		the state at each running time in seconds
+//	TrajectoryQuery run.lot -step 0 -step 42
+//		the state of each time slice by number
+//
+// The values are printed with all of their digits, so a time slice reads
+// back exactly as it was recorded. Returns 1 if the file cannot be opened
+// or any query fails.
+#include "TrajectoryArchive.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/////////////////////////////////////////////////////////////////////////////
+// print a state on one line after the given label
+static void PrintState( const char* pLabel, const LUNAR_STATE& state )
+{
+	printf
+	(
+		"%s t %.17g x %.17g y %.17g vx %.17g vy %.17g ax %.17g ay %.17g\n",
+		pLabel, state.dTime, state.dX, state.dY, state.dVx, state.dVy,
+		state.dAx, state.dAy
+	);
+
+} // PrintState
+
+/////////////////////////////////////////////////////////////////////////////
+int main( int argc, char** argv )
+{
+	if ( argc < 2 )
+	{
+		printf( "usage: TrajectoryQuery file [time | -step n]...\n" );
+		return 1;
+	}
+
+	CTrajectoryArchive archive;
+	if ( !archive.Open( argv[ 1 ] ) )
+	{
+		printf( "%s is not a complete recording\n", argv[ 1 ] );
+		return 1;
+	}
+
+	if ( argc == 2 )
+	{
+		printf
+		(
+			"%lld blocks, %lld time slices, %.17g to %.17g seconds\n",
+			archive.GetBlocks(), archive.GetSteps(), archive.GetFirstTime(),
+			archive.GetLastTime()
+		);
+		return 0;
+	}
+
+	int nResult = 0;
+	for ( int nArg = 2; nArg < argc; nArg++ )
+	{
+		LUNAR_STATE state;
+		if ( strcmp( argv[ nArg ], "-step" ) == 0 && nArg + 1 < argc )
+		{
+			const char* pStep = argv[ ++nArg ];
+			if ( archive.GetStep( atoll( pStep ), state ) )
+			{
+				PrintState( pStep, state );
+			}
+			else
+			{
+				printf( "%s no such time slice\n", pStep );
+				nResult = 1;
+			}
+		}
+		else if ( archive.GetState( atof( argv[ nArg ] ), state ) )
+		{
+			PrintState( argv[ nArg ], state );
+		}
+		else
+		{
+			printf( "%s outside the recording\n", argv[ nArg ] );
+			nResult = 1;
+		}
+	}
+	return nResult;
+
+} // main
+
+/////////////////////////////////////////////////////////////////////////////